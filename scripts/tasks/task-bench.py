@@ -0,0 +1,72 @@
+#! /usr/bin/env python3
+import argparse
+import os
+import subprocess
+import sys
+import util
+
+
+def argparser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(
+        prog="bench",
+        description="Render test patches through the DSP code on this machine and time each stage",
+    )
+    parser.add_argument(
+        "-s",
+        "--seconds",
+        type=float,
+        default=10,
+        help="Seconds of audio to render per patch",
+    )
+    parser.add_argument(
+        "-w",
+        "--wav-dir",
+        help="Also write each patch's output to a WAV in this directory",
+    )
+
+    return parser
+
+
+def cmake_configure() -> int:
+    cmake_args = ["cmake"]
+    cmake_args += ["-S", "tests/"]
+    cmake_args += ["-B", "build/tests"]
+    cmake_args += ["-G", "Ninja Multi-Config"]  # generator
+
+    return subprocess.run(cmake_args, env=os.environ).returncode
+
+
+def cmake_build() -> int:
+    cmake_args = ["cmake"]
+    cmake_args += ["--build", "build/tests/"]
+    cmake_args += ["--config", "Release"]
+    cmake_args += ["--target", "RenderBenchmark"]
+
+    return subprocess.run(cmake_args, env=os.environ).returncode
+
+
+def main() -> int:
+    args = argparser().parse_args()
+
+    os.chdir(util.get_git_root())
+
+    if not os.path.exists("build/tests"):
+        result = cmake_configure()
+        if result != 0:
+            return result
+
+    build = cmake_build()
+    if build != 0:
+        return build
+
+    bench_args = [os.path.join("build", "tests", "benchmark", "Release", "RenderBenchmark")]
+    bench_args += ["--seconds", str(args.seconds)]
+    if args.wav_dir:
+        os.makedirs(args.wav_dir, exist_ok=True)
+        bench_args += ["--wav-dir", args.wav_dir]
+
+    return subprocess.run(bench_args, env=os.environ).returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -237,8 +237,8 @@ static void ne10_fft_generate_twiddles_line_int32 (ne10_fft_cpx_int32_t * twiddl
 
             ne10_fft_cpx_int32_t *tw = &twiddles[mstride * (k - 1) + j];
 
-            tw->r = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * cos(phase));
-            tw->i = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * sin(phase));
+            tw->r = ne10_f2i32_twiddle (cos (phase));
+            tw->i = ne10_f2i32_twiddle (sin (phase));
         } // radix
     } // mstride
 }
@@ -78,6 +78,16 @@
 
 #define NE10_FFT_PARA_LEVEL 4
 
+/*
+ * Rounds a twiddle's cos or sin to Q31. Where it's 1, that rounds up to 2^31, which is out of range - ARM's
+ * float-to-int conversion saturates that to the largest int32, but x86's wraps it round to -1.
+ */
+NE10_INLINE ne10_int32_t ne10_f2i32_twiddle (ne10_float64_t value)
+{
+    ne10_float64_t rounded = floor (0.5f + NE10_F2I32_MAX * value);
+    return (rounded >= NE10_F2I32_MAX) ? NE10_F2I32_MAX : (ne10_int32_t) rounded;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -1210,8 +1210,8 @@ ne10_fft_r2c_cfg_int32_t ne10_fft_alloc_r2c_int32 (ne10_int32_t nfft)
                 for (k = 1; k < cur_radix; k++) // phase = 1 when k = 0
                 {
                     phase = -2 * pi * fstride * k * j / ncfft;
-                    twiddles[mstride * (k - 1) + j].r = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * cos (phase));
-                    twiddles[mstride * (k - 1) + j].i = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * sin (phase));
+                    twiddles[mstride * (k - 1) + j].r = ne10_f2i32_twiddle (cos (phase));
+                    twiddles[mstride * (k - 1) + j].i = ne10_f2i32_twiddle (sin (phase));
                 }
             }
             twiddles += mstride * (cur_radix - 1);
@@ -1225,8 +1225,8 @@ ne10_fft_r2c_cfg_int32_t ne10_fft_alloc_r2c_int32 (ne10_int32_t nfft)
         for (j = 0; j < ncfft / 2; j++)
         {
             phase = -pi * ( (ne10_float32_t) (j + 1) / ncfft + 0.5f);
-            twiddles->r = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * cos (phase));
-            twiddles->i = (ne10_int32_t) floor (0.5f + NE10_F2I32_MAX * sin (phase));
+            twiddles->r = ne10_f2i32_twiddle (cos (phase));
+            twiddles->i = ne10_f2i32_twiddle (sin (phase));
             twiddles++;
         }
     }
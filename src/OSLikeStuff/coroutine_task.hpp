@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "task_scheduler.h"
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// Stackless coroutines the task scheduler can run as tasks. A long job - writing out a file, say - is written as one
+/// straight-line function which gives the rest of the system a turn with co_await nextTick(), or waits for something
+/// with co_await until(), instead of calling yield() from deep in its stack. Only the coroutine's own locals are kept
+/// while it's suspended, in a frame on the heap, so nothing else's stack has to stay wound up underneath it.
+///
+///     Coroutine<Error> writeEverything(Thing* thing) {
+///         for (...) {
+///             co_await nextTick();
+///         }
+///         co_return Error::NONE;
+///     }
+///     Coroutine<void> job() {
+///         Error error = co_await writeEverything(thing);
+///         ...
+///     }
+///     addCoroutineTask(job(), priority, "write everything");
+namespace deluge::coroutine {
+
+/// What a suspended coroutine task is waiting for. With no ready function, it's just waiting for its next turn
+struct Condition {
+	bool (*ready)(void* context){nullptr};
+	void* context{nullptr};
+
+	[[nodiscard]] bool isReady() const { return ready == nullptr || ready(context); }
+};
+
+namespace internal {
+/// Where a coroutine task has stopped: the innermost of its coroutines, and what that's waiting for
+struct Resumption {
+	std::coroutine_handle<> handle;
+	Condition condition;
+};
+/// Set by the scheduler while it's resuming a coroutine task, nullptr otherwise
+extern Resumption* current;
+
+/// Hands control back to whichever coroutine awaited this one, or out of resume() if it's the outermost
+struct FinalAwaiter {
+	[[nodiscard]] bool await_ready() const noexcept { return false; }
+	template <typename Promise>
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+		std::coroutine_handle<> continuation = handle.promise().continuation;
+		return continuation ? continuation : std::noop_coroutine();
+	}
+	void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+	std::coroutine_handle<> continuation;
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+	FinalAwaiter final_suspend() noexcept { return {}; }
+	void unhandled_exception() {} // built without exceptions
+
+	// frames come off the heap. Without exceptions, running out of memory has to show up as an empty Coroutine
+	static void* operator new(std::size_t size) noexcept { return ::operator new(size, std::nothrow); }
+	static void operator delete(void* frame) noexcept { ::operator delete(frame); }
+};
+
+template <typename T>
+class Promise;
+} // namespace internal
+
+/// A coroutine returning T, which doesn't start until it's awaited or handed to addCoroutineTask(). T needs to be
+/// default constructible. If there wasn't the memory for its frame it's empty, which should be checked for before
+/// awaiting it - awaiting an empty one gives T{} straight away.
+template <typename T>
+class [[nodiscard]] Coroutine {
+public:
+	using promise_type = internal::Promise<T>;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	Coroutine() = default;
+	explicit Coroutine(Handle handle) : handle_(handle) {}
+	Coroutine(Coroutine const&) = delete;
+	Coroutine& operator=(Coroutine const&) = delete;
+	Coroutine(Coroutine&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+	Coroutine& operator=(Coroutine&& other) noexcept {
+		if (this != &other) {
+			destroy();
+			handle_ = std::exchange(other.handle_, nullptr);
+		}
+		return *this;
+	}
+	~Coroutine() { destroy(); }
+
+	[[nodiscard]] explicit operator bool() const { return static_cast<bool>(handle_); }
+	/// Gives up ownership of the frame, for the scheduler
+	Handle release() { return std::exchange(handle_, nullptr); }
+
+	auto operator co_await() && noexcept {
+		struct Awaiter {
+			Handle handle;
+			[[nodiscard]] bool await_ready() const noexcept { return !handle || handle.done(); }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+				handle.promise().continuation = caller;
+				return handle;
+			}
+			T await_resume() {
+				if constexpr (!std::is_void_v<T>) {
+					return handle ? std::move(handle.promise().value) : T{};
+				}
+			}
+		};
+		return Awaiter{handle_};
+	}
+
+private:
+	Handle handle_;
+
+	void destroy() {
+		if (handle_) {
+			handle_.destroy();
+			handle_ = nullptr;
+		}
+	}
+};
+
+namespace internal {
+template <typename T>
+class Promise : public PromiseBase {
+public:
+	T value{};
+
+	Coroutine<T> get_return_object() { return Coroutine<T>{Coroutine<T>::Handle::from_promise(*this)}; }
+	static Coroutine<T> get_return_object_on_allocation_failure() { return Coroutine<T>{}; }
+	void return_value(T returned) { value = std::move(returned); }
+};
+
+template <>
+class Promise<void> : public PromiseBase {
+public:
+	Coroutine<void> get_return_object() { return Coroutine<void>{Coroutine<void>::Handle::from_promise(*this)}; }
+	static Coroutine<void> get_return_object_on_allocation_failure() { return Coroutine<void>{}; }
+	void return_void() {}
+};
+
+} // namespace internal
+
+/// Suspends a coroutine task until the condition's met, handing control back to the scheduler. Outside of a coroutine
+/// task there's nothing to hand control back to, so it doesn't wait at all
+struct Wait {
+	Condition condition;
+
+	[[nodiscard]] bool await_ready() const { return condition.ready != nullptr && condition.ready(condition.context); }
+	bool await_suspend(std::coroutine_handle<> handle) const {
+		if (internal::current == nullptr) {
+			return false;
+		}
+		*internal::current = internal::Resumption{handle, condition};
+		return true;
+	}
+	void await_resume() const {}
+};
+
+/// Carries on the next time the scheduler gets round to this task, other tasks having had their turn
+[[nodiscard]] inline Wait nextTick() {
+	return {};
+}
+
+/// Carries on once ready(context) returns true. The scheduler checks it between other tasks, so it needs to be quick
+[[nodiscard]] inline Wait until(bool (*ready)(void* context), void* context) {
+	return {Condition{ready, context}};
+}
+
+/// Runs a coroutine as a task until it returns, at which point the task is removed. Removing the task sooner destroys
+/// the coroutine where it stopped. Returns -1, having destroyed the coroutine, if there's no room for another task or
+/// the coroutine is empty
+TaskID addCoroutineTask(Coroutine<void> coroutine, uint8_t priority, const char* name);
+
+} // namespace deluge::coroutine
@@ -17,10 +17,14 @@
 
 #include "task_scheduler.h"
 
+#include "coroutine_task.hpp"
 #include "io/debug/log.h"
 #include "util/container/static_vector.hpp"
 #include <algorithm>
+#include <array>
+#include <coroutine>
 #include <iostream>
+#include <utility>
 
 #if !IN_UNIT_TESTS
 #include "memory/general_memory_allocator.h"
@@ -30,35 +34,103 @@ extern "C" {
 #include "RZA1/ostm/ostm.h"
 }
 
-#define SCHEDULER_DETAILED_STATS (0 && ENABLE_TEXT_OUTPUT)
+// set by the ENABLE_EDF_SCHEDULER build option
+#ifndef SCHEDULER_EDF
+#define SCHEDULER_EDF 0
+#endif
+
+enum class SchedulingPolicy : uint8_t {
+	/// Run the least important task that can finish before a more important one needs to start, going by static
+	/// priorities and expected durations
+	PRIORITY,
+	/// Run the ready task whose maxInterval runs out soonest, but only if it'll finish before any task with a budget
+	/// has to start
+	EDF,
+};
+
+constexpr SchedulingPolicy kDefaultPolicy = SCHEDULER_EDF ? SchedulingPolicy::EDF : SchedulingPolicy::PRIORITY;
 
 struct StatBlock {
-#if SCHEDULER_DETAILED_STATS
-	double min{std::numeric_limits<double>::infinity()};
-	double max{-std::numeric_limits<double>::infinity()};
-#endif
 	/// Running average, computed as (last + avg) / 2
 	double average{0};
 
-	[[gnu::hot]] void update(double v) {
-#if SCHEDULER_DETAILED_STATS
-		min = std::min(v, min);
-		max = std::max(v, max);
-#endif
-		average = (average + v) / 2;
+	[[gnu::hot]] void update(double v) { average = (average + v) / 2; }
+	void reset() { average = 0; }
+};
+
+/// Counts of times in buckets a power of two apart: bucket 0 holds anything under 1us, and bucket b holds
+/// [2^(b-1), 2^b) us. Once it's seen kMaxSamples the counts are halved, so the percentiles follow what the task's been
+/// doing lately rather than what it did at boot.
+struct Histogram {
+	static constexpr int32_t kNumBuckets = 24; // up to about 8 seconds
+	static constexpr uint32_t kMaxSamples = 1024;
+
+	std::array<uint16_t, kNumBuckets> counts{};
+	uint32_t numSamples{0};
+
+	[[gnu::hot]] void add(double seconds) {
+		uint32_t microseconds = std::clamp(seconds, 0.0, 8.0) * 1000000;
+		int32_t bucket = (microseconds != 0) ? 32 - __builtin_clz(microseconds) : 0;
+		counts[std::min(bucket, kNumBuckets - 1)] += 1;
+		numSamples += 1;
+		if (numSamples >= kMaxSamples) {
+			numSamples = 0;
+			for (auto& count : counts) {
+				count /= 2;
+				numSamples += count;
+			}
+		}
 	}
-	void reset() {
-#if SCHEDULER_DETAILED_STATS
-		min = std::numeric_limits<double>::infinity();
-		max = -std::numeric_limits<double>::infinity();
-#endif
-		average = 0;
+
+	/// The time that fraction of the samples took no longer than, in seconds, interpolating within the bucket it
+	/// lands in. 0 if nothing's been added yet
+	[[nodiscard]] double percentile(double fraction) const {
+		uint32_t rank = std::max<uint32_t>(fraction * numSamples + 0.5, 1);
+		uint32_t below = 0;
+		for (int32_t b = 0; b < kNumBuckets; b++) {
+			if (below + counts[b] >= rank) {
+				double lower = (b == 0) ? 0 : (1 << (b - 1));
+				double upper = 1 << b;
+				return (lower + (upper - lower) * (rank - below) / counts[b]) / 1000000;
+			}
+			below += counts[b];
+		}
+		return 0;
 	}
+
+	void reset() { *this = {}; }
+};
+
+/// Duration and lateness for one task, cheap enough to keep in release builds. The histograms follow recent runs; the
+/// worst cases and counts add up until they're reset over sysex, so a task that overran once can still be found
+struct TimingStats {
+	Histogram duration;
+	/// How long after its target time each run started
+	Histogram latency;
+	double worstDuration{0};
+	double worstLatency{0};
+	uint32_t numRuns{0};
+	/// Runs that started more than maxInterval after the previous one
+	uint32_t numMissedDeadlines{0};
+	/// Runs that took longer than the task's budget, for tasks which have one
+	uint32_t numBudgetOverruns{0};
+
+	void reset() { *this = {}; }
 };
 
+/// Which percentile of a task's duration the scheduler plans around
+constexpr double kPredictionPercentile = 0.9;
+/// Which percentile of a task's duration EDF treats as its worst case, if it's not been given a budget
+constexpr double kBudgetPercentile = 0.99;
+
 // currently 14 are in use
 constexpr int kMaxTasks = 25;
 constexpr double rollTime = ((double)(UINT32_MAX) / DELUGE_CLOCKS_PERf);
+/// The longest a coroutine task that isn't waiting for anything should go without a turn
+constexpr double kCoroutineMaxInterval = 0.05;
+
+static void resumeCurrentCoroutine();
+
 struct Task {
 	Task() = default;
 
@@ -87,23 +159,68 @@ struct Task {
 		runnable = false;
 		condition = _condition;
 	}
+	// makes a coroutine task, which runs whenever it's not waiting on anything until the coroutine returns
+	Task(std::coroutine_handle<> _coroutine, uint8_t priority, double timeNow, const char* _name) {
+		handle = resumeCurrentCoroutine;
+		lastCallTime = timeNow;
+		schedule = {priority, 0, 0, kCoroutineMaxInterval};
+		name = _name;
+		removeAfterUse = false;
+		coroutine = _coroutine;
+		resumption = {_coroutine, {}};
+	}
 	TaskHandle handle{nullptr};
 	TaskSchedule schedule{0, 0, 0, 0};
 	double lastCallTime{0};
 	double lastFinishTime{0};
 
 	StatBlock durationStats;
-#if SCHEDULER_DETAILED_STATS
-	StatBlock latency;
-#endif
+	TimingStats timing;
+	/// kPredictionPercentile of durations, which is what the scheduler expects the next run to take
+	double expectedDuration{0};
+	/// The longest the task is allowed to run, set with setTaskBudget(). 0 if it hasn't got one, in which case EDF goes
+	/// by measuredBudget and doesn't hold other tasks back for it
+	double budget{0};
+	/// kBudgetPercentile of durations
+	double measuredBudget{0};
 	bool runnable{true};
 	RunCondition condition{nullptr};
 	bool removeAfterUse{false};
 	const char* name{nullptr};
+	/// For coroutine tasks: the outermost coroutine, which the task owns, and where it's stopped
+	std::coroutine_handle<> coroutine{};
+	deluge::coroutine::internal::Resumption resumption{};
+	/// Set while the coroutine is running, which it still is if it's called yield()
+	bool resuming{false};
 
 	double totalTime{0};
 	int32_t timesCalled{0};
 	double lastRunTime;
+
+	void recordRun(double runtime) {
+		durationStats.update(runtime);
+		timing.duration.add(runtime);
+		timing.worstDuration = std::max(timing.worstDuration, runtime);
+		timing.numRuns += 1;
+		expectedDuration = timing.duration.percentile(kPredictionPercentile);
+		measuredBudget = timing.duration.percentile(kBudgetPercentile);
+		if (budget > 0 && runtime > budget) {
+			timing.numBudgetOverruns += 1;
+		}
+		totalTime += runtime;
+		lastRunTime = runtime;
+		timesCalled += 1;
+	}
+
+	[[nodiscard]] bool hasBudget() const { return budget > 0; }
+	/// How long EDF expects the next run could take
+	[[nodiscard]] double getBudget() const { return hasBudget() ? budget : measuredBudget; }
+	/// When EDF may next start the task
+	[[nodiscard]] double getReleaseTime() const {
+		return std::max(lastCallTime + schedule.targetInterval, lastFinishTime + schedule.backOffPeriod);
+	}
+	/// When EDF needs the task to have started
+	[[nodiscard]] double getDeadline() const { return lastCallTime + schedule.maxInterval; }
 };
 
 struct SortedTask {
@@ -113,8 +230,94 @@ struct SortedTask {
 	bool operator<(const SortedTask& another) const { return priority > another.priority; }
 };
 
+/// Binary heap of task IDs ordered by a time given for each, earliest on top. Keeps track of where each task is, so any
+/// of them can be taken out in O(log n)
+class TaskHeap {
+public:
+	TaskHeap() { position_.fill(-1); }
+
+	[[nodiscard]] bool empty() const { return size_ == 0; }
+	[[nodiscard]] bool contains(TaskID id) const { return position_[id] >= 0; }
+	[[nodiscard]] TaskID top() const { return heap_[0]; }
+	[[nodiscard]] double topTime() const { return times_[heap_[0]]; }
+
+	void push(TaskID id, double time) {
+		times_[id] = time;
+		int32_t i = size_++;
+		place(i, id);
+		siftUp(i);
+	}
+
+	TaskID pop() {
+		TaskID id = heap_[0];
+		remove(id);
+		return id;
+	}
+
+	void remove(TaskID id) {
+		int32_t i = position_[id];
+		if (i < 0) {
+			return;
+		}
+		position_[id] = -1;
+		size_--;
+		if (i == size_) {
+			return;
+		}
+		TaskID moved = heap_[size_];
+		place(i, moved);
+		siftUp(i);
+		siftDown(position_[moved]);
+	}
+
+private:
+	std::array<TaskID, kMaxTasks> heap_{};
+	std::array<int8_t, kMaxTasks> position_{};
+	std::array<double, kMaxTasks> times_{};
+	int32_t size_{0};
+
+	void place(int32_t i, TaskID id) {
+		heap_[i] = id;
+		position_[id] = i;
+	}
+	void siftUp(int32_t i) {
+		while (i > 0) {
+			int32_t parent = (i - 1) / 2;
+			if (times_[heap_[parent]] <= times_[heap_[i]]) {
+				break;
+			}
+			swap(i, parent);
+			i = parent;
+		}
+	}
+	void siftDown(int32_t i) {
+		while (true) {
+			int32_t earliest = i;
+			for (int32_t child = 2 * i + 1; child <= 2 * i + 2 && child < size_; child++) {
+				if (times_[heap_[child]] < times_[heap_[earliest]]) {
+					earliest = child;
+				}
+			}
+			if (earliest == i) {
+				break;
+			}
+			swap(i, earliest);
+			i = earliest;
+		}
+	}
+	void swap(int32_t a, int32_t b) {
+		TaskID idA = heap_[a];
+		place(a, heap_[b]);
+		place(b, idA);
+	}
+};
+
 /// internal only to the task scheduler, hence all public. External interaction to use the api
 struct TaskManager {
+	TaskManager() = default;
+	explicit TaskManager(SchedulingPolicy policy) : policy(policy) {}
+
+	SchedulingPolicy policy{kDefaultPolicy};
 	// All current tasks
 	// Not all entries are filled - removed entries have a null task handle
 	std::array<Task, kMaxTasks> list{};
@@ -122,6 +325,10 @@ struct TaskManager {
 	std::array<SortedTask, kMaxTasks> sortedList;
 	uint8_t numActiveTasks = 0;
 	uint8_t numRegisteredTasks = 0;
+	// For EDF: runnable tasks waiting for their release time, by release time
+	TaskHeap waiting;
+	// For EDF: released tasks, by deadline
+	TaskHeap ready;
 	double mustEndBefore = -1; // use for testing or I guess if you want a second temporary task manager?
 	bool running{false};
 	double cpuTime{0};
@@ -132,12 +339,18 @@ struct TaskManager {
 	void removeTask(TaskID id);
 	void runTask(TaskID id);
 	TaskID chooseBestTask(double deadline);
+	TaskID chooseEarliestDeadline(double deadline);
+	bool fitsBeforeBudgetedTasks(TaskID id, double currentTime, double deadline);
 	TaskID addRepeatingTask(TaskHandle task, TaskSchedule schedule, const char* name);
 
 	TaskID addOnceTask(TaskHandle task, uint8_t priority, double timeToWait, const char* name);
 	TaskID addConditionalTask(TaskHandle task, uint8_t priority, RunCondition condition, const char* name);
+	TaskID addCoroutineTask(std::coroutine_handle<> coroutine, uint8_t priority, const char* name);
+	void resumeCoroutine();
 
 	void createSortedList();
+	void queueTask(TaskID id);
+	void dequeueTask(TaskID id);
 	TaskID insertTaskToList(Task task);
 	void printStats();
 	bool checkConditionalTasks();
@@ -148,6 +361,9 @@ struct TaskManager {
 	void setNextRunTimeforCurrentTask(double seconds);
 
 	double getLastRunTimeforCurrentTask();
+	bool setTaskBudget(TaskID id, double budget);
+	TaskID getTaskStats(TaskID from, TaskStats* stats);
+	void resetTimingStats();
 
 private:
 	TaskID currentID{0};
@@ -162,6 +378,10 @@ private:
 
 TaskManager taskManager;
 
+static void resumeCurrentCoroutine() {
+	taskManager.resumeCoroutine();
+}
+
 void TaskManager::createSortedList() {
 	int j = 0;
 	for (TaskID i = 0; i < kMaxTasks; i++) {
@@ -179,8 +399,31 @@ void TaskManager::createSortedList() {
 	}
 }
 
+void TaskManager::queueTask(TaskID id) {
+	if (policy == SchedulingPolicy::PRIORITY) {
+		createSortedList();
+		return;
+	}
+	Task const& task = list[id];
+	if (task.handle != nullptr && task.runnable && !waiting.contains(id) && !ready.contains(id)) {
+		waiting.push(id, task.getReleaseTime());
+	}
+}
+
+void TaskManager::dequeueTask(TaskID id) {
+	if (policy == SchedulingPolicy::PRIORITY) {
+		createSortedList();
+		return;
+	}
+	waiting.remove(id);
+	ready.remove(id);
+}
+
 // deadline < 0 means no deadline
 TaskID TaskManager::chooseBestTask(double deadline) {
+	if (policy == SchedulingPolicy::EDF) {
+		return chooseEarliestDeadline(deadline);
+	}
 	double currentTime = getSecondsFromStart();
 	double nextFinishTime = currentTime;
 	TaskID bestTask = -1;
@@ -191,20 +434,20 @@ TaskID TaskManager::chooseBestTask(double deadline) {
 	for (int i = 0; i < numActiveTasks; i++) {
 		struct Task* t = &list[sortedList[i].task];
 		struct TaskSchedule* s = &t->schedule;
-		double timeToCall = t->lastCallTime + s->targetInterval - t->durationStats.average;
-		double maxTimeToCall = t->lastCallTime + s->maxInterval - t->durationStats.average;
+		double timeToCall = t->lastCallTime + s->targetInterval - t->expectedDuration;
+		double maxTimeToCall = t->lastCallTime + s->maxInterval - t->expectedDuration;
 		double timeSinceFinish = currentTime - t->lastFinishTime;
 		// ensure every routine is within its target
 		if (currentTime - t->lastCallTime > s->maxInterval) {
 			return sortedList[i].task;
 		}
 		if (timeToCall < currentTime || maxTimeToCall < nextFinishTime) {
-			if (deadline < 0 || currentTime + t->durationStats.average < deadline) {
+			if (deadline < 0 || currentTime + t->expectedDuration < deadline) {
 
 				if (s->priority < bestPriority && t->handle) {
 					if (timeSinceFinish > s->backOffPeriod) {
 						bestTask = sortedList[i].task;
-						nextFinishTime = currentTime + t->durationStats.average;
+						nextFinishTime = currentTime + t->expectedDuration;
 					}
 					else {
 						bestTask = -1;
@@ -222,7 +465,7 @@ TaskID TaskManager::chooseBestTask(double deadline) {
 		for (int i = (numActiveTasks - 1); i >= 0; i--) {
 			struct Task* t = &list[sortedList[i].task];
 			struct TaskSchedule* s = &t->schedule;
-			if (currentTime + t->durationStats.average < nextFinishTime
+			if (currentTime + t->expectedDuration < nextFinishTime
 			    && currentTime - t->lastFinishTime > s->targetInterval
 			    && currentTime - t->lastFinishTime > s->backOffPeriod) {
 				return sortedList[i].task;
@@ -232,7 +475,7 @@ TaskID TaskManager::chooseBestTask(double deadline) {
 		for (int i = (numActiveTasks - 1); i >= 0; i--) {
 			struct Task* t = &list[sortedList[i].task];
 			struct TaskSchedule* s = &t->schedule;
-			if (currentTime + t->durationStats.average < nextFinishTime
+			if (currentTime + t->expectedDuration < nextFinishTime
 			    && currentTime - t->lastFinishTime > s->backOffPeriod) {
 				return sortedList[i].task;
 			}
@@ -241,6 +484,59 @@ TaskID TaskManager::chooseBestTask(double deadline) {
 	return bestTask;
 }
 
+/// Takes the released task with the earliest deadline that fits before every task with a budget needs to start, off the
+/// ready heap. It goes back on the waiting heap once it's run. deadline < 0 means no deadline
+TaskID TaskManager::chooseEarliestDeadline(double deadline) {
+	double currentTime = getSecondsFromStart();
+	while (!waiting.empty() && waiting.topTime() <= currentTime) {
+		TaskID id = waiting.pop();
+		ready.push(id, list[id].getDeadline());
+	}
+
+	std::array<TaskID, kMaxTasks> skipped;
+	int32_t numSkipped = 0;
+	TaskID chosen = -1;
+	while (!ready.empty()) {
+		TaskID id = ready.pop();
+		if (fitsBeforeBudgetedTasks(id, currentTime, deadline)) {
+			chosen = id;
+			break;
+		}
+		skipped[numSkipped++] = id;
+	}
+	for (int32_t i = 0; i < numSkipped; i++) {
+		ready.push(skipped[i], list[skipped[i]].getDeadline());
+	}
+	return chosen;
+}
+
+/// The admission check for EDF: whether a task, if started now, would be done before any task with a budget has to
+/// start to meet its own deadline
+bool TaskManager::fitsBeforeBudgetedTasks(TaskID id, double currentTime, double deadline) {
+	Task const& task = list[id];
+	double finishTime = currentTime + task.getBudget();
+	if (deadline >= 0 && finishTime >= deadline) {
+		return false;
+	}
+	// without this, a task that never fits between the budgeted ones would never run at all. Held back for a whole
+	// extra maxInterval, it goes anyway
+	if (!task.hasBudget() && currentTime > task.getDeadline() + task.schedule.maxInterval) {
+		return true;
+	}
+	for (TaskID other = 0; other < kMaxTasks; other++) {
+		Task const& t = list[other];
+		if (other == id || !t.hasBudget() || !(waiting.contains(other) || ready.contains(other))) {
+			continue;
+		}
+		double latestStart = t.getDeadline() - t.budget;
+		// if it's already too late for that one, holding this one back won't help it
+		if (latestStart >= currentTime && latestStart < finishTime) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /// insert task into the first empty spot in the list
 TaskID TaskManager::insertTaskToList(Task task) {
 	int8_t index = 0;
@@ -262,7 +558,7 @@ TaskID TaskManager::addRepeatingTask(TaskHandle task, TaskSchedule schedule, con
 
 	TaskID index = insertTaskToList(Task{task, schedule, name});
 
-	createSortedList();
+	queueTask(index);
 	return index;
 }
 
@@ -273,7 +569,7 @@ TaskID TaskManager::addOnceTask(TaskHandle task, uint8_t priority, double timeTo
 	double timeToStart = running ? getSecondsFromStart() : 0;
 	TaskID index = insertTaskToList(Task{task, priority, timeToStart, timeToWait, name});
 
-	createSortedList();
+	queueTask(index);
 	return index;
 }
 
@@ -286,10 +582,57 @@ TaskID TaskManager::addConditionalTask(TaskHandle task, uint8_t priority, RunCon
 	return index;
 }
 
+TaskID TaskManager::addCoroutineTask(std::coroutine_handle<> coroutine, uint8_t priority, const char* name) {
+	if (numRegisteredTasks >= (kMaxTasks)) {
+		coroutine.destroy();
+		return -1;
+	}
+	double timeNow = running ? getSecondsFromStart() : 0;
+	TaskID index = insertTaskToList(Task{coroutine, priority, timeNow, name});
+
+	queueTask(index);
+	return index;
+}
+
+/// The handle of every coroutine task. Resumes the coroutine where it stopped, then takes the task off the run queue if
+/// it's stopped to wait for something - checkConditionalTasks() puts it back once that's happened
+void TaskManager::resumeCoroutine() {
+	TaskID id = currentID;
+	Task& task = list[id];
+	// a coroutine that calls yield() is still running, and the loop it yields to can choose it again
+	if (task.resuming || !task.resumption.condition.isReady()) {
+		task.lastCallTime = getSecondsFromStart();
+		ignoreForStats();
+		return;
+	}
+	task.resuming = true;
+	task.resumption.condition = {};
+	auto* outer = std::exchange(deluge::coroutine::internal::current, &task.resumption);
+	task.resumption.handle.resume();
+	deluge::coroutine::internal::current = outer;
+	task.resuming = false;
+
+	if (task.coroutine.done()) {
+		task.removeAfterUse = true;
+	}
+	else if (task.resumption.condition.ready != nullptr) {
+		task.runnable = false;
+		dequeueTask(id);
+	}
+}
+
 void TaskManager::removeTask(TaskID id) {
+	if (list[id].resuming) {
+		// a coroutine can't be destroyed from inside itself, so it goes as soon as it next stops
+		list[id].removeAfterUse = true;
+		return;
+	}
+	if (list[id].coroutine) {
+		list[id].coroutine.destroy();
+	}
 	list[id] = Task{};
 	numRegisteredTasks--;
-	createSortedList();
+	dequeueTask(id);
 	return;
 }
 void TaskManager::ignoreForStats() {
@@ -324,18 +667,25 @@ void TaskManager::runTask(TaskID id) {
 	}
 	else {
 		if (countThisTask) {
-#if SCHEDULER_DETAILED_STATS
-			currentTask->latency.update(startTime - currentTask->lastCallTime);
-#endif
+			// a task that's never finished has nothing to be late against
+			if (currentTask->lastFinishTime > 0) {
+				double sinceLastCall = startTime - currentTask->lastCallTime;
+				double late = std::max(sinceLastCall - currentTask->schedule.targetInterval, 0.0);
+				currentTask->timing.latency.add(late);
+				currentTask->timing.worstLatency = std::max(currentTask->timing.worstLatency, late);
+				if (sinceLastCall > currentTask->schedule.maxInterval) {
+					currentTask->timing.numMissedDeadlines += 1;
+				}
+			}
 			currentTask->lastCallTime = startTime;
 
-			currentTask->durationStats.update(runtime);
-			currentTask->totalTime += runtime;
-			currentTask->lastRunTime = runtime;
-			currentTask->timesCalled += 1;
+			currentTask->recordRun(runtime);
 		}
 	}
 	currentTask->lastFinishTime = timeNow;
+	if (policy == SchedulingPolicy::EDF) {
+		queueTask(id);
+	}
 
 	lastFinishTime = timeNow;
 }
@@ -365,10 +715,7 @@ bool TaskManager::yield(RunCondition until, double timeout) {
 	else {
 		yieldingTask->lastFinishTime = timeNow; // update this so it's in its back off window
 		if (countThisTask) {
-			yieldingTask->durationStats.update(runtime);
-			yieldingTask->totalTime += runtime;
-			yieldingTask->lastRunTime = runtime;
-			yieldingTask->timesCalled += 1;
+			yieldingTask->recordRun(runtime);
 		}
 	}
 	// continue the main loop. The yielding task is still on the stack but that should be fine
@@ -442,15 +789,28 @@ bool TaskManager::checkConditionalTasks() {
 	bool addedTask = false;
 	for (int i = 0; i < kMaxTasks; i++) {
 		struct Task* t = &list[i];
-		if (t->condition != nullptr && !(t->runnable)) {
+		if (t->runnable) {
+			continue;
+		}
+		if (t->condition != nullptr) {
 			t->runnable = t->condition();
-			if (t->runnable) {
-				addedTask = true;
+		}
+		else if (t->coroutine && t->resumption.condition.isReady()) {
+			t->runnable = true;
+			// it's been waiting, which doesn't make it late
+			t->lastCallTime = getSecondsFromStart();
+		}
+		if (t->runnable) {
+			addedTask = true;
+			if (policy == SchedulingPolicy::EDF) {
+				queueTask(i);
 			}
 		}
 	}
 	if (addedTask) {
-		createSortedList();
+		if (policy == SchedulingPolicy::PRIORITY) {
+			createSortedList();
+		}
 		return true;
 	}
 	return false;
@@ -462,9 +822,6 @@ void TaskManager::resetStats() {
 			task.totalTime = 0;
 			task.timesCalled = 0;
 			task.durationStats.reset();
-#if SCHEDULER_DETAILED_STATS
-			task.latency.reset();
-#endif
 		}
 	}
 	cpuTime = 0;
@@ -472,31 +829,22 @@ void TaskManager::resetStats() {
 }
 
 void TaskManager::printStats() {
-	D_PRINTLN("Dumping task manager stats: (min/ average/ max)");
-	for (auto task : list) {
+	D_PRINTLN("Dumping task manager stats: (median/ p90/ worst)");
+	for (auto& task : list) {
 		if (task.handle) {
 			constexpr const double latencyScale = 1000.0;
 			constexpr const double durationScale = 1000000.0;
-#if SCHEDULER_DETAILED_STATS
-			D_PRINTLN("Load: %5.2f, "                             //<
-			          "Dur: %8.3f/%8.3f/%9.3f us "                //<
-			          "Latency: %8.3f/%8.3f/%8.3f ms "            //<
-			          "N: %10d, Task: %s",                        //<
-			          100.0 * task.totalTime / cpuTime,           //<
-			          durationScale * task.durationStats.min,     //<
-			          durationScale * task.durationStats.average, //<
-			          durationScale * task.durationStats.max,     //<
-			          latencyScale * task.latency.min,            //<
-			          latencyScale * task.latency.average,        //<
-			          latencyScale * task.latency.max,            //<
-			          task.timesCalled, task.name);
-#else
-			D_PRINTLN("Load: %5.2f "                  //<
-			          "Average Duration: %9.3f "      //<
-			          "Times Called: %10d, Task: %s", //<
-			          100.0 * task.totalTime / cpuTime, durationScale * task.durationStats.average, task.timesCalled,
-			          task.name);
-#endif
+			D_PRINTLN("Load: %5.2f, "                                         //<
+			          "Dur: %8.3f/%8.3f/%9.3f us "                            //<
+			          "Late: %8.3f/%8.3f ms "                                 //<
+			          "Missed: %6lu, N: %10d, Task: %s",                      //<
+			          100.0 * task.totalTime / cpuTime,                       //<
+			          durationScale * task.timing.duration.percentile(0.5),   //<
+			          durationScale * task.expectedDuration,                  //<
+			          durationScale * task.timing.worstDuration,              //<
+			          latencyScale * task.timing.latency.percentile(0.9),     //<
+			          latencyScale * task.timing.worstLatency,                //<
+			          task.timing.numMissedDeadlines, task.timesCalled, task.name);
 		}
 	}
 	auto totalTime = cpuTime + overhead;
@@ -504,6 +852,64 @@ void TaskManager::printStats() {
 	          100 * overhead / totalTime, runningTime);
 	resetStats();
 }
+
+TaskID TaskManager::getTaskStats(TaskID from, TaskStats* stats) {
+	for (TaskID id = std::max<TaskID>(from, 0); id < kMaxTasks; id++) {
+		Task const& task = list[id];
+		if (task.handle == nullptr) {
+			continue;
+		}
+		stats->name = task.name;
+		stats->numRuns = task.timing.numRuns;
+		stats->numMissedDeadlines = task.timing.numMissedDeadlines;
+		stats->durationMedian = task.timing.duration.percentile(0.5);
+		stats->durationExpected = task.expectedDuration;
+		stats->durationWorst = task.timing.worstDuration;
+		stats->latencyP90 = task.timing.latency.percentile(0.9);
+		stats->latencyWorst = task.timing.worstLatency;
+		stats->budget = task.budget;
+		stats->numBudgetOverruns = task.timing.numBudgetOverruns;
+		return id;
+	}
+	return -1;
+}
+
+void TaskManager::resetTimingStats() {
+	for (auto& task : list) {
+		task.timing.reset();
+		task.expectedDuration = 0;
+		task.measuredBudget = 0;
+	}
+}
+
+/// Admits the budget only if the tasks with budgets, this one included, would then need no more than all of the CPU
+/// between them, each running for its whole budget once per targetInterval
+bool TaskManager::setTaskBudget(TaskID id, double budget) {
+	if (id < 0 || id >= kMaxTasks || list[id].handle == nullptr) {
+		return false;
+	}
+	auto getPeriod = [](Task const& task) {
+		return (task.schedule.targetInterval > 0) ? task.schedule.targetInterval : task.schedule.maxInterval;
+	};
+	if (budget > 0) {
+		double period = getPeriod(list[id]);
+		if (period <= 0) {
+			return false;
+		}
+		double utilisation = budget / period;
+		for (TaskID other = 0; other < kMaxTasks; other++) {
+			if (other != id && list[other].handle != nullptr && list[other].hasBudget()) {
+				utilisation += list[other].budget / getPeriod(list[other]);
+			}
+		}
+		if (utilisation > 1) {
+			return false;
+		}
+	}
+	list[id].budget = std::max(budget, 0.0);
+	return true;
+}
+
 /// return a monotonic timer value in seconds from when the task manager started
 double TaskManager::getSecondsFromStart() {
 	auto timeNow = getTimerValueSeconds(0);
@@ -558,3 +964,28 @@ void removeTask(TaskID id) {
 double getSystemTime() {
 	return taskManager.getSecondsFromStart();
 }
+
+bool setTaskBudget(TaskID id, double budget) {
+	return taskManager.setTaskBudget(id, budget);
+}
+
+TaskID getTaskStats(TaskID from, struct TaskStats* stats) {
+	return taskManager.getTaskStats(from, stats);
+}
+
+void resetTaskStats() {
+	taskManager.resetTimingStats();
+}
+
+namespace deluge::coroutine {
+namespace internal {
+Resumption* current = nullptr;
+} // namespace internal
+
+TaskID addCoroutineTask(Coroutine<void> coroutine, uint8_t priority, const char* name) {
+	if (!coroutine) {
+		return -1;
+	}
+	return taskManager.addCoroutineTask(coroutine.release(), priority, name);
+}
+} // namespace deluge::coroutine
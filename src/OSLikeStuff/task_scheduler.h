@@ -36,14 +36,34 @@ struct TaskSchedule {
 	// maximum time between function calls
 	double maxInterval;
 };
+/// A task's timing, as kept by the scheduler. Times are in seconds. The percentiles follow the last few hundred runs;
+/// the worst cases and counts are since the last resetTaskStats()
+struct TaskStats {
+	const char* name;
+	uint32_t numRuns;
+	/// Runs that started more than maxTimeBetweenCalls after the previous one
+	uint32_t numMissedDeadlines;
+	double durationMedian;
+	/// The percentile of duration the scheduler plans around
+	double durationExpected;
+	double durationWorst;
+	/// How long after its target time a run started
+	double latencyP90;
+	double latencyWorst;
+	/// As set by setTaskBudget(), or 0
+	double budget;
+	/// Runs that took longer than the budget
+	uint32_t numBudgetOverruns;
+};
+
 /// Schedule a task that will be called at a regular interval.
 ///
 /// The scheduler will try to run the task at a regular cadence such that the time between start of calls to the
 /// task is approximately targetTimeBetweenCalls. It will never call the task sooner than backOffTime seconds after it
 /// last completed.
 ///
-/// Tasks are selected to run based on priority and expected duration (computed via a running average of previous
-/// invocations of the task). The task with the lowest priority that can complete before a task with higher
+/// Tasks are selected to run based on priority and expected duration (the 90th percentile of recent invocations of
+/// the task). The task with the lowest priority that can complete before a task with higher
 /// priority needs to start will run, without violation of the backOffTime.
 ///
 /// @param task The task to call
@@ -64,6 +84,15 @@ double getLastRunTimeforCurrentTask();
 double getSystemTime();
 void setNextRunTimeforCurrentTask(double seconds);
 void removeTask(TaskID id);
+/// Gives a task a worst-case execution time. When the scheduler is built for earliest-deadline-first (the
+/// ENABLE_EDF_SCHEDULER option), no other task is started unless it'll be done before this one next needs to start.
+/// Returns false, leaving the task without a budget, if the tasks with budgets would then need more than the whole CPU.
+/// A budget of 0 takes the task's budget away. Has no effect on the default priority scheduling
+bool setTaskBudget(TaskID id, double budget);
+/// Fills in stats for the first task at or after from, returning its ID, or -1 if there are no more tasks
+TaskID getTaskStats(TaskID from, struct TaskStats* stats);
+/// Clears the worst cases, counts and histograms of every task
+void resetTaskStats();
 void yield(RunCondition until);
 /// timeout in seconds, returns whether the condition was met
 bool yieldWithTimeout(RunCondition until, double timeout);
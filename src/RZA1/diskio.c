@@ -228,6 +228,45 @@ DRESULT disk_read_without_streaming_first(BYTE pdrv, /* Physical drive nmuber to
     }
 }
 
+/*-----------------------------------------------------------------------*/
+/* Read consecutive Sectors into several buffers, with one card command  */
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_read_scattered_without_streaming_first(BYTE pdrv, /* Physical drive nmuber to identify the drive */
+    SD_READ_SEGMENT const* segments,                          /* Where each run of sectors goes */
+    int numSegments,                                          /* Number of segments */
+    DWORD sector                                              /* Sector address in LBA of the first segment */
+)
+{
+
+    logAudioAction("disk_read_scattered_without_streaming_first");
+
+    BYTE err;
+
+    if (currentlyAccessingCard)
+    {
+        if (ALPHA_OR_BETA_VERSION)
+        {
+            FREEZE_WITH_ERROR("E259");
+        }
+    }
+
+    currentlyAccessingCard = 1;
+
+    err = sd_read_sect_scattered(SD_PORT, segments, numSegments, sector);
+
+    currentlyAccessingCard = 0;
+
+    if (err == 0)
+    {
+        return RES_OK;
+    }
+    else
+    {
+        return RES_ERROR;
+    }
+}
+
 /*-----------------------------------------------------------------------*/
 /* Write Sector(s)                                                       */
 /*-----------------------------------------------------------------------*/
@@ -236,6 +236,13 @@ extern "C" {
 #define SD_CLR_PWD                0x02
 #define SD_SET_PWD                0x01
 
+/* ---- one destination of a scattered read ---- */
+typedef struct
+{
+    unsigned char *buff;    /* where this segment's sectors go */
+    long cnt;               /* number of sectors */
+} SD_READ_SEGMENT;
+
 /* ==== API prototype ===== */
 /* ---- access library I/F ---- */
 int sd_init(int sd_port, unsigned long base, void *workarea, int cd_port);
@@ -245,6 +252,7 @@ int sd_format(int sd_port, int mode,int (*callback)(unsigned long,unsigned long)
 int sd_format2(int sd_port, int mode,unsigned long volserial,int (*callback)(unsigned long,unsigned long));
 int sd_mount(int sd_port, unsigned long mode,unsigned long voltage);
 int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt);
+int sd_read_sect_scattered(int sd_port, SD_READ_SEGMENT const *segments, int num_segments, unsigned long psn);
 int sd_write_sect(int sd_port, unsigned char const *buff,unsigned long psn,long cnt,int writemode);
 int sd_get_type(int sd_port, unsigned char *type,unsigned char *speed,unsigned char *capa);
 int sd_get_size(int sd_port, unsigned long *user,unsigned long *protect);
@@ -106,6 +106,138 @@ int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char *buff, long cnt,
 	return ret;
 }
 
+// Like doActualReadRohan() in DMA mode, but for one multiple block command whose sectors go to several buffers. The
+// host holds the card's clock whenever its buffer's full and nothing's reading it, so the DMAC can just be pointed at
+// each buffer in turn while the card waits.
+static int doActualScatteredRead(int sd_port, SDHNDL *hndl, SD_READ_SEGMENT const *segments, int num_segments,
+		int dma_64) {
+
+	int ret = SD_OK;
+
+	/* ---- disable RespEnd and ILA ---- */
+	_sd_clear_int_mask(hndl,SD_INFO1_MASK_RESP,SD_INFO2_MASK_ILA);
+
+	/* disable card ins&rem interrupt for FIFO */
+	unsigned short info1_back = (unsigned short)(hndl->int_info1_mask & SD_INFO1_MASK_DET_CD);
+	_sd_clear_int_mask(hndl,SD_INFO1_MASK_DET_CD,0);
+
+	/* enable All end and errors */
+	_sd_set_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,SD_INFO2_MASK_ERR);
+
+	unsigned long reg_base_here = hndl->reg_base;
+	if(TARGET_RZ_A1 != 1 || dma_64 != SD_MODE_DMA_64) /* SD_CMD Address for 64byte transfer */
+		reg_base_here += SD_BUF0;
+
+	for(int s = 0; s < num_segments && ret == SD_OK; s++){
+		unsigned char *buff = segments[s].buff;
+		long cnt = segments[s].cnt;
+
+		// See doActualReadRohan() for why this is needed before as well as after the transfer
+		v7_dma_inv_range((intptr_t)buff, (intptr_t)(buff + cnt * 512));
+
+		if(sddev_init_dma(sd_port, (unsigned long)buff, reg_base_here, cnt*512, SD_TRANS_READ) != SD_OK){
+			_sd_set_err(hndl,SD_ERR_CPU_IF);
+			ret = SD_ERR_CPU_IF;
+			break;
+		}
+
+		/* DMA data transfer */
+		ret = _sd_dma_trans(hndl,cnt);
+	}
+
+	sd_outp(hndl,CC_EXT_MODE,(unsigned short)(sd_inp(hndl,CC_EXT_MODE) & ~CC_EXT_MODE_DMASDRW));
+	_sd_set_int_mask(hndl,info1_back,0);
+
+	return ret;
+}
+
+/*****************************************************************************
+ * ID           :
+ * Summary      : recover from an error during a multiple block read
+ * Include      : 
+ * Declaration  : static int _sd_read_err_exit(int sd_port, SDHNDL *hndl, int mode);
+ * Functions    : stop the transfer, put the card back in transfer state and
+ *              : halt the clock
+ *              : 
+ * Argument     : int sd_port : channel no (0 or 1)
+ *              : SDHNDL *hndl : SD handle
+ *              : int mode : SD_MODE_DMA if the DMAC was being used
+ * Return       : hndl->error : the error which caused the exit
+ * Remark       : 
+ *****************************************************************************/
+static int _sd_read_err_exit(int sd_port, SDHNDL *hndl, int mode)
+{
+	if(mode == SD_MODE_DMA){
+		sddev_disable_dma(sd_port);	/* disable DMA */
+	}
+	sd_outp(hndl,CC_EXT_MODE,(unsigned short)(sd_inp(hndl,CC_EXT_MODE) 
+			& ~CC_EXT_MODE_DMASDRW));	/* disable DMA */
+
+	mode = hndl->error;
+
+	/* ---- clear error bits ---- */
+	_sd_clear_info(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+	/* ---- disable all interrupts ---- */
+	_sd_clear_int_mask(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+
+	if((sd_inp(hndl,SD_INFO2) & SD_INFO2_MASK_CBSY) == SD_INFO2_MASK_CBSY){
+		unsigned short sd_option,sd_clk_ctrl;
+
+		/* ---- enable All end ---- */
+		_sd_set_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,0);
+		/* ---- data transfer stop (issue CMD12) ---- */
+		sd_outp(hndl,SD_STOP,0x0001);
+		/* ---- wait All end ---- */
+		logAudioAction("0b");
+
+		sddev_int_wait(sd_port, SD_TIMEOUT_RESP);
+		_sd_clear_info(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+		_sd_clear_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,0);
+
+		sddev_loc_cpu(sd_port);
+		sd_option = sd_inp(hndl,SD_OPTION);
+		sd_clk_ctrl = sd_inp(hndl,SD_CLK_CTRL);
+		#if		(TARGET_RZ_A1 == 1)
+		sd_outp(hndl,SOFT_RST,0x0006);
+		sd_outp(hndl,SOFT_RST,0x0007);
+		#else
+		sd_outp(hndl,SOFT_RST,0);
+		sd_outp(hndl,SOFT_RST,1);
+		#endif
+		sd_outp(hndl,SD_STOP,0x0000);
+		sd_outp(hndl,SD_OPTION,sd_option);
+		sd_outp(hndl,SD_CLK_CTRL,sd_clk_ctrl);
+		sddev_unl_cpu(sd_port);
+
+	}
+
+	sd_outp(hndl,SD_STOP,0x0001);
+	sd_outp(hndl,SD_STOP,0x0000);
+
+	/* Check Current State */
+	if(_sd_card_send_cmd_arg(hndl,CMD13,SD_RESP_R1,hndl->rca[0],0x0000) == SD_OK){
+		/* not transfer state? */
+		if((hndl->resp_status & RES_STATE) != STATE_TRAN){	
+			/* if not tran state, issue CMD12 to transit the SD card to tran state */
+			_sd_card_send_cmd_arg(hndl,CMD12,SD_RESP_R1b,hndl->rca[0],0x0000);
+			/* not check error because already checked */
+		}
+	}
+
+	hndl->error = mode;
+	
+	_sd_clear_int_mask(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+
+	#if		(TARGET_RZ_A1 == 1)
+	sd_outp(hndl,EXT_SWAP,0x0000);		/* Clear DMASEL for 64byte transfer */
+	#endif
+
+	/* ---- halt clock ---- */
+	_sd_set_clock(hndl,0,SD_CLOCK_DISABLE);
+
+	return hndl->error;
+}
+
 /*****************************************************************************
  * ID           :
  * Summary      : read sector data from card
@@ -388,66 +520,198 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 
 ErrExit_DMA:
 ErrExit:
-	if(mode == SD_MODE_DMA){
-		sddev_disable_dma(sd_port);	/* disable DMA */
+	return _sd_read_err_exit(sd_port, hndl, mode);
+}
+
+/*****************************************************************************
+ * ID           :
+ * Summary      : read consecutive sectors from card into several buffers
+ * Include      : 
+ * Declaration  : int sd_read_sect_scattered(int sd_port, SD_READ_SEGMENT const *segments,
+ *              : int num_segments, unsigned long psn);
+ * Functions    : read the sectors starting at physical sector number (=psn),
+ *              : segments[0].cnt of them into segments[0].buff, the next
+ *              : segments[1].cnt into segments[1].buff and so on, with a
+ *              : single multiple block command
+ *              : if that can't be done by DMAC in one command, falls back to
+ *              : one sd_read_sect() per segment
+ *              : 
+ * Argument     : int sd_port : channel no (0 or 1)
+ *              : SD_READ_SEGMENT const *segments : where to put the sectors
+ *              : int num_segments : number of segments
+ *              : unsigned long psn : first physical sector number
+ * Return       : SD_OK : end of succeed
+ *              : SD_ERR: end of error
+ * Remark       : 
+ *****************************************************************************/
+int sd_read_sect_scattered(int sd_port, SD_READ_SEGMENT const *segments, int num_segments, unsigned long psn)
+{
+	SDHNDL *hndl;
+	long cnt = 0;
+	int s,ret;
+	int mode = SD_MODE_DMA;
+	int dma_64 = SD_MODE_DMA;
+	int scatter = 1;
+
+	logAudioAction("sd_read_sect_scattered");
+
+	if( (sd_port != 0) && (sd_port != 1) ){
+		return SD_ERR;
 	}
-	sd_outp(hndl,CC_EXT_MODE,(unsigned short)(sd_inp(hndl,CC_EXT_MODE) 
-			& ~CC_EXT_MODE_DMASDRW));	/* disable DMA */
 
-	mode = hndl->error;
+	hndl = _sd_get_hndls(sd_port);
+	if(hndl == 0){
+		return SD_ERR;	/* not initilized */
+	}
 
-	/* ---- clear error bits ---- */
-	_sd_clear_info(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
-	/* ---- disable all interrupts ---- */
-	_sd_clear_int_mask(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+	for(s = 0; s < num_segments; s++){
+		cnt += segments[s].cnt;
+		if(((unsigned long)segments[s].buff & 0x03u) != 0){
+			scatter = 0;	/* DMA needs quadlet aligned buffers */
+		}
+	}
 
-	if((sd_inp(hndl,SD_INFO2) & SD_INFO2_MASK_CBSY) == SD_INFO2_MASK_CBSY){
-		unsigned short sd_option,sd_clk_ctrl;
+	/* the card's last sector needs a manual CMD12 on MMC, and a few sectors go by single block transfer anyway */
+	if(!(hndl->trans_mode & SD_MODE_DMA) || cnt <= 2 || cnt > TRANS_SECTORS || hndl->media_type == SD_MEDIA_MMC){
+		scatter = 0;
+	}
 
-		/* ---- enable All end ---- */
-		_sd_set_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,0);
-		/* ---- data transfer stop (issue CMD12) ---- */
-		sd_outp(hndl,SD_STOP,0x0001);
-		/* ---- wait All end ---- */
-		logAudioAction("0b");
+	if(!scatter){
+		for(s = 0; s < num_segments; s++){
+			ret = sd_read_sect(sd_port, segments[s].buff, psn, segments[s].cnt);
+			if(ret != SD_OK){
+				return ret;
+			}
+			psn += segments[s].cnt;
+		}
+		return SD_OK;
+	}
 
-		sddev_int_wait(sd_port, SD_TIMEOUT_RESP);
-		_sd_clear_info(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
-		_sd_clear_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,0);
+	routineForSD(); // Once per read, as in sd_read_sect()
 
-		sddev_loc_cpu(sd_port);
-		sd_option = sd_inp(hndl,SD_OPTION);
-		sd_clk_ctrl = sd_inp(hndl,SD_CLK_CTRL);
-		#if		(TARGET_RZ_A1 == 1)
-		sd_outp(hndl,SOFT_RST,0x0006);
-		sd_outp(hndl,SOFT_RST,0x0007);
-		#else
-		sd_outp(hndl,SOFT_RST,0);
-		sd_outp(hndl,SOFT_RST,1);
-		#endif
-		sd_outp(hndl,SD_STOP,0x0000);
-		sd_outp(hndl,SD_OPTION,sd_option);
-		sd_outp(hndl,SD_CLK_CTRL,sd_clk_ctrl);
-		sddev_unl_cpu(sd_port);
+	hndl->error = SD_OK;
 
+	/* ---- check card is mounted ---- */
+	if(hndl->mount != SD_MOUNT_UNLOCKED_CARD){
+		_sd_set_err(hndl,SD_ERR);
+		return hndl->error;	/* not mounted yet */
 	}
 
-	sd_outp(hndl,SD_STOP,0x0001);
-	sd_outp(hndl,SD_STOP,0x0000);
+	/* ---- is stop compulsory? ---- */
+	if(hndl->stop){
+		hndl->stop = 0;
+		_sd_set_err(hndl,SD_ERR_STOP);
+		return SD_ERR_STOP;
+	}
 
-	/* Check Current State */
-	if(_sd_card_send_cmd_arg(hndl,CMD13,SD_RESP_R1,hndl->rca[0],0x0000) == SD_OK){
-		/* not transfer state? */
-		if((hndl->resp_status & RES_STATE) != STATE_TRAN){	
-			/* if not tran state, issue CMD12 to transit the SD card to tran state */
-			_sd_card_send_cmd_arg(hndl,CMD12,SD_RESP_R1b,hndl->rca[0],0x0000);
-			/* not check error because already checked */
+	/* ---- is card existed? ---- */
+	if(_sd_check_media(hndl) != SD_OK){
+		_sd_set_err(hndl,SD_ERR_NO_CARD);	/* no card */
+		return SD_ERR_NO_CARD;
+	}
+
+	/* access area check */
+	if(psn >= hndl->card_sector_size || psn + cnt > hndl->card_sector_size){
+		_sd_set_err(hndl,SD_ERR);
+		return hndl->error;	/* out of area */
+	}
+
+	#if		(TARGET_RZ_A1 == 1)
+	if(hndl->trans_mode & SD_MODE_DMA_64){
+		dma_64 = SD_MODE_DMA_64;
+	}
+	#endif
+
+	/* transfer size is fixed (512 bytes) */
+	sd_outp(hndl,SD_SIZE,512);
+
+	/* ---- supply clock (data-transfer ratio) ---- */
+	if(_sd_set_clock(hndl,(int)hndl->csd_tran_speed,SD_CLOCK_ENABLE) != SD_OK){
+		return hndl->error;
+	}
+
+	/* ==== check status precede read operation ==== */
+	if(_sd_card_send_cmd_arg(hndl,CMD13,SD_RESP_R1,hndl->rca[0],0x0000) 
+		== SD_OK){
+		if((hndl->resp_status & RES_STATE) != STATE_TRAN){	/* not transfer state */
+			 hndl->error = SD_ERR;
+			goto ErrExit;
 		}
 	}
+	else{	/* SDHI error */
+		goto ErrExit;
+	}
 
-	hndl->error = mode;
-	
-	_sd_clear_int_mask(hndl,SD_INFO1_MASK_TRNS_RESP,0x837f);
+	/* enable SD_SECCNT */
+	sd_outp(hndl,SD_STOP,0x0100);
+	sd_outp(hndl,SD_SECCNT,(unsigned short)cnt);
+
+	/* ---- enable RespEnd and ILA ---- */
+	_sd_set_int_mask(hndl,SD_INFO1_MASK_RESP,0);
+	#if		(TARGET_RZ_A1 == 1)
+	if( dma_64 == SD_MODE_DMA_64 ){
+		sd_outp(hndl,EXT_SWAP,0x0100);		/* Set DMASEL for 64byte transfer */
+	}
+	#endif
+	sd_outp(hndl,CC_EXT_MODE,(unsigned short)(sd_inp(hndl,CC_EXT_MODE) | CC_EXT_MODE_DMASDRW));	/* enable DMA */
+
+	/* issue CMD18 (READ_MULTIPLE_BLOCK) */
+	if(_sd_send_mcmd(hndl,CMD18,SET_ACC_ADDR) != SD_OK){
+		goto ErrExit;
+	}
+
+	if(doActualScatteredRead(sd_port, hndl, segments, num_segments, dma_64) != SD_OK){
+		goto ErrExit;
+	}
+
+	/* ---- wait All end interrupt ---- */
+	if(sddev_int_wait(sd_port, SD_TIMEOUT_RESP) != SD_OK){
+		_sd_set_err(hndl,SD_ERR_HOST_TOE);
+		goto ErrExit;
+	}
+
+	/* ---- check errors ---- */
+	if(hndl->int_info2&SD_INFO2_MASK_ERR){
+		_sd_check_info2_err(hndl);
+		goto ErrExit;
+	}
+
+	// Invalidate ram
+	for(s = 0; s < num_segments; s++){
+		v7_dma_inv_range((uintptr_t)segments[s].buff, (uintptr_t)(segments[s].buff + segments[s].cnt * 512));
+	}
+
+	/* clear All end bit */
+	_sd_clear_info(hndl,SD_INFO1_MASK_DATA_TRNS,0x0000);
+
+	/* disable All end, BRE and errors */
+	_sd_clear_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,SD_INFO2_MASK_BRE);
+
+	/* ==== check status after read operation ==== */
+	if(_sd_card_send_cmd_arg(hndl,CMD13,SD_RESP_R1,hndl->rca[0],0x0000) 
+		!= SD_OK){
+		/* check OUT_OF_RANGE error */
+		/* ignore errors during last block access */
+		if(hndl->resp_status & 0xffffe008ul){
+			if(psn + cnt != hndl->card_sector_size){
+				goto ErrExit;	/* but for last block */
+			}
+			if(hndl->resp_status & 0x7fffe008ul){
+				goto ErrExit;	/* not OUT_OF_RANGE error */
+			}
+			/* clear OUT_OF_RANGE error */
+			hndl->resp_status &= 0x1f00u;
+			hndl->error = SD_OK;
+		}
+		else{	/* SDHI error, ex)timeout error so on */
+			goto ErrExit;
+		}
+	}
+
+	if((hndl->resp_status & RES_STATE) != STATE_TRAN){
+		hndl->error = SD_ERR;
+		goto ErrExit;
+	}
 
 	#if		(TARGET_RZ_A1 == 1)
 	sd_outp(hndl,EXT_SWAP,0x0000);		/* Clear DMASEL for 64byte transfer */
@@ -457,6 +721,9 @@ ErrExit:
 	_sd_set_clock(hndl,0,SD_CLOCK_DISABLE);
 
 	return hndl->error;
+
+ErrExit:
+	return _sd_read_err_exit(sd_port, hndl, mode);
 }
 
 /*****************************************************************************
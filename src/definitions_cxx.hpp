@@ -705,8 +705,9 @@ constexpr int32_t kNumMarkerTypes = util::to_underlying(MarkerType::END) + 1;
 enum class InterpolationMode {
 	LINEAR,
 	SMOOTH,
+	PRECISE, // Same windowed sinc as SMOOTH, but keeping all 24 bits. See dsp/interpolation/precise.h
 };
-constexpr int32_t kNumInterpolationModes = 2;
+constexpr int32_t kNumInterpolationModes = 3;
 
 constexpr int32_t kCacheByteDepth = 3;
 constexpr int32_t kCacheByteDepthMagnitude = 2; // Invalid / unused for odd numbers of bytes like 3
@@ -45,9 +45,11 @@
 #include "hid/led/pad_leds.h"
 #include "hid/matrix/matrix_driver.h"
 #include "io/debug/log.h"
+#include "io/debug/print.h"
 #include "io/midi/midi_device_manager.h"
 #include "io/midi/midi_engine.h"
 #include "io/midi/midi_follow.h"
+#include "io/midi/midi_routing_index.h"
 #include "lib/printf.h" // IWYU pragma: keep this over rides printf with a non allocating version
 #include "memory/general_memory_allocator.h"
 #include "model/clip/instrument_clip.h"
@@ -61,6 +63,9 @@
 #include "processing/engines/audio_engine.h"
 #include "processing/engines/cv_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/cluster_prefetcher.h"
+#include "storage/audio/sample_cache_store.h"
+#include "storage/audio/sample_peaks_builder.h"
 #include "storage/flash_storage.h"
 #include "storage/storage_manager.h"
 #include "task_scheduler.h"
@@ -450,6 +455,7 @@ void setupBlankSong() {
 	preLoadedSong->ensureAtLeastOneSessionClip();
 
 	currentSong = preLoadedSong;
+	midiRoutingIndex.invalidate();
 	preLoadedSong = NULL;
 
 	AudioEngine::getReverbParamsFromSong(currentSong);
@@ -557,10 +563,14 @@ void registerTasks() {
 	// - max time between calls
 	//
 	// Scheduling algorithm is in chooseBestTask(), briefly:
-	// - keep track of average time a task takes
+	// - keep track of how long a task usually takes
 	// - run the least important task that can finish before
 	//   a more important task needs to start
 	//
+	// or with ENABLE_EDF_SCHEDULER, chooseEarliestDeadline():
+	// - run the task whose max time between calls runs out soonest
+	// - but only if it'll finish before a task with a budget has to start
+	//
 	// Explicit gaps at 10, 20, 30, 40 for dynamic tasks.
 	//
 	// p++ for priorities, so we can be sure the lexical order
@@ -568,7 +578,10 @@ void registerTasks() {
 
 	// 0-9: High priority (10 for dyn tasks)
 	uint8_t p = 0;
-	addRepeatingTask(&(AudioEngine::routine), p++, 0.00001, 16 / 44100., 24 / 44100., "audio  routine");
+	TaskID audioTask =
+	    addRepeatingTask(&(AudioEngine::routine), p++, 0.00001, 16 / 44100., 24 / 44100., "audio  routine");
+	// when built for EDF scheduling, nothing else starts unless it'll be done in time for the next render
+	setTaskBudget(audioTask, 12 / 44100.);
 	// this one runs quickly and frequently to check for encoder changes
 	addRepeatingTask([]() { encoders::readEncoders(); }, p++, 0.0005, 0.001, 0.001, "read encoders");
 	// formerly part of audio routine, updates midi and clock
@@ -594,6 +607,12 @@ void registerTasks() {
 	// if recordings are finished
 	addRepeatingTask([]() { audioFileManager.slowRoutine(); }, p++, 0.1, 0.1, 0.2, "audio file slow");
 	addRepeatingTask([]() { audioRecorder.slowRoutine(); }, p++, 0.01, 0.1, 0.1, "audio recorder slow");
+	// looks ahead of playback for samples about to be triggered, and gets their clusters loading
+	addRepeatingTask([]() { clusterPrefetcher.routine(); }, p++, 0.01, 0.02, 0.05, "cluster prefetch");
+	// reads through samples being drawn zoomed out to make their waveform overviews, when the card's otherwise idle
+	addRepeatingTask([]() { samplePeaksBuilder.routine(); }, p++, 0.01, 0.05, 0.2, "sample peaks");
+	// copies finished sample caches to the card, and reads back any that got stolen when they're wanted again
+	addRepeatingTask([]() { sampleCacheStore.routine(); }, p++, 0.005, 0.01, 0.05, "sample cache store");
 
 	// 31-39: Idle priority (40 for dyn tasks)
 	p = 31;
@@ -646,6 +665,9 @@ void mainLoop() {
 		AudioEngine::slowRoutine();
 
 		audioRecorder.slowRoutine();
+		clusterPrefetcher.routine();
+		samplePeaksBuilder.routine();
+		sampleCacheStore.routine();
 
 #if AUTOPILOT_TEST_ENABLED
 		autoPilotStuff();
@@ -745,7 +767,6 @@ extern "C" int32_t deluge_main(void) {
 #if TEST_GENERAL_MEMORY_ALLOCATION
 	GeneralMemoryAllocator::get().test();
 #endif
-
 	init_crc_table();
 
 	// Setup for gate output
@@ -758,6 +779,7 @@ extern "C" int32_t deluge_main(void) {
 	PIC::setupForPads();
 	setOutputState(CODEC.port, CODEC.pin, 1); // Enable codec
 
+	Debug::init(); // Starts the cycle counter, which the CPU meter reads
 	AudioEngine::init();
 
 #if HARDWARE_TEST_MODE
@@ -1044,6 +1066,8 @@ void deleteOldSongBeforeLoadingNew() {
 
 	AudioEngine::unassignAllVoices(true); // Need to do this now that we're not bothering getting the old Song's
 	                                      // Instruments detached and everything on delete
+	clusterPrefetcher.releaseAll();
+	samplePeaksBuilder.cancelAll();
 
 	view.activeModControllableModelStack.modControllable = NULL;
 	view.activeModControllableModelStack.setTimelineCounter(NULL);
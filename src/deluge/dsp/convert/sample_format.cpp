@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/convert/sample_format.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Everything's loaded and stored as bytes, since audio data needn't start on a word boundary in the file
+
+namespace deluge::dsp::convert {
+
+void floatToQ31(uint32_t* data, size_t numWords) {
+	size_t i = 0;
+
+#if defined(__ARM_NEON)
+	int32x4_t const maxValue = vdupq_n_s32(2147483647);
+	uint32x4_t const implicitBit = vdupq_n_u32(0x80000000);
+	int32x4_t const bias = vdupq_n_s32(127);
+
+	for (; i + 4 <= numWords; i += 4) {
+		uint32x4_t readValue = vreinterpretq_u32_u8(vld1q_u8((uint8_t*)&data[i]));
+
+		int32x4_t exponent =
+		    vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(readValue, 23), vdupq_n_u32(255))), bias);
+
+		// A negative shift is a right shift, and anything 32 or more shifts everything out - just like the scalar
+		// version on the ARM
+		uint32x4_t mantissa = vorrq_u32(vshlq_n_u32(readValue, 8), implicitBit);
+		int32x4_t outputValue = vreinterpretq_s32_u32(vshlq_u32(mantissa, exponent));
+		outputValue = vbslq_s32(vcgeq_s32(exponent, vdupq_n_s32(0)), maxValue, outputValue);
+
+		// Negate where the sign bit's set: (x ^ -1) - -1 == -x
+		int32x4_t sign = vshrq_n_s32(vreinterpretq_s32_u32(readValue), 31);
+		outputValue = vsubq_s32(veorq_s32(outputValue, sign), sign);
+
+		vst1q_u8((uint8_t*)&data[i], vreinterpretq_u8_s32(outputValue));
+	}
+#endif
+
+	for (; i < numWords; i++) {
+		data[i] = floatBitPatternToQ31(data[i]);
+	}
+}
+
+void swapBytes32(uint32_t* data, size_t numWords) {
+	size_t i = 0;
+
+#if defined(__ARM_NEON)
+	for (; i + 4 <= numWords; i += 4) {
+		uint8x16_t bytes = vld1q_u8((uint8_t*)&data[i]);
+		vst1q_u8((uint8_t*)&data[i], vrev32q_u8(bytes));
+	}
+#endif
+
+	for (; i < numWords; i++) {
+		data[i] = __builtin_bswap32(data[i]);
+	}
+}
+
+void swapBytes16(uint32_t* data, size_t numWords) {
+	size_t i = 0;
+
+#if defined(__ARM_NEON)
+	for (; i + 4 <= numWords; i += 4) {
+		uint8x16_t bytes = vld1q_u8((uint8_t*)&data[i]);
+		vst1q_u8((uint8_t*)&data[i], vrev16q_u8(bytes));
+	}
+#endif
+
+	for (; i < numWords; i++) {
+		uint32_t value = data[i];
+		data[i] = ((value & 0x00FF00FF) << 8) | ((value >> 8) & 0x00FF00FF);
+	}
+}
+
+void flipSign8(uint32_t* data, size_t numWords) {
+	size_t i = 0;
+
+#if defined(__ARM_NEON)
+	uint8x16_t const signBits = vdupq_n_u8(0x80);
+	for (; i + 4 <= numWords; i += 4) {
+		vst1q_u8((uint8_t*)&data[i], veorq_u8(vld1q_u8((uint8_t*)&data[i]), signBits));
+	}
+#endif
+
+	for (; i < numWords; i++) {
+		data[i] ^= 0x80808080;
+	}
+}
+
+void swapBytes24(uint8_t* data, size_t numSamples) {
+	size_t i = 0;
+
+#if defined(__ARM_NEON)
+	// De-interleaving 16 samples at a time means the swap is just a matter of which register goes where
+	for (; i + 16 <= numSamples; i += 16) {
+		uint8x16x3_t samples = vld3q_u8(&data[i * 3]);
+		uint8x16_t temp = samples.val[0];
+		samples.val[0] = samples.val[2];
+		samples.val[2] = temp;
+		vst3q_u8(&data[i * 3], samples);
+	}
+#endif
+
+	for (; i < numSamples; i++) {
+		uint8_t* pos = &data[i * 3];
+		uint8_t temp = pos[0];
+		pos[0] = pos[2];
+		pos[2] = temp;
+	}
+}
+
+} // namespace deluge::dsp::convert
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Whole-buffer conversion of sample data from the formats it can arrive from the card in, to the native little-endian
+// signed format the rest of the Deluge reads. Each has a NEON version for the Deluge and a plain one for anywhere else,
+// which give identical results. Conversion is in place.
+
+namespace deluge::dsp::convert {
+
+/// Float samples to Q31, exactly as convertFloatToIntAtMemoryLocation() does: truncated towards zero, with anything
+/// of magnitude 1 or more (including infinities and NaNs) becoming +/-2147483647
+void floatToQ31(uint32_t* data, size_t numWords);
+
+/// Big-endian 32-bit samples
+void swapBytes32(uint32_t* data, size_t numWords);
+
+/// Pairs of big-endian 16-bit samples
+void swapBytes16(uint32_t* data, size_t numWords);
+
+/// Unsigned 8-bit samples, four to a word
+void flipSign8(uint32_t* data, size_t numWords);
+
+/// Big-endian 24-bit samples, packed three bytes each
+void swapBytes24(uint8_t* data, size_t numSamples);
+
+/// The scalar conversion, for the odd value that has to be done on its own
+constexpr int32_t floatBitPatternToQ31(uint32_t readValue) {
+	int32_t exponent = (int32_t)((readValue >> 23) & 255) - 127;
+
+	int32_t outputValue;
+	if (exponent >= 0) {
+		outputValue = 2147483647;
+	}
+	// The ARM shifts everything out for shifts of 32 or more, which is what we want, but C++ doesn't promise that
+	else if (exponent <= -32) {
+		outputValue = 0;
+	}
+	else {
+		outputValue = ((readValue << 8) | 0x80000000) >> (-exponent);
+	}
+
+	// Sign bit
+	if (readValue >> 31) {
+		outputValue = -outputValue;
+	}
+	return outputValue;
+}
+
+} // namespace deluge::dsp::convert
@@ -0,0 +1,272 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/convolution/partitioned_convolver.h"
+#include "deluge/deluge.h"
+#include "dsp/fft/fft_config_manager.h"
+#include "memory/memory_allocator_interface.h"
+#include "util/fixedpoint.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Everything's fixed point. The forward FFTs are scaled (by 1/N), which keeps them from overflowing, and products are
+// accumulated at 64 bits. The inverse FFT isn't scaled, as the output would need N times less level to fit through a
+// scaled one - instead, its input is brought down to what comes out as the output's level, less kInverseHeadroomBits
+// which the butterflies can need along the way.
+
+namespace deluge::dsp {
+
+namespace {
+
+#if defined(__ARM_NEON)
+constexpr auto fftForward = ne10_fft_r2c_1d_int32_neon;
+constexpr auto fftInverse = ne10_fft_c2r_1d_int32_neon;
+#else
+constexpr auto fftForward = ne10_fft_r2c_1d_int32_c;
+constexpr auto fftInverse = ne10_fft_c2r_1d_int32_c;
+#endif
+
+/// accumulator += x * h, for numBins complex bins
+void multiplyAccumulate(int64_t* __restrict__ accumulator, ne10_fft_cpx_int32_t const* __restrict__ x,
+                        ne10_fft_cpx_int32_t const* __restrict__ h, int32_t numBins) {
+	int64_t* __restrict__ accR = accumulator;
+	int64_t* __restrict__ accI = accumulator + numBins;
+	int32_t b = 0;
+
+#if defined(__ARM_NEON)
+	for (; b + 2 <= numBins; b += 2) {
+		int32x2x2_t xs = vld2_s32((int32_t const*)&x[b]);
+		int32x2x2_t hs = vld2_s32((int32_t const*)&h[b]);
+
+		int64x2_t r = vld1q_s64(&accR[b]);
+		r = vmlal_s32(r, xs.val[0], hs.val[0]);
+		r = vmlsl_s32(r, xs.val[1], hs.val[1]);
+		vst1q_s64(&accR[b], r);
+
+		int64x2_t i = vld1q_s64(&accI[b]);
+		i = vmlal_s32(i, xs.val[0], hs.val[1]);
+		i = vmlal_s32(i, xs.val[1], hs.val[0]);
+		vst1q_s64(&accI[b], i);
+	}
+#endif
+
+	for (; b < numBins; b++) {
+		accR[b] += (int64_t)x[b].r * h[b].r - (int64_t)x[b].i * h[b].i;
+		accI[b] += (int64_t)x[b].r * h[b].i + (int64_t)x[b].i * h[b].r;
+	}
+}
+
+int32_t saturateToInt32(int64_t value) {
+	return std::clamp<int64_t>(value, INT32_MIN, INT32_MAX);
+}
+
+constexpr int32_t kInverseHeadroomBits = 2;
+
+} // namespace
+
+Error PartitionedConvolver::setImpulseResponse(q31_t const* irL, q31_t const* irR, int32_t length,
+                                               int32_t partitionMagnitude) {
+	length = std::min(length, kMaxImpulseResponseLength);
+	if (length <= 0) {
+		unload();
+		return Error::NONE;
+	}
+
+	int32_t fftMagnitude = partitionMagnitude + 1;
+	if (partitionMagnitude < 1) {
+		return Error::BUG;
+	}
+
+	ne10_fft_r2c_cfg_int32_t fftConfig = FFTConfigManager::getConfig(fftMagnitude);
+	if (!fftConfig) {
+		return Error::INSUFFICIENT_RAM;
+	}
+
+	int32_t partitionSize = 1 << partitionMagnitude;
+	int32_t fftSize = partitionSize * 2;
+	int32_t numBins = partitionSize + 1;
+	int32_t numPartitions = (length + partitionSize - 1) >> partitionMagnitude;
+	int32_t numIRChannels = irR ? 2 : 1;
+
+	int32_t irSpectraSize = numIRChannels * numPartitions * numBins * sizeof(ne10_fft_cpx_int32_t);
+	int32_t inputSpectraSize = 2 * numPartitions * numBins * sizeof(ne10_fft_cpx_int32_t);
+	int32_t inputBlocksSize = 2 * fftSize * sizeof(int32_t);
+	int32_t outputBlocksSize = 2 * partitionSize * sizeof(int32_t);
+	int32_t accumulatorSize = numBins * 2 * sizeof(int64_t);
+	int32_t spectrumSize = numBins * sizeof(ne10_fft_cpx_int32_t);
+	int32_t timeDomainSize = fftSize * sizeof(int32_t);
+
+	uint8_t* memory = (uint8_t*)allocLowSpeed(sizeof(State) + accumulatorSize + irSpectraSize + inputSpectraSize
+	                                          + inputBlocksSize + outputBlocksSize + spectrumSize + timeDomainSize);
+	if (!memory) {
+		return Error::INSUFFICIENT_RAM;
+	}
+
+	// The 64-bit accumulator goes first, to keep it 8-byte aligned
+	State* state = new (memory) State;
+	uint8_t* pos = memory + sizeof(State);
+	state->accumulator = (int64_t*)pos;
+	pos += accumulatorSize;
+	state->irSpectra = (ne10_fft_cpx_int32_t*)pos;
+	pos += irSpectraSize;
+	state->inputSpectra = (ne10_fft_cpx_int32_t*)pos;
+	pos += inputSpectraSize;
+	state->inputBlocks = (int32_t*)pos;
+	pos += inputBlocksSize;
+	state->outputBlocks = (int32_t*)pos;
+	pos += outputBlocksSize;
+	state->spectrum = (ne10_fft_cpx_int32_t*)pos;
+	pos += spectrumSize;
+	state->timeDomain = (int32_t*)pos;
+
+	state->fftConfig = fftConfig;
+	state->partitionSize = partitionSize;
+	state->fftMagnitude = fftMagnitude;
+	state->numBins = numBins;
+	state->numPartitions = numPartitions;
+	state->numIRChannels = numIRChannels;
+
+	// Transform each partition of the IR, zero-padded to the FFT size
+	for (int32_t c = 0; c < numIRChannels; c++) {
+		q31_t const* ir = c ? irR : irL;
+		for (int32_t p = 0; p < numPartitions; p++) {
+			int32_t start = p << partitionMagnitude;
+			int32_t numTaps = std::min(partitionSize, length - start);
+			memcpy(state->timeDomain, &ir[start], numTaps * sizeof(int32_t));
+			memset(&state->timeDomain[numTaps], 0, (fftSize - numTaps) * sizeof(int32_t));
+
+			fftForward(&state->irSpectra[(c * numPartitions + p) * numBins], state->timeDomain, fftConfig, 1);
+
+			if (!(p & 15)) {
+				routineWithClusterLoading(); // -----------------------------------
+			}
+		}
+	}
+
+	memset(state->inputSpectra, 0, inputSpectraSize);
+	memset(state->inputBlocks, 0, inputBlocksSize);
+	memset(state->outputBlocks, 0, outputBlocksSize);
+	state->newestInput = 0;
+	state->posInBlock = 0;
+
+	// Only now that it's all ready does the audio routine get to see it
+	unload();
+	state_ = state;
+	return Error::NONE;
+}
+
+void PartitionedConvolver::unload() {
+	if (state_) {
+		State* state = state_;
+		state_ = nullptr;
+		state->~State();
+		delugeDealloc(state);
+	}
+}
+
+void PartitionedConvolver::reset() {
+	if (!state_) {
+		return;
+	}
+	memset(state_->inputSpectra, 0, 2 * state_->numPartitions * state_->numBins * sizeof(ne10_fft_cpx_int32_t));
+	memset(state_->inputBlocks, 0, 2 * state_->partitionSize * 2 * sizeof(int32_t));
+	memset(state_->outputBlocks, 0, 2 * state_->partitionSize * sizeof(int32_t));
+	state_->posInBlock = 0;
+}
+
+void PartitionedConvolver::process(std::span<StereoSample> buffer) {
+	if (!state_) {
+		for (StereoSample& sample : buffer) {
+			sample = StereoSample{};
+		}
+		return;
+	}
+
+	State& state = *state_;
+	int32_t* inputL = &state.inputBlocks[state.partitionSize];
+	int32_t* inputR = &state.inputBlocks[state.partitionSize * 3];
+	int32_t* outputL = state.outputBlocks;
+	int32_t* outputR = &state.outputBlocks[state.partitionSize];
+
+	for (StereoSample& sample : buffer) {
+		inputL[state.posInBlock] = sample.l;
+		inputR[state.posInBlock] = sample.r;
+		sample.l = outputL[state.posInBlock];
+		sample.r = outputR[state.posInBlock];
+
+		if (++state.posInBlock == state.partitionSize) {
+			processBlock();
+			state.posInBlock = 0;
+		}
+	}
+}
+
+void PartitionedConvolver::processBlock() {
+	State& state = *state_;
+	if (++state.newestInput == state.numPartitions) {
+		state.newestInput = 0;
+	}
+	processChannel(0);
+	processChannel(1);
+}
+
+void PartitionedConvolver::processChannel(int32_t channel) {
+	State& state = *state_;
+	int32_t numBins = state.numBins;
+	int32_t numPartitions = state.numPartitions;
+	int32_t* inputBlock = &state.inputBlocks[channel * state.partitionSize * 2];
+	ne10_fft_cpx_int32_t* inputSpectra = &state.inputSpectra[channel * numPartitions * numBins];
+	ne10_fft_cpx_int32_t const* irSpectra =
+	    &state.irSpectra[(state.numIRChannels == 2 ? channel : 0) * numPartitions * numBins];
+
+	// The last block and this one, so the first half of what comes back is the circular wrap-around, which we discard.
+	// NE10 uses its input as scratch space, so it gets a copy.
+	memcpy(state.timeDomain, inputBlock, state.partitionSize * 2 * sizeof(int32_t));
+	memcpy(inputBlock, &inputBlock[state.partitionSize], state.partitionSize * sizeof(int32_t));
+	fftForward(&inputSpectra[state.newestInput * numBins], state.timeDomain, state.fftConfig, 1);
+
+	memset(state.accumulator, 0, numBins * 2 * sizeof(int64_t));
+	int32_t slot = state.newestInput;
+	for (int32_t p = 0; p < numPartitions; p++) {
+		multiplyAccumulate(state.accumulator, &inputSpectra[slot * numBins], &irSpectra[p * numBins], numBins);
+		if (--slot < 0) {
+			slot = numPartitions - 1;
+		}
+	}
+
+	// With both inputs scaled by 1/N and the products by 2^-32, this leaves the spectrum at 1/N of the output's, as the
+	// unscaled inverse wants it
+	int32_t shift = 31 - state.fftMagnitude + kInverseHeadroomBits;
+	for (int32_t b = 0; b < numBins; b++) {
+		state.spectrum[b].r = saturateToInt32(state.accumulator[b] >> shift);
+		state.spectrum[b].i = saturateToInt32(state.accumulator[numBins + b] >> shift);
+	}
+
+	fftInverse(state.timeDomain, state.spectrum, state.fftConfig, 0);
+
+	int32_t* output = &state.outputBlocks[channel * state.partitionSize];
+	for (int32_t i = 0; i < state.partitionSize; i++) {
+		output[i] = lshiftAndSaturate<kInverseHeadroomBits>(state.timeDomain[state.partitionSize + i]);
+	}
+}
+
+} // namespace deluge::dsp
@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "NE10.h"
+#include "definitions_cxx.hpp"
+#include "dsp/stereo_sample.h"
+#include <cstdint>
+#include <span>
+
+namespace deluge::dsp {
+
+/// Convolves a stereo signal with an impulse response of up to kMaxImpulseResponseLength taps, by uniformly
+/// partitioned overlap-save in the frequency domain.
+///
+/// The IR is cut into partitions of partitionSize taps, each of which is transformed once, when it's loaded. Each time
+/// partitionSize samples of input have built up, they're transformed too and multiplied against every partition's
+/// spectrum, each partition pairing with the input from that many blocks ago. That's one FFT each way per block, plus
+/// about 8 multiply-accumulates per sample per partition - against 2 per sample per tap for a direct-form FIR like
+/// ImpulseResponseProcessor.
+///
+/// Output is delayed by exactly getLatency() samples, whatever the IR length.
+///
+/// The IMPULSE_RESPONSE reverb model runs one of these - see reverb::Convolution.
+class PartitionedConvolver {
+public:
+	static constexpr int32_t kDefaultPartitionMagnitude = 7; // Same as the render window, so no block costs extra
+	static constexpr int32_t kMaxImpulseResponseLength = 1 << 15;
+
+	PartitionedConvolver() = default;
+	~PartitionedConvolver() { unload(); }
+	PartitionedConvolver(PartitionedConvolver const&) = delete;
+	PartitionedConvolver& operator=(PartitionedConvolver const&) = delete;
+
+	/// Copies in the IR as Q31. For a mono IR, pass nullptr for irR and it'll be used on both channels. Anything
+	/// beyond kMaxImpulseResponseLength is cut off. May call the audio routine, and the previous IR keeps playing until
+	/// the new one's ready.
+	Error setImpulseResponse(q31_t const* irL, q31_t const* irR, int32_t length,
+	                         int32_t partitionMagnitude = kDefaultPartitionMagnitude);
+	void unload();
+	[[nodiscard]] bool isLoaded() const { return state_ != nullptr; }
+
+	/// Clears out any signal still ringing, keeping the IR
+	void reset();
+
+	/// Replaces the buffer's contents with the convolved signal
+	void process(std::span<StereoSample> buffer);
+
+	[[nodiscard]] int32_t getLatency() const { return isLoaded() ? state_->partitionSize : 0; }
+
+private:
+	struct alignas(8) State {
+		ne10_fft_r2c_cfg_int32_t fftConfig;
+		int32_t partitionSize;
+		int32_t fftMagnitude;
+		int32_t numBins;
+		int32_t numPartitions;
+		int32_t numIRChannels;
+
+		// In the one allocation, after this struct
+		ne10_fft_cpx_int32_t* irSpectra;    // [numIRChannels][numPartitions][numBins]
+		ne10_fft_cpx_int32_t* inputSpectra; // [2][numPartitions][numBins], a ring - see newestInput
+		int32_t* inputBlocks;               // [2][partitionSize * 2] - the last block, then the one building up
+		int32_t* outputBlocks;              // [2][partitionSize]
+		int64_t* accumulator;               // [numBins * 2], real then imaginary
+		ne10_fft_cpx_int32_t* spectrum;     // [numBins]
+		int32_t* timeDomain;                // [partitionSize * 2]
+
+		int32_t newestInput; // Partition slot in inputSpectra of the latest block's spectrum
+		int32_t posInBlock;
+	};
+
+	void processBlock();
+	void processChannel(int32_t channel);
+
+	State* state_ = nullptr;
+};
+
+} // namespace deluge::dsp
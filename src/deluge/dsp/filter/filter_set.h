@@ -29,6 +29,8 @@ class Sound;
 
 namespace deluge::dsp::filter {
 
+class MultiVoiceFilter;
+
 union LowPass {
 	LpLadderFilter ladder;
 	SVFilter svf;
@@ -59,6 +61,8 @@ public:
 	inline bool isOn() { return HPFOn || LPFOn; }
 
 private:
+	friend class MultiVoiceFilter;
+
 	FilterMode lpfMode_;
 	FilterMode lastLPFMode_;
 	FilterMode hpfMode_;
@@ -23,6 +23,8 @@
 
 namespace deluge::dsp::filter {
 
+class MultiVoiceFilter;
+
 class HpLadderFilter : public Filter<HpLadderFilter> {
 public:
 	HpLadderFilter() = default;
@@ -36,6 +38,8 @@ public:
 	}
 
 private:
+	friend class MultiVoiceFilter;
+
 	struct HPLadderState {
 		BasicFilterComponent hpfHPF1;
 		BasicFilterComponent hpfLPF1;
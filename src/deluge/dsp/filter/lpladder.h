@@ -23,6 +23,8 @@
 
 namespace deluge::dsp::filter {
 
+class MultiVoiceFilter;
+
 class LpLadderFilter : public Filter<LpLadderFilter> {
 public:
 	LpLadderFilter() = default;
@@ -36,6 +38,8 @@ public:
 	}
 
 private:
+	friend class MultiVoiceFilter;
+
 	struct LpLadderState {
 		q31_t noiseLastValue;
 		BasicFilterComponent lpfLPF1;
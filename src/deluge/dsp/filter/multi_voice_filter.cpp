@@ -0,0 +1,500 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/filter/multi_voice_filter.h"
+#include "definitions_cxx.hpp"
+#include "util/functions.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace deluge::dsp::filter {
+
+namespace {
+
+constexpr int32_t kNumLanes = MultiVoiceFilter::kNumLanes;
+
+PLACE_INTERNAL_FRUNK q31_t parallelBuffer[SSI_TX_BUFFER_NUM_SAMPLES * kNumLanes]
+    __attribute__((aligned(CACHE_LINE_SIZE)));
+PLACE_INTERNAL_FRUNK q31_t noiseBuffer[SSI_TX_BUFFER_NUM_SAMPLES * kNumLanes] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// The same operations as the scalar filters use, on one value per voice. The NEON versions give exactly the same
+// results as the instructions the scalar code uses: for smmul, (2ab >> 32) >> 1 is ab >> 32; and for smmulr, rounding
+// that last shift instead gives (ab + 2^31) >> 32. The only difference is -1 * -1, which can't come up here
+#if defined(__ARM_NEON)
+using Lanes = int32x4_t;
+
+[[gnu::always_inline]] inline Lanes load(q31_t const* values) {
+	return vld1q_s32(values);
+}
+[[gnu::always_inline]] inline void store(q31_t* values, Lanes x) {
+	vst1q_s32(values, x);
+}
+[[gnu::always_inline]] inline Lanes dup(q31_t value) {
+	return vdupq_n_s32(value);
+}
+[[gnu::always_inline]] inline Lanes add(Lanes a, Lanes b) {
+	return vaddq_s32(a, b);
+}
+[[gnu::always_inline]] inline Lanes sub(Lanes a, Lanes b) {
+	return vsubq_s32(a, b);
+}
+[[gnu::always_inline]] inline Lanes max(Lanes a, Lanes b) {
+	return vmaxq_s32(a, b);
+}
+template <int32_t n>
+[[gnu::always_inline]] inline Lanes shiftLeft(Lanes x) {
+	return vshlq_n_s32(x, n);
+}
+template <int32_t n>
+[[gnu::always_inline]] inline Lanes shiftRight(Lanes x) {
+	return vshrq_n_s32(x, n);
+}
+/// multiply_32x32_rshift32()
+[[gnu::always_inline]] inline Lanes multiply(Lanes a, Lanes b) {
+	return vshrq_n_s32(vqdmulhq_s32(a, b), 1);
+}
+/// multiply_32x32_rshift32_rounded()
+[[gnu::always_inline]] inline Lanes multiplyRounded(Lanes a, Lanes b) {
+	return vrshrq_n_s32(vqdmulhq_s32(a, b), 1);
+}
+/// lshiftAndSaturate<2>()
+[[gnu::always_inline]] inline Lanes lshiftAndSaturate2(Lanes x) {
+	return vshlq_n_s32(vmaxq_s32(vminq_s32(x, vdupq_n_s32((1 << 29) - 1)), vdupq_n_s32(-(1 << 29))), 2);
+}
+#else
+struct Lanes {
+	std::array<q31_t, kNumLanes> v;
+};
+
+template <typename Op>
+[[gnu::always_inline]] inline Lanes eachLane(Lanes a, Lanes b, Op op) {
+	Lanes out;
+	for (int32_t i = 0; i < kNumLanes; i++) {
+		out.v[i] = op(a.v[i], b.v[i]);
+	}
+	return out;
+}
+
+inline Lanes load(q31_t const* values) {
+	Lanes out;
+	std::copy(values, values + kNumLanes, out.v.begin());
+	return out;
+}
+inline void store(q31_t* values, Lanes x) {
+	std::copy(x.v.begin(), x.v.end(), values);
+}
+inline Lanes dup(q31_t value) {
+	Lanes out;
+	out.v.fill(value);
+	return out;
+}
+inline Lanes add(Lanes a, Lanes b) {
+	return eachLane(a, b, [](q31_t x, q31_t y) { return (q31_t)((uint32_t)x + (uint32_t)y); });
+}
+inline Lanes sub(Lanes a, Lanes b) {
+	return eachLane(a, b, [](q31_t x, q31_t y) { return (q31_t)((uint32_t)x - (uint32_t)y); });
+}
+inline Lanes max(Lanes a, Lanes b) {
+	return eachLane(a, b, [](q31_t x, q31_t y) { return std::max(x, y); });
+}
+template <int32_t n>
+inline Lanes shiftLeft(Lanes x) {
+	return eachLane(x, x, [](q31_t a, q31_t) { return (q31_t)((uint32_t)a << n); });
+}
+template <int32_t n>
+inline Lanes shiftRight(Lanes x) {
+	return eachLane(x, x, [](q31_t a, q31_t) { return a >> n; });
+}
+inline Lanes multiply(Lanes a, Lanes b) {
+	return eachLane(a, b, [](q31_t x, q31_t y) { return multiply_32x32_rshift32(x, y); });
+}
+inline Lanes multiplyRounded(Lanes a, Lanes b) {
+	return eachLane(a, b, [](q31_t x, q31_t y) { return multiply_32x32_rshift32_rounded(x, y); });
+}
+inline Lanes lshiftAndSaturate2(Lanes x) {
+	return eachLane(x, x, [](q31_t a, q31_t) { return lshiftAndSaturate<2>(a); });
+}
+#endif
+
+/// The lane a spare lane borrows its coefficients and state from, so it has something sensible to work on
+[[gnu::always_inline]] inline size_t sourceLane(std::span<FilterSet* const> filterSets, size_t lane) {
+	return std::min(lane, filterSets.size() - 1);
+}
+
+template <typename Get>
+[[gnu::always_inline]] inline Lanes gather(std::span<FilterSet* const> filterSets, Get get) {
+	alignas(16) q31_t values[kNumLanes];
+	for (size_t i = 0; i < kNumLanes; i++) {
+		values[i] = get(*filterSets[sourceLane(filterSets, i)]);
+	}
+	return load(values);
+}
+
+template <typename Set>
+[[gnu::always_inline]] inline void scatter(std::span<FilterSet* const> filterSets, Lanes x, Set set) {
+	alignas(16) q31_t values[kNumLanes];
+	store(values, x);
+	for (size_t i = 0; i < filterSets.size(); i++) {
+		set(*filterSets[i], values[i]);
+	}
+}
+
+template <typename Op>
+[[gnu::always_inline]] inline Lanes forEachLane(Lanes x, Op op) {
+	alignas(16) q31_t values[kNumLanes];
+	store(values, x);
+	for (int32_t i = 0; i < kNumLanes; i++) {
+		values[i] = op(values[i], i);
+	}
+	return load(values);
+}
+
+/// BasicFilterComponent::doFilter()
+[[gnu::always_inline]] inline Lanes doFilter(Lanes& memory, Lanes input, Lanes moveability) {
+	Lanes a = shiftLeft<1>(multiplyRounded(sub(input, memory), moveability));
+	Lanes b = add(a, memory);
+	memory = add(b, a);
+	return b;
+}
+
+/// BasicFilterComponent::doAPF()
+[[gnu::always_inline]] inline Lanes doAPF(Lanes& memory, Lanes input, Lanes moveability) {
+	Lanes a = shiftLeft<1>(multiplyRounded(sub(input, memory), moveability));
+	Lanes b = add(a, memory);
+	memory = add(a, b);
+	return sub(shiftLeft<1>(b), input);
+}
+
+bool canBatchFilter(FilterMode mode, float dryFade) {
+	return mode != FilterMode::TRANSISTOR_24DB_DRIVE && dryFade < 0.001;
+}
+
+} // namespace
+
+bool MultiVoiceFilter::canBatch(FilterSet const& filterSet) {
+	if (!filterSet.LPFOn && !filterSet.HPFOn) {
+		return false;
+	}
+	if (filterSet.LPFOn) {
+		bool isSVF = (filterSet.lpfMode_ == FilterMode::SVF_BAND) || (filterSet.lpfMode_ == FilterMode::SVF_NOTCH);
+		float dryFade = isSVF ? filterSet.lpfilter.svf.dryFade : filterSet.lpfilter.ladder.dryFade;
+		if (!canBatchFilter(filterSet.lpfMode_, dryFade)) {
+			return false;
+		}
+	}
+	if (filterSet.HPFOn) {
+		bool isLadder = (filterSet.hpfMode_ == FilterMode::HPLADDER);
+		float dryFade = isLadder ? filterSet.hpfilter.ladder.dryFade : filterSet.hpfilter.svf.dryFade;
+		if (!canBatchFilter(filterSet.hpfMode_, dryFade)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MultiVoiceFilter::canBatchTogether(FilterSet const& a, FilterSet const& b) {
+	return a.routing_ == b.routing_ && a.LPFOn == b.LPFOn && a.HPFOn == b.HPFOn
+	       && (!a.LPFOn || a.lpfMode_ == b.lpfMode_) && (!a.HPFOn || a.hpfMode_ == b.hpfMode_);
+}
+
+// Same order as FilterSet::renderLong()
+[[gnu::hot]] void MultiVoiceFilter::render(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples) {
+	switch (filterSets[0]->routing_) {
+	case FilterRoute::HIGH_TO_LOW:
+		renderHPF(filterSets, buffer, numSamples);
+		renderLPF(filterSets, buffer, numSamples);
+		break;
+
+	case FilterRoute::LOW_TO_HIGH:
+		renderLPF(filterSets, buffer, numSamples);
+		renderHPF(filterSets, buffer, numSamples);
+		break;
+
+	case FilterRoute::PARALLEL:
+		int32_t length = numSamples * kNumLanes;
+		memcpy(parallelBuffer, buffer, length * sizeof(q31_t));
+
+		renderHPF(filterSets, parallelBuffer, numSamples);
+		renderLPF(filterSets, buffer, numSamples);
+
+		for (int32_t i = 0; i < length; i += kNumLanes) {
+			store(&buffer[i], add(load(&buffer[i]), load(&parallelBuffer[i])));
+		}
+		break;
+	}
+}
+
+void MultiVoiceFilter::renderLPF(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples) {
+	FilterSet& first = *filterSets[0];
+	if (!first.LPFOn) {
+		return;
+	}
+	if ((first.lpfMode_ == FilterMode::SVF_BAND) || (first.lpfMode_ == FilterMode::SVF_NOTCH)) {
+		renderSVF(filterSets, true, buffer, numSamples);
+	}
+	else {
+		renderLPLadder(filterSets, buffer, numSamples);
+	}
+}
+
+void MultiVoiceFilter::renderHPF(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples) {
+	FilterSet& first = *filterSets[0];
+	if (!first.HPFOn) {
+		return;
+	}
+	if (first.hpfMode_ == FilterMode::HPLADDER) {
+		renderHPLadder(filterSets, buffer, numSamples);
+	}
+	else {
+		renderSVF(filterSets, false, buffer, numSamples);
+	}
+}
+
+// LpLadderFilter::do12dBLPFOnSample() and do24dBLPFOnSample()
+[[gnu::hot]] void MultiVoiceFilter::renderLPLadder(std::span<FilterSet* const> filterSets, q31_t* buffer,
+                                                   int32_t numSamples) {
+	using State = LpLadderFilter::LpLadderState;
+	auto ladder = [](FilterSet& f) -> LpLadderFilter& { return f.lpfilter.ladder; };
+	bool halfLadder = (ladder(*filterSets[0]).lpfMode == FilterMode::TRANSISTOR_12DB);
+
+	// Each voice gets the noise it would have got rendering on its own, one voice after the other
+	for (size_t lane = 0; lane < kNumLanes; lane++) {
+		for (int32_t i = 0; i < numSamples; i++) {
+			noiseBuffer[i * kNumLanes + lane] = (lane < filterSets.size()) ? (getNoise() >> 2) : 0;
+		}
+	}
+
+	Lanes moveability = gather(filterSets, [&](FilterSet& f) { return ladder(f).moveability; });
+	Lanes feedback1 = gather(filterSets, [&](FilterSet& f) { return ladder(f).lpf1Feedback; });
+	Lanes feedback2 = gather(filterSets, [&](FilterSet& f) { return ladder(f).lpf2Feedback; });
+	Lanes feedback3 = gather(filterSets, [&](FilterSet& f) {
+		return halfLadder ? ladder(f).divideBy1PlusTannedFrequency : ladder(f).lpf3Feedback;
+	});
+	Lanes feedback4 = gather(filterSets, [&](FilterSet& f) { return ladder(f).divideBy1PlusTannedFrequency; });
+	Lanes resonance = gather(filterSets, [&](FilterSet& f) { return ladder(f).processedResonance; });
+	Lanes divideByTotal =
+	    gather(filterSets, [&](FilterSet& f) { return ladder(f).divideByTotalMoveabilityAndProcessedResonance; });
+	Lanes morph = gather(filterSets, [&](FilterSet& f) { return ladder(f).morph; });
+
+	// Which voices scaleInput() saturates
+	std::array<bool, kNumLanes> saturate;
+	bool anySaturate = false;
+	for (size_t i = 0; i < kNumLanes; i++) {
+		LpLadderFilter& f = ladder(*filterSets[sourceLane(filterSets, i)]);
+		saturate[i] = (f.morph > 0 || f.processedResonance > 510000000);
+		anySaturate |= saturate[i];
+	}
+
+	auto stateOf = [&](FilterSet& f) -> State& { return ladder(f).l; };
+	Lanes noiseLastValue = gather(filterSets, [&](FilterSet& f) { return stateOf(f).noiseLastValue; });
+	Lanes memory1 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).lpfLPF1.memory; });
+	Lanes memory2 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).lpfLPF2.memory; });
+	Lanes memory3 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).lpfLPF3.memory; });
+	Lanes memory4 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).lpfLPF4.memory; });
+
+	q31_t const* noise = noiseBuffer;
+	q31_t* const end = buffer + numSamples * kNumLanes;
+	for (q31_t* frame = buffer; frame != end; frame += kNumLanes, noise += kNumLanes) {
+		Lanes input = load(frame);
+
+		noiseLastValue = add(noiseLastValue, shiftRight<7>(sub(load(noise), noiseLastValue)));
+		Lanes noisyMoveability = add(moveability, multiply(moveability, noiseLastValue));
+
+		Lanes feedbacksSum;
+		if (halfLadder) {
+			feedbacksSum = add(add(shiftLeft<2>(multiplyRounded(memory1, feedback1)),
+			                       shiftLeft<2>(multiplyRounded(memory2, feedback2))),
+			                   shiftLeft<2>(multiplyRounded(memory3, feedback3)));
+		}
+		else {
+			feedbacksSum = shiftLeft<2>(
+			    add(add(multiplyRounded(memory1, feedback1), multiplyRounded(memory2, feedback2)),
+			        add(multiplyRounded(memory3, feedback3), multiplyRounded(memory4, feedback4))));
+		}
+
+		// LpLadderFilter::scaleInput()
+		Lanes x = shiftLeft<2>(
+		    multiplyRounded(sub(input, shiftLeft<3>(multiplyRounded(feedbacksSum, resonance))), divideByTotal));
+		if (anySaturate) {
+			Lanes extra = shiftLeft<1>(multiply(input, morph));
+			Lanes withExtra = add(x, extra);
+			alignas(16) q31_t saturated[kNumLanes];
+			store(saturated, withExtra);
+			x = forEachLane(x, [&](q31_t value, int32_t i) {
+				return saturate[i] ? getTanHUnknown(saturated[i], 2) : value;
+			});
+		}
+
+		Lanes output;
+		if (halfLadder) {
+			output = doAPF(memory3,
+			               doFilter(memory2, doFilter(memory1, x, noisyMoveability), noisyMoveability),
+			               noisyMoveability);
+		}
+		else {
+			output = doFilter(memory4,
+			                  doFilter(memory3,
+			                           doFilter(memory2, doFilter(memory1, x, noisyMoveability), noisyMoveability),
+			                           noisyMoveability),
+			                  noisyMoveability);
+		}
+		store(frame, shiftLeft<1>(output));
+	}
+
+	scatter(filterSets, noiseLastValue, [&](FilterSet& f, q31_t v) { stateOf(f).noiseLastValue = v; });
+	scatter(filterSets, memory1, [&](FilterSet& f, q31_t v) { stateOf(f).lpfLPF1.memory = v; });
+	scatter(filterSets, memory2, [&](FilterSet& f, q31_t v) { stateOf(f).lpfLPF2.memory = v; });
+	scatter(filterSets, memory3, [&](FilterSet& f, q31_t v) { stateOf(f).lpfLPF3.memory = v; });
+	scatter(filterSets, memory4, [&](FilterSet& f, q31_t v) { stateOf(f).lpfLPF4.memory = v; });
+}
+
+// HpLadderFilter::doHPF()
+[[gnu::hot]] void MultiVoiceFilter::renderHPLadder(std::span<FilterSet* const> filterSets, q31_t* buffer,
+                                                   int32_t numSamples) {
+	using State = HpLadderFilter::HPLadderState;
+	auto ladder = [](FilterSet& f) -> HpLadderFilter& { return f.hpfilter.ladder; };
+	auto stateOf = [&](FilterSet& f) -> State& { return ladder(f).l; };
+
+	Lanes fc = gather(filterSets, [&](FilterSet& f) { return ladder(f).fc; });
+	Lanes morph = gather(filterSets, [&](FilterSet& f) { return ladder(f).morph_; });
+	Lanes feedbackHPF3 = gather(filterSets, [&](FilterSet& f) { return ladder(f).hpfHPF3Feedback; });
+	Lanes feedbackLPF1 = gather(filterSets, [&](FilterSet& f) { return ladder(f).hpfLPF1Feedback; });
+	Lanes divideByTotalMoveability = gather(filterSets, [&](FilterSet& f) { return ladder(f).divideByTotalMoveability; });
+	Lanes divideByResonance = gather(filterSets, [&](FilterSet& f) { return ladder(f).hpfDivideByProcessedResonance; });
+	Lanes lowerLimit = dup(-(ONE_Q31 >> 8));
+
+	// How much each voice saturates: 2 for antialiased, 1 for plain tanh, 0 for not at all
+	std::array<int32_t, kNumLanes> saturation;
+	bool anyAntialiased = false;
+	bool anySaturated = false;
+	for (size_t i = 0; i < kNumLanes; i++) {
+		q31_t resonance = ladder(*filterSets[sourceLane(filterSets, i)]).hpfProcessedResonance;
+		saturation[i] = (resonance > 900000000) ? 2 : (resonance > 750000000) ? 1 : 0;
+		anyAntialiased |= (saturation[i] == 2);
+		anySaturated |= (saturation[i] != 0);
+	}
+
+	Lanes memoryHPF1 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).hpfHPF1.memory; });
+	Lanes memoryLPF1 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).hpfLPF1.memory; });
+	Lanes memoryHPF3 = gather(filterSets, [&](FilterSet& f) { return stateOf(f).hpfHPF3.memory; });
+	alignas(16) q31_t lastWorkingValue[kNumLanes];
+	store(lastWorkingValue,
+	      gather(filterSets, [&](FilterSet& f) { return (q31_t)stateOf(f).hpfLastWorkingValue; }));
+
+	q31_t* const end = buffer + numSamples * kNumLanes;
+	for (q31_t* frame = buffer; frame != end; frame += kNumLanes) {
+		Lanes input = load(frame);
+
+		Lanes tempFc = max(add(fc, multiplyRounded(shiftLeft<4>(input), morph)), lowerLimit);
+		Lanes firstHPFOutput = sub(input, doFilter(memoryHPF1, input, tempFc));
+		Lanes feedbacksValue = add(shiftLeft<2>(multiplyRounded(memoryHPF3, feedbackHPF3)),
+		                           shiftLeft<2>(multiplyRounded(memoryLPF1, feedbackLPF1)));
+		Lanes a = shiftLeft<5>(multiplyRounded(divideByTotalMoveability, add(firstHPFOutput, feedbacksValue)));
+
+		if (anyAntialiased) {
+			Lanes plainWorkingValue = lshiftAndSaturate2(a);
+			alignas(16) q31_t plain[kNumLanes];
+			store(plain, plainWorkingValue);
+			a = forEachLane(a, [&](q31_t value, int32_t i) {
+				if (saturation[i] == 2) {
+					return getTanHAntialiased(value, (uint32_t*)&lastWorkingValue[i], 1);
+				}
+				lastWorkingValue[i] = (q31_t)((uint32_t)plain[i] + 2147483648u);
+				return (saturation[i] == 1) ? getTanHUnknown(value, 2) : value;
+			});
+		}
+		else {
+			// Nobody needs the last working value this time round, but it has to be right for next time
+			store(lastWorkingValue, add(lshiftAndSaturate2(a), dup(-2147483648)));
+			if (anySaturated) {
+				a = forEachLane(a, [&](q31_t value, int32_t i) {
+					return (saturation[i] == 1) ? getTanHUnknown(value, 2) : value;
+				});
+			}
+		}
+
+		doFilter(memoryLPF1, sub(a, doFilter(memoryHPF3, a, tempFc)), tempFc);
+
+		store(frame, shiftLeft<7>(multiplyRounded(a, divideByResonance)));
+	}
+
+	scatter(filterSets, memoryHPF1, [&](FilterSet& f, q31_t v) { stateOf(f).hpfHPF1.memory = v; });
+	scatter(filterSets, memoryLPF1, [&](FilterSet& f, q31_t v) { stateOf(f).hpfLPF1.memory = v; });
+	scatter(filterSets, memoryHPF3, [&](FilterSet& f, q31_t v) { stateOf(f).hpfHPF3.memory = v; });
+	scatter(filterSets, load(lastWorkingValue),
+	        [&](FilterSet& f, q31_t v) { stateOf(f).hpfLastWorkingValue = (uint32_t)v; });
+}
+
+// SVFilter::doSVF()
+[[gnu::hot]] void MultiVoiceFilter::renderSVF(std::span<FilterSet* const> filterSets, bool lowPass, q31_t* buffer,
+                                              int32_t numSamples) {
+	auto svf = [lowPass](FilterSet& f) -> SVFilter& { return lowPass ? f.lpfilter.svf : f.hpfilter.svf; };
+	bool bandMode = svf(*filterSets[0]).band_mode;
+
+	Lanes fc = gather(filterSets, [&](FilterSet& f) { return svf(f).fc; });
+	Lanes q = gather(filterSets, [&](FilterSet& f) { return svf(f).q; });
+	Lanes inputScale = gather(filterSets, [&](FilterSet& f) { return svf(f).in; });
+	Lanes cLow = gather(filterSets, [&](FilterSet& f) { return svf(f).c_low; });
+	Lanes cBand = gather(filterSets, [&](FilterSet& f) { return svf(f).c_band; });
+	Lanes cHigh = gather(filterSets, [&](FilterSet& f) { return svf(f).c_high; });
+
+	Lanes low = gather(filterSets, [&](FilterSet& f) { return svf(f).l.low; });
+	Lanes band = gather(filterSets, [&](FilterSet& f) { return svf(f).l.band; });
+
+	auto saturateBand = [](q31_t value, int32_t) { return getTanHUnknown(value, 3); };
+
+	q31_t* const end = buffer + numSamples * kNumLanes;
+	for (q31_t* frame = buffer; frame != end; frame += kNumLanes) {
+		Lanes input = multiply(inputScale, load(frame));
+
+		low = add(low, shiftLeft<1>(multiply(band, fc)));
+		Lanes high = sub(sub(input, low), shiftLeft<1>(multiply(band, q)));
+		band = add(shiftLeft<1>(multiply(high, fc)), band);
+		band = forEachLane(band, saturateBand);
+
+		Lanes lowSum = low;
+		Lanes highSum = high;
+		Lanes bandSum = band;
+
+		// Double sampled, to get the cutoff higher
+		low = add(low, shiftLeft<1>(multiply(band, fc)));
+		high = sub(sub(input, low), shiftLeft<1>(multiply(band, q)));
+		band = add(shiftLeft<1>(multiply(high, fc)), band);
+
+		lowSum = add(lowSum, low);
+		highSum = add(highSum, high);
+		bandSum = add(bandSum, band);
+
+		Lanes result = add(multiplyRounded(lowSum, cLow), multiplyRounded(highSum, cHigh));
+		if (bandMode) {
+			result = add(result, multiplyRounded(bandSum, cBand));
+		}
+
+		band = forEachLane(band, saturateBand);
+		store(frame, add(shiftLeft<1>(result), result));
+	}
+
+	scatter(filterSets, low, [&](FilterSet& f, q31_t v) { svf(f).l.low = v; });
+	scatter(filterSets, band, [&](FilterSet& f, q31_t v) { svf(f).l.band = v; });
+}
+
+} // namespace deluge::dsp::filter
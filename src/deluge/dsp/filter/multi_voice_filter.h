@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "dsp/filter/filter_set.h"
+#include "util/fixedpoint.h"
+#include <cstdint>
+#include <span>
+
+namespace deluge::dsp::filter {
+
+/// Runs the FilterSets of several voices of the same Sound together, one voice per NEON lane. Each voice keeps its own
+/// coefficients and state in its FilterSet - they're just loaded into lanes at the start of each render and put back
+/// at the end, so a voice can move in and out of a batch from one render to the next. Given the same noise, the output
+/// is the same as rendering each FilterSet on its own, to the bit. But the LP ladder's noise gets drawn for every voice
+/// at once, when the batch is rendered, rather than in between each voice's oscillators - so within a whole Sound it's
+/// from a different point in getNoise()'s sequence than it would have been.
+class MultiVoiceFilter {
+public:
+	static constexpr int32_t kNumLanes = 4;
+
+	/// Whether a voice's filters can go in a batch at the moment. Not for the drive ladder, which decides on
+	/// oversampling per voice, or while a filter is still fading in after its mode changed
+	static bool canBatch(FilterSet const& filterSet);
+
+	/// Whether two voices' filters can go in the same batch - they need the same modes and routing
+	static bool canBatchTogether(FilterSet const& a, FilterSet const& b);
+
+	/// buffer holds numSamples frames of kNumLanes mono samples, the sample in lane i belonging to filterSets[i]. There
+	/// can be fewer filterSets than lanes, in which case whatever is in the spare lanes is left meaningless
+	static void render(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples);
+
+private:
+	static void renderLPF(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples);
+	static void renderHPF(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples);
+	static void renderLPLadder(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples);
+	static void renderHPLadder(std::span<FilterSet* const> filterSets, q31_t* buffer, int32_t numSamples);
+	static void renderSVF(std::span<FilterSet* const> filterSets, bool lowPass, q31_t* buffer, int32_t numSamples);
+};
+
+} // namespace deluge::dsp::filter
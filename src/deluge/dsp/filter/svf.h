@@ -22,6 +22,8 @@
 
 namespace deluge::dsp::filter {
 
+class MultiVoiceFilter;
+
 class SVFilter : public Filter<SVFilter> {
 public:
 	SVFilter() = default;
@@ -35,6 +37,8 @@ public:
 	}
 
 private:
+	friend class MultiVoiceFilter;
+
 	struct SVFState {
 		q31_t low;
 		q31_t band;
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/interpolation/precise.h"
+#include <cmath>
+#include <numbers>
+
+namespace deluge::dsp::interpolation {
+
+int32_t preciseKernels[kPreciseNumKernels][kPreciseNumPhases + 1][kPreciseNumTaps];
+
+namespace {
+
+// Cutoff for each kernel, as a fraction of the source's Nyquist frequency. Kernel 0 is for playing at about the
+// original pitch, so doesn't filter. The rest are for pitching up, each by the middle of the range getWhichKernel()
+// uses it for, in semitones.
+constexpr double kKernelSemitones[kPreciseNumKernels] = {0, 3, 8.5, 14.5, 20.5, 26.5, 32.5};
+
+double blackman(double t) {
+	double x = std::numbers::pi * t / (kPreciseNumTaps / 2);
+	return 0.42 + 0.5 * std::cos(x) + 0.08 * std::cos(2 * x);
+}
+
+double sinc(double x) {
+	if (x == 0) {
+		return 1;
+	}
+	return std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+}
+
+} // namespace
+
+void initPreciseKernels() {
+	for (int32_t k = 0; k < kPreciseNumKernels; k++) {
+		double cutoff = std::exp2(-kKernelSemitones[k] / 12);
+
+		for (int32_t p = 0; p <= kPreciseNumPhases; p++) {
+			double fraction = (double)p / kPreciseNumPhases;
+			double taps[kPreciseNumTaps];
+			double sum = 0;
+			for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+				double t = (kPreciseNumTaps / 2 - i) - fraction; // Tap 8 is the sample we're just past
+				taps[i] = cutoff * sinc(cutoff * t) * blackman(t);
+				sum += taps[i];
+			}
+
+			// Unity gain at DC for every phase, or there'd be a ripple at the rate the phase goes round
+			for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+				double value = std::round(taps[i] / sum * 2147483648.0);
+				preciseKernels[k][p][i] = (int32_t)std::fmax(std::fmin(value, 2147483647.0), -2147483648.0);
+			}
+		}
+	}
+}
+
+} // namespace deluge::dsp::interpolation
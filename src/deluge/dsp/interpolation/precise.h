@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// The high-precision windowed-sinc interpolation, for InterpolationMode::PRECISE. Unlike interpolate.h, which works on
+// the top 16 bits of each sample with 16-bit kernels, this keeps all 32 bits of the samples and uses Q31 kernels with
+// four times as many phases, so 24-bit samples keep their low bits when pitched. Costs roughly twice the cycles.
+
+namespace deluge::dsp::interpolation {
+
+constexpr int32_t kPreciseNumTaps = 16;
+constexpr int32_t kPreciseNumPhasesMagnitude = 6;
+constexpr int32_t kPreciseNumPhases = 1 << kPreciseNumPhasesMagnitude;
+/// Same as windowedSincKernel, so getWhichKernel() picks for both
+constexpr int32_t kPreciseNumKernels = 7;
+
+/// Row p of a kernel is for output p/kPreciseNumPhases of the way from buffer[8] to buffer[7]. There's one extra row at
+/// the end, so the last phase has something to be interpolated towards.
+extern int32_t preciseKernels[kPreciseNumKernels][kPreciseNumPhases + 1][kPreciseNumTaps];
+
+/// Fills in preciseKernels. Call once at startup
+void initPreciseKernels();
+
+/// Interpolates between the values in the buffer, newest first, as SampleLowLevelReader keeps them. oscPos is the
+/// 24-bit fractional position, and bitMask gets applied to each value to get rid of anything past the end of a sample
+/// that was read along with it. Output is half-scale, the same as interpolate().
+inline void interpolatePrecise(int32_t* sampleRead, int32_t const (*buffer)[kPreciseNumTaps], int32_t numChannels,
+                               uint32_t oscPos, int32_t whichKernel, uint32_t bitMask) {
+	int32_t const* row = preciseKernels[whichKernel][oscPos >> (24 - kPreciseNumPhasesMagnitude)];
+	int32_t const* nextRow = row + kPreciseNumTaps;
+	int32_t fraction = (int32_t)((oscPos & ((1 << (24 - kPreciseNumPhasesMagnitude)) - 1))
+	                             << (7 + kPreciseNumPhasesMagnitude)); // Q31
+
+#if defined(__ARM_NEON)
+	int32x4_t const mask = vdupq_n_s32((int32_t)bitMask);
+	int64x2_t accumulatorL = vdupq_n_s64(0);
+
+	if (numChannels == 2) {
+		// Each bit of kernel is only worked out once, for both channels
+		int64x2_t accumulatorR = vdupq_n_s64(0);
+		for (int32_t i = 0; i < kPreciseNumTaps; i += 4) {
+			int32x4_t kernel = vld1q_s32(&row[i]);
+			kernel = vaddq_s32(kernel, vqrdmulhq_n_s32(vsubq_s32(vld1q_s32(&nextRow[i]), kernel), fraction));
+			int32x4_t valuesL = vandq_s32(vld1q_s32(&buffer[0][i]), mask);
+			int32x4_t valuesR = vandq_s32(vld1q_s32(&buffer[1][i]), mask);
+			accumulatorL = vmlal_s32(accumulatorL, vget_low_s32(kernel), vget_low_s32(valuesL));
+			accumulatorL = vmlal_s32(accumulatorL, vget_high_s32(kernel), vget_high_s32(valuesL));
+			accumulatorR = vmlal_s32(accumulatorR, vget_low_s32(kernel), vget_low_s32(valuesR));
+			accumulatorR = vmlal_s32(accumulatorR, vget_high_s32(kernel), vget_high_s32(valuesR));
+		}
+		sampleRead[1] = (int32_t)((vgetq_lane_s64(accumulatorR, 0) + vgetq_lane_s64(accumulatorR, 1)) >> 32);
+	}
+	else {
+		for (int32_t i = 0; i < kPreciseNumTaps; i += 4) {
+			int32x4_t kernel = vld1q_s32(&row[i]);
+			kernel = vaddq_s32(kernel, vqrdmulhq_n_s32(vsubq_s32(vld1q_s32(&nextRow[i]), kernel), fraction));
+			int32x4_t valuesL = vandq_s32(vld1q_s32(&buffer[0][i]), mask);
+			accumulatorL = vmlal_s32(accumulatorL, vget_low_s32(kernel), vget_low_s32(valuesL));
+			accumulatorL = vmlal_s32(accumulatorL, vget_high_s32(kernel), vget_high_s32(valuesL));
+		}
+	}
+	sampleRead[0] = (int32_t)((vgetq_lane_s64(accumulatorL, 0) + vgetq_lane_s64(accumulatorL, 1)) >> 32);
+
+#else
+	for (int32_t c = 0; c < numChannels; c++) {
+		int64_t accumulator = 0;
+		for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+			// Rounds the same as vqrdmulh
+			int32_t kernel = row[i] + (int32_t)(((int64_t)(nextRow[i] - row[i]) * fraction + (1 << 30)) >> 31);
+			accumulator += (int64_t)kernel * (int32_t)(buffer[c][i] & bitMask);
+		}
+		sampleRead[c] = (int32_t)(accumulator >> 32);
+	}
+#endif
+}
+
+} // namespace deluge::dsp::interpolation
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/reverb/convolution/convolution.hpp"
+#include "util/fixedpoint.h"
+#include <algorithm>
+#include <array>
+
+namespace deluge::dsp::reverb {
+
+void Convolution::process(std::span<int32_t> input, std::span<StereoSample> output) {
+	if (!convolver_->isLoaded()) {
+		return;
+	}
+
+	constexpr float kInputScale = 1.f / 2147483648.f;
+	constexpr size_t kChunkSize = 64; // Keeps the wet buffer small enough for the stack
+
+	float side_gain = width_ * 0.5f;
+	std::array<StereoSample, kChunkSize> wet;
+
+	for (size_t start = 0; start < input.size(); start += kChunkSize) {
+		size_t num_frames = std::min(kChunkSize, input.size() - start);
+
+		for (size_t frame = 0; frame < num_frames; frame++) {
+			float in = static_cast<float>(input[start + frame]) * kInputScale;
+
+			// HPF on the input, as for the other models - any DC offset would come out as a thump at the IR's level
+			hp_state_ += (in - hp_state_) * hp_cutoff_;
+			in -= hp_state_;
+
+			auto in_q31 = static_cast<int32_t>(std::clamp(in * 2147483648.f, -2147483648.f, 2147483520.f));
+			wet[frame].l = in_q31;
+			wet[frame].r = in_q31;
+		}
+
+		// The IR's normalized to unit energy, so this comes out at about the send's level
+		convolver_->process({wet.data(), num_frames});
+
+		for (size_t frame = 0; frame < num_frames; frame++) {
+			float wet_l = static_cast<float>(wet[frame].l);
+			float wet_r = static_cast<float>(wet[frame].r);
+			float mid = (wet_l + wet_r) * 0.5f;
+			float side = (wet_l - wet_r) * side_gain;
+			auto output_left = static_cast<int32_t>(std::clamp(mid + side, -2147483648.f, 2147483520.f));
+			auto output_right = static_cast<int32_t>(std::clamp(mid - side, -2147483648.f, 2147483520.f));
+
+			output[start + frame].l += multiply_32x32_rshift32_rounded(output_left, getPanLeft());
+			output[start + frame].r += multiply_32x32_rshift32_rounded(output_right, getPanRight());
+		}
+	}
+}
+
+} // namespace deluge::dsp::reverb
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "dsp/convolution/partitioned_convolver.h"
+#include "dsp/reverb/base.hpp"
+#include <cstdint>
+#include <span>
+
+namespace deluge::dsp::reverb {
+
+/// Convolves the reverb send with an impulse response from the card - a recording of a real room, hall, plate or
+/// spring. The PartitionedConvolver belongs to Reverb rather than to this, so the IR stays loaded while another model
+/// is selected. Until one's loaded, this model's silent.
+class Convolution : public Base {
+public:
+	/// Partitions of 512 samples: a quarter of the work per sample of the convolver's default size, for IRs of up to
+	/// PartitionedConvolver::kMaxImpulseResponseLength, at the price of about 12ms latency - which in a reverb is only
+	/// some extra predelay
+	static constexpr int32_t kPartitionMagnitude = 9;
+
+	explicit Convolution(PartitionedConvolver& convolver) : convolver_(&convolver) { convolver.reset(); }
+	~Convolution() override = default;
+
+	void process(std::span<int32_t> input, std::span<StereoSample> output) override;
+
+	// Reverb Base Overrides
+	// Room size and damping don't apply - the IR holds all that - but they're kept, for the song to save
+	void setRoomSize(float value) override { room_size_ = value; }
+	[[nodiscard]] float getRoomSize() const override { return room_size_; }
+
+	void setDamping(float value) override { damping_ = value; }
+	[[nodiscard]] float getDamping() const override { return damping_; }
+
+	void setWidth(float value) override { width_ = value; }
+	[[nodiscard]] float getWidth() const override { return width_; }
+
+	void setHPF(float f) override {
+		hp_cutoff_val_ = f;
+		hp_cutoff_ = calcFilterCutoff(f);
+	}
+	[[nodiscard]] float getHPF() const override { return hp_cutoff_val_; }
+
+private:
+	PartitionedConvolver* convolver_;
+
+	float room_size_ = 0.f;
+	float damping_ = 0.f;
+	float width_ = 1.f;
+	float hp_cutoff_val_ = 0.f;
+	float hp_cutoff_ = calcFilterCutoff(0.f);
+	float hp_state_ = 0.f;
+};
+
+} // namespace deluge::dsp::reverb
@@ -0,0 +1,310 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/reverb/fdn/fdn.hpp"
+#include "definitions_cxx.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace deluge::dsp::reverb {
+
+namespace {
+
+// In samples at full rate. Primes, spread over a bit more than an octave so the echoes don't line up
+constexpr std::array<float, FDN::kNumLines> kLineLengths = {1049, 1223, 1427, 1637, 1871, 2153, 2417, 2767};
+// Slow, and all different, so the modes drift apart rather than ringing
+constexpr std::array<float, FDN::kNumLines> kModRatesHz = {0.53f, 0.61f, 0.71f, 0.79f, 0.89f, 0.97f, 0.43f, 0.67f};
+constexpr float kModDepth = 8; // Samples at full rate, either way
+
+constexpr float kInputGain = 0.35355339f; // 1/sqrt(8), into each line
+constexpr float kHadamardScale = 0.35355339f;
+// Roughly as loud as Freeverb for the same send
+constexpr float kOutputGain = 0.125f;
+
+// Rows of the Hadamard matrix, so the two outputs come out uncorrelated
+alignas(16) constexpr std::array<float, FDN::kNumLines> kInputSigns = {1, 1, 1, 1, 1, 1, 1, 1};
+alignas(16) constexpr std::array<float, FDN::kNumLines> kLeftSigns = {1, -1, 1, -1, 1, -1, 1, -1};
+alignas(16) constexpr std::array<float, FDN::kNumLines> kRightSigns = {1, 1, -1, -1, 1, 1, -1, -1};
+
+constexpr float kMinDecayTime = 0.25f;
+constexpr float kDecayTimeRangeOctaves = 5.5f; // So up to about 11s
+
+#if defined(__ARM_NEON)
+// Unnormalised 4-point Hadamard transform across the lanes - the first two butterfly stages of the 8-point one
+[[gnu::always_inline]] inline float32x4_t hadamard4(float32x4_t x) {
+	const float32x4_t signs_1 = {1, -1, 1, -1};
+	const float32x4_t signs_2 = {1, 1, -1, -1};
+	x = vmlaq_f32(vrev64q_f32(x), x, signs_1); // a+b, a-b, c+d, c-d
+	float32x4_t swapped = vcombine_f32(vget_high_f32(x), vget_low_f32(x));
+	return vmlaq_f32(swapped, x, signs_2);
+}
+
+[[gnu::always_inline]] inline float sumLanes(float32x4_t x) {
+	float32x2_t pairs = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+	return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+}
+#endif
+
+} // namespace
+
+FDN::FDN() {
+	setRate(rate_);
+	setRoomSize(room_size_);
+	setDamping(damping_);
+}
+
+void FDN::clear() {
+	for (auto& line : lines_) {
+		line.fill(0);
+	}
+	lp_state_.fill(0);
+	down_filter_.reset();
+	up_filter_l_.reset();
+	up_filter_r_.reset();
+	hp_state_ = 0;
+	decimation_count_ = 0;
+}
+
+void FDN::setRate(Rate rate) {
+	rate_ = rate;
+	int32_t decimation = getDecimation();
+
+	// The lines keep the same length in time, so the room sounds the same at any rate
+	for (size_t i = 0; i < kNumLines; i++) {
+		base_delay_[i] = std::round(kLineLengths[i] / decimation);
+		delay_[i] = base_delay_[i];
+		delay_step_[i] = 0;
+	}
+	mod_depth_ = kModDepth / decimation;
+
+	// A bit under the lower rate's Nyquist
+	float cutoff = 0.45f / decimation;
+	down_filter_.setCutoff(cutoff);
+	up_filter_l_.setCutoff(cutoff);
+	up_filter_r_.setCutoff(cutoff);
+
+	clear(); // What's in the lines is at the wrong rate now
+	updateFeedback();
+	updateDamping();
+}
+
+void FDN::setRoomSize(float value) {
+	room_size_ = value;
+	updateFeedback();
+}
+
+void FDN::setDamping(float value) {
+	damping_ = value;
+	updateDamping();
+}
+
+float FDN::getDecayTime() const {
+	return kMinDecayTime * std::exp2(room_size_ * kDecayTimeRangeOctaves);
+}
+
+// Each line loses the same number of dB per second, whatever its length
+void FDN::updateFeedback() {
+	float decay_time = getDecayTime();
+	for (size_t i = 0; i < kNumLines; i++) {
+		feedback_[i] = std::pow(10.f, -3.f * kLineLengths[i] / (decay_time * kSampleRate));
+	}
+}
+
+void FDN::updateDamping() {
+	float tick_rate = static_cast<float>(kSampleRate) / getDecimation();
+	float cutoff_hz = std::min(16000.f * std::exp2(-5.f * damping_), 0.45f * tick_rate);
+	damping_coefficient_ = 1.f - std::exp(-2.f * std::numbers::pi_v<float> * cutoff_hz / tick_rate);
+}
+
+void FDN::Biquad::setLowpass(float fc, float q) {
+	float w0 = 2.f * std::numbers::pi_v<float> * fc;
+	float cos_w0 = std::cos(w0);
+	float alpha = std::sin(w0) / (2.f * q);
+	float a0 = 1.f + alpha;
+	b0 = (1.f - cos_w0) / 2.f / a0;
+	b1 = (1.f - cos_w0) / a0;
+	a1 = -2.f * cos_w0 / a0;
+	a2 = (1.f - alpha) / a0;
+}
+
+// fc as a fraction of the full sample rate
+void FDN::RateFilter::setCutoff(float fc) {
+	stage1.setLowpass(fc, 0.54119610f);
+	stage2.setLowpass(fc, 1.30656296f);
+}
+
+// Ramps each line's delay towards where its LFO will be at the end of this block
+void FDN::updateModulation(int32_t num_ticks) {
+	if (!num_ticks) {
+		return;
+	}
+	for (size_t i = 0; i < kNumLines; i++) {
+		lfo_phase_[i] += kModRatesHz[i] * num_ticks * getDecimation() / kSampleRate;
+		lfo_phase_[i] -= std::floor(lfo_phase_[i]);
+		float target = base_delay_[i] + mod_depth_ * std::sin(2.f * std::numbers::pi_v<float> * lfo_phase_[i]);
+		delay_step_[i] = (target - delay_[i]) / num_ticks;
+	}
+}
+
+// One sample of the network, at the lower rate if there is one
+[[gnu::always_inline]] inline void FDN::tick(float input, float* out_l, float* out_r) {
+	alignas(16) std::array<int32_t, kNumLines> read_index;
+	alignas(16) std::array<float, kNumLines> read_fraction;
+	alignas(16) std::array<float, kNumLines> read_a;
+	alignas(16) std::array<float, kNumLines> read_b;
+	alignas(16) std::array<float, kNumLines> to_write;
+	float write_pos = static_cast<float>(write_pos_ + kLineSize);
+
+	// Where to read each line from. Always positive, so truncating is the same as flooring
+#if defined(__ARM_NEON)
+	for (size_t i = 0; i < kNumLines; i += 4) {
+		float32x4_t delay = vaddq_f32(vld1q_f32(&delay_[i]), vld1q_f32(&delay_step_[i]));
+		vst1q_f32(&delay_[i], delay);
+		float32x4_t position = vsubq_f32(vdupq_n_f32(write_pos), delay);
+		int32x4_t index = vcvtq_s32_f32(position);
+		vst1q_s32(&read_index[i], index);
+		vst1q_f32(&read_fraction[i], vsubq_f32(position, vcvtq_f32_s32(index)));
+	}
+#else
+	for (size_t i = 0; i < kNumLines; i++) {
+		delay_[i] += delay_step_[i];
+		float position = write_pos - delay_[i];
+		read_index[i] = static_cast<int32_t>(position);
+		read_fraction[i] = position - static_cast<float>(read_index[i]);
+	}
+#endif
+
+	for (size_t i = 0; i < kNumLines; i++) {
+		read_a[i] = lines_[i][read_index[i] & (kLineSize - 1)];
+		read_b[i] = lines_[i][(read_index[i] + 1) & (kLineSize - 1)];
+	}
+
+#if defined(__ARM_NEON)
+	float32x4_t damped[2];
+	float32x4_t sum_l = vdupq_n_f32(0);
+	float32x4_t sum_r = vdupq_n_f32(0);
+	for (size_t h = 0; h < 2; h++) {
+		size_t i = h * 4;
+		float32x4_t a = vld1q_f32(&read_a[i]);
+		float32x4_t value = vmlaq_f32(a, vsubq_f32(vld1q_f32(&read_b[i]), a), vld1q_f32(&read_fraction[i]));
+		float32x4_t lp = vld1q_f32(&lp_state_[i]);
+		lp = vmlaq_n_f32(lp, vsubq_f32(value, lp), damping_coefficient_);
+		vst1q_f32(&lp_state_[i], lp);
+		damped[h] = lp;
+		sum_l = vmlaq_f32(sum_l, lp, vld1q_f32(&kLeftSigns[i]));
+		sum_r = vmlaq_f32(sum_r, lp, vld1q_f32(&kRightSigns[i]));
+	}
+	*out_l = sumLanes(sum_l);
+	*out_r = sumLanes(sum_r);
+
+	// Last butterfly stage of the 8-point Hadamard is across the two halves
+	float32x4_t low = hadamard4(damped[0]);
+	float32x4_t high = hadamard4(damped[1]);
+	float32x4_t mixed[2] = {vaddq_f32(low, high), vsubq_f32(low, high)};
+	float32x4_t in = vdupq_n_f32(input * kInputGain);
+	for (size_t h = 0; h < 2; h++) {
+		size_t i = h * 4;
+		float32x4_t gain = vmulq_n_f32(vld1q_f32(&feedback_[i]), kHadamardScale);
+		vst1q_f32(&to_write[i], vmlaq_f32(vmulq_f32(in, vld1q_f32(&kInputSigns[i])), mixed[h], gain));
+	}
+#else
+	std::array<float, kNumLines> mixed;
+	*out_l = 0;
+	*out_r = 0;
+	for (size_t i = 0; i < kNumLines; i++) {
+		float value = read_a[i] + (read_b[i] - read_a[i]) * read_fraction[i];
+		lp_state_[i] += (value - lp_state_[i]) * damping_coefficient_;
+		mixed[i] = lp_state_[i];
+		*out_l += mixed[i] * kLeftSigns[i];
+		*out_r += mixed[i] * kRightSigns[i];
+	}
+
+	for (size_t stride = 1; stride < kNumLines; stride <<= 1) {
+		for (size_t i = 0; i < kNumLines; i++) {
+			if (!(i & stride)) {
+				float a = mixed[i];
+				float b = mixed[i + stride];
+				mixed[i] = a + b;
+				mixed[i + stride] = a - b;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < kNumLines; i++) {
+		to_write[i] = input * kInputGain * kInputSigns[i] + mixed[i] * feedback_[i] * kHadamardScale;
+	}
+#endif
+
+	for (size_t i = 0; i < kNumLines; i++) {
+		lines_[i][write_pos_] = to_write[i];
+	}
+	write_pos_ = (write_pos_ + 1) & (kLineSize - 1);
+}
+
+void FDN::process(std::span<int32_t> input, std::span<StereoSample> output) {
+	constexpr float kInputScale = 1.f / 2147483648.f;
+	constexpr float kOutputScale = 2147483647.f * kOutputGain;
+
+	int32_t decimation = getDecimation();
+	updateModulation((decimation_count_ + static_cast<int32_t>(input.size())) / decimation);
+
+	float side_gain = width_ * 0.5f;
+
+	for (size_t frame = 0; frame < input.size(); frame++) {
+		float in = static_cast<float>(input[frame]) * kInputScale;
+
+		// HPF on the input, cos if it has DC offset, the tail builds that up
+		hp_state_ += (in - hp_state_) * hp_cutoff_;
+		in -= hp_state_;
+
+		float wet_l;
+		float wet_r;
+		if (decimation == 1) {
+			tick(in, &wet_l, &wet_r);
+		}
+		else {
+			// Filtering every sample but only keeping some; then putting zeros between the ones we get back, and
+			// filtering those, making up for the zeros
+			in = down_filter_.process(in);
+			wet_l = 0;
+			wet_r = 0;
+			if (++decimation_count_ == decimation) {
+				decimation_count_ = 0;
+				tick(in, &wet_l, &wet_r);
+				wet_l *= decimation;
+				wet_r *= decimation;
+			}
+			wet_l = up_filter_l_.process(wet_l);
+			wet_r = up_filter_r_.process(wet_r);
+		}
+
+		float mid = (wet_l + wet_r) * 0.5f;
+		float side = (wet_l - wet_r) * side_gain;
+		auto output_left = static_cast<int32_t>(std::clamp((mid + side) * kOutputScale, -2147483648.f, 2147483520.f));
+		auto output_right = static_cast<int32_t>(std::clamp((mid - side) * kOutputScale, -2147483648.f, 2147483520.f));
+
+		output[frame].l += multiply_32x32_rshift32_rounded(output_left, getPanLeft());
+		output[frame].r += multiply_32x32_rshift32_rounded(output_right, getPanRight());
+	}
+}
+
+} // namespace deluge::dsp::reverb
@@ -0,0 +1,141 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "dsp/reverb/base.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace deluge::dsp::reverb {
+
+/// Feedback delay network: 8 modulated delay lines, damped, mixed through an 8x8 Hadamard matrix and fed back. The
+/// lines are processed 4 at a time with NEON. The whole network can run at half or quarter rate, between a pair of
+/// 4th-order Butterworth filters which keep it from aliasing on the way down and imaging on the way back up - the
+/// tail's mostly above the damping cutoff anyway, so this costs little but halves or quarters the work.
+class FDN : public Base {
+public:
+	enum class Rate : uint8_t {
+		FULL = 0,
+		HALF,
+		QUARTER,
+	};
+
+	static constexpr size_t kNumLines = 8;
+	/// Power of two, and long enough for the longest line plus its modulation at full rate
+	static constexpr size_t kLineSize = 4096;
+
+	FDN();
+	~FDN() override = default;
+
+	void process(std::span<int32_t> input, std::span<StereoSample> output) override;
+
+	void clear();
+
+	// Reverb Base Overrides
+	void setRoomSize(float value) override;
+	[[nodiscard]] float getRoomSize() const override { return room_size_; }
+
+	void setDamping(float value) override;
+	[[nodiscard]] float getDamping() const override { return damping_; }
+
+	void setWidth(float value) override { width_ = value; }
+	[[nodiscard]] float getWidth() const override { return width_; }
+
+	void setHPF(float f) override {
+		hp_cutoff_val_ = f;
+		hp_cutoff_ = calcFilterCutoff(f);
+	}
+	[[nodiscard]] float getHPF() const override { return hp_cutoff_val_; }
+
+	void setRate(Rate rate);
+	[[nodiscard]] Rate getRate() const { return rate_; }
+
+	/// Seconds for the tail to fall by 60dB
+	[[nodiscard]] float getDecayTime() const;
+
+private:
+	// Transposed direct form II
+	struct Biquad {
+		void setLowpass(float fc, float q);
+		[[gnu::always_inline]] float process(float x) {
+			float y = b0 * x + z1;
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b0 * x - a2 * y; // b2 == b0 for a lowpass
+			return y;
+		}
+		void reset() {
+			z1 = 0;
+			z2 = 0;
+		}
+		float b0 = 1;
+		float b1 = 0;
+		float a1 = 0;
+		float a2 = 0;
+		float z1 = 0;
+		float z2 = 0;
+	};
+
+	// 4th-order Butterworth, for getting to and from the lower rate
+	struct RateFilter {
+		void setCutoff(float fc);
+		[[gnu::always_inline]] float process(float x) { return stage2.process(stage1.process(x)); }
+		void reset() {
+			stage1.reset();
+			stage2.reset();
+		}
+		Biquad stage1;
+		Biquad stage2;
+	};
+
+	void tick(float input, float* out_l, float* out_r);
+	void updateModulation(int32_t num_ticks);
+	void updateFeedback();
+	void updateDamping();
+	[[nodiscard]] int32_t getDecimation() const { return 1 << static_cast<int32_t>(rate_); }
+
+	std::array<std::array<float, kLineSize>, kNumLines> lines_{};
+	uint32_t write_pos_ = 0;
+
+	// Per line, in the order the vector code wants them
+	alignas(16) std::array<float, kNumLines> base_delay_{};  // In ticks at the current rate
+	alignas(16) std::array<float, kNumLines> delay_{};       // Including modulation
+	alignas(16) std::array<float, kNumLines> delay_step_{};  // Per tick, to get to the next block's modulation
+	alignas(16) std::array<float, kNumLines> feedback_{};    // Gain for one trip round the line
+	alignas(16) std::array<float, kNumLines> lp_state_{};    // Damping filters
+	alignas(16) std::array<float, kNumLines> lfo_phase_{};   // 0 to 1
+	float damping_coefficient_ = 1;
+	float mod_depth_ = 0; // In ticks
+
+	Rate rate_ = Rate::HALF;
+	int32_t decimation_count_ = 0; // Samples since the last tick
+	RateFilter down_filter_;
+	RateFilter up_filter_l_;
+	RateFilter up_filter_r_;
+
+	float room_size_ = 0.5f;
+	float damping_ = 0.5f;
+	float width_ = 1.f;
+
+	float hp_cutoff_val_ = 0.f;
+	float hp_cutoff_ = calcFilterCutoff(0);
+	float hp_state_ = 0.f;
+};
+
+} // namespace deluge::dsp::reverb
@@ -1,5 +1,8 @@
 #pragma once
 #include "base.hpp"
+#include "convolution/convolution.hpp"
+#include "dsp/convolution/partitioned_convolver.h"
+#include "fdn/fdn.hpp"
 #include "freeverb/freeverb.hpp"
 #include "mutable/reverb.hpp"
 #include <algorithm>
@@ -13,6 +16,8 @@ public:
 	enum class Model {
 		FREEVERB = 0, // Freeverb is the original
 		MUTABLE,
+		FDN,
+		IMPULSE_RESPONSE,
 	};
 
 	Reverb()
@@ -30,6 +35,12 @@ public:
 		case Model::MUTABLE:
 			reverb_.emplace<reverb::Mutable>();
 			break;
+		case Model::FDN:
+			reverb_.emplace<reverb::FDN>().setRate(fdn_rate_);
+			break;
+		case Model::IMPULSE_RESPONSE:
+			reverb_.emplace<reverb::Convolution>(convolver_);
+			break;
 		}
 		base_->setRoomSize(room_size_);
 		base_->setDamping(damping_);
@@ -49,6 +60,12 @@ public:
 		case Model::MUTABLE:
 			reverb_as<Mutable>().process(input, output);
 			break;
+		case Model::FDN:
+			reverb_as<FDN>().process(input, output);
+			break;
+		case Model::IMPULSE_RESPONSE:
+			reverb_as<Convolution>().process(input, output);
+			break;
 		}
 	}
 
@@ -83,15 +100,31 @@ public:
 	}
 	[[nodiscard]] virtual float getHPF() const { return base_->getHPF(); }
 
+	/// Only does anything to the FDN model, but is remembered for when that's selected
+	void setRate(reverb::FDN::Rate rate) {
+		fdn_rate_ = rate;
+		if (model_ == Model::FDN) {
+			reverb_as<reverb::FDN>().setRate(rate);
+		}
+	}
+	[[nodiscard]] reverb::FDN::Rate getRate() const { return fdn_rate_; }
+
+	/// Where the IMPULSE_RESPONSE model's IR gets loaded, whichever model's selected
+	PartitionedConvolver& getConvolver() { return convolver_; }
+
 	template <typename T>
 	constexpr T& reverb_as() {
 		return std::get<T>(reverb_);
 	}
 
 private:
-	std::variant<         //<
-	    reverb::Freeverb, //<
-	    reverb::Mutable   //<
+	PartitionedConvolver convolver_;
+
+	std::variant<           //<
+	    reverb::Freeverb,   //<
+	    reverb::Mutable,    //<
+	    reverb::FDN,        //<
+	    reverb::Convolution //<
 	    >
 	    reverb_{};
 
@@ -103,5 +136,6 @@ private:
 	float damping_;
 	float width_;
 	float hpf_;
+	reverb::FDN::Rate fdn_rate_ = reverb::FDN::Rate::HALF;
 };
 } // namespace deluge::dsp
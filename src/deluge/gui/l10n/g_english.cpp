@@ -363,6 +363,8 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_SAMPLE_PREVIEW, "Sample preview"},
         {STRING_FOR_PLAY_CURSOR, "Play-cursor"},
         {STRING_FOR_FIRMWARE_VERSION, "Firmware version"},
+        {STRING_FOR_MEMORY_STATS, "Memory stats"},
+        {STRING_FOR_CPU_METER, "CPU meter"},
         {STRING_FOR_COMMUNITY_FTS, "Community features"},
         {STRING_FOR_MIDI_THRU, "MIDI-thru"},
         {STRING_FOR_TAKEOVER, "TAKEOVER"},
@@ -439,6 +441,11 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_COMMUNITY_FEATURE_DX_SHORTCUTS, "Enable DX shortcuts"},
         {STRING_FOR_COMMUNITY_FEATURE_KEYBOARD_VIEW_SIDEBAR_MENU_EXIT, "Enable KB View Sidebar Menu Exit"},
         {STRING_FOR_COMMUNITY_FEATURE_LAUNCH_EVENT_PLAYHEAD, "Enable Launch Event Playhead"},
+        {STRING_FOR_COMMUNITY_FEATURE_SUB_BLOCK_MODULATION, "Sub-block Modulation"},
+        {STRING_FOR_COMMUNITY_FEATURE_SAMPLE_PREFETCH, "Sample Prefetch"},
+        {STRING_FOR_COMMUNITY_FEATURE_SAMPLE_CACHE_ON_CARD, "Sample Cache on Card"},
+        {STRING_FOR_COMMUNITY_FEATURE_TIMED_MIDI_INPUT, "Timed MIDI Input"},
+        {STRING_FOR_COMMUNITY_FEATURE_BINARY_SONG_COPIES, "Binary Song Copies"},
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "Track still has clips in session"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "Delete all track's clips first"},
         {STRING_FOR_CANT_DELETE_FINAL_CLIP, "Can't delete final Clip"},
@@ -501,6 +508,8 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_WIDTH, "WIDTH"},
         {STRING_FOR_REVERB_WIDTH, "Reverb width"},
         {STRING_FOR_REVERB_PAN, "Reverb pan"},
+        {STRING_FOR_REVERB_RATE, "Reverb rate"},
+        {STRING_FOR_REVERB_IR_FILE, "Reverb IR file"},
         {STRING_FOR_SATURATION, "SATURATION"},
         {STRING_FOR_BANK, "BANK"},
         {STRING_FOR_MIDI_BANK, "MIDI bank"},
@@ -668,6 +677,7 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_INDEPENDENT, "Independent"},
         {STRING_FOR_LINEAR, "Linear"},
         {STRING_FOR_SINC, "Sinc"},
+        {STRING_FOR_SINC_24_BIT, "Sinc 24-bit"},
         {STRING_FOR_MPE_OUTPUT, "MPE output"},
         {STRING_FOR_MPE_INPUT, "MPE input"},
         {STRING_FOR_SUBTRACTIVE, "Subtractive"},
@@ -752,6 +762,12 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_MODEL, "Model"},
         {STRING_FOR_FREEVERB, "Freeverb"},
         {STRING_FOR_MUTABLE, "Mutable"},
+        {STRING_FOR_FDN, "FDN"},
+        {STRING_FOR_FULL_RATE, "Full"},
+        {STRING_FOR_HALF_RATE, "Half"},
+        {STRING_FOR_QUARTER_RATE, "Quarter"},
+        {STRING_FOR_IMPULSE_RESPONSE, "IR"},
+        {STRING_FOR_IR_FILE, "IR FILE"},
         {STRING_FOR_DIFFUSION, "Diffusion"},
         {STRING_FOR_TIME, "Time"},
         {STRING_FOR_MASTER, "Master"},
@@ -284,6 +284,8 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_SAMPLE_PREVIEW, "PREV"},
         {STRING_FOR_PLAY_CURSOR, "CURS"},
         {STRING_FOR_FIRMWARE_VERSION, "FIRM"},
+        {STRING_FOR_MEMORY_STATS, "MEM"},
+        {STRING_FOR_CPU_METER, "CPU"},
         {STRING_FOR_COMMUNITY_FTS, "FEAT"},
         {STRING_FOR_MIDI_THRU, "THRU"},
         {STRING_FOR_TAKEOVER, "TOVR"},
@@ -362,6 +364,11 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_COMMUNITY_FEATURE_DX_SHORTCUTS, "DX7S"},
         {STRING_FOR_COMMUNITY_FEATURE_KEYBOARD_VIEW_SIDEBAR_MENU_EXIT, "EXIT"},
         {STRING_FOR_COMMUNITY_FEATURE_LAUNCH_EVENT_PLAYHEAD, "PLAY"},
+        {STRING_FOR_COMMUNITY_FEATURE_SUB_BLOCK_MODULATION, "SUBB"},
+        {STRING_FOR_COMMUNITY_FEATURE_SAMPLE_PREFETCH, "PREF"},
+        {STRING_FOR_COMMUNITY_FEATURE_SAMPLE_CACHE_ON_CARD, "CACH"},
+        {STRING_FOR_COMMUNITY_FEATURE_TIMED_MIDI_INPUT, "MTIM"},
+        {STRING_FOR_COMMUNITY_FEATURE_BINARY_SONG_COPIES, "BSNG"},
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "CANT"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "CANT"},
         {STRING_FOR_CANT_DELETE_FINAL_CLIP, "CANT"},
@@ -413,6 +420,12 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_MODEL, "MODE"},
         {STRING_FOR_FREEVERB, "FVRB"},
         {STRING_FOR_MUTABLE, "MTBL"},
+        {STRING_FOR_FDN, "FDN"},
+        {STRING_FOR_FULL_RATE, "FULL"},
+        {STRING_FOR_HALF_RATE, "HALF"},
+        {STRING_FOR_QUARTER_RATE, "QRTR"},
+        {STRING_FOR_IMPULSE_RESPONSE, "IR"},
+        {STRING_FOR_IR_FILE, "FILE"},
         {STRING_FOR_DIFFUSION, "DIFF"},
         {STRING_FOR_TIME, "TIME"},
         {STRING_FOR_MASTER, "MSTR"},
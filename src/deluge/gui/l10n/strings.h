@@ -385,6 +385,8 @@ enum class String : size_t {
 	STRING_FOR_SAMPLE_PREVIEW,
 	STRING_FOR_PLAY_CURSOR,
 	STRING_FOR_FIRMWARE_VERSION,
+	STRING_FOR_MEMORY_STATS,
+	STRING_FOR_CPU_METER,
 	STRING_FOR_COMMUNITY_FTS,
 	STRING_FOR_MIDI_THRU,
 	STRING_FOR_TAKEOVER,
@@ -463,6 +465,11 @@ enum class String : size_t {
 	STRING_FOR_COMMUNITY_FEATURE_DX_SHORTCUTS,
 	STRING_FOR_COMMUNITY_FEATURE_KEYBOARD_VIEW_SIDEBAR_MENU_EXIT,
 	STRING_FOR_COMMUNITY_FEATURE_LAUNCH_EVENT_PLAYHEAD,
+	STRING_FOR_COMMUNITY_FEATURE_SUB_BLOCK_MODULATION,
+	STRING_FOR_COMMUNITY_FEATURE_SAMPLE_PREFETCH,
+	STRING_FOR_COMMUNITY_FEATURE_SAMPLE_CACHE_ON_CARD,
+	STRING_FOR_COMMUNITY_FEATURE_TIMED_MIDI_INPUT,
+	STRING_FOR_COMMUNITY_FEATURE_BINARY_SONG_COPIES,
 
 	STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION,
 	STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST,
@@ -539,6 +546,8 @@ enum class String : size_t {
 	STRING_FOR_WIDTH,
 	STRING_FOR_REVERB_WIDTH,
 	STRING_FOR_REVERB_PAN,
+	STRING_FOR_REVERB_RATE,
+	STRING_FOR_REVERB_IR_FILE,
 	STRING_FOR_SATURATION,
 	STRING_FOR_DECIMATION,
 	STRING_FOR_BANK,
@@ -724,6 +733,7 @@ enum class String : size_t {
 	STRING_FOR_INDEPENDENT,
 	STRING_FOR_LINEAR,
 	STRING_FOR_SINC,
+	STRING_FOR_SINC_24_BIT,
 	STRING_FOR_MPE_OUTPUT,
 	STRING_FOR_MPE_INPUT,
 	STRING_FOR_SUBTRACTIVE,
@@ -848,6 +858,12 @@ enum class String : size_t {
 	STRING_FOR_MODEL,
 	STRING_FOR_FREEVERB,
 	STRING_FOR_MUTABLE,
+	STRING_FOR_FDN,
+	STRING_FOR_FULL_RATE,
+	STRING_FOR_HALF_RATE,
+	STRING_FOR_QUARTER_RATE,
+	STRING_FOR_IMPULSE_RESPONSE,
+	STRING_FOR_IR_FILE,
 	STRING_FOR_DIFFUSION,
 	STRING_FOR_TIME,
 
@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cpu_meter_stats.h"
+#include "definitions_cxx.hpp"
+#include "model/drum/drum.h"
+#include "model/instrument/kit.h"
+#include "model/output.h"
+#include "model/song/song.h"
+#include "processing/engines/cpu_meter.h"
+#include "processing/sound/sound_drum.h"
+
+namespace deluge::gui::menu_item {
+
+void CPUMeterStats::takeSnapshot() {
+	addLine("over %lus", CPUMeter::getNumSamplesMeasured() / kSampleRate);
+
+	// Before the Outputs, which there can be more of than will fit
+	uint32_t masterTotal = CPUMeter::getPerMille(CPUMeter::master.total());
+	addLine("master %lu.%lu%%", masterTotal / 10, masterTotal % 10);
+
+	if (currentSong != nullptr) {
+		for (Output* output = currentSong->firstOutput; output; output = output->next) {
+			uint32_t total = CPUMeter::getPerMille(output->cpuMeter.total());
+			uint32_t peak = CPUMeter::getPeakPerMille(output->cpuMeter.peakCyclesPerSample);
+			addLine("%.8s %lu.%lu%% pk %lu%%", output->name.get(), total / 10, total % 10, peak / 10);
+			if (output->type != OutputType::KIT) {
+				continue;
+			}
+			for (Drum* drum = static_cast<Kit*>(output)->firstDrum; drum; drum = drum->next) {
+				if (drum->type == DrumType::SOUND) {
+					SoundDrum* soundDrum = static_cast<SoundDrum*>(drum);
+					total = CPUMeter::getPerMille(soundDrum->cpuMeter.total());
+					addLine(" %.12s %lu.%lu%%", soundDrum->name.get(), total / 10, total % 10);
+				}
+			}
+		}
+	}
+
+	// So that next time, it's what's happened since now
+	CPUMeter::reset();
+}
+
+} // namespace deluge::gui::menu_item
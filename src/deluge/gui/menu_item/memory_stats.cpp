@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory_stats.h"
+#include "memory/general_memory_allocator.h"
+
+extern "C" {
+#include "RZA1/ostm/ostm.h"
+}
+
+namespace deluge::gui::menu_item {
+
+void MemoryStats::takeSnapshot() {
+	GeneralMemoryAllocator& allocator = GeneralMemoryAllocator::get();
+
+	for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+		MemoryRegionStats stats = allocator.getRegionStats(r);
+		addLine("%s", GeneralMemoryAllocator::getRegionName(r));
+		addLine(" free %luK/%luK", stats.freeBytes >> 10, stats.size >> 10);
+		addLine(" largest %luK", stats.largestFreeRun >> 10);
+		addLine(" frag %lu.%lu%%", stats.fragmentation / 10, stats.fragmentation % 10);
+		addLine(" alloc %luK (%lu)", stats.allocatedBytes >> 10, stats.numAllocations);
+		addLine(" steal %luK (%lu)", stats.stealableBytes >> 10, stats.numStealables);
+		addLine(" reclaim %lu (%lu fail)", stats.reclaim.numReclaims, stats.reclaim.numFailed);
+		addLine(" max %luus", stats.reclaim.maxTime / (DELUGE_CLOCKS_PER / 1000000));
+	}
+
+	for (int32_t t = 0; t < kNumSlabPoolTypes; t++) {
+		SlabPoolStats stats = allocator.getSlabPoolStats(static_cast<SlabPoolType>(t));
+		addLine("slab %lu %lu/%lu pk %lu", stats.objectSize, stats.numInUse, stats.capacity, stats.peakInUse);
+	}
+}
+
+} // namespace deluge::gui::menu_item
@@ -27,5 +27,10 @@ public:
 	void readCurrentValue() override { this->setValue(std::round(AudioEngine::reverb.getDamping() * kMaxMenuValue)); }
 	void writeCurrentValue() override { AudioEngine::reverb.setDamping((float)this->getValue() / kMaxMenuValue); }
 	[[nodiscard]] int32_t getMaxValue() const override { return kMaxMenuValue; }
+
+	// The IR is the whole of the room
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
+		return (AudioEngine::reverb.getModel() != dsp::Reverb::Model::IMPULSE_RESPONSE);
+	}
 };
 } // namespace deluge::gui::menu_item::reverb
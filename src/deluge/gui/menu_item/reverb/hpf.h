@@ -33,7 +33,7 @@ public:
 	[[nodiscard]] int32_t getMaxValue() const override { return kMaxMenuValue; }
 
 	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
-		return (AudioEngine::reverb.getModel() == dsp::Reverb::Model::MUTABLE);
+		return (AudioEngine::reverb.getModel() != dsp::Reverb::Model::FREEVERB);
 	}
 };
 } // namespace deluge::gui::menu_item::reverb
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "impulse_response.h"
+#include "dsp/reverb/reverb.hpp"
+#include "hid/display/display.h"
+#include "model/song/song.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+#include <cstring>
+
+namespace deluge::gui::menu_item::reverb {
+
+void ImpulseResponse::beginSession(MenuItem* navigatedBackwardFrom) {
+	fileNames_.clear();
+	fileNameOffsets_.clear();
+
+	// No folder just means there's only NONE to pick
+	if (f_opendir(&staticDIR, kFolder) == FR_OK) {
+		while (f_readdir(&staticDIR, &staticFNO) == FR_OK && staticFNO.fname[0] != 0) {
+			audioFileManager.loadAnyEnqueuedClusters();
+			if (staticFNO.fattrib & AM_DIR || !isAudioFilename(staticFNO.fname)) {
+				continue;
+			}
+			fileNameOffsets_.push_back(fileNames_.size());
+			fileNames_.insert(fileNames_.end(), staticFNO.fname, staticFNO.fname + strlen(staticFNO.fname) + 1);
+		}
+		f_closedir(&staticDIR);
+	}
+
+	Selection::beginSession(navigatedBackwardFrom);
+}
+
+void ImpulseResponse::readCurrentValue() {
+	this->setValue(0);
+	char const* path = currentSong->reverbImpulseResponsePath.get();
+	size_t folderLength = strlen(kFolder);
+	if (strncmp(path, kFolder, folderLength) || path[folderLength] != '/') {
+		return;
+	}
+	for (size_t i = 0; i < fileNameOffsets_.size(); i++) {
+		if (!strcmp(&path[folderLength + 1], &fileNames_[fileNameOffsets_[i]])) {
+			this->setValue(i + 1);
+			return;
+		}
+	}
+}
+
+void ImpulseResponse::writeCurrentValue() {
+	String& path = currentSong->reverbImpulseResponsePath;
+	int32_t value = this->getValue();
+	if (value == 0) {
+		path.clear();
+	}
+	else {
+		Error error = path.set(kFolder);
+		if (error == Error::NONE) {
+			error = path.concatenate("/");
+		}
+		if (error == Error::NONE) {
+			error = path.concatenate(&fileNames_[fileNameOffsets_[value - 1]]);
+		}
+		if (error != Error::NONE) {
+			display->displayError(error);
+			return;
+		}
+	}
+
+	Error error = AudioEngine::loadReverbImpulseResponse(&path);
+	if (error != Error::NONE) {
+		display->displayError(error);
+	}
+}
+
+deluge::vector<std::string_view> ImpulseResponse::getOptions() {
+	deluge::vector<std::string_view> options{l10n::getView(l10n::String::STRING_FOR_NONE)};
+	for (size_t offset : fileNameOffsets_) {
+		options.push_back(&fileNames_[offset]);
+	}
+	return options;
+}
+
+bool ImpulseResponse::isRelevant(ModControllableAudio* modControllable, int32_t whichThing) {
+	return (AudioEngine::reverb.getModel() == dsp::Reverb::Model::IMPULSE_RESPONSE);
+}
+
+} // namespace deluge::gui::menu_item::reverb
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "gui/menu_item/selection.h"
+#include "util/containers.h"
+#include <string_view>
+
+namespace deluge::gui::menu_item::reverb {
+/// Which of the files in SAMPLES/IR the IMPULSE_RESPONSE model plays, or none. The folder's read afresh each time
+/// this is entered, so files put on the card since show up
+class ImpulseResponse final : public Selection {
+public:
+	using Selection::Selection;
+	static constexpr char const* kFolder = "SAMPLES/IR";
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override;
+	void readCurrentValue() override;
+	void writeCurrentValue() override;
+	deluge::vector<std::string_view> getOptions() override;
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override;
+
+private:
+	// Each file's name, null-terminated, one after the other
+	deluge::vector<char> fileNames_;
+	deluge::vector<size_t> fileNameOffsets_;
+};
+} // namespace deluge::gui::menu_item::reverb
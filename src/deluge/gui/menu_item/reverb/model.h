@@ -2,6 +2,8 @@
 
 #include "dsp/reverb/reverb.hpp"
 #include "gui/menu_item/selection.h"
+#include "hid/display/display.h"
+#include "model/song/song.h"
 #include "processing/engines/audio_engine.h"
 #include <string_view>
 
@@ -11,7 +13,15 @@ public:
 	using Selection::Selection;
 	void readCurrentValue() override { this->setValue(util::to_underlying(AudioEngine::reverb.getModel())); }
 	void writeCurrentValue() override {
-		AudioEngine::reverb.setModel(static_cast<dsp::Reverb::Model>(this->getValue()));
+		auto model = static_cast<dsp::Reverb::Model>(this->getValue());
+		if (model == dsp::Reverb::Model::IMPULSE_RESPONSE) {
+			// Another song's IR may have been left in the convolver, or none loaded yet
+			Error error = AudioEngine::loadReverbImpulseResponse(&currentSong->reverbImpulseResponsePath);
+			if (error != Error::NONE) {
+				display->displayError(error);
+			}
+		}
+		AudioEngine::reverb.setModel(model);
 	}
 
 	deluge::vector<std::string_view> getOptions() override {
@@ -19,6 +29,8 @@ public:
 		return {
 		    l10n::getView(STRING_FOR_FREEVERB),
 		    l10n::getView(STRING_FOR_MUTABLE),
+		    l10n::getView(STRING_FOR_FDN),
+		    l10n::getView(STRING_FOR_IMPULSE_RESPONSE),
 		};
 	}
 };
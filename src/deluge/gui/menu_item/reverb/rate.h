@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "dsp/reverb/reverb.hpp"
+#include "gui/menu_item/selection.h"
+#include "processing/engines/audio_engine.h"
+#include <string_view>
+
+namespace deluge::gui::menu_item::reverb {
+/// The sample rate the FDN's tail runs at. Lower is cheaper, and loses only the top end the damping would mostly take
+class Rate final : public Selection {
+public:
+	using Selection::Selection;
+	void readCurrentValue() override { this->setValue(util::to_underlying(AudioEngine::reverb.getRate())); }
+	void writeCurrentValue() override {
+		AudioEngine::reverb.setRate(static_cast<dsp::reverb::FDN::Rate>(this->getValue()));
+	}
+
+	deluge::vector<std::string_view> getOptions() override {
+		using enum l10n::String;
+		return {
+		    l10n::getView(STRING_FOR_FULL_RATE),
+		    l10n::getView(STRING_FOR_HALF_RATE),
+		    l10n::getView(STRING_FOR_QUARTER_RATE),
+		};
+	}
+
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
+		return (AudioEngine::reverb.getModel() == dsp::Reverb::Model::FDN);
+	}
+};
+} // namespace deluge::gui::menu_item::reverb
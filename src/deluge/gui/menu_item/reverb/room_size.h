@@ -29,10 +29,16 @@ public:
 	void writeCurrentValue() override { AudioEngine::reverb.setRoomSize((float)this->getValue() / kMaxMenuValue); }
 	[[nodiscard]] int32_t getMaxValue() const override { return kMaxMenuValue; }
 
+	// The IR is the whole of the room
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
+		return (AudioEngine::reverb.getModel() != dsp::Reverb::Model::IMPULSE_RESPONSE);
+	}
+
 	[[nodiscard]] std::string_view getName() const override {
 		using enum l10n::String;
 		switch (AudioEngine::reverb.getModel()) {
 		case dsp::Reverb::Model::MUTABLE:
+		case dsp::Reverb::Model::FDN:
 			return l10n::getView(STRING_FOR_TIME);
 		default:
 			return l10n::getView(this->name);
@@ -46,6 +46,11 @@ Setting menuEnableDxShortcuts(RuntimeFeatureSettingType::EnableDxShortcuts);
 EmulatedDisplay menuEmulatedDisplay{};
 Setting menuEnableKeyboardViewSidebarMenuExit(RuntimeFeatureSettingType::EnableKeyboardViewSidebarMenuExit);
 Setting menuEnableLaunchEventPlayhead(RuntimeFeatureSettingType::EnableLaunchEventPlayhead);
+Setting menuSubBlockModulation(RuntimeFeatureSettingType::SubBlockModulation);
+Setting menuSamplePrefetch(RuntimeFeatureSettingType::SamplePrefetch);
+Setting menuSampleCacheOnCard(RuntimeFeatureSettingType::SampleCacheOnCard);
+Setting menuTimedMIDIInput(RuntimeFeatureSettingType::TimedMIDIInput);
+Setting menuBinarySongCopies(RuntimeFeatureSettingType::BinarySongCopies);
 
 std::array<MenuItem*, RuntimeFeatureSettingType::MaxElement - kNonTopLevelSettings> subMenuEntries{
     &menuDrumRandomizer,
@@ -66,7 +71,12 @@ std::array<MenuItem*, RuntimeFeatureSettingType::MaxElement - kNonTopLevelSettin
     &menuEnableDxShortcuts,
     &menuEmulatedDisplay,
     &menuEnableKeyboardViewSidebarMenuExit,
-    &menuEnableLaunchEventPlayhead};
+    &menuEnableLaunchEventPlayhead,
+    &menuSubBlockModulation,
+    &menuSamplePrefetch,
+    &menuSampleCacheOnCard,
+    &menuTimedMIDIInput,
+    &menuBinarySongCopies};
 
 Settings::Settings(l10n::String name, l10n::String title) : menu_item::Submenu(name, title, subMenuEntries) {
 }
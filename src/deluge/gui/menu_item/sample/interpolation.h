@@ -37,7 +37,8 @@ public:
 	}
 
 	deluge::vector<std::string_view> getOptions() override {
-		return {l10n::getView(l10n::String::STRING_FOR_LINEAR), l10n::getView(l10n::String::STRING_FOR_SINC)};
+		return {l10n::getView(l10n::String::STRING_FOR_LINEAR), l10n::getView(l10n::String::STRING_FOR_SINC),
+		        l10n::getView(l10n::String::STRING_FOR_SINC_24_BIT)};
 	}
 
 	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
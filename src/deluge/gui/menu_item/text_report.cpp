@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "text_report.h"
+#include "gui/ui/ui.h"
+#include "hid/display/display.h"
+#include "util/container/static_vector.hpp"
+#include <cstdarg>
+#include <cstdio>
+
+namespace deluge::gui::menu_item {
+
+void TextReport::beginSession(MenuItem* navigatedBackwardFrom) {
+	numLines_ = 0;
+	numLinesNotShown_ = 0;
+	takeSnapshot();
+	currentLine_ = 0;
+	scrollPos_ = 0;
+	readValueAgain();
+}
+
+void TextReport::readValueAgain() {
+	if (display->haveOLED()) {
+		renderUIsForOled();
+	}
+	else {
+		drawValue();
+	}
+}
+
+void TextReport::addLine(char const* format, ...) {
+	if (numLines_ == kMaxLines) {
+		// Out of room, so the last line gives up its place to say how many lines didn't fit, itself included
+		numLinesNotShown_ = (numLinesNotShown_ != 0) ? numLinesNotShown_ + 1 : 2;
+		snprintf(lines_[kMaxLines - 1], kLineLength, "(%ld more)", numLinesNotShown_);
+		return;
+	}
+	va_list args;
+	va_start(args, format);
+	vsnprintf(lines_[numLines_++], kLineLength, format, args);
+	va_end(args);
+}
+
+void TextReport::drawPixelsForOled() {
+	static_vector<std::string_view, kMaxLines> lineViews = {};
+	for (int32_t i = 0; i < numLines_; i++) {
+		lineViews.push_back(lines_[i]);
+	}
+	drawItemsForOled(lineViews, currentLine_ - scrollPos_, scrollPos_);
+}
+
+void TextReport::drawValue() {
+	display->setScrollingText(lines_[currentLine_]);
+}
+
+void TextReport::selectEncoderAction(int32_t offset) {
+	int32_t newLine = currentLine_ + offset;
+	if (newLine < 0 || newLine >= numLines_) {
+		return;
+	}
+	currentLine_ = newLine;
+
+	if (currentLine_ < scrollPos_) {
+		scrollPos_ = currentLine_;
+	}
+	else if (currentLine_ >= scrollPos_ + kOLEDMenuNumOptionsVisible) {
+		scrollPos_++;
+	}
+
+	readValueAgain();
+}
+
+} // namespace deluge::gui::menu_item
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gui/menu_item/menu_item.h"
+
+namespace deluge::gui::menu_item {
+
+// Read-only. A list of short lines to scroll through, filled in by takeSnapshot() when the menu's entered.
+class TextReport : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+	void beginSession(MenuItem* navigatedBackwardFrom) override;
+	void readValueAgain() override;
+	void selectEncoderAction(int32_t offset) override;
+	void drawPixelsForOled() override;
+	void drawValue();
+
+protected:
+	virtual void takeSnapshot() = 0;
+	void addLine(char const* format, ...);
+
+private:
+	static constexpr int32_t kMaxLines = 32;
+	static constexpr int32_t kLineLength = 24;
+
+	char lines_[kMaxLines][kLineLength];
+	int32_t numLines_ = 0;
+	int32_t numLinesNotShown_ = 0;
+	int32_t currentLine_ = 0;
+	int32_t scrollPos_ = 0;
+};
+
+} // namespace deluge::gui::menu_item
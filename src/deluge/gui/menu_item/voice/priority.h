@@ -18,6 +18,9 @@
 #include "definitions_cxx.hpp"
 #include "gui/menu_item/selection.h"
 #include "gui/ui/sound_editor.h"
+#include "model/voice/voice_priority_queue.h"
+#include "processing/engines/audio_engine.h"
+#include "processing/sound/sound.h"
 #include "util/misc.h"
 
 namespace deluge::gui::menu_item::voice {
@@ -25,7 +28,13 @@ class Priority final : public Selection {
 public:
 	using Selection::Selection;
 	void readCurrentValue() override { this->setValue(*soundEditor.currentPriority); }
-	void writeCurrentValue() override { *soundEditor.currentPriority = this->getValue<VoicePriority>(); }
+	void writeCurrentValue() override {
+		*soundEditor.currentPriority = this->getValue<VoicePriority>();
+		// Part of every one of the Sound's Voices' priority ratings
+		if (soundEditor.currentSound) {
+			AudioEngine::voicePriorityQueue.updateAllForSound(soundEditor.currentSound);
+		}
+	}
 	deluge::vector<std::string_view> getOptions() override {
 		return {
 		    l10n::getView(l10n::String::STRING_FOR_LOW),
@@ -41,6 +41,7 @@
 #include "storage/audio/audio_file_manager.h"
 #include "storage/multi_range/multisample_range.h"
 #include "storage/storage_manager.h"
+#include "task_scheduler.h"
 #include <string.h>
 
 AudioRecorder audioRecorder{};
@@ -175,7 +176,7 @@ void AudioRecorder::endRecordingSoon(int32_t buttonLatency) {
 
 void AudioRecorder::slowRoutine() {
 	if (recordingSource >= AUDIO_INPUT_CHANNEL_FIRST_INTERNAL_OPTION) {
-		if (recorder->status >= RecorderStatus::COMPLETE) {
+		if (recorder->status >= RecorderStatus::COMPLETE && !recorder->alteringFile) {
 			indicator_leds::setLedState(IndicatorLED::RECORD, (playbackHandler.recording == RecordingMode::NORMAL));
 			finishRecording();
 		}
@@ -185,21 +186,11 @@ void AudioRecorder::slowRoutine() {
 void AudioRecorder::process() {
 	while (true) {
 
-		AudioEngine::routineWithClusterLoading();
-
-		uiTimerManager.routine();
-
-		if (display->haveOLED()) {
-			oledRoutine();
-		}
-		PIC::flush();
-
-		readButtonsAndPads();
-
-		AudioEngine::slowRoutine();
+		// Lets everything else run - including the recorder finishing off its file, which happens in a task of its own
+		yield([]() { return true; });
 
 		// If recording has finished...
-		if (recorder->status >= RecorderStatus::COMPLETE || recorder->hadCardError) {
+		if ((recorder->status >= RecorderStatus::COMPLETE || recorder->hadCardError) && !recorder->alteringFile) {
 
 			if (recorder->status == RecorderStatus::ABORTED || recorder->hadCardError) {}
 
@@ -246,7 +246,16 @@ void LoadSongUI::performLoad(StorageManager& bdsm) {
 		playbackHandler.switchToSession();
 	}
 
-	Error error = storageManager.openXMLFile(&currentFileItem->filePointer, smDeserializer, "song");
+	String filePath;
+	Error error = getCurrentFilePath(&filePath);
+	if (error != Error::NONE) {
+		display->displayError(error);
+		return;
+	}
+
+	// Reads a binary copy of the song instead of the XML, if there's an up to date one and they're switched on
+	Deserializer* reader;
+	error = storageManager.openSongFile(&currentFileItem->filePointer, filePath.get(), &reader);
 	if (error != Error::NONE) {
 		display->displayError(error);
 		return;
@@ -284,7 +293,7 @@ ramError:
 
 someError:
 		display->displayError(error);
-		storageManager.closeFile();
+		storageManager.closeSongFile(*reader);
 fail:
 		// If we already deleted the old song, make a new blank one. This will take us back to InstrumentClipView.
 		if (!currentSong) {
@@ -319,13 +328,13 @@ gotErrorAfterCreatingSong:
 
 	// Will return false if we ran out of RAM. This isn't currently detected for while loading ParamNodes, but chances
 	// are, after failing on one of those, it'd try to load something else and that would fail.
-	error = preLoadedSong->readFromFile(smDeserializer);
+	error = preLoadedSong->readFromFile(*reader);
 	if (error != Error::NONE) {
 		goto gotErrorAfterCreatingSong;
 	}
 	AudioEngine::logAction("read new song from file");
 
-	bool success = storageManager.closeFile();
+	bool success = storageManager.closeSongFile(*reader);
 
 	if (!success) {
 		display->displayPopup(deluge::l10n::get(deluge::l10n::String::STRING_FOR_ERROR_LOADING_SONG));
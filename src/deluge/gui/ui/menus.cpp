@@ -24,6 +24,7 @@
 #include "gui/menu_item/bend_range/main.h"
 #include "gui/menu_item/bend_range/per_finger.h"
 #include "gui/menu_item/colour.h"
+#include "gui/menu_item/cpu_meter_stats.h"
 #include "gui/menu_item/cv/selection.h"
 #include "gui/menu_item/cv/submenu.h"
 #include "gui/menu_item/cv/transpose.h"
@@ -70,6 +71,7 @@
 #include "gui/menu_item/lfo/sync.h"
 #include "gui/menu_item/lfo/type.h"
 #include "gui/menu_item/master_transpose.h"
+#include "gui/menu_item/memory_stats.h"
 #include "gui/menu_item/menu_item.h"
 #include "gui/menu_item/midi/after_touch_to_mono.h"
 #include "gui/menu_item/midi/bank.h"
@@ -114,8 +116,10 @@
 #include "gui/menu_item/record/quantize.h"
 #include "gui/menu_item/reverb/damping.h"
 #include "gui/menu_item/reverb/hpf.h"
+#include "gui/menu_item/reverb/impulse_response.h"
 #include "gui/menu_item/reverb/model.h"
 #include "gui/menu_item/reverb/pan.h"
+#include "gui/menu_item/reverb/rate.h"
 #include "gui/menu_item/reverb/room_size.h"
 #include "gui/menu_item/reverb/sidechain/shape.h"
 #include "gui/menu_item/reverb/sidechain/volume.h"
@@ -393,6 +397,8 @@ reverb::Width reverbWidthMenu{STRING_FOR_WIDTH, STRING_FOR_REVERB_WIDTH};
 reverb::Pan reverbPanMenu{STRING_FOR_PAN, STRING_FOR_REVERB_PAN};
 reverb::Model reverbModelMenu{STRING_FOR_MODEL};
 reverb::HPF reverbHPFMenu{STRING_FOR_HPF};
+reverb::Rate reverbRateMenu{STRING_FOR_RATE, STRING_FOR_REVERB_RATE};
+reverb::ImpulseResponse reverbImpulseResponseMenu{STRING_FOR_IR_FILE, STRING_FOR_REVERB_IR_FILE};
 
 Submenu reverbMenu{
     STRING_FOR_REVERB,
@@ -403,6 +409,8 @@ Submenu reverbMenu{
         &reverbDampingMenu,
         &reverbWidthMenu,
         &reverbHPFMenu,
+        &reverbRateMenu,
+        &reverbImpulseResponseMenu,
         &reverbPanMenu,
         &reverbSidechainMenu,
     },
@@ -548,6 +556,8 @@ Submenu globalReverbMenu{
         &reverbDampingMenu,
         &reverbWidthMenu,
         &reverbHPFMenu,
+        &reverbRateMenu,
+        &reverbImpulseResponseMenu,
         &reverbPanMenu,
         &reverbSidechainMenu,
     },
@@ -739,6 +749,9 @@ flash::Status flashStatusMenu{STRING_FOR_PLAY_CURSOR};
 
 firmware::Version firmwareVersionMenu{STRING_FOR_FIRMWARE_VERSION, STRING_FOR_FIRMWARE_VER_MENU_TITLE};
 
+MemoryStats memoryStatsMenu{STRING_FOR_MEMORY_STATS};
+CPUMeterStats cpuMeterMenu{STRING_FOR_CPU_METER};
+
 runtime_feature::Settings runtimeFeatureSettingsMenu{STRING_FOR_COMMUNITY_FTS, STRING_FOR_COMMUNITY_FTS_MENU_TITLE};
 
 // CV menu
@@ -1213,6 +1226,8 @@ Submenu settingsRootMenu{
         &flashStatusMenu,
         &recordSubmenu,
         &runtimeFeatureSettingsMenu,
+        &memoryStatsMenu,
+        &cpuMeterMenu,
         &firmwareVersionMenu,
     },
 };
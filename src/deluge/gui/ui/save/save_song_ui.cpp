@@ -457,6 +457,8 @@ cardError:
 		}
 	}
 
+	bdsm.writeBinaryCopyOfSong(filePath.get());
+
 	display->removeWorkingAnimation();
 	char const* message = anyErrorMovingTempFiles
 	                          ? (deluge::l10n::get(deluge::l10n::String::STRING_FOR_ERROR_MOVING_TEMP_FILES))
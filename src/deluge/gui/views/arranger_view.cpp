@@ -46,6 +46,7 @@
 #include "io/debug/log.h"
 #include "io/midi/device_specific/specific_midi_device.h"
 #include "io/midi/midi_engine.h"
+#include "io/midi/midi_routing_index.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action_logger.h"
 #include "model/clip/audio_clip.h"
@@ -2887,6 +2888,7 @@ ActionResult ArrangerView::verticalScrollOneSquare(int32_t direction) {
 
 	// If an Output is selected, drag it against the scroll
 	if (draggingWholeRow) {
+		midiRoutingIndex.invalidate(); // It has the Outputs in order
 
 		// Shift Output up
 		if (direction >= 0) {
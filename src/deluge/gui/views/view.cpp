@@ -51,6 +51,7 @@
 #include "io/midi/midi_device_manager.h"
 #include "io/midi/midi_engine.h"
 #include "io/midi/midi_follow.h"
+#include "io/midi/midi_routing_index.h"
 #include "lib/printf.h"
 #include "model/action/action_logger.h"
 #include "model/clip/audio_clip.h"
@@ -634,6 +635,7 @@ recordDetailsOfLearnedThing:
 			learnedThing->device = fromDevice;
 			learnedThing->channelOrZone = channelOrZone;
 			learnedThing->noteOrCC = note;
+			midiRoutingIndex.invalidate();
 			break;
 
 		case MidiLearn::INSTRUMENT_INPUT:
@@ -729,6 +731,7 @@ isMPEZone:
 			learnedThing->channelOrZone = channelOrZone;
 			learnedThing->device = fromDevice;
 			learnedThing->noteOrCC = note;                    // used for low note in kits
+			midiRoutingIndex.invalidate();
 			instrumentPressedForMIDILearn->beenEdited(false); // Why again?
 
 			if (instrumentPressedForMIDILearn->type == OutputType::SYNTH) {
@@ -778,6 +781,7 @@ void View::ccReceivedForMIDILearn(MIDIDevice* fromDevice, int32_t channel, int32
 				if (highestMIDIChannelSeenWhileLearning < lowestMIDIChannelSeenWhileLearning) {
 					learnedThing->device = fromDevice;
 					learnedThing->channelOrZone = channel;
+					midiRoutingIndex.invalidate();
 					getCurrentInstrument()->beenEdited(false);
 				}
 			}
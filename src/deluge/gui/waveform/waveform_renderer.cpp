@@ -25,6 +25,7 @@
 #include "model/voice/voice_sample.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/sample_peaks_builder.h"
 #include "storage/cluster/cluster.h"
 #include "storage/multi_range/multisample_range.h"
 #include <optional>
@@ -246,6 +247,12 @@ bool WaveformRenderer::findPeaksPerCol(Sample* sample, int64_t xScrollSamples, u
 
 	uint64_t numValidBytes = numValidSamples * sample->byteDepth * sample->numChannels;
 
+	// Zoomed out far enough that reading actual audio for each column would be slow, get peaks made for next time.
+	// (A recording makes its own as it goes.)
+	if (!recorder && xZoomSamples >= SamplePeaks::kFramesPerBaseEntry) {
+		samplePeaksBuilder.request(sample);
+	}
+
 	bool hadAnyTroubleLoading = false;
 
 	for (int32_t col = xStart; col < xEnd; col++) {
@@ -283,6 +290,14 @@ bool WaveformRenderer::findPeaksPerCol(Sample* sample, int64_t xScrollSamples, u
 			continue;
 		}
 
+		// If the peaks cover this stretch, no need to go near the audio data
+		PeakEntry peak;
+		if (sample->peaks.getSpan(colStartSample, colEndSample, &peak)) {
+			data->minPerCol[col] = (int32_t)peak.min << 16;
+			data->maxPerCol[col] = (int32_t)peak.max << 16;
+			continue;
+		}
+
 		int32_t colStartByte =
 		    colStartSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
 		int32_t colEndByte = colEndSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
@@ -627,7 +627,7 @@ void SevenSegment::setTextVeryBasicA1(char const* text) {
 	PIC::update7SEG(segments);
 }
 
-// Highest error code used, main branch: E453
+// Highest error code used, main branch: E459
 // Highest error code used, fix branch: i041
 
 void SevenSegment::freezeWithError(char const* text) {
@@ -25,10 +25,13 @@
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_device_manager.h"
 #include "io/midi/sysex.h"
+#include "io/midi/timed_input.h"
 #include "mem_functions.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "playback/mode/playback_mode.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/stem_export/stem_export.h"
 #include "version.h"
 
 extern "C" {
@@ -687,8 +690,8 @@ bool MidiEngine::checkIncomingSerialMidi() {
 		if (getMidiMessageLength(serialMidiInput[0]) == numSerialMidiInput) {
 			uint8_t channel = serialMidiInput[0] & 0x0F;
 
-			midiMessageReceived(&MIDIDeviceManager::dinMIDIPorts, serialMidiInput[0] >> 4, channel, serialMidiInput[1],
-			                    serialMidiInput[2], timer);
+			channelMessageReceived(TIMED_INPUT_DIN, &MIDIDeviceManager::dinMIDIPorts, serialMidiInput[0] >> 4, channel,
+			                       serialMidiInput[1], serialMidiInput[2], timer);
 
 			// If message was more than 1 byte long, and was a voice or mode message, then allow for running status
 			if (numSerialMidiInput > 1 && ((serialMidiInput[0] & 0xF0) != 0xF0)) {
@@ -899,8 +902,8 @@ void MidiEngine::checkIncomingUsbMidi() {
 							// fallback to cable 0 since we don't support more than one port on hosted devices yet
 							cable = 0;
 						}
-						midiMessageReceived(connectedUSBMIDIDevices[ip][d].device[cable], statusType, channel, data1,
-						                    data2, &timeLastBRDY[ip]);
+						channelMessageReceived(TIMED_INPUT_USB, connectedUSBMIDIDevices[ip][d].device[cable], statusType,
+						                       channel, data1, data2, &timeLastBRDY[ip]);
 					}
 				}
 
@@ -940,6 +943,59 @@ void MidiEngine::checkIncomingUsbMidi() {
 	}
 }
 
+void MidiEngine::channelMessageReceived(TimedInputPort port, MIDIDevice* fromDevice, uint8_t statusType,
+                                        uint8_t channel, uint8_t data1, uint8_t data2, uint32_t* timer) {
+	// Only notes get held back - they're what the timing's heard in. Everything else gets actioned now, from the main
+	// loop as ever, since plenty of it (learning, program changes, global commands) is for the UI rather than the
+	// render. And a stem export renders faster than time goes by, so can't wait on anything
+	bool mayHoldBack = (timer != nullptr && !stemExport.processStarted
+	                    && runtimeFeatureSettings.isOn(RuntimeFeatureSettingType::TimedMIDIInput));
+	uint32_t time = mayHoldBack ? AudioEngine::getRenderTimeForTxBufferPos(*timer) : 0;
+	TimedMessage message{fromDevice, time, statusType, channel, data1, data2};
+
+	// This takes the consumer's side of the ring from the producer's, if it has to flush it. That's fine because both
+	// are only ever called from the main loop - the input polls, sometimes from within the audio routine but never
+	// interrupting it
+	if (holdBackTimedInput(timedInput_[port], message, mayHoldBack, [this](TimedMessage const& due) {
+		    midiMessageReceived(due.device, due.statusType, due.channel, due.data1, due.data2);
+	    })) {
+		return;
+	}
+	midiMessageReceived(fromDevice, statusType, channel, data1, data2, timer);
+}
+
+void MidiEngine::actionDueTimedInput(size_t& numSamples) {
+	while (true) {
+		// Whichever port has the earliest note waiting
+		deluge::SPSCRing<TimedMessage, 128>* earliestPort = nullptr;
+		int32_t earliestTimeTil = 0;
+		for (auto& port : timedInput_) {
+			TimedMessage const* message = port.front();
+			if (message == nullptr) {
+				continue;
+			}
+			int32_t timeTil = message->time - AudioEngine::audioSampleTimer;
+			if (earliestPort == nullptr || timeTil < earliestTimeTil) {
+				earliestPort = &port;
+				earliestTimeTil = timeTil;
+			}
+		}
+		if (earliestPort == nullptr) {
+			return;
+		}
+
+		// Not due yet, so end the window where it is
+		if (earliestTimeTil > 0) {
+			numSamples = std::min<size_t>(numSamples, earliestTimeTil);
+			return;
+		}
+
+		TimedMessage message = *earliestPort->front();
+		earliestPort->pop();
+		midiMessageReceived(message.device, message.statusType, message.channel, message.data1, message.data2);
+	}
+}
+
 int32_t MidiEngine::getMidiMessageLength(uint8_t statusByte) {
 	if (statusByte == 0xF0    // System exclusive - dynamic length
 	    || statusByte == 0xF4 // Undefined
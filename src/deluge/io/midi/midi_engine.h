@@ -22,6 +22,7 @@
 #include "definitions_cxx.hpp"
 #include "io/midi/learned_midi.h"
 #include "playback/playback_handler.h"
+#include "util/container/ring/spsc_ring.hpp"
 
 class MIDIDevice;
 class MIDIInstrument;
@@ -92,6 +93,10 @@ public:
 	void setupUSBHostReceiveTransfer(int32_t ip, int32_t midiDeviceNum);
 	void flushUSBMIDIOutput();
 
+	/// Called by the audio routine at the start of each window. Actions any held-back notes that are due, and shortens
+	/// the window so it ends where the next one is due
+	void actionDueTimedInput(size_t& numSamples);
+
 	// If bit "16" (actually bit 4) is 1, this is a program change. (Wait, still?)
 	LearnedMIDI globalMIDICommands[kNumGlobalMIDICommands];
 
@@ -123,6 +128,24 @@ private:
 	/// Top of the event stack. If this is equal to eventStack_.begin(), the stack is empty.
 	EventStackStorage::iterator eventStackTop_;
 
+	/// A note on or off held back until the render gets to the time it arrived at, plus a constant latency. Lets
+	/// incoming notes land where they were played within a render window, rather than at the start of the next one
+	struct TimedMessage {
+		MIDIDevice* device;
+		uint32_t time; // In audioSampleTimer terms
+		uint8_t statusType;
+		uint8_t channel;
+		uint8_t data1;
+		uint8_t data2;
+	};
+	enum TimedInputPort : uint8_t { TIMED_INPUT_DIN, TIMED_INPUT_USB, kNumTimedInputPorts };
+
+	/// One per port, each filled as that port's input is read and emptied by the audio routine
+	std::array<deluge::SPSCRing<TimedMessage, 128>, kNumTimedInputPorts> timedInput_;
+
+	void channelMessageReceived(TimedInputPort port, MIDIDevice* fromDevice, uint8_t statusType, uint8_t channel,
+	                            uint8_t data1, uint8_t data2, uint32_t* timer);
+
 	int32_t getMidiMessageLength(uint8_t statusuint8_t);
 	void midiMessageReceived(MIDIDevice* fromDevice, uint8_t statusType, uint8_t channel, uint8_t data1, uint8_t data2,
 	                         uint32_t* timer = NULL);
@@ -90,6 +90,7 @@ void MidiFollow::init() {
 	successfullyReadDefaultsFromFile = false;
 
 	initMapping(paramToCC);
+	indexParamToCC();
 
 	for (int32_t i = 0; i < (kMaxMIDIValue + 1); i++) {
 		timeLastCCSent[i] = 0;
@@ -107,6 +108,32 @@ void MidiFollow::initMapping(int32_t mapping[kDisplayWidth][kDisplayHeight]) {
 	}
 }
 
+void MidiFollow::indexParamToCC() {
+	std::array<uint8_t, kMaxMIDIValue + 2> numCellsBefore{};
+	for (int32_t xDisplay = 0; xDisplay < kDisplayWidth; xDisplay++) {
+		for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+			int32_t ccNumber = paramToCC[xDisplay][yDisplay];
+			if (ccNumber >= 0 && ccNumber <= kMaxMIDIValue) {
+				numCellsBefore[ccNumber + 1]++;
+			}
+		}
+	}
+	for (int32_t ccNumber = 0; ccNumber <= kMaxMIDIValue; ccNumber++) {
+		numCellsBefore[ccNumber + 1] += numCellsBefore[ccNumber];
+	}
+	firstCellForCC = numCellsBefore;
+
+	// Keeping them in grid order, as they'd be found searching it
+	for (int32_t xDisplay = 0; xDisplay < kDisplayWidth; xDisplay++) {
+		for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+			int32_t ccNumber = paramToCC[xDisplay][yDisplay];
+			if (ccNumber >= 0 && ccNumber <= kMaxMIDIValue) {
+				cellsForCC[numCellsBefore[ccNumber]++] = xDisplay * kDisplayHeight + yDisplay;
+			}
+		}
+	}
+}
+
 /// checks to see if there is an active clip for the current context
 /// cases where there is an active clip:
 /// 1) pressing and holding a clip pad in arranger view, song row view, song grid view
@@ -520,66 +547,66 @@ void MidiFollow::midiCCReceived(MIDIDevice* fromDevice, uint8_t channel, uint8_t
 void MidiFollow::handleReceivedCC(ModelStackWithTimelineCounter& modelStackWithTimelineCounter, Clip* clip,
                                   int32_t ccNumber, int32_t value) {
 
-	// loop through the grid to see if any parameters have been learned to the ccNumber received
-	for (int32_t xDisplay = 0; xDisplay < kDisplayWidth; xDisplay++) {
-		for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
-			if (paramToCC[xDisplay][yDisplay] == ccNumber) {
-				// obtain the model stack for the parameter the ccNumber received is learned to
-				ModelStackWithAutoParam* modelStackWithParam =
-				    getModelStackWithParam(&modelStackWithTimelineCounter, clip, xDisplay, yDisplay, ccNumber,
-				                           midiEngine.midiFollowDisplayParam);
-				// check if model stack is valid
-				if (modelStackWithParam && modelStackWithParam->autoParam) {
-					// get current value
-					int32_t oldValue =
-					    modelStackWithParam->autoParam->getValuePossiblyAtPos(view.modPos, modelStackWithParam);
-
-					// convert current value to knobPos to compare to cc value being received
-					int32_t knobPos =
-					    modelStackWithParam->paramCollection->paramValueToKnobPos(oldValue, modelStackWithParam);
-
-					// calculate new knob position based on value received and deluge current value
-					int32_t newKnobPos = MidiTakeover::calculateKnobPos(knobPos, value, nullptr, true, ccNumber);
-					// is the cc being received for the same value as the current knob pos? If so, do nothing
-					if (newKnobPos != knobPos) {
-						// Convert the New Knob Position to a Parameter Value
-						int32_t newValue =
-						    modelStackWithParam->paramCollection->knobPosToParamValue(newKnobPos, modelStackWithParam);
-
-						// Set the new Parameter Value for the MIDI Learned Parameter
-						modelStackWithParam->autoParam->setValuePossiblyForRegion(newValue, modelStackWithParam,
-						                                                          view.modPos, view.modLength);
-
-						// check if you're currently editing the same learned param in automation view or
-						// performance view if so, you will need to refresh the automation editor grid or the
-						// performance view
-						bool editingParamInAutomationOrPerformanceView = false;
-						RootUI* rootUI = getRootUI();
-						if (rootUI == &automationView || rootUI == &performanceSessionView) {
-							int32_t id = modelStackWithParam->paramId;
-							params::Kind kind = modelStackWithParam->paramCollection->getParamKind();
-
-							if (rootUI == &automationView) {
-								// pass the current clip because you want to check that you're editing the param
-								// for the same clip active in automation view
-								editingParamInAutomationOrPerformanceView =
-								    automationView.possiblyRefreshAutomationEditorGrid(clip, kind, id);
-							}
-							else {
-								editingParamInAutomationOrPerformanceView =
-								    performanceSessionView.possiblyRefreshPerformanceViewDisplay(kind, id, newKnobPos);
-							}
-						}
+	if (ccNumber < 0 || ccNumber > kMaxMIDIValue) {
+		return;
+	}
 
-						// check if you should display name of the parameter that was changed and the value that
-						// has been set if you're in the automation view editor or performance view non-editing
-						// mode don't display popup if you're currently editing the same param
-						if (midiEngine.midiFollowDisplayParam && !editingParamInAutomationOrPerformanceView) {
-							params::Kind kind = modelStackWithParam->paramCollection->getParamKind();
-							view.displayModEncoderValuePopup(kind, modelStackWithParam->paramId, newKnobPos);
-						}
+	// go through the grid cells that parameters have been learned to the ccNumber received in
+	for (int32_t i = firstCellForCC[ccNumber]; i < firstCellForCC[ccNumber + 1]; i++) {
+		int32_t xDisplay = cellsForCC[i] / kDisplayHeight;
+		int32_t yDisplay = cellsForCC[i] % kDisplayHeight;
+		// obtain the model stack for the parameter the ccNumber received is learned to
+		ModelStackWithAutoParam* modelStackWithParam =
+		    getModelStackWithParam(&modelStackWithTimelineCounter, clip, xDisplay, yDisplay, ccNumber,
+		                           midiEngine.midiFollowDisplayParam);
+		// check if model stack is valid
+		if (modelStackWithParam && modelStackWithParam->autoParam) {
+			// get current value
+			int32_t oldValue = modelStackWithParam->autoParam->getValuePossiblyAtPos(view.modPos, modelStackWithParam);
+
+			// convert current value to knobPos to compare to cc value being received
+			int32_t knobPos = modelStackWithParam->paramCollection->paramValueToKnobPos(oldValue, modelStackWithParam);
+
+			// calculate new knob position based on value received and deluge current value
+			int32_t newKnobPos = MidiTakeover::calculateKnobPos(knobPos, value, nullptr, true, ccNumber);
+			// is the cc being received for the same value as the current knob pos? If so, do nothing
+			if (newKnobPos != knobPos) {
+				// Convert the New Knob Position to a Parameter Value
+				int32_t newValue =
+				    modelStackWithParam->paramCollection->knobPosToParamValue(newKnobPos, modelStackWithParam);
+
+				// Set the new Parameter Value for the MIDI Learned Parameter
+				modelStackWithParam->autoParam->setValuePossiblyForRegion(newValue, modelStackWithParam, view.modPos,
+				                                                          view.modLength);
+
+				// check if you're currently editing the same learned param in automation view or
+				// performance view if so, you will need to refresh the automation editor grid or the
+				// performance view
+				bool editingParamInAutomationOrPerformanceView = false;
+				RootUI* rootUI = getRootUI();
+				if (rootUI == &automationView || rootUI == &performanceSessionView) {
+					int32_t id = modelStackWithParam->paramId;
+					params::Kind kind = modelStackWithParam->paramCollection->getParamKind();
+
+					if (rootUI == &automationView) {
+						// pass the current clip because you want to check that you're editing the param
+						// for the same clip active in automation view
+						editingParamInAutomationOrPerformanceView =
+						    automationView.possiblyRefreshAutomationEditorGrid(clip, kind, id);
+					}
+					else {
+						editingParamInAutomationOrPerformanceView =
+						    performanceSessionView.possiblyRefreshPerformanceViewDisplay(kind, id, newKnobPos);
 					}
 				}
+
+				// check if you should display name of the parameter that was changed and the value that
+				// has been set if you're in the automation view editor or performance view non-editing
+				// mode don't display popup if you're currently editing the same param
+				if (midiEngine.midiFollowDisplayParam && !editingParamInAutomationOrPerformanceView) {
+					params::Kind kind = modelStackWithParam->paramCollection->getParamKind();
+					view.displayModEncoderValuePopup(kind, modelStackWithParam->paramId, newKnobPos);
+				}
 			}
 		}
 	}
@@ -835,6 +862,7 @@ void MidiFollow::readDefaultsFromFile(StorageManager& bdsm) {
 	}
 
 	bdsm.closeFile();
+	indexParamToCC();
 
 	successfullyReadDefaultsFromFile = true;
 }
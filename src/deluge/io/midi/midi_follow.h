@@ -21,6 +21,7 @@
 #include "model/global_effectable/global_effectable.h"
 #include "modulation/params/param.h"
 #include "storage/storage_manager.h"
+#include <array>
 
 class AudioClip;
 class InstrumentClip;
@@ -57,6 +58,8 @@ public:
 	int32_t getCCFromParam(deluge::modulation::params::Kind paramKind, int32_t paramID);
 
 	int32_t paramToCC[kDisplayWidth][kDisplayHeight];
+	// Call after changing paramToCC
+	void indexParamToCC();
 	int32_t previousKnobPos[kMaxMIDIValue + 1];
 	uint32_t timeLastCCSent[kMaxMIDIValue + 1];
 	uint32_t timeAutomationFeedbackLastSent;
@@ -68,6 +71,12 @@ public:
 	void handleReceivedCC(ModelStackWithTimelineCounter& modelStack, Clip* clip, int32_t ccNumber, int32_t value);
 
 private:
+	// Which cells of paramToCC hold each CC, as x * kDisplayHeight + y, so a CC received doesn't need the whole grid
+	// searching. Those for CC n are from cellsForCC[firstCellForCC[n]] up to cellsForCC[firstCellForCC[n + 1]]
+	static_assert(kDisplayWidth * kDisplayHeight <= 255);
+	std::array<uint8_t, kMaxMIDIValue + 2> firstCellForCC;
+	std::array<uint8_t, kDisplayWidth * kDisplayHeight> cellsForCC;
+
 	// initialize
 	void init();
 	void initMapping(int32_t mapping[kDisplayWidth][kDisplayHeight]);
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/midi/midi_routing_index.h"
+#include "definitions_cxx.hpp"
+#include "io/midi/learned_midi.h"
+#include "model/clip/clip.h"
+#include "model/drum/drum.h"
+#include "model/instrument/kit.h"
+#include "model/mod_controllable/mod_controllable_audio.h"
+#include "model/song/song.h"
+#include "modulation/knob.h"
+#include "processing/audio_output.h"
+#include "processing/sound/sound_drum.h"
+#include "processing/sound/sound_instrument.h"
+#include <algorithm>
+
+MIDIRoutingIndex midiRoutingIndex{};
+
+bool MIDIRoutingIndex::anyCommandLearnedTo(int32_t channel, int32_t noteOrCC) {
+	ensureValid();
+	return containsKey(commandKeys_, makeKey(channel, noteOrCC));
+}
+
+bool MIDIRoutingIndex::anySongParamLearnedTo(int32_t channel, int32_t ccNumber) {
+	ensureValid();
+	return containsKey(songParamKeys_, makeKey(channel, ccNumber));
+}
+
+void MIDIRoutingIndex::build() {
+	commandKeys_.clear();
+	songParamKeys_.clear();
+	outputs_.clear();
+
+	Song* song = currentSong;
+	if (song) {
+		for (int32_t s = 0; s < kMaxNumSections; s++) {
+			addKey(commandKeys_, song->sections[s].launchMIDICommand);
+		}
+		for (int32_t c = 0; c < song->sessionClips.getNumElements(); c++) {
+			addKey(commandKeys_, song->sessionClips.getClipAtIndex(c)->muteMIDICommand);
+		}
+
+		MidiKnobArray& songKnobs = song->globalEffectable.midiKnobArray;
+		for (int32_t k = 0; k < songKnobs.getNumElements(); k++) {
+			addKey(songParamKeys_, songKnobs.getElement(k)->midiInput);
+		}
+
+		uint16_t order = 0;
+		for (Output* output = song->firstOutput; output; output = output->next) {
+			switch (output->type) {
+			case OutputType::SYNTH:
+				addParamEntries(output, order, (SoundInstrument*)output);
+				break;
+
+			case OutputType::KIT: {
+				Kit* kit = (Kit*)output;
+				addParamEntries(output, order, kit);
+				// A CC for a Drum goes to the Kit, which offers it on to its Drums
+				for (Drum* drum = kit->firstDrum; drum; drum = drum->next) {
+					if (drum->type == DrumType::SOUND) {
+						addParamEntries(output, order, (SoundDrum*)drum);
+					}
+					addOutputEntry(output, order, drum->midiInput, true);
+				}
+				break;
+			}
+
+			case OutputType::AUDIO:
+				addParamEntries(output, order, (AudioOutput*)output);
+				break;
+
+			default:
+				break;
+			}
+
+			if (output->type != OutputType::AUDIO) {
+				addOutputEntry(output, order, ((Instrument*)output)->midiInput, true);
+			}
+			order++;
+		}
+	}
+
+	std::sort(commandKeys_.begin(), commandKeys_.end());
+	std::sort(songParamKeys_.begin(), songParamKeys_.end());
+
+	outputs_.sort();
+
+	valid_ = true;
+}
+
+void MIDIRoutingIndex::addKey(deluge::vector<uint16_t>& keys, LearnedMIDI const& learned) {
+	if (learned.channelOrZone != MIDI_CHANNEL_NONE) {
+		keys.push_back(makeKey(learned.channelOrZone, learned.noteOrCC));
+	}
+}
+
+void MIDIRoutingIndex::addOutputEntry(Output* output, uint16_t order, LearnedMIDI const& learned, bool wholeChannel) {
+	if (learned.channelOrZone != MIDI_CHANNEL_NONE) {
+		int32_t noteOrCC = wholeChannel ? MIDIRoutingTable::kAnyNumber : learned.noteOrCC;
+		outputs_.add(output, order, learned.channelOrZone, noteOrCC);
+	}
+}
+
+void MIDIRoutingIndex::addParamEntries(Output* output, uint16_t order, ModControllableAudio* modControllable) {
+	for (int32_t k = 0; k < modControllable->midiKnobArray.getNumElements(); k++) {
+		addOutputEntry(output, order, modControllable->midiKnobArray.getElement(k)->midiInput, false);
+	}
+}
+
+bool MIDIRoutingIndex::containsKey(deluge::vector<uint16_t> const& keys, uint16_t key) {
+	return std::binary_search(keys.begin(), keys.end(), key);
+}
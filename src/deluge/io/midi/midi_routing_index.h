@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/midi/midi_routing_table.h"
+#include "util/containers.h"
+#include <cstdint>
+
+class LearnedMIDI;
+class ModControllableAudio;
+class Output;
+
+/// Which of the current Song's learned things could want an incoming MIDI message, by the channel (or zone) and note or
+/// CC number it came in on, so it only gets offered to those instead of to everything in the Song. The device isn't
+/// part of it - whatever a message is offered to still checks device, channel and number for itself, so anything
+/// unlearned or moved since the index was built just doesn't match. But anything newly learned, or any Output or Drum
+/// or Clip that turns up with things already learned, must call invalidate(), and the index gets built again the next
+/// time a message needs it.
+class MIDIRoutingIndex {
+public:
+	void invalidate() { valid_ = false; }
+
+	/// Whether a section launch or Clip mute command might be learned to this. channel is as
+	/// PlaybackHandler::offerNoteToLearnedThings() gets it, with IS_A_CC or IS_A_PC added for those
+	bool anyCommandLearnedTo(int32_t channel, int32_t noteOrCC);
+
+	/// Whether one of the Song's own params might be learned to this CC
+	bool anySongParamLearnedTo(int32_t channel, int32_t ccNumber);
+
+	/// Calls action(output, paramLearned, inputLearned) for each Output a CC might be for, in the Song's order.
+	/// paramLearned means it, or one of its Drums, has a param learned to the CC on channel. inputLearned means its
+	/// MIDI input, or one of its Drums', is learned to channelOrZone - the channel as MIDIPort::channelToZone() gives it
+	template <typename Action>
+	void forEachOutputForCC(int32_t channel, int32_t channelOrZone, int32_t ccNumber, Action action) {
+		ensureValid();
+		// Whatever action does might want the index built again, which mustn't happen under us
+		numIterating_++;
+		outputs_.forEachOutputForCC(channel, channelOrZone, ccNumber, action);
+		numIterating_--;
+	}
+
+private:
+	static uint16_t makeKey(int32_t channel, int32_t noteOrCC) { return MIDIRoutingTable::makeKey(channel, noteOrCC); }
+
+	void ensureValid() {
+		if (!valid_ && !numIterating_) {
+			build();
+		}
+	}
+	void build();
+	void addKey(deluge::vector<uint16_t>& keys, LearnedMIDI const& learned);
+	void addOutputEntry(Output* output, uint16_t order, LearnedMIDI const& learned, bool wholeChannel);
+	void addParamEntries(Output* output, uint16_t order, ModControllableAudio* modControllable);
+	bool containsKey(deluge::vector<uint16_t> const& keys, uint16_t key);
+
+	bool valid_ = false;
+	int32_t numIterating_ = 0;
+	deluge::vector<uint16_t> commandKeys_;
+	deluge::vector<uint16_t> songParamKeys_;
+	MIDIRoutingTable outputs_;
+};
+
+extern MIDIRoutingIndex midiRoutingIndex;
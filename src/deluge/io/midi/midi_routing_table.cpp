@@ -0,0 +1,33 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/midi/midi_routing_table.h"
+#include <algorithm>
+
+void MIDIRoutingTable::sort() {
+	// An Output with lots of things learned to the same CC only needs offering it once
+	std::sort(entries_.begin(), entries_.end(),
+	          [](Entry const& a, Entry const& b) { return a.key < b.key || (a.key == b.key && a.order < b.order); });
+	auto newEnd = std::unique(entries_.begin(), entries_.end(),
+	                          [](Entry const& a, Entry const& b) { return a.key == b.key && a.order == b.order; });
+	entries_.erase(newEnd, entries_.end());
+}
+
+MIDIRoutingTable::Entry const* MIDIRoutingTable::findFirst(uint16_t key) const {
+	return std::lower_bound(entries_.data(), entries_.data() + entries_.size(), key,
+	                        [](Entry const& entry, uint16_t key) { return entry.key < key; });
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/containers.h"
+#include <cstdint>
+
+class Output;
+
+/// The part of MIDIRoutingIndex that doesn't need the Song: which Outputs have something learned to each channel (or
+/// zone) and CC, or to a whole channel, each with where it is in the Song's list. add() everything, then sort() it,
+/// before calling forEachOutputForCC()
+class MIDIRoutingTable {
+public:
+	/// In place of a note or CC number, for things learned to a whole channel
+	static constexpr int32_t kAnyNumber = 255;
+
+	void clear() { entries_.clear(); }
+	void add(Output* output, uint16_t order, int32_t channelOrZone, int32_t noteOrCC) {
+		entries_.push_back({makeKey(channelOrZone, noteOrCC), order, output});
+	}
+	void sort();
+
+	/// See MIDIRoutingIndex::forEachOutputForCC()
+	template <typename Action>
+	void forEachOutputForCC(int32_t channel, int32_t channelOrZone, int32_t ccNumber, Action action) const {
+		uint16_t paramsKey = makeKey(channel, ccNumber);
+		uint16_t inputsKey = makeKey(channelOrZone, kAnyNumber);
+		Entry const* params = findFirst(paramsKey);
+		Entry const* inputs = findFirst(inputsKey);
+		Entry const* end = entries_.data() + entries_.size();
+
+		while (true) {
+			bool paramsLeft = (params != end && params->key == paramsKey);
+			bool inputsLeft = (inputs != end && inputs->key == inputsKey);
+			if (!paramsLeft && !inputsLeft) {
+				break;
+			}
+			if (!inputsLeft || (paramsLeft && params->order < inputs->order)) {
+				action(params->output, true, false);
+				params++;
+			}
+			else if (!paramsLeft || inputs->order < params->order) {
+				action(inputs->output, false, true);
+				inputs++;
+			}
+			else {
+				action(params->output, true, true);
+				params++;
+				inputs++;
+			}
+		}
+	}
+
+	static uint16_t makeKey(int32_t channel, int32_t noteOrCC) { return (uint16_t)((channel << 8) | noteOrCC); }
+
+private:
+	struct Entry {
+		uint16_t key;
+		uint16_t order; ///< Where the Output is in the Song's list
+		Output* output;
+	};
+
+	Entry const* findFirst(uint16_t key) const;
+
+	deluge::vector<Entry> entries_; ///< Sorted by key, then order
+};
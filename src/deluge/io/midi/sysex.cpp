@@ -21,7 +21,21 @@
 #include "io/debug/print.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
+#include "memory/general_memory_allocator.h"
+#include "model/drum/drum.h"
+#include "model/instrument/kit.h"
+#include "model/output.h"
+#include "model/sample/sample_low_level_reader.h"
+#include "model/song/song.h"
+#include "processing/engines/cpu_meter.h"
+#include "processing/sound/sound_drum.h"
+#include "task_scheduler.h"
 #include "util/chainload.h"
+#include <cstdio>
+
+extern "C" {
+#include "RZA1/ostm/ostm.h"
+}
 
 #include "util/pack.h"
 
@@ -53,11 +67,161 @@ void Debug::sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len) {
 #endif
 		break;
 
+	case 3:
+		sendMemoryStats(device);
+		break;
+
+	case 4:
+		sendResamplerStats(device, data[2] == 1);
+		break;
+
+	case 5:
+		sendCPUMeterStats(device, data[2] == 1);
+		break;
+
+	case 6:
+		sendSchedulerStats(device, data[2] == 1);
+		break;
+
 	default:
 		break;
 	}
 }
 
+// A few lines of text per memory region, then one per slab pool. Times are in microseconds.
+void Debug::sendMemoryStats(MIDIDevice* device) {
+	GeneralMemoryAllocator& allocator = GeneralMemoryAllocator::get();
+	char buffer[160];
+
+	for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+		MemoryRegionStats stats = allocator.getRegionStats(r);
+		snprintf(buffer, sizeof(buffer),
+		         "%s: size %lu, free %lu in %lu runs, largest %lu, frag %lu.%lu%%, alloc %lu in %lu, "
+		         "stealable %lu in %lu",
+		         GeneralMemoryAllocator::getRegionName(r), stats.size, stats.freeBytes, stats.numFreeRuns,
+		         stats.largestFreeRun, stats.fragmentation / 10, stats.fragmentation % 10, stats.allocatedBytes,
+		         stats.numAllocations, stats.stealableBytes, stats.numStealables);
+		sysexDebugPrint(device, buffer, true);
+
+		char* pos = buffer + snprintf(buffer, sizeof(buffer), "  queues:");
+		for (uint32_t queueBytes : stats.stealableBytesPerQueue) {
+			pos += snprintf(pos, buffer + sizeof(buffer) - pos, " %lu", queueBytes);
+		}
+		sysexDebugPrint(device, buffer, true);
+
+		uint32_t ticksPerMicrosecond = DELUGE_CLOCKS_PER / 1000000;
+		uint32_t meanTime = stats.reclaim.numReclaims ? stats.reclaim.totalTime / stats.reclaim.numReclaims : 0;
+		snprintf(buffer, sizeof(buffer),
+		         "  reclaims: %lu, failed %lu, with neighbours %lu, last %luus, max %luus, mean %luus",
+		         stats.reclaim.numReclaims, stats.reclaim.numFailed, stats.reclaim.numGrabbedNeighbours,
+		         stats.reclaim.lastTime / ticksPerMicrosecond, stats.reclaim.maxTime / ticksPerMicrosecond,
+		         meanTime / ticksPerMicrosecond);
+		sysexDebugPrint(device, buffer, true);
+	}
+
+	for (int32_t t = 0; t < kNumSlabPoolTypes; t++) {
+		SlabPoolStats stats = allocator.getSlabPoolStats(static_cast<SlabPoolType>(t));
+		snprintf(buffer, sizeof(buffer), "slab %lu: %lu of %lu in use, peak %lu, allocs %lu, exhausted %lu",
+		         stats.objectSize, stats.numInUse, stats.capacity, stats.peakInUse, stats.numAllocs,
+		         stats.numExhausted);
+		sysexDebugPrint(device, buffer, true);
+	}
+}
+
+// One line per InterpolationMode: how many samples it's made, and the mean cycles each took. Output samples, so a
+// stereo one counts once
+void Debug::sendResamplerStats(MIDIDevice* device, bool reset) {
+	constexpr char const* modeNames[kNumInterpolationModes] = {"linear", "sinc", "sinc 24-bit"};
+	char buffer[80];
+
+	for (int32_t m = 0; m < kNumInterpolationModes; m++) {
+		ResamplerCost const& cost = resamplerCosts[m];
+		uint32_t tenthsOfCycles = cost.numSamples ? (cost.numCycles * 10) / cost.numSamples : 0;
+		snprintf(buffer, sizeof(buffer), "%s: %lu k samples, %lu.%lu cycles each", modeNames[m],
+		         (uint32_t)(cost.numSamples / 1000), tenthsOfCycles / 10, tenthsOfCycles % 10);
+		sysexDebugPrint(device, buffer, true);
+	}
+
+	if (reset) {
+		resamplerCosts = {};
+	}
+}
+
+static void sendCPUMeterLine(MIDIDevice* device, char const* name, CPUMeter::Counters const& counters,
+                             bool withPeak) {
+	char buffer[192];
+	uint32_t total = CPUMeter::getPerMille(counters.total());
+	char* pos = buffer + snprintf(buffer, sizeof(buffer), "%s: %lu.%lu%%", (*name != 0) ? name : "(unnamed)",
+	                              total / 10, total % 10);
+	if (withPeak && pos < buffer + sizeof(buffer)) {
+		uint32_t peak = CPUMeter::getPeakPerMille(counters.peakCyclesPerSample);
+		pos += snprintf(pos, buffer + sizeof(buffer) - pos, ", peak %lu.%lu%%", peak / 10, peak % 10);
+	}
+	for (size_t s = 0; s < CPUMeter::kNumStages; s++) {
+		uint32_t stage = CPUMeter::getPerMille(counters.cycles[s]);
+		if (stage != 0 && pos < buffer + sizeof(buffer)) {
+			pos += snprintf(pos, buffer + sizeof(buffer) - pos, ", %s %lu.%lu",
+			                CPUMeter::getStageName(static_cast<CPUMeter::Stage>(s)), stage / 10, stage % 10);
+		}
+	}
+	Debug::sysexDebugPrint(device, buffer, true);
+}
+
+// A line for each Output, then for each Sound in each Kit, then the master: its share of the CPU since the last reset
+// in total and for each stage it spent time in. Outputs also get their worst window
+void Debug::sendCPUMeterStats(MIDIDevice* device, bool reset) {
+	char buffer[48];
+	snprintf(buffer, sizeof(buffer), "over %lu ms", CPUMeter::getNumSamplesMeasured() / (kSampleRate / 1000));
+	sysexDebugPrint(device, buffer, true);
+
+	if (currentSong != nullptr) {
+		for (Output* output = currentSong->firstOutput; output; output = output->next) {
+			sendCPUMeterLine(device, output->name.get(), output->cpuMeter, true);
+			if (output->type != OutputType::KIT) {
+				continue;
+			}
+			for (Drum* drum = static_cast<Kit*>(output)->firstDrum; drum; drum = drum->next) {
+				if (drum->type == DrumType::SOUND) {
+					SoundDrum* soundDrum = static_cast<SoundDrum*>(drum);
+					snprintf(buffer, sizeof(buffer), "  %s", soundDrum->name.get());
+					sendCPUMeterLine(device, buffer, soundDrum->cpuMeter, false);
+				}
+			}
+		}
+	}
+	sendCPUMeterLine(device, "master", CPUMeter::master, false);
+
+	if (reset) {
+		CPUMeter::reset();
+	}
+}
+
+// One line per task: its median, expected and worst durations in microseconds, how late its starts have been in
+// microseconds, and how many of its runs came later than its maxInterval. Tasks with a budget also get how many runs
+// went over it
+void Debug::sendSchedulerStats(MIDIDevice* device, bool reset) {
+	char buffer[160];
+	TaskStats stats;
+	for (TaskID id = getTaskStats(0, &stats); id >= 0; id = getTaskStats(id + 1, &stats)) {
+		char* pos = buffer + snprintf(buffer, sizeof(buffer),
+		                              "%s: %lu runs, dur %lu/%lu/%lu us, late %lu/%lu us, missed %lu",
+		                              (stats.name != nullptr) ? stats.name : "(unnamed)", stats.numRuns,
+		                              (uint32_t)(stats.durationMedian * 1000000),
+		                              (uint32_t)(stats.durationExpected * 1000000),
+		                              (uint32_t)(stats.durationWorst * 1000000), (uint32_t)(stats.latencyP90 * 1000000),
+		                              (uint32_t)(stats.latencyWorst * 1000000), stats.numMissedDeadlines);
+		if (stats.budget > 0 && pos < buffer + sizeof(buffer)) {
+			snprintf(pos, buffer + sizeof(buffer) - pos, ", budget %lu us, over %lu",
+			         (uint32_t)(stats.budget * 1000000), stats.numBudgetOverruns);
+		}
+		sysexDebugPrint(device, buffer, true);
+	}
+
+	if (reset) {
+		resetTaskStats();
+	}
+}
+
 void Debug::sysexDebugPrint(MIDIDevice* device, const char* msg, bool nl) {
 	if (!msg) {
 		return; // Do not do that
@@ -93,6 +257,7 @@ void Debug::sysexDebugPrint(MIDIDevice* device, const char* msg, bool nl) {
 #include "hid/display/oled.h"
 #include "hid/led/pad_leds.h"
 #include "memory/general_memory_allocator.h"
+#include "model/sample/sample_low_level_reader.h"
 #include "model/settings/runtime_feature_settings.h"
 
 static uint8_t* load_buf;
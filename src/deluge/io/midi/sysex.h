@@ -26,6 +26,10 @@ namespace Debug {
 
 void sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len);
 void sysexDebugPrint(MIDIDevice* device, const char* msg, bool nl);
+void sendMemoryStats(MIDIDevice* device);
+void sendResamplerStats(MIDIDevice* device, bool reset);
+void sendCPUMeterStats(MIDIDevice* device, bool reset);
+void sendSchedulerStats(MIDIDevice* device, bool reset);
 #ifdef ENABLE_SYSEX_LOAD
 void loadPacketReceived(uint8_t* data, int32_t len);
 void loadCheckAndRun(uint8_t* data, int32_t len);
@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "util/container/ring/spsc_ring.hpp"
+#include <cstddef>
+
+/// Actions everything a port has held back straight away, in the order it came in
+template <typename Message, size_t kCapacity, typename Action>
+void flushTimedInput(deluge::SPSCRing<Message, kCapacity>& queue, Action&& action) {
+	while (Message const* message = queue.front()) {
+		Message due = *message;
+		queue.pop();
+		action(due);
+	}
+}
+
+/// What MidiEngine does with each channel message that comes in from a port. Returns true if it's been held back in the
+/// port's queue, until the render gets to the time it came in at - which only notes are, and only if mayHoldBack. If
+/// not, the caller actions it now, but first everything the port still has held back gets actioned, as that came in
+/// first. That's a little early for those notes, but otherwise a pitch bend, CC or aftertouch could overtake the note
+/// it was played after, or a note-off its note-on.
+///
+/// A template so it can be tested without the rest of MidiEngine.
+template <typename Message, size_t kCapacity, typename Action>
+bool holdBackTimedInput(deluge::SPSCRing<Message, kCapacity>& queue, Message const& message, bool mayHoldBack,
+                        Action&& action) {
+	bool isNote = (message.statusType == 0x08 || message.statusType == 0x09);
+	if (isNote && mayHoldBack && queue.push(message)) {
+		return true;
+	}
+	flushTimedInput(queue, action);
+	return false;
+}
@@ -4,8 +4,13 @@
 #include "memory/memory_region.h"
 #include "memory/stealable.h"
 #include "processing/engines/audio_engine.h"
+#include <algorithm>
 #include <cstdint>
 
+extern "C" {
+#include "RZA1/ostm/ostm.h"
+}
+
 extern bool skipConsistencyCheck;
 uint32_t currentTraversalNo = 0;
 
@@ -18,6 +23,7 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 #endif
 
 	AudioEngine::logAction("CacheManager::reclaim");
+	uint32_t startTime = getTimerValue(0);
 
 	uint32_t traversalNumberBeforeQueues = currentTraversalNo;
 
@@ -172,6 +178,7 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 		skipConsistencyCheck = false;
 #endif
 		AudioEngine::logAction("/CacheManager::reclaim nope");
+		RecordReclaim(startTime, false, false);
 		return 0;
 	}
 
@@ -189,6 +196,21 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 #endif
 
 	AudioEngine::logAction("/CacheManager::reclaim success");
+	RecordReclaim(startTime, true, stolen);
 
 	return newSpaceAddress;
 }
+
+void CacheManager::RecordReclaim(uint32_t startTime, bool succeeded, bool grabbedNeighbours) {
+	uint32_t time = getTimerValue(0) - startTime;
+	reclaim_stats_.numReclaims++;
+	if (!succeeded) {
+		reclaim_stats_.numFailed++;
+	}
+	if (grabbedNeighbours) {
+		reclaim_stats_.numGrabbedNeighbours++;
+	}
+	reclaim_stats_.lastTime = time;
+	reclaim_stats_.maxTime = std::max(reclaim_stats_.maxTime, time);
+	reclaim_stats_.totalTime += time;
+}
@@ -9,6 +9,16 @@
 
 class MemoryRegion;
 
+struct ReclaimStats {
+	uint32_t numReclaims;          // Calls to ReclaimMemory()
+	uint32_t numFailed;            // ...which couldn't find or steal enough memory
+	uint32_t numGrabbedNeighbours; // ...which had to steal neighbouring memory as well as a queued Stealable
+	// Times taken by ReclaimMemory(), in ticks of the 33.33MHz OS timer
+	uint32_t lastTime;
+	uint32_t maxTime;
+	uint64_t totalTime;
+};
+
 class CacheManager {
 public:
 	CacheManager() = default;
@@ -36,11 +46,17 @@ public:
 	uint32_t ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeeded, void* thingNotToStealFrom,
 	                       int32_t* __restrict__ foundSpaceSize);
 
+	[[nodiscard]] const ReclaimStats& reclaim_stats() const { return reclaim_stats_; }
+
 private:
+	void RecordReclaim(uint32_t startTime, bool succeeded, bool grabbedNeighbours);
+
 	std::array<BidirectionalLinkedList, kNumStealableQueue> reclamation_queue_;
 
 	// Keeps track, semi-accurately, of biggest runs of memory that could be stolen. In a perfect world, we'd have a
 	// second index on stealableClusterQueues[q], for run length. Although even that wouldn't automatically reflect
 	// changes to run lengths as neighbouring memory is allocated.
 	std::array<uint32_t, kNumStealableQueue> longest_runs_;
+
+	ReclaimStats reclaim_stats_{};
 };
@@ -20,6 +20,7 @@
 #include "io/debug/log.h"
 #include "memory/stealable.h"
 #include "processing/engines/audio_engine.h"
+#include <algorithm>
 
 // TODO: Check if these have the right size
 char emptySpacesMemory[sizeof(EmptySpaceRecord) * 512];
@@ -42,12 +43,25 @@ GeneralMemoryAllocator::GeneralMemoryAllocator() {
 	                                      (uint32_t)&__heap_start, (uint32_t)&program_stack_start);
 
 #if ALPHA_OR_BETA_VERSION
-	regions[MEMORY_REGION_STEALABLE].name = "stealable";
-	regions[MEMORY_REGION_INTERNAL].name = "internal";
-	regions[MEMORY_REGION_EXTERNAL].name = "external";
+	for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+		regions[r].name = getRegionName(r);
+	}
 #endif
 }
 
+char const* GeneralMemoryAllocator::getRegionName(int32_t region) {
+	switch (region) {
+	case MEMORY_REGION_STEALABLE:
+		return "stealable";
+	case MEMORY_REGION_INTERNAL:
+		return "internal";
+	case MEMORY_REGION_EXTERNAL:
+		return "external";
+	default:
+		return "";
+	}
+}
+
 int32_t closestDistance = 2147483647;
 
 void GeneralMemoryAllocator::checkStack(char const* caller) {
@@ -158,7 +172,57 @@ void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, bool mayUseOnChipRam,
 	return address;
 }
 
+// The pools' memory gets allocated once, at startup, and is never given back - so however the pools get used, they
+// can't fragment the regions. It's on-chip RAM, as Voices, VoiceSamples and TimeStretchers always got when they were
+// allocated one at a time - unless there's not enough of that, in which case alloc() gives us external RAM instead.
+void GeneralMemoryAllocator::setupSlabPools(SlabPoolSize const (&sizes)[kNumSlabPoolTypes]) {
+	uint32_t totalSize = 0;
+	for (SlabPoolSize const& size : sizes) {
+		totalSize += ((size.objectSize + 3) & ~3) * size.capacity;
+	}
+
+	// If that fails, the pools are still set up with nothing in them, so allocPooled() knows what size to fall back to
+	char* arena = (char*)allocMaxSpeed(totalSize);
+	if (!arena) {
+		D_PRINTLN("Couldn't allocate slab pools");
+		totalSize = 0;
+	}
+
+	char* pos = arena;
+	for (int32_t t = 0; t < kNumSlabPoolTypes; t++) {
+		uint32_t objectSize = (sizes[t].objectSize + 3) & ~3;
+		uint32_t capacity = arena ? sizes[t].capacity : 0;
+		slabPools[t].setup(pos, objectSize, capacity);
+		pos += objectSize * capacity;
+	}
+
+	slabArenaStart = (uint32_t)arena;
+	slabArenaSize = totalSize;
+}
+
+void* GeneralMemoryAllocator::allocPooled(SlabPoolType type, bool mayFallBack, void* thingNotToStealFrom) {
+	SlabPool& pool = slabPools[util::to_underlying(type)];
+	void* address = pool.alloc();
+	if (address || !mayFallBack) {
+		return address;
+	}
+	return alloc(pool.getObjectSize(), true, false, thingNotToStealFrom);
+}
+
+SlabPool& GeneralMemoryAllocator::getSlabPool(void* address) {
+	for (SlabPool& pool : slabPools) {
+		if (pool.owns(address)) {
+			return pool;
+		}
+	}
+	FREEZE_WITH_ERROR("M006");
+	return slabPools[0];
+}
+
 uint32_t GeneralMemoryAllocator::getAllocatedSize(void* address) {
+	if (isPooled(address)) {
+		return getSlabPool(address).getObjectSize();
+	}
 	uint32_t* header = (uint32_t*)((uint32_t)address - 4);
 	return (*header & SPACE_SIZE_MASK);
 }
@@ -181,12 +245,18 @@ int32_t GeneralMemoryAllocator::getRegion(void* address) {
 
 // Returns new size
 uint32_t GeneralMemoryAllocator::shortenRight(void* address, uint32_t newSize) {
+	if (isPooled(address)) {
+		return getSlabPool(address).getObjectSize(); // Slab slots can't be resized
+	}
 	return regions[getRegion(address)].shortenRight(address, newSize);
 }
 
 // Returns how much it was shortened by
 uint32_t GeneralMemoryAllocator::shortenLeft(void* address, uint32_t amountToShorten,
                                              uint32_t numBytesToMoveRightIfSuccessful) {
+	if (isPooled(address)) {
+		return 0;
+	}
 	return regions[getRegion(address)].shortenLeft(address, amountToShorten, numBytesToMoveRightIfSuccessful);
 }
 
@@ -197,7 +267,7 @@ void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, u
 	*getAmountExtendedLeft = 0;
 	*getAmountExtendedRight = 0;
 
-	if (lock) {
+	if (lock || isPooled(address)) {
 		return;
 	}
 
@@ -208,10 +278,17 @@ void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, u
 }
 
 uint32_t GeneralMemoryAllocator::extendRightAsMuchAsEasilyPossible(void* address) {
+	if (isPooled(address)) {
+		return getSlabPool(address).getObjectSize();
+	}
 	return regions[getRegion(address)].extendRightAsMuchAsEasilyPossible(address);
 }
 
 void GeneralMemoryAllocator::dealloc(void* address) {
+	if (isPooled(address)) {
+		getSlabPool(address).dealloc(address);
+		return;
+	}
 	return regions[getRegion(address)].dealloc(address);
 }
 
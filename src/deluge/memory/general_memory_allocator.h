@@ -19,12 +19,23 @@
 
 #include "definitions_cxx.hpp"
 #include "memory/memory_region.h"
+#include "memory/slab_pool.h"
 
 #define MEMORY_REGION_STEALABLE 0
 #define MEMORY_REGION_INTERNAL 1
 #define MEMORY_REGION_EXTERNAL 2
 #define NUM_MEMORY_REGIONS 3
 constexpr uint32_t RESERVED_EXTERNAL_ALLOCATOR = 0x00800000;
+
+/// What the slab pools hold - one type each, in slots of exactly its size
+enum class SlabPoolType : uint8_t { VOICE, VOICE_SAMPLE, TIME_STRETCHER };
+constexpr int32_t kNumSlabPoolTypes = 3;
+
+struct SlabPoolSize {
+	uint32_t objectSize;
+	uint32_t capacity;
+};
+
 class Stealable;
 
 /*
@@ -74,6 +85,23 @@ public:
 
 	void* alloc(uint32_t requiredSize, bool mayUseOnChipRam, bool makeStealable, void* thingNotToStealFrom);
 	void dealloc(void* address);
+
+	/// For small objects which come and go a lot, like Voices. Takes a slot from type's slab pool, without searching or
+	/// stealing anything. If that pool's full, falls back to a normal alloc() of the pool's object size only if
+	/// mayFallBack - so from the audio routine, pass false and deal with getting nullptr. Either way, give it back with
+	/// dealloc() like anything else.
+	void* allocPooled(SlabPoolType type, bool mayFallBack, void* thingNotToStealFrom = NULL);
+	/// Once, at startup, with each SlabPoolType's object size and how many of them its pool is to hold
+	void setupSlabPools(SlabPoolSize const (&sizes)[kNumSlabPoolTypes]);
+	[[nodiscard]] bool isPooled(void* address) const { return (uint32_t)address - slabArenaStart < slabArenaSize; }
+	[[nodiscard]] SlabPoolStats getSlabPoolStats(SlabPoolType type) const {
+		return slabPools[util::to_underlying(type)].getStats();
+	}
+
+	/// For one of the MEMORY_REGION_* regions. Walks the whole region, so call from the UI, not the audio routine.
+	[[nodiscard]] MemoryRegionStats getRegionStats(int32_t region) { return regions[region].getStats(); }
+	static char const* getRegionName(int32_t region);
+
 	void* allocExternal(uint32_t requiredSize);
 	void deallocExternal(void* address);
 	uint32_t shortenRight(void* address, uint32_t newSize);
@@ -92,6 +120,7 @@ public:
 	void putStealableInAppropriateQueue(Stealable* stealable);
 
 	MemoryRegion regions[NUM_MEMORY_REGIONS];
+	SlabPool slabPools[kNumSlabPoolTypes];
 
 	bool lock;
 
@@ -102,6 +131,10 @@ public:
 
 private:
 	void checkEverythingOk(char const* errorString);
+	SlabPool& getSlabPool(void* address);
+
+	uint32_t slabArenaStart = 0;
+	uint32_t slabArenaSize = 0;
 };
 
 extern "C" {
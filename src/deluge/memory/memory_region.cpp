@@ -115,6 +115,55 @@ void MemoryRegion::verifyMemoryNotFree(void* address, uint32_t spaceSize) {
 	}
 }
 
+MemoryRegionStats MemoryRegion::getStats() {
+	MemoryRegionStats stats{};
+	stats.size = end + 8 - start;
+	stats.reclaim = cache_manager_.reclaim_stats();
+
+	// emptySpaces is sorted by length, so the last one is the longest
+	stats.numFreeRuns = emptySpaces.getNumElements();
+	for (int32_t i = 0; i < emptySpaces.getNumElements(); i++) {
+		stats.freeBytes += ((EmptySpaceRecord*)emptySpaces.getElementAddress(i))->length;
+	}
+	if (stats.numFreeRuns) {
+		stats.largestFreeRun = ((EmptySpaceRecord*)emptySpaces.getElementAddress(stats.numFreeRuns - 1))->length;
+	}
+	if (stats.freeBytes) {
+		stats.fragmentation = 1000 - (uint64_t)stats.largestFreeRun * 1000 / stats.freeBytes;
+	}
+
+	// Each space has a header before it and a footer after it, both holding its type and size. The first header is
+	// after the allocated marker at start, and the last footer is at end.
+	uint32_t address = start + 8;
+	while (address < end) {
+		uint32_t header = *(uint32_t*)(address - 4);
+		uint32_t spaceSize = header & SPACE_SIZE_MASK;
+		switch (header & SPACE_TYPE_MASK) {
+		case SPACE_HEADER_ALLOCATED:
+			stats.allocatedBytes += spaceSize;
+			stats.numAllocations++;
+			break;
+		case SPACE_HEADER_STEALABLE:
+			stats.stealableBytes += spaceSize;
+			stats.numStealables++;
+			break;
+		default:
+			break;
+		}
+		address += spaceSize + 8;
+	}
+
+	for (size_t q = 0; q < kNumStealableQueue; q++) {
+		BidirectionalLinkedList& list = cache_manager_.queue(static_cast<StealableQueue>(q));
+		for (auto* node = list.getFirst(); node != nullptr; node = list.getNext(node)) {
+			uint32_t header = *(uint32_t*)((uint32_t) static_cast<Stealable*>(node) - 4);
+			stats.stealableBytesPerQueue[q] += header & SPACE_SIZE_MASK;
+		}
+	}
+
+	return stats;
+}
+
 // Okay this is me being experimental and trying something you're not supposed to do - using static variables in place
 // of stack ones within a function. It seemed to give a slight speed up, but it's probably quite circumstantial, and I
 // wouldn't normally do this.
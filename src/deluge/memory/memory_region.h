@@ -19,6 +19,7 @@
 
 #include "memory/cache_manager.h"
 #include "util/container/array/ordered_resizeable_array_with_multi_word_key.h"
+#include <array>
 
 struct EmptySpaceRecord {
 	uint32_t length;
@@ -31,6 +32,22 @@ struct NeighbouringMemoryGrabAttemptResult {
 	uint32_t longestRunFound; // Only valid if didn't return some space.
 };
 
+// A snapshot of how a region's memory is being used, not counting space headers and footers
+struct MemoryRegionStats {
+	uint32_t size;
+	uint32_t freeBytes;
+	uint32_t allocatedBytes; // Not including stealable spaces
+	uint32_t stealableBytes;
+	uint32_t numAllocations;
+	uint32_t numStealables;
+	uint32_t numFreeRuns;
+	uint32_t largestFreeRun;
+	// In thousandths. 0 when all free memory is in one run, approaching 1000 as it gets split into more, smaller ones
+	uint32_t fragmentation;
+	std::array<uint32_t, kNumStealableQueue> stealableBytesPerQueue;
+	ReclaimStats reclaim;
+};
+
 #define SPACE_HEADER_EMPTY 0
 #define SPACE_HEADER_STEALABLE 0x40000000
 #define SPACE_HEADER_ALLOCATED 0x80000000
@@ -53,6 +70,8 @@ public:
 	uint32_t extendRightAsMuchAsEasilyPossible(void* spaceAddress);
 	void dealloc(void* address);
 	void verifyMemoryNotFree(void* address, uint32_t spaceSize);
+	/// Walks every space in the region, so call from the UI, not the audio routine
+	MemoryRegionStats getStats();
 
 	uint32_t start;
 	uint32_t end;
@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory/slab_pool.h"
+
+void SlabPool::setup(void* memory, uint32_t objectSize, uint32_t capacity) {
+	start_ = (char*)memory;
+	objectSize_ = objectSize;
+	capacity_ = capacity;
+
+	for (uint32_t i = 0; i < capacity; i++) {
+		*slot(i) = (i == capacity - 1) ? kNoSlot : i + 1;
+	}
+	head_.store(capacity ? 0 : kNoSlot, std::memory_order_release);
+}
+
+void* SlabPool::alloc() {
+	uint64_t oldHead = head_.load(std::memory_order_acquire);
+	uint64_t newHead;
+	uint32_t index;
+	do {
+		index = (uint32_t)oldHead;
+		if (index == kNoSlot) {
+			numExhausted_.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		uint64_t tag = (oldHead >> 32) + 1;
+		newHead = (tag << 32) | *slot(index);
+	} while (!head_.compare_exchange_weak(oldHead, newHead, std::memory_order_acq_rel, std::memory_order_acquire));
+
+	numAllocs_.fetch_add(1, std::memory_order_relaxed);
+	uint32_t numInUse = numInUse_.fetch_add(1, std::memory_order_relaxed) + 1;
+	uint32_t peak = peakInUse_.load(std::memory_order_relaxed);
+	while (numInUse > peak && !peakInUse_.compare_exchange_weak(peak, numInUse, std::memory_order_relaxed)) {}
+
+	return slot(index);
+}
+
+void SlabPool::dealloc(void* address) {
+	uint32_t index = ((char*)address - start_) / objectSize_;
+	uint64_t oldHead = head_.load(std::memory_order_relaxed);
+	uint64_t newHead;
+	do {
+		*slot(index) = (uint32_t)oldHead;
+		newHead = (oldHead & 0xFFFFFFFF00000000) | index;
+	} while (!head_.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed));
+
+	numInUse_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+SlabPoolStats SlabPool::getStats() const {
+	return {
+	    .objectSize = objectSize_,
+	    .capacity = capacity_,
+	    .numInUse = numInUse_.load(std::memory_order_relaxed),
+	    .peakInUse = peakInUse_.load(std::memory_order_relaxed),
+	    .numAllocs = numAllocs_.load(std::memory_order_relaxed),
+	    .numExhausted = numExhausted_.load(std::memory_order_relaxed),
+	};
+}
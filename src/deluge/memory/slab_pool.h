@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct SlabPoolStats {
+	uint32_t objectSize;
+	uint32_t capacity;
+	uint32_t numInUse;
+	uint32_t peakInUse;
+	uint32_t numAllocs;
+	uint32_t numExhausted; // Allocations refused because every slot was in use
+};
+
+// A fixed number of equal-sized slots in one block of memory, handed out from a free list. alloc() and dealloc() are
+// each a single compare-and-swap, never search anything, and never steal, so they're safe to call from the audio
+// routine - and from an interrupt which lands in the middle of either. The memory is never given back, so a pool can't
+// fragment anything either.
+class SlabPool {
+public:
+	SlabPool() = default;
+	SlabPool(SlabPool const&) = delete;
+	SlabPool& operator=(SlabPool const&) = delete;
+
+	/// memory must hold objectSize * capacity bytes, and objectSize must be a multiple of 4
+	void setup(void* memory, uint32_t objectSize, uint32_t capacity);
+
+	/// Returns nullptr if every slot's in use
+	void* alloc();
+	void dealloc(void* address);
+
+	[[nodiscard]] bool owns(void* address) const {
+		return (uintptr_t)address - (uintptr_t)start_ < objectSize_ * capacity_;
+	}
+	[[nodiscard]] uint32_t getObjectSize() const { return objectSize_; }
+	[[nodiscard]] SlabPoolStats getStats() const;
+
+private:
+	static constexpr uint32_t kNoSlot = 0xFFFFFFFF;
+
+	// Each free slot's first word holds the index of the next free one
+	[[nodiscard]] uint32_t* slot(uint32_t index) const { return (uint32_t*)(start_ + index * objectSize_); }
+
+	// The index of the first free slot in the low word, and in the high word a count of pops, so a compare-and-swap
+	// can't succeed against a head which was popped and pushed back again in between
+	std::atomic<uint64_t> head_{kNoSlot};
+
+	char* start_ = nullptr;
+	uint32_t objectSize_ = 0;
+	uint32_t capacity_ = 0;
+
+	std::atomic<uint32_t> numInUse_{0};
+	std::atomic<uint32_t> peakInUse_{0};
+	std::atomic<uint32_t> numAllocs_{0};
+	std::atomic<uint32_t> numExhausted_{0};
+};
@@ -1015,6 +1015,9 @@ void AudioClip::writeDataToFile(Serializer& writer, Song* song) {
 	if (sampleControls.interpolationMode == InterpolationMode::LINEAR) {
 		writer.writeAttribute("linearInterpolation", 1);
 	}
+	else if (sampleControls.interpolationMode == InterpolationMode::PRECISE) {
+		writer.writeAttribute("highPrecisionInterpolation", 1);
+	}
 	if (sampleControls.reversed) {
 		writer.writeAttribute("reversed", "1");
 	}
@@ -1104,6 +1107,12 @@ someError:
 			}
 		}
 
+		else if (!strcmp(tagName, "highPrecisionInterpolation")) {
+			if (reader.readTagOrAttributeValueInt()) {
+				sampleControls.interpolationMode = InterpolationMode::PRECISE;
+			}
+		}
+
 		else if (!strcmp(tagName, "attack")) {
 			attack = reader.readTagOrAttributeValueInt();
 		}
@@ -17,8 +17,10 @@
 
 #include "model/clip/clip_array.h"
 #include "definitions_cxx.hpp"
+#include "io/midi/midi_routing_index.h"
 
 Error ClipArray::insertClipAtIndex(Clip* clip, int32_t index) {
+	midiRoutingIndex.invalidate(); // For its mute command
 	return insertPointerAtIndex(clip, index);
 }
 
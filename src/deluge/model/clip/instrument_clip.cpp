@@ -453,8 +453,7 @@ Error InstrumentClip::beginLinearRecording(ModelStackWithTimelineCounter* modelS
 				thisDrum->earlyNoteVelocity = 0;
 
 				int32_t noteRowIndex;
-				NoteRow* noteRow = getNoteRowForDrum(
-				    thisDrum, &noteRowIndex); // Remember, I'm planning to introduce a faster search/index for this
+				NoteRow* noteRow = getNoteRowForDrum(thisDrum, &noteRowIndex); // Looked up in noteRowIndexForDrum
 				if (noteRow) {
 
 					if (!action) {
@@ -1035,6 +1034,24 @@ ModelStackWithNoteRow* InstrumentClip::getNoteRowForDrum(ModelStackWithTimelineC
 
 NoteRow* InstrumentClip::getNoteRowForDrum(Drum* drum, int32_t* getIndex) {
 
+	if (drum && indexNoteRowsByDrum()) {
+		uint32_t* bucket = (uint32_t*)noteRowIndexForDrum.lookup((uint32_t)drum);
+		if (!bucket) {
+			return NULL;
+		}
+		int32_t i = (int32_t)bucket[1];
+		NoteRow* thisNoteRow = noteRows.getElement(i);
+		if (thisNoteRow->drum == drum) {
+			if (getIndex) {
+				*getIndex = i;
+			}
+			return thisNoteRow;
+		}
+		// Something changed a NoteRow's Drum without calling NoteRowVector::noteRowsChanged(). Search, and index again
+		// next time
+		noteRowIndexForDrumValid = false;
+	}
+
 	for (int32_t i = 0; i < noteRows.getNumElements(); i++) {
 		NoteRow* thisNoteRow = noteRows.getElement(i);
 		if (thisNoteRow->drum == drum) {
@@ -1048,6 +1065,36 @@ NoteRow* InstrumentClip::getNoteRowForDrum(Drum* drum, int32_t* getIndex) {
 	return NULL;
 }
 
+// Makes sure noteRowIndexForDrum is up to date, returning false if there wasn't the RAM for that
+bool InstrumentClip::indexNoteRowsByDrum() {
+	if (noteRowIndexForDrumValid && noteRowIndexForDrumGeneration == NoteRowVector::generation) {
+		return true;
+	}
+
+	noteRowIndexForDrum.clear();
+	noteRowIndexForDrumGeneration = NoteRowVector::generation;
+	noteRowIndexForDrumValid = true;
+
+	for (int32_t i = 0; i < noteRows.getNumElements(); i++) {
+		Drum* drum = noteRows.getElement(i)->drum;
+		// 0xFFFFFFFF is what an empty bucket holds - and also what a NoteRow being read from file has for "no drum"
+		if (!drum || (uint32_t)drum == 0xFFFFFFFF) {
+			continue;
+		}
+		bool alreadyPresent = false;
+		uint32_t* bucket = (uint32_t*)noteRowIndexForDrum.insert((uint32_t)drum, &alreadyPresent);
+		if (!bucket) {
+			noteRowIndexForDrumValid = false;
+			return false;
+		}
+		// If two NoteRows have the same Drum, it's the first one that gets found
+		if (!alreadyPresent) {
+			bucket[1] = i;
+		}
+	}
+	return true;
+}
+
 // Should only be called for Kit Clips
 ModelStackWithNoteRow* InstrumentClip::getNoteRowForDrumName(ModelStackWithTimelineCounter* modelStack,
                                                              char const* name) {
@@ -2456,6 +2503,7 @@ someError:
 			NoteRow* thisNoteRow = noteRows.getElement(i);
 			thisNoteRow->drum = NULL;
 		}
+		NoteRowVector::noteRowsChanged();
 
 		return error;
 	}
@@ -2687,7 +2735,7 @@ someError:
 					reader.exitTag("syncType");
 				}
 				else if (!strcmp(tagName, "mode")
-				         && smDeserializer.firmware_version < FirmwareVersion::community({1, 1, 0})) {
+				         && reader.firmware_version < FirmwareVersion::community({1, 1, 0})) {
 					// Import the old "mode" into the new splitted params "arpMode", "noteMode", and "octaveMode
 					// but only if the new params are not already read and set,
 					// that is, if we detect they have a value other than default
@@ -2817,7 +2865,7 @@ loadInstrument:
 
 			// Normal case - load in brand new ParamManager
 
-			if (smDeserializer.firmware_version >= FirmwareVersion::official({1, 2, 0}) || !output) {
+			if (reader.firmware_version >= FirmwareVersion::official({1, 2, 0}) || !output) {
 createNewParamManager:
 				error = paramManager.setupWithPatching();
 				if (error != Error::NONE) {
@@ -3020,7 +3068,7 @@ doReadBendRange:
 
 	// Pre V3.2.0 (and also for some of 3.2's alpha phase), bend range wasn't adjustable, wasn't written in the file,
 	// and was always 12.
-	if (smDeserializer.firmware_version <= FirmwareVersion::official({3, 2, 0, "alpha"})
+	if (reader.firmware_version <= FirmwareVersion::official({3, 2, 0, "alpha"})
 	    && !paramManager.getExpressionParamSet()) {
 		ExpressionParamSet* expressionParams = paramManager.getOrCreateExpressionParamSet();
 		if (expressionParams) {
@@ -3104,7 +3152,7 @@ expressionParam:
 							if (paramId == CC_NUMBER_MOD_WHEEL) {
 								// m-m-adams - used to convert CC74 to y-axis, and I don't think that would
 								// ever have been desireable. Now convert mod wheel, as mono y axis outputs as mod wheel
-								if (smDeserializer.firmware_version < FirmwareVersion::community({1, 1, 0})) {
+								if (reader.firmware_version < FirmwareVersion::community({1, 1, 0})) {
 									paramId = Y_SLIDE_TIMBRE;
 									goto expressionParam;
 								}
@@ -3961,6 +4009,7 @@ Error InstrumentClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 			// Maybe we (cryptically) marked it as "no drum".
 			if ((uint32_t)thisNoteRow->drum == (uint32_t)0xFFFFFFFF) {
 				thisNoteRow->drum = NULL;
+				NoteRowVector::noteRowsChanged();
 			}
 
 			// Or a gate drum from a pre-V2.0 Song file...
@@ -3969,6 +4018,7 @@ Error InstrumentClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 				int32_t gateChannel = 0xFFFFFFFE - (uint32_t)thisNoteRow->drum;
 
 				thisNoteRow->drum = kit->getGateDrumForChannel(gateChannel);
+				NoteRowVector::noteRowsChanged();
 
 				if (!thisNoteRow->drum) {
 					void* drumMemory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(GateDrum));
@@ -3980,6 +4030,7 @@ Error InstrumentClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 
 					kit->addDrum(newDrum);
 					thisNoteRow->drum = newDrum;
+					NoteRowVector::noteRowsChanged();
 				}
 				thisNoteRow->giveMidiCommandsToDrum();
 			}
@@ -4016,6 +4067,7 @@ Error InstrumentClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 
 				// Cool ok, we found our Drum!
 				thisNoteRow->drum = drumFromIndex;
+				NoteRowVector::noteRowsChanged();
 				thisNoteRow->giveMidiCommandsToDrum();
 
 				// If we didn't get a paramManager (means pre-September-2016 song). TODO: this whole section would lead
@@ -4047,6 +4099,7 @@ Error InstrumentClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 							FREEZE_WITH_ERROR("E011");
 haveNoDrum:
 							thisNoteRow->drum = NULL;
+							NoteRowVector::noteRowsChanged();
 						}
 					}
 				}
@@ -4055,7 +4108,7 @@ haveNoDrum:
 				if (thisNoteRow->drum) {
 
 					// If saved before V2.1, see if we need linear interpolation
-					if (smDeserializer.firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
+					if (activeDeserializer->firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
 						if (thisNoteRow->drum->type == DrumType::SOUND) {
 							SoundDrum* sound = (SoundDrum*)thisNoteRow->drum;
 
@@ -4108,6 +4161,7 @@ haveNoDrum:
 			NoteRow* thisNoteRow = noteRows.getElement(i);
 			thisNoteRow->drum = NULL;
 		}
+		NoteRowVector::noteRowsChanged();
 
 		// And...
 		if (output->type == OutputType::MIDI_OUT) {
@@ -4133,7 +4187,7 @@ haveNoDrum:
 	compensateVolumeForResonance(modelStack);
 
 	// If saved before V2.1....
-	if (smDeserializer.firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
+	if (activeDeserializer->firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
 
 		if (output->type == OutputType::SYNTH) {
 			SoundInstrument* sound = (SoundInstrument*)output;
@@ -4148,7 +4202,7 @@ haveNoDrum:
 
 		// For songs saved before V2.0, ensure that non-square oscillators have PW set to 0 (cos PW in this case didn't
 		// have an effect then but it will now)
-		if (smDeserializer.firmware_version < FirmwareVersion::official({2, 0, 0, "beta"})) {
+		if (activeDeserializer->firmware_version < FirmwareVersion::official({2, 0, 0, "beta"})) {
 			if (output->type == OutputType::SYNTH) {
 				SoundInstrument* sound = (SoundInstrument*)output;
 
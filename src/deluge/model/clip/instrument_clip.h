@@ -25,6 +25,7 @@
 #include "model/scale/note_set.h"
 #include "model/timeline_counter.h"
 #include "modulation/arpeggiator.h"
+#include "util/container/hashtable/open_addressing_hash_table.h"
 #include "util/d_string.h"
 #include <cstddef>
 
@@ -279,4 +280,12 @@ private:
 	bool lastProbabilities[kNumProbabilityValues];
 	int32_t lastProbabiltyPos[kNumProbabilityValues];
 	bool currentlyRecordingLinearly;
+
+	// Which NoteRow each Drum is on, so the Kit doesn't have to search for it every render. Keyed by the Drum's
+	// address, with the NoteRow's index stored after it. Rebuilt the first time it's needed after
+	// NoteRowVector::generation has moved on
+	OpenAddressingHashTableWith32bitKey noteRowIndexForDrum{sizeof(int32_t)};
+	uint32_t noteRowIndexForDrumGeneration = 0;
+	bool noteRowIndexForDrumValid = false;
+	bool indexNoteRowsByDrum();
 };
@@ -27,6 +27,7 @@
 #include "io/debug/log.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
+#include "io/midi/midi_routing_index.h"
 #include "io/midi/midi_takeover.h"
 #include "mem_functions.h"
 #include "model/clip/audio_clip.h"
@@ -35,6 +36,7 @@
 #include "model/song/song.h"
 #include "modulation/params/param_set.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/cpu_meter.h"
 #include "processing/sound/sound.h"
 #include "storage/storage_manager.h"
 
@@ -172,6 +174,7 @@ void ModControllableAudio::setWrapsToShutdown() {
 void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, ModFXType modFXType, int32_t modFXRate,
                                      int32_t modFXDepth, const Delay::State& delayWorkingState, int32_t* postFXVolume,
                                      ParamManager* paramManager) {
+	CPUMeter::StageScope meterStage{CPUMeter::Stage::MOD_FX};
 
 	UnpatchedParamSet* unpatchedParams = paramManager->getUnpatchedParamSet();
 
@@ -534,6 +537,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 	}
 
 	// Delay ----------------------------------------------------------------------------------
+	CPUMeter::StageScope delayStage{CPUMeter::Stage::DELAY};
 	delay.process({buffer, static_cast<size_t>(numSamples)}, delayWorkingState);
 }
 
@@ -1679,6 +1683,7 @@ midiKnobFound:
 		knob->midiInput.device = fromDevice;
 		knob->paramDescriptor = paramDescriptor;
 		knob->relative = (whichKnob != 128); // Guess that it's relative, unless this is a pitch-bend "knob"
+		midiRoutingIndex.invalidate();
 	}
 
 	if (overwroteExistingKnob) {
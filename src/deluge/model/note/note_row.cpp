@@ -22,6 +22,7 @@
 #include "gui/views/view.h"
 #include "io/debug/log.h"
 #include "io/midi/midi_device.h"
+#include "io/midi/midi_routing_index.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action.h"
 #include "model/clip/instrument_clip.h"
@@ -125,7 +126,7 @@ Error NoteRow::beenCloned(ModelStackWithNoteRow* modelStack, bool shouldFlattenR
 					int32_t finalNoteOvershoot = oldNote->pos + oldNote->length - effectiveLength;
 					if (finalNoteOvershoot > 0) {
 						numNotesBesidesWrapping--;
-						Note* newNote = (Note*)notes.getElementAddress(numNotesBesidesWrapping);
+						Note* newNote = &notes[numNotesBesidesWrapping];
 						newNote->pos = effectiveLength - finalNoteOvershoot;
 						newNote->setLength(oldNote->getLength());
 						newNote->setProbability(oldNote->getProbability());
@@ -138,7 +139,7 @@ Error NoteRow::beenCloned(ModelStackWithNoteRow* modelStack, bool shouldFlattenR
 					int32_t iNew = numNotesBesidesWrapping - 1 - iOld;
 
 					Note* oldNote = (Note*)oldNotes.getElementAddress(iOld);
-					Note* newNote = (Note*)notes.getElementAddress(iNew);
+					Note* newNote = &notes[iNew];
 
 					int32_t newPos = effectiveLength - oldNote->pos - oldNote->length;
 					newNote->pos = newPos;
@@ -161,7 +162,7 @@ Error NoteRow::beenCloned(ModelStackWithNoteRow* modelStack, bool shouldFlattenR
 						iNew += numNotes;
 					}
 					Note* oldNote = (Note*)oldNotes.getElementAddress(iOld);
-					Note* newNote = (Note*)notes.getElementAddress(iNew);
+					Note* newNote = &notes[iNew];
 
 					int32_t newPos = -oldNote->pos;
 					if (newPos < 0) {
@@ -2280,7 +2281,7 @@ currentlyOff:
 
 				// Or if still here, we've decided on a valid note index
 gotValidNoteIndex:
-				Note* nextNote = (Note*)notes.getElementAddress(nextNoteI);
+				Note* nextNote = &notes[nextNoteI];
 				int32_t newTicksTil =
 				    nextNote->pos
 				    - effectiveCurrentPos; // Assumes we're playing forwards - it'll get modified just below otherwise
@@ -2783,7 +2784,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 		if (noteTailsAllowed) {
 
 			// Investigate whether there's a wrapped note
-			Note* lastNote = (Note*)notes.getElementAddress(numNotesBefore - 1);
+			Note* lastNote = &notes[numNotesBefore - 1];
 
 			int32_t lengthBeforeWrap = oldLoopLength - lastNote->pos;
 			lengthAfterWrap = lastNote->length - lengthBeforeWrap;
@@ -2807,7 +2808,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 						}
 					}
 
-					Note* oldNote = (Note*)notes.getElementAddress(iOld);
+					Note* oldNote = &notes[iOld];
 					int32_t newPos = oldNote->pos;
 					int32_t newLength = oldNote->length;
 
@@ -2826,7 +2827,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 					}
 
 					int32_t iNew = iNewWithinRepeat + numNotesBefore * r;
-					Note* newNote = (Note*)notes.getElementAddress(iNew);
+					Note* newNote = &notes[iNew];
 					newNote->pos = newPos;
 					newNote->setLength(newLength);
 					newNote->setProbability(oldNote->getProbability());
@@ -2841,7 +2842,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 		// No-tails (e.g. one-shot samples):
 		else {
 
-			Note* firstNote = (Note*)notes.getElementAddress(0);
+			Note* firstNote = &notes[0];
 			bool anythingAtZero = (firstNote->pos == 0);
 
 			for (int32_t r = 1; r < numRepeatsRoundedUp; r++) { // For each repeat
@@ -2857,7 +2858,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 						}
 					}
 
-					Note* oldNote = (Note*)notes.getElementAddress(iOld);
+					Note* oldNote = &notes[iOld];
 					int32_t newPos = oldNote->pos;
 
 					if (r & 1) {
@@ -2873,7 +2874,7 @@ bool NoteRow::generateRepeats(ModelStackWithNoteRow* modelStack, uint32_t oldLoo
 					}
 
 					int32_t iNew = iNewWithinRepeat + numNotesBefore * r;
-					Note* newNote = (Note*)notes.getElementAddress(iNew);
+					Note* newNote = &notes[iNew];
 					newNote->pos = newPos;
 					newNote->setLength(1);
 					newNote->setProbability(oldNote->getProbability());
@@ -3160,7 +3161,7 @@ Error NoteRow::readFromFile(Deserializer& reader, int32_t* minY, InstrumentClip*
 
 			// Sneaky sorta hack for 2016 files - allow more params to be loaded into a ParamManager that already had
 			// some loading done by the Drum
-			if (smDeserializer.firmware_version < FirmwareVersion::official({1, 2, 0}) && parentClip->output) {
+			if (reader.firmware_version < FirmwareVersion::official({1, 2, 0}) && parentClip->output) {
 
 				SoundDrum* actualDrum = (SoundDrum*)((Kit*)parentClip->output)->getDrumFromIndex((int32_t)drum);
 
@@ -3392,31 +3393,18 @@ void NoteRow::writeToFile(Serializer& writer, int32_t drumIndex, InstrumentClip*
 	}
 
 	if (notes.getNumElements()) {
-		writer.write("\n");
-		writer.printIndents();
-		writer.write("noteDataWithLift=\"0x");
+		writer.writeAttributeHexBlobBegin("noteDataWithLift");
 
 		for (int32_t n = 0; n < notes.getNumElements(); n++) {
 			Note* thisNote = notes.getElement(n);
 
-			char buffer[9];
-
-			intToHex(thisNote->pos, buffer);
-			writer.write(buffer);
-
-			intToHex(thisNote->getLength(), buffer);
-			writer.write(buffer);
-
-			intToHex(thisNote->getVelocity(), buffer, 2);
-			writer.write(buffer);
-
-			intToHex(thisNote->getLift(), buffer, 2);
-			writer.write(buffer);
-
-			intToHex(thisNote->getProbability(), buffer, 2);
-			writer.write(buffer);
+			writer.writeHexBlobInt(thisNote->pos);
+			writer.writeHexBlobInt(thisNote->getLength());
+			writer.writeHexBlobInt(thisNote->getVelocity(), 1);
+			writer.writeHexBlobInt(thisNote->getLift(), 1);
+			writer.writeHexBlobInt(thisNote->getProbability(), 1);
 		}
-		writer.write("\"");
+		writer.writeHexBlobEnd();
 	}
 
 	ExpressionParamSet* expressionParams = paramManager.getExpressionParamSet();
@@ -3490,6 +3478,8 @@ void NoteRow::setDrum(Drum* newDrum, Kit* kit, ModelStackWithNoteRow* modelStack
 
 	drum = (SoundDrum*)
 	    newDrum; // Better set this temporarily for this call. See comment above for why we can't set it permanently yet
+	// While the drum's being swapped about, any index of NoteRows by Drum has to check what it finds
+	NoteRowVector::noteRowsChanged();
 
 	if (newParamManager) {
 		paramManager.stealParamCollectionsFrom(newParamManager, true);
@@ -3521,6 +3511,7 @@ void NoteRow::setDrum(Drum* newDrum, Kit* kit, ModelStackWithNoteRow* modelStack
 
 				drum = soundDrum; // Better set this temporarily for this call. See comment above for why we can't set
 				                  // it permanently yet
+				NoteRowVector::noteRowsChanged();
 				bool success = modelStack->song->getBackedUpParamManagerPreferablyWithClip(
 				    soundDrum, (Clip*)modelStack->getTimelineCounter(), &paramManager);
 				if (success) {
@@ -3563,6 +3554,7 @@ void NoteRow::setDrum(Drum* newDrum, Kit* kit, ModelStackWithNoteRow* modelStack
 		ModelStackWithThreeMainThings* modelStackWithThreeMainThings =
 		    modelStack->addOtherTwoThings(soundDrum, &paramManager);
 		drum = soundDrum;
+		NoteRowVector::noteRowsChanged();
 		soundDrum->ensureInaccessibleParamPresetValuesWithoutKnobsAreZero(modelStackWithThreeMainThings);
 		drum = NULL; // Yup this ugliness again, sorry!
 
@@ -3592,6 +3584,7 @@ void NoteRow::setDrum(Drum* newDrum, Kit* kit, ModelStackWithNoteRow* modelStack
 	}
 
 	drum = newDrum;
+	NoteRowVector::noteRowsChanged();
 
 	if (drum) {
 		drum->noteRowAssignedTemp = true;
@@ -3886,6 +3879,7 @@ void NoteRow::giveMidiCommandsToDrum() {
 	if (midiInput.containsSomething()) {
 		if (!drum->midiInput.containsSomething()) {
 			drum->midiInput = midiInput;
+			midiRoutingIndex.invalidate();
 		}
 		midiInput.clear();
 	}
@@ -3982,7 +3976,7 @@ Error NoteRow::appendNoteRow(ModelStackWithNoteRow* thisModelStack, ModelStackWi
 			// of this NoteRow *before* we do the appending.
 			if (anyWrapping && pingpongingGenerally) {
 				if (insertIndex) {
-					Note* lastNoteMe = (Note*)notes.getElementAddress(insertIndex - 1);
+					Note* lastNoteMe = &notes[insertIndex - 1];
 					int32_t distanceFromEnd = offset - lastNoteMe->pos;
 					if (lastNoteMe->length > distanceFromEnd) {
 						lastNoteMe->length = distanceFromEnd + lengthBeforeWrap;
@@ -4026,7 +4020,7 @@ Error NoteRow::appendNoteRow(ModelStackWithNoteRow* thisModelStack, ModelStackWi
 					}
 				}
 
-				Note* newNote = (Note*)notes.getElementAddress(insertIndex++);
+				Note* newNote = &notes[insertIndex++];
 				newNote->pos = newPos + offset;
 				newNote->setLength(newLength);
 				newNote->setProbability(oldNote->getProbability());
@@ -4069,7 +4063,7 @@ Error NoteRow::appendNoteRow(ModelStackWithNoteRow* thisModelStack, ModelStackWi
 					newPos += otherNoteRowLength;
 				}
 
-				Note* newNote = (Note*)notes.getElementAddress(insertIndex++);
+				Note* newNote = &notes[insertIndex++];
 				newNote->pos = newPos + offset;
 				newNote->setLength(1);
 				newNote->setProbability(oldNote->getProbability());
@@ -20,6 +20,8 @@
 #include "processing/engines/audio_engine.h"
 #include <new>
 
+uint32_t NoteRowVector::generation = 0;
+
 NoteRowVector::NoteRowVector() : OrderedResizeableArray(sizeof(NoteRow), 16, 0, 16, 7) {
 }
 
@@ -37,6 +39,7 @@ NoteRow* NoteRowVector::insertNoteRowAtIndex(int32_t index) {
 		return NULL;
 	}
 	void* memory = getElementAddress(index);
+	noteRowsChanged();
 
 	return new (memory) NoteRow();
 }
@@ -46,6 +49,22 @@ void NoteRowVector::deleteNoteRowAtIndex(int32_t startIndex, int32_t numToDelete
 		getElement(i)->~NoteRow();
 	}
 	deleteAtIndex(startIndex, numToDelete);
+	noteRowsChanged();
+}
+
+bool NoteRowVector::cloneFrom(NoteRowVector const* other) {
+	noteRowsChanged();
+	return OrderedResizeableArray::cloneFrom(other);
+}
+
+void NoteRowVector::swapElements(int32_t i1, int32_t i2) {
+	OrderedResizeableArray::swapElements(i1, i2);
+	noteRowsChanged();
+}
+
+void NoteRowVector::repositionElement(int32_t iFrom, int32_t iTo) {
+	OrderedResizeableArray::repositionElement(iFrom, iTo);
+	noteRowsChanged();
 }
 
 NoteRow* NoteRowVector::insertNoteRowAtY(int32_t y, int32_t* getIndex) {
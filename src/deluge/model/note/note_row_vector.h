@@ -30,4 +30,13 @@ public:
 	NoteRow* insertNoteRowAtIndex(int32_t index);
 	NoteRow* insertNoteRowAtY(int32_t y, int32_t* getIndex = NULL);
 	void deleteNoteRowAtIndex(int32_t index, int32_t numToDelete = 1);
+	bool cloneFrom(NoteRowVector const* other);
+	void swapElements(int32_t i1, int32_t i2);
+	void repositionElement(int32_t iFrom, int32_t iTo);
+
+	// Goes up whenever a NoteRow is added, removed or moved in any NoteRowVector, or given a different Drum, so that
+	// anything which has indexed NoteRows knows to index them again. Whatever sets a NoteRow's drum must call
+	// noteRowsChanged()
+	static uint32_t generation;
+	static void noteRowsChanged() { generation++; }
 };
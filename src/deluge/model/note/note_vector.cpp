@@ -19,16 +19,5 @@
 #include "model/note/note.h"
 #include <cstring>
 
-NoteVector::NoteVector() : OrderedResizeableArrayWith32bitKey(sizeof(Note)) {
-}
-
-Note* NoteVector::getElement(int32_t index) {
-	if (index < 0 || index >= getNumElements()) {
-		return NULL;
-	}
-	return (Note*)getElementAddress(index);
-}
-
-Note* NoteVector::getLast() {
-	return getElement(getNumElements() - 1);
+NoteVector::NoteVector() {
 }
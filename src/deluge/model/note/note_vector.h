@@ -19,16 +19,11 @@
 
 #include <cstdint>
 
-#include "util/container/array/ordered_resizeable_array.h"
+#include "util/container/array/typed_resizeable_array.hpp"
 
 class Note;
 
-class NoteVector : public OrderedResizeableArrayWith32bitKey {
+class NoteVector : public deluge::container::OrderedResizeableArray<Note> {
 public:
 	NoteVector();
-
-	Note* getElement(int32_t index);
-	Note* getLast();
-
-private:
 };
@@ -232,20 +232,13 @@ bool Output::writeDataToFile(Serializer& writer, Clip* clipForSavingOutputOnly,
 		writer.writeAttribute("activeModFunction", modKnobMode);
 
 		if (clipInstances.getNumElements()) {
-			writer.write("\n");
-			writer.printIndents();
-			writer.write("clipInstances=\"0x");
+			writer.writeAttributeHexBlobBegin("clipInstances");
 
 			for (int32_t i = 0; i < clipInstances.getNumElements(); i++) {
 				ClipInstance* thisInstance = clipInstances.getElement(i);
 
-				char buffer[9];
-
-				intToHex(thisInstance->pos, buffer);
-				writer.write(buffer);
-
-				intToHex(thisInstance->length, buffer);
-				writer.write(buffer);
+				writer.writeHexBlobInt(thisInstance->pos);
+				writer.writeHexBlobInt(thisInstance->length);
 
 				uint32_t clipCode;
 
@@ -259,10 +252,9 @@ bool Output::writeDataToFile(Serializer& writer, Clip* clipForSavingOutputOnly,
 					}
 				}
 
-				intToHex(clipCode, buffer);
-				writer.write(buffer);
+				writer.writeHexBlobInt(clipCode);
 			}
-			writer.write("\"");
+			writer.writeHexBlobEnd();
 		}
 
 		writer.writeAttribute("colour", colour);
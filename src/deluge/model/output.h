@@ -20,6 +20,7 @@
 #include "definitions_cxx.hpp"
 #include "model/clip/clip_instance_vector.h"
 #include "modulation/params/param.h"
+#include "processing/engines/cpu_meter.h"
 #include "util/d_string.h"
 #include <cstdint>
 
@@ -73,6 +74,8 @@ public:
 
 	bool nextClipFoundShouldGetArmed; // Temp thing for Session::armClipsToStartOrSoloWithQuantization
 
+	CPUMeter::Counters cpuMeter; // Cycles spent rendering everything in this Output
+
 	// reverbAmountAdjust has "1" as 67108864
 	// Only gets called if there's an activeClip
 	virtual void renderOutput(ModelStack* modelStack, StereoSample* startPos, StereoSample* endPos, int32_t numSamples,
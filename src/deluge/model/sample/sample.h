@@ -18,8 +18,10 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "dsp/convert/sample_format.h"
 #include "model/sample/sample_cluster.h"
 #include "model/sample/sample_cluster_array.h"
+#include "model/sample/sample_peaks.h"
 #include "storage/audio/audio_file.h"
 #include "util/container/array/ordered_resizeable_array.h"
 #include "util/container/array/ordered_resizeable_array_with_multi_word_key.h"
@@ -92,6 +94,24 @@ public:
 		}
 	}
 
+	// Same as convertOneData(), for a run of numWords values
+	inline void convertData(int32_t* data, int32_t numWords) {
+		using namespace deluge::dsp::convert;
+
+		if (rawDataFormat == RAW_DATA_FLOAT) {
+			floatToQ31((uint32_t*)data, numWords);
+		}
+		else if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_32) {
+			swapBytes32((uint32_t*)data, numWords);
+		}
+		else if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_16) {
+			swapBytes16((uint32_t*)data, numWords);
+		}
+		else if (rawDataFormat == RAW_DATA_UNSIGNED_8) {
+			flipSign8((uint32_t*)data, numWords);
+		}
+	}
+
 	String tempFilePathForRecording;
 	uint8_t byteDepth;
 	uint32_t sampleRate;
@@ -140,6 +160,8 @@ public:
 
 	SampleClusterArray clusters;
 
+	SamplePeaks peaks; // Waveform overview, for drawing it zoomed out. Only made once something asks for it
+
 protected:
 #if ALPHA_OR_BETA_VERSION
 	void numReasonsDecreasedToZero(char const* errorCode);
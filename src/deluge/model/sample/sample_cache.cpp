@@ -20,11 +20,14 @@
 #include "memory/general_memory_allocator.h"
 #include "model/sample/sample.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/sample_cache_store.h"
 #include "storage/cluster/cluster.h"
 #include "util/misc.h"
+#include <cstring>
 
 SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newWaveformLengthBytes,
-                         int32_t newPhaseIncrement, int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart) {
+                         int32_t newPhaseIncrement, int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart,
+                         bool newReversed) {
 	sample = newSample;
 	phaseIncrement = newPhaseIncrement;
 	timeStretchRatio = newTimeStretchRatio;
@@ -34,6 +37,12 @@ SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newW
 #endif
 	waveformLengthBytes = newWaveformLengthBytes;
 	skipSamplesAtStart = newSkipSamplesAtStart;
+	reversed = newReversed;
+	cardState = CardState::UNKNOWN;
+	queuedForCard = false;
+	wantsRestoring = false;
+	cardBytePos = 0;
+	cardLastUse = 0;
 	/*
 	for (int32_t i = 0; i < numClusters; i++) {
 	    clusters[i] = NULL; // We don't actually have to initialize these, since writeBytePos tells us how many are
@@ -43,6 +52,7 @@ SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newW
 }
 
 SampleCache::~SampleCache() {
+	sampleCacheStore.forget(this);
 	unlinkClusters(0, true);
 }
 
@@ -158,6 +168,66 @@ bool SampleCache::setupNewCluster(int32_t clusterIndex) {
 	clusters[clusterIndex]->clusterIndex = clusterIndex;
 	clusters[clusterIndex]->sampleCache = this;
 
+	// The one before is finished now, so can go on the card
+	if (clusterIndex) {
+		sampleCacheStore.requestSpill(this);
+	}
+
+	return true;
+}
+
+// Where the data in a Cluster stops, and the next one's starts. The last sample straddling the boundary goes in the
+// earlier Cluster, so that's the boundary rounded up to a whole sample
+int32_t SampleCache::getClusterEndBytePos(int32_t clusterIndex) {
+	uint32_t bytesPerSample = sample->numChannels * kCacheByteDepth;
+	return (uint32_t)(((clusterIndex + 1) << audioFileManager.clusterSizeMagnitude) + bytesPerSample - 1)
+	       / bytesPerSample * bytesPerSample;
+}
+
+// Copies out a finished Cluster's data as it's laid out on the card - from the Cluster's nominal start, so the first
+// few bytes come from the end of the previous Cluster. Returns the number of bytes
+int32_t SampleCache::copyClusterOut(int32_t clusterIndex, uint8_t* dest) {
+	int32_t startBytePos = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	int32_t endBytePos = getClusterEndBytePos(clusterIndex);
+
+#if ALPHA_OR_BETA_VERSION
+	if (endBytePos > writeBytePos) {
+		FREEZE_WITH_ERROR("E458");
+	}
+#endif
+
+	int32_t numBytesInPrevious = 0;
+	if (clusterIndex) {
+		numBytesInPrevious = getClusterEndBytePos(clusterIndex - 1) - startBytePos;
+		memcpy(dest, &clusters[clusterIndex - 1]->data[audioFileManager.clusterSize], numBytesInPrevious);
+	}
+	memcpy(&dest[numBytesInPrevious], &clusters[clusterIndex]->data[numBytesInPrevious],
+	       endBytePos - startBytePos - numBytesInPrevious);
+	return endBytePos - startBytePos;
+}
+
+// For a Cluster just read back in from the card, laid out as copyClusterOut() gives it. Takes it on in place of
+// rendering that Cluster, unless the cache has moved on while it was being read, in which case the caller must
+// deallocate it. Any voice still writing this Cluster will see it's been written ahead of it, and switch to reading
+bool SampleCache::adoptClusterFromCard(int32_t clusterIndex, Cluster* cluster) {
+	int32_t startBytePos = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	int32_t endBytePos = getClusterEndBytePos(clusterIndex);
+
+	// Only if the Clusters before are all still here, and this one isn't already finished
+	if (writeBytePos < startBytePos || writeBytePos >= endBytePos) {
+		return false;
+	}
+
+	if (getNumExistentClusters(writeBytePos) > clusterIndex) {
+		audioFileManager.deallocateCluster(clusters[clusterIndex]);
+	}
+
+	clusters[clusterIndex] = cluster;
+	cluster->clusterIndex = clusterIndex;
+	cluster->sampleCache = this;
+	writeBytePos = endBytePos;
+
+	prioritizeNotStealingCluster(clusterIndex); // Puts it in its queue
 	return true;
 }
 
@@ -24,13 +24,18 @@ class Cluster;
 
 class SampleCache {
 public:
+	enum class CardState : uint8_t { UNKNOWN, AVAILABLE, UNAVAILABLE };
+
 	SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newWaveformLengthBytes, int32_t newPhaseIncrement,
-	            int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart);
+	            int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart, bool newReversed);
 	~SampleCache();
 	void clusterStolen(int32_t clusterIndex);
 	bool setupNewCluster(int32_t cachedClusterIndex);
 	Cluster* getCluster(int32_t clusterIndex);
 	void setWriteBytePos(int32_t newWriteBytePos);
+	int32_t getClusterEndBytePos(int32_t clusterIndex);
+	int32_t copyClusterOut(int32_t clusterIndex, uint8_t* dest);
+	bool adoptClusterFromCard(int32_t clusterIndex, Cluster* cluster);
 
 	int32_t writeBytePos;
 #if ALPHA_OR_BETA_VERSION
@@ -41,6 +46,14 @@ public:
 	int32_t phaseIncrement;
 	int32_t timeStretchRatio;
 	int32_t skipSamplesAtStart;
+	bool reversed;
+
+	// For SampleCacheStore, which keeps copies of finished Clusters on the card
+	CardState cardState;
+	bool queuedForCard;
+	bool wantsRestoring;
+	int32_t cardBytePos; // How much of this cache, from the start, is on the card. Always the end of a Cluster
+	uint32_t cardLastUse; // The SampleCacheStore's use count when this was last marked used in its file
 
 private:
 	void unlinkClusters(int32_t startAtIndex, bool beingDestructed);
@@ -191,6 +191,11 @@ justEnqueue:
 			}
 		}
 
+		// If it's still waiting to be loaded, maybe for something less urgent (e.g. ClusterPrefetcher), catch it up
+		else if (loadInstruction == CLUSTER_ENQUEUE && !cluster->loaded) {
+			audioFileManager.loadingQueue.raisePriorityIfPresent(cluster, priorityRating);
+		}
+
 		audioFileManager.addReasonToCluster(cluster);
 
 #if 1 || ALPHA_OR_BETA_VERSION // Switching permanently on for now, as users on V4.0.x have been getting E341.
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "storage/cluster/cluster_priority_queue.h"
 
 class Cluster;
 class Sample;
@@ -31,7 +32,7 @@ public:
 
 	// TODO: This should return a std::expected<Cluster*, Error), removing the last parameter
 	Cluster* getCluster(Sample* sample, uint32_t clusterIndex, int32_t loadInstruction = CLUSTER_ENQUEUE,
-	                    uint32_t priorityRating = 0xFFFFFFFF, Error* error = nullptr);
+	                    uint32_t priorityRating = kClusterLowestPriority, Error* error = nullptr);
 	void ensureNoReason(Sample* sample);
 
 	// In sectors. (Those 512 byte things. Not to be confused with clusters.)
@@ -19,9 +19,11 @@
 #pragma GCC target("fpu=neon")
 
 #include "model/sample/sample_low_level_reader.h"
+#include "dsp/interpolation/precise.h"
 #include "dsp/timestretch/time_stretcher.h"
 #include "hid/display/display.h"
 #include "io/debug/log.h"
+#include "io/debug/print.h"
 #include "model/sample/sample.h"
 #include "model/voice/voice.h"
 #include "model/voice/voice_sample_playback_guide.h"
@@ -30,10 +32,15 @@
 
 #include "arm_neon.h"
 
+std::array<ResamplerCost, kNumInterpolationModes> resamplerCosts{};
+
+static_assert(deluge::dsp::interpolation::kPreciseNumTaps == kInterpolationMaxNumSamples);
+
 SampleLowLevelReader::SampleLowLevelReader() {
 	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
 		clusters[l] = NULL;
 	}
+	interpolationBufferIsPrecise = false;
 }
 
 SampleLowLevelReader::~SampleLowLevelReader() {
@@ -472,10 +479,7 @@ void SampleLowLevelReader::fillInterpolationBufferRetrospectively(Sample* sample
 
 		if (!clusters[0]) {
 justWriteZeros:
-			interpolationBuffer[0][0][i] = 0;
-			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = 0;
-			}
+			bufferZero(i, sample->numChannels);
 		}
 
 		else {
@@ -486,11 +490,7 @@ justWriteZeros:
 
 			// If there was valid audio data there...
 			if (bytesPastClusterStart >= 0) {
-				interpolationBuffer[0][0][i] = *(int16_t*)(thisPlayPos + 2);
-
-				if (sample->numChannels == 2) {
-					interpolationBuffer[1][0][i] = *(int16_t*)(thisPlayPos + 2 + sample->byteDepth);
-				}
+				bufferSample(i, thisPlayPos, sample->numChannels, sample->byteDepth);
 			}
 
 			// Or if not, just write zeros
@@ -508,10 +508,7 @@ bool SampleLowLevelReader::fillInterpolationBufferForward(SamplePlaybackGuide* g
 
 		if (!clusters[0]) {
 doZeroesFillingBuffer:
-			interpolationBuffer[0][0][i] = 0;
-			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = 0;
-			}
+			bufferZero(i, sample->numChannels);
 			currentPlayPos++;
 			if ((uint32_t)currentPlayPos >= interpolationBufferSize) {
 				return false;
@@ -525,10 +522,7 @@ doZeroesFillingBuffer:
 				goto doZeroesFillingBuffer;
 			}
 
-			interpolationBuffer[0][0][i] = *(int16_t*)(currentPlayPos + 2);
-			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = *(int16_t*)(currentPlayPos + 2 + sample->byteDepth);
-			}
+			bufferSample(i, currentPlayPos, sample->numChannels, sample->byteDepth);
 
 			// And move forward one more
 			currentPlayPos += sample->numChannels * sample->byteDepth * guide->playDirection;
@@ -623,10 +617,7 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 				int32_t offset = difference >> 1;
 
 				for (int32_t i = 0; i < interpolationBufferSize; i++) {
-					interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i + offset];
-					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i + offset];
-					}
+					moveBufferedSample(i, i + offset, sample->numChannels);
 				}
 
 				jumpBackSamples(sample, offset, guide->playDirection);
@@ -655,10 +646,7 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 				int32_t offset = difference >> 1;
 
 				for (int32_t i = 0; i < interpolationBufferSizeLastTime; i++) {
-					interpolationBuffer[0][0][i + offset] = interpolationBuffer[0][0][i];
-					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i + offset] = interpolationBuffer[1][0][i];
-					}
+					moveBufferedSample(i + offset, i, sample->numChannels);
 				}
 
 				// And fill up to end of interpolation buffer
@@ -670,10 +658,7 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 
 				// If still here, fill far end with zeros. Not perfect, but it'll do.
 				for (int32_t i = (interpolationBufferSize - offset); i < interpolationBufferSize; i++) {
-					interpolationBuffer[0][0][i] = 0;
-					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i] = 0;
-					}
+					bufferZero(i, sample->numChannels);
 				}
 
 				if (ALPHA_OR_BETA_VERSION && clusters[0]) {
@@ -880,45 +865,103 @@ doZeroes:
 
 #pragma GCC push_options
 #pragma GCC optimize("no-tree-loop-distribute-patterns")
-void SampleLowLevelReader::bufferIndividualSampleForInterpolation(uint32_t bitMask, int32_t numChannels,
-                                                                  int32_t byteDepth, char* __restrict__ playPosNow) {
-
+template <typename Value>
+[[gnu::always_inline]] static inline void shiftInterpolationBufferAlong(Value (*buffer)[kInterpolationMaxNumSamples],
+                                                                        int32_t numChannels) {
 	// This works better than using memmoves. Ideally we'd switch this off if not smoothly interpolating - check that
 	// that's actually more efficient though
 	for (int32_t i = kInterpolationMaxNumSamples - 1; i >= 1; i--) {
-		interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - 1];
+		buffer[0][i] = buffer[0][i - 1];
 		if (numChannels == 2) {
-			interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - 1];
+			buffer[1][i] = buffer[1][i - 1];
 		}
 	}
+}
 
-	interpolationBuffer[0][0][0] = *(int16_t*)(playPosNow + 2);
-
-	if (numChannels == 2) {
-		interpolationBuffer[1][0][0] = *(int16_t*)(playPosNow + 2 + byteDepth);
+void SampleLowLevelReader::bufferIndividualSampleForInterpolation(uint32_t bitMask, int32_t numChannels,
+                                                                  int32_t byteDepth, char* __restrict__ playPosNow) {
+	if (interpolationBufferIsPrecise) {
+		shiftInterpolationBufferAlong(preciseInterpolationBuffer, numChannels);
 	}
+	else {
+		shiftInterpolationBufferAlong((int16_t(*)[kInterpolationMaxNumSamples])interpolationBuffer, numChannels);
+	}
+	bufferSample(0, playPosNow, numChannels, byteDepth);
 }
 
 #pragma GCC pop_options
 
 void SampleLowLevelReader::bufferZeroForInterpolation(int32_t numChannels) {
+	if (interpolationBufferIsPrecise) {
+		shiftInterpolationBufferAlong(preciseInterpolationBuffer, numChannels);
+	}
+	else {
+		shiftInterpolationBufferAlong((int16_t(*)[kInterpolationMaxNumSamples])interpolationBuffer, numChannels);
+	}
+	bufferZero(0, numChannels);
 
-	// This works better than using memmoves. Ideally we'd switch this off if not smoothly interpolating - check that
-	// that's actually more efficient though
-	for (int32_t i = kInterpolationMaxNumSamples - 1; i >= 1; i--) {
-		interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - 1];
+	currentPlayPos++;
+}
+
+void SampleLowLevelReader::bufferSample(int32_t i, char const* playPos, int32_t numChannels, int32_t byteDepth) {
+	if (interpolationBufferIsPrecise) {
+		preciseInterpolationBuffer[0][i] = *(int32_t*)playPos;
+		if (numChannels == 2) {
+			preciseInterpolationBuffer[1][i] = *(int32_t*)(playPos + byteDepth);
+		}
+	}
+	else {
+		interpolationBuffer[0][0][i] = *(int16_t*)(playPos + 2);
 		if (numChannels == 2) {
-			interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - 1];
+			interpolationBuffer[1][0][i] = *(int16_t*)(playPos + 2 + byteDepth);
 		}
 	}
+}
 
-	interpolationBuffer[0][0][0] = 0;
+void SampleLowLevelReader::bufferZero(int32_t i, int32_t numChannels) {
+	if (interpolationBufferIsPrecise) {
+		preciseInterpolationBuffer[0][i] = 0;
+		if (numChannels == 2) {
+			preciseInterpolationBuffer[1][i] = 0;
+		}
+	}
+	else {
+		interpolationBuffer[0][0][i] = 0;
+		if (numChannels == 2) {
+			interpolationBuffer[1][0][i] = 0;
+		}
+	}
+}
 
-	if (numChannels == 2) {
-		interpolationBuffer[1][0][0] = 0;
+void SampleLowLevelReader::moveBufferedSample(int32_t to, int32_t from, int32_t numChannels) {
+	if (interpolationBufferIsPrecise) {
+		preciseInterpolationBuffer[0][to] = preciseInterpolationBuffer[0][from];
+		if (numChannels == 2) {
+			preciseInterpolationBuffer[1][to] = preciseInterpolationBuffer[1][from];
+		}
 	}
+	else {
+		interpolationBuffer[0][0][to] = interpolationBuffer[0][0][from];
+		if (numChannels == 2) {
+			interpolationBuffer[1][0][to] = interpolationBuffer[1][0][from];
+		}
+	}
+}
 
-	currentPlayPos++;
+// Only happens when a sound's InterpolationMode changes, so the values carry over rather than being read in again
+void SampleLowLevelReader::setInterpolationBufferPrecise(bool precise, int32_t numChannels) {
+	for (int32_t c = 0; c < numChannels; c++) {
+		for (int32_t i = 0; i < kInterpolationMaxNumSamples; i++) {
+			if (precise) {
+				// The low bits are gone, so it's no more precise than before until these have all moved out
+				preciseInterpolationBuffer[c][i] = (int32_t)interpolationBuffer[c][0][i] << 16;
+			}
+			else {
+				interpolationBuffer[c][0][i] = preciseInterpolationBuffer[c][i] >> 16;
+			}
+		}
+	}
+	interpolationBufferIsPrecise = precise;
 }
 
 // This could be optimized, but why bother, it doesn't get called much
@@ -994,6 +1037,62 @@ void SampleLowLevelReader::interpolateLinear(int32_t* __restrict__ sampleRead, i
 #include "dsp/interpolation/interpolate_linear.h"
 }
 
+void SampleLowLevelReader::interpolatePrecise(int32_t* __restrict__ sampleRead, int32_t numChannelsNow,
+                                              int32_t whichKernel, uint32_t bitMask) {
+	deluge::dsp::interpolation::interpolatePrecise(sampleRead, preciseInterpolationBuffer, numChannelsNow, oscPos,
+	                                               whichKernel, bitMask);
+}
+
+// Moves the sinc interpolation buffer along by numSamplesToJumpForward, reading in the new ones from playPos, which
+// points at the top 16 bits of a sample - all the 16-bit buffer wants. The 32-bit one reads the whole word, from 2
+// bytes before. Returns the play position after the last sample read in
+template <typename Value>
+[[gnu::always_inline]] static inline char*
+bufferSamplesForSinc(Value (*__restrict__ buffer)[kInterpolationMaxNumSamples], char* __restrict__ playPos,
+                     int32_t numSamplesToJumpForward, int32_t numChannels, int32_t byteDepth, int32_t jumpAmount) {
+	constexpr int32_t kBytesBefore = sizeof(Value) - sizeof(int16_t);
+
+	Value sourceL = *(Value*)(playPos - kBytesBefore);
+
+	for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
+		buffer[0][i] = buffer[0][i - numSamplesToJumpForward];
+	}
+
+	if (numChannels == 2) {
+		for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
+			buffer[1][i] = buffer[1][i - numSamplesToJumpForward];
+		}
+
+		numSamplesToJumpForward--;
+
+		while (true) {
+			buffer[0][numSamplesToJumpForward] = sourceL;
+			buffer[1][numSamplesToJumpForward] = *(Value*)(playPos - kBytesBefore + byteDepth);
+			playPos += jumpAmount;
+			if (!numSamplesToJumpForward) {
+				return playPos;
+			}
+			numSamplesToJumpForward--;
+			sourceL = *(Value*)(playPos - kBytesBefore);
+		}
+	}
+
+	else {
+
+		numSamplesToJumpForward--;
+
+		while (true) {
+			playPos += jumpAmount;
+			buffer[0][numSamplesToJumpForward] = sourceL;
+			if (!numSamplesToJumpForward) {
+				return playPos;
+			}
+			sourceL = *(Value*)(playPos - kBytesBefore);
+			numSamplesToJumpForward--;
+		}
+	}
+}
+
 // This stuff is in its own function here rather than in Voice because for some reason it's faster
 void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBufferPos, int32_t numSamplesTotal,
                                                 Sample* sample, int32_t jumpAmount, int32_t numChannels,
@@ -1002,7 +1101,13 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
                                                 int32_t interpolationBufferSize, bool writingCache,
                                                 char** __restrict__ cacheWritePos, bool* __restrict__ doneAnySamplesYet,
                                                 TimeStretcher* timeStretcher, bool bufferingToTimeStretcher,
-                                                int32_t whichKernel) {
+                                                int32_t whichKernel, bool highPrecision) {
+
+	uint32_t const startTime = Debug::readCycleCounter();
+
+	if (highPrecision != interpolationBufferIsPrecise) {
+		setInterpolationBufferPrecise(highPrecision, numChannels);
+	}
 
 	uint32_t const bitMask = sample->bitMask;
 	int32_t const byteDepth = sample->byteDepth;
@@ -1041,45 +1146,15 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 						numSamplesToJumpForward = kInterpolationMaxNumSamples;
 					}
 
-					int16_t sourceL = *(int16_t*)currentPlayPosNow;
-
-					for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
-						interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - numSamplesToJumpForward];
+					if (highPrecision) {
+						currentPlayPosNow =
+						    bufferSamplesForSinc(preciseInterpolationBuffer, currentPlayPosNow, numSamplesToJumpForward,
+						                         numChannels, byteDepth, jumpAmount);
 					}
-
-					if (numChannels == 2) {
-						for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
-							interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - numSamplesToJumpForward];
-						}
-
-						numSamplesToJumpForward--;
-
-						while (true) {
-							interpolationBuffer[0][0][numSamplesToJumpForward] = sourceL;
-							interpolationBuffer[1][0][numSamplesToJumpForward] =
-							    *(int16_t*)(currentPlayPosNow + byteDepth);
-							currentPlayPosNow += jumpAmount;
-							if (!numSamplesToJumpForward) {
-								goto skipFirstSmooth;
-							}
-							numSamplesToJumpForward--;
-							sourceL = *(int16_t*)currentPlayPosNow;
-						}
-					}
-
 					else {
-
-						numSamplesToJumpForward--;
-
-						while (true) {
-							currentPlayPosNow += jumpAmount;
-							interpolationBuffer[0][0][numSamplesToJumpForward] = sourceL;
-							if (!numSamplesToJumpForward) {
-								goto skipFirstSmooth;
-							}
-							sourceL = *(int16_t*)currentPlayPosNow;
-							numSamplesToJumpForward--;
-						}
+						currentPlayPosNow = bufferSamplesForSinc(
+						    (int16_t(*)[kInterpolationMaxNumSamples])interpolationBuffer, currentPlayPosNow,
+						    numSamplesToJumpForward, numChannels, byteDepth, jumpAmount);
 					}
 				}
 			}
@@ -1089,7 +1164,12 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 
 skipFirstSmooth:
 			int32_t sampleRead[2];
-			interpolate(sampleRead, numChannels, whichKernel);
+			if (highPrecision) {
+				interpolatePrecise(sampleRead, numChannels, whichKernel, bitMask);
+			}
+			else {
+				interpolate(sampleRead, numChannels, whichKernel);
+			}
 
 			int32_t existingValueL = *oscBufferPosNow;
 
@@ -1181,6 +1261,13 @@ skipFirstLinear:
 	if (cacheWritePos) {
 		*cacheWritePos = cacheWritePosNow;
 	}
+
+	InterpolationMode mode = (interpolationBufferSize <= 2) ? InterpolationMode::LINEAR
+	                         : highPrecision                ? InterpolationMode::PRECISE
+	                                                        : InterpolationMode::SMOOTH;
+	ResamplerCost& cost = resamplerCosts[util::to_underlying(mode)];
+	cost.numCycles += Debug::readCycleCounter() - startTime;
+	cost.numSamples += numSamplesTotal;
 }
 
 void SampleLowLevelReader::readSamplesNative(int32_t** __restrict__ bufferPos, int32_t numSamplesTotal, Sample* sample,
@@ -1239,7 +1326,8 @@ bool SampleLowLevelReader::readSamplesForTimeStretching(
     int32_t* outputBuffer, SamplePlaybackGuide* guide, Sample* sample, int32_t numSamples, int32_t numChannels,
     int32_t numChannelsAfterCondensing, int32_t phaseIncrement, int32_t amplitude, int32_t amplitudeIncrement,
     bool loopingAtLowLevel, int32_t jumpAmount, int32_t bufferSize, TimeStretcher* timeStretcher,
-    bool bufferingToTimeStretcher, int32_t whichPlayHead, int32_t whichKernel, int32_t priorityRating) {
+    bool bufferingToTimeStretcher, int32_t whichPlayHead, int32_t whichKernel, int32_t priorityRating,
+    bool highPrecision) {
 
 	do {
 		int32_t samplesNow = numSamples;
@@ -1269,7 +1357,8 @@ bool SampleLowLevelReader::readSamplesForTimeStretching(
 			bool doneAnySamplesYet = false;
 			readSamplesResampled(&outputBuffer, samplesNow, sample, jumpAmount, numChannels, numChannelsAfterCondensing,
 			                     phaseIncrement, &amplitude, amplitudeIncrement, bufferSize, false, NULL,
-			                     &doneAnySamplesYet, timeStretcher, bufferingToTimeStretcher, whichKernel);
+			                     &doneAnySamplesYet, timeStretcher, bufferingToTimeStretcher, whichKernel,
+			                     highPrecision);
 		}
 
 		numSamples -= samplesNow;
@@ -1298,6 +1387,8 @@ void SampleLowLevelReader::cloneFrom(SampleLowLevelReader* other, bool stealReas
 	}
 
 	memcpy(interpolationBuffer, other->interpolationBuffer, sizeof(interpolationBuffer));
+	memcpy(preciseInterpolationBuffer, other->preciseInterpolationBuffer, sizeof(preciseInterpolationBuffer));
+	interpolationBufferIsPrecise = other->interpolationBufferIsPrecise;
 
 	oscPos = other->oscPos;
 	currentPlayPos = other->currentPlayPos;
@@ -20,6 +20,7 @@
 #include "arm_neon_shim.h"
 
 #include "definitions_cxx.hpp"
+#include <array>
 #include <cstdint>
 #define REASSESSMENT_ACTION_STOP_OR_LOOP 0
 #define REASSESSMENT_ACTION_NEXT_CLUSTER 1
@@ -31,6 +32,14 @@ class Cluster;
 class TimeStretcher;
 class SamplePlaybackGuide;
 
+/// Cycles spent resampling with each InterpolationMode, and how many samples that produced, for working out what
+/// switching a sound to InterpolationMode::PRECISE would cost. Reported over debug sysex
+struct ResamplerCost {
+	uint64_t numCycles;
+	uint64_t numSamples;
+};
+extern std::array<ResamplerCost, kNumInterpolationModes> resamplerCosts;
+
 class SampleLowLevelReader {
 public:
 	SampleLowLevelReader();
@@ -42,6 +51,7 @@ public:
 	void jumpForwardZeroes(int32_t bufferSize, int32_t numChannels, int32_t phaseIncrement);
 	void interpolate(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel);
 	void interpolateLinear(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel);
+	void interpolatePrecise(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel, uint32_t bitMask);
 	void fillInterpolationBufferRetrospectively(Sample* sample, int32_t bufferSize, int32_t startI,
 	                                            int32_t playDirection);
 	void jumpBackSamples(Sample* sample, int32_t numToJumpBack, int32_t playDirection);
@@ -77,14 +87,15 @@ public:
 	                          int32_t phaseIncrement, int32_t* amplitude, int32_t amplitudeIncrement,
 	                          int32_t bufferSize, bool writingCache, char** __restrict__ cacheWritePos,
 	                          bool* doneAnySamplesYet, TimeStretcher* timeStretcher, bool bufferingToTimeStretcher,
-	                          int32_t whichKernel);
+	                          int32_t whichKernel, bool highPrecision = false);
 
 	bool readSamplesForTimeStretching(int32_t* oscBufferPos, SamplePlaybackGuide* guide, Sample* sample,
 	                                  int32_t numSamples, int32_t numChannels, int32_t numChannelsAfterCondensing,
 	                                  int32_t phaseIncrement, int32_t amplitude, int32_t amplitudeIncrement,
 	                                  bool loopingAtLowLevel, int32_t jumpAmount, int32_t bufferSize,
 	                                  TimeStretcher* timeStretcher, bool bufferingToTimeStretcher,
-	                                  int32_t whichPlayHead, int32_t whichKernel, int32_t priorityRating);
+	                                  int32_t whichPlayHead, int32_t whichKernel, int32_t priorityRating,
+	                                  bool highPrecision = false);
 
 	void bufferIndividualSampleForInterpolation(uint32_t bitMask, int32_t numChannels, int32_t byteDepth,
 	                                            char* playPosNow);
@@ -99,9 +110,18 @@ public:
 
 	int16x4_t interpolationBuffer[2][kInterpolationMaxNumSamples >> 2];
 
+	// Whole 32-bit words as read from the Cluster, newest first, for InterpolationMode::PRECISE - which masks off
+	// whatever's below the sample's own bits itself. Only one of the two buffers is kept up to date at a time
+	int32_t preciseInterpolationBuffer[2][kInterpolationMaxNumSamples];
+	bool interpolationBufferIsPrecise;
+
 	Cluster* clusters[kNumClustersLoadedAhead];
 
 private:
+	void setInterpolationBufferPrecise(bool precise, int32_t numChannels);
+	void bufferSample(int32_t i, char const* playPos, int32_t numChannels, int32_t byteDepth);
+	void bufferZero(int32_t i, int32_t numChannels);
+	void moveBufferedSample(int32_t to, int32_t from, int32_t numChannels);
 	bool assignClusters(SamplePlaybackGuide* guide, Sample* sample, int32_t clusterIndex, int32_t priorityRating);
 	bool fillInterpolationBufferForward(SamplePlaybackGuide* guide, Sample* sample, int32_t interpolationBufferSize,
 	                                    bool loopingAtLowLevel, int32_t numSpacesToFill, int32_t priorityRating);
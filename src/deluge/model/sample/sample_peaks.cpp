@@ -0,0 +1,298 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/sample/sample_peaks.h"
+#include "memory/memory_allocator_interface.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+PeakEntry combine(PeakEntry const& a, PeakEntry const& b) {
+	float meanSquare = ((float)a.rms * a.rms + (float)b.rms * b.rms) * 0.5f;
+	return {
+	    .min = std::min(a.min, b.min),
+	    .max = std::max(a.max, b.max),
+	    .rms = (uint16_t)std::sqrt(meanSquare),
+	};
+}
+
+template <int32_t byteDepth>
+int32_t readValue(uint8_t const* pos) {
+	if constexpr (byteDepth == 1) {
+		return (int32_t)((uint32_t)pos[0] << 24);
+	}
+	else if constexpr (byteDepth == 2) {
+		return (int32_t)(((uint32_t)pos[0] << 16) | ((uint32_t)pos[1] << 24));
+	}
+	else if constexpr (byteDepth == 3) {
+		return (int32_t)(((uint32_t)pos[0] << 8) | ((uint32_t)pos[1] << 16) | ((uint32_t)pos[2] << 24));
+	}
+	else {
+		int32_t value;
+		memcpy(&value, pos, 4);
+		return value;
+	}
+}
+
+} // namespace
+
+SamplePeaks::~SamplePeaks() {
+	clear();
+}
+
+int32_t SamplePeaks::getNumLevels(uint32_t numBaseEntries) {
+	return numBaseEntries ? std::bit_width(numBaseEntries - 1) + 1 : 0;
+}
+
+// Where a level starts, for peaks with room for this many base entries
+uint32_t SamplePeaks::getLevelOffset(uint32_t numBaseEntries, int32_t level) {
+	uint32_t offset = 0;
+	for (int32_t l = 0; l < level; l++) {
+		offset += ((numBaseEntries - 1) >> l) + 1;
+	}
+	return offset;
+}
+
+bool SamplePeaks::setup(uint64_t numFrames) {
+	clear();
+
+	uint32_t numBaseEntries = ((numFrames - 1) >> kBaseMagnitude) + 1;
+	if (!numFrames || numBaseEntries > (1 << 24)) {
+		status_ = Status::FAILED;
+		return false;
+	}
+
+	int32_t numLevels = getNumLevels(numBaseEntries);
+	entries_ = (PeakEntry*)allocLowSpeed(getLevelOffset(numBaseEntries, numLevels) * sizeof(PeakEntry));
+	if (!entries_) {
+		status_ = Status::FAILED;
+		return false;
+	}
+
+	capacity_ = numBaseEntries;
+	numLevels_ = numLevels;
+	status_ = Status::PENDING;
+	return true;
+}
+
+bool SamplePeaks::grow(uint64_t numFrames) {
+	uint32_t numBaseEntries = ((numFrames - 1) >> kBaseMagnitude) + 1;
+	if (numBaseEntries <= capacity_ || numBaseEntries > (1 << 24)) {
+		return false;
+	}
+
+	int32_t numLevels = getNumLevels(numBaseEntries);
+	PeakEntry* newEntries = (PeakEntry*)allocLowSpeed(getLevelOffset(numBaseEntries, numLevels) * sizeof(PeakEntry));
+	if (!newEntries) {
+		return false;
+	}
+
+	for (int32_t l = 0; l < numLevels_; l++) {
+		memcpy(&newEntries[getLevelOffset(numBaseEntries, l)], &entries_[getLevelOffset(capacity_, l)],
+		       getNumEntriesDone(l) * sizeof(PeakEntry));
+	}
+	delugeDealloc(entries_);
+
+	entries_ = newEntries;
+	capacity_ = numBaseEntries;
+	numLevels_ = numLevels;
+	return true;
+}
+
+void SamplePeaks::clear() {
+	if (entries_) {
+		delugeDealloc(entries_);
+		entries_ = nullptr;
+	}
+	capacity_ = 0;
+	numBaseEntriesDone_ = 0;
+	numLevels_ = 0;
+	numFramesFed_ = 0;
+	overflowed_ = false;
+	status_ = Status::NONE;
+	pendingMin_ = 0;
+	pendingMax_ = 0;
+	pendingSumSquares_ = 0;
+	pendingNumValues_ = 0;
+}
+
+uint32_t SamplePeaks::getNumEntriesDone(int32_t level) const {
+	if (!numBaseEntriesDone_) {
+		return 0;
+	}
+	// Until finish(), an entry above the base level only exists once both the ones below it do
+	if (status_ == Status::COMPLETE) {
+		return ((numBaseEntriesDone_ - 1) >> level) + 1;
+	}
+	return numBaseEntriesDone_ >> level;
+}
+
+// Puts an entry at the end of a level, and if that completes a pair, their combination at the end of the next one up
+void SamplePeaks::writeEntry(int32_t level, PeakEntry entry) {
+	uint32_t index = (level == 0) ? numBaseEntriesDone_ : getNumEntriesDone(level);
+	while (true) {
+		PeakEntry* levelEntries = &entries_[getLevelOffset(capacity_, level)];
+		levelEntries[index] = entry;
+		if (!(index & 1) || level + 1 >= numLevels_) {
+			return;
+		}
+		entry = combine(levelEntries[index - 1], entry);
+		index >>= 1;
+		level++;
+	}
+}
+
+void SamplePeaks::finishBaseEntry() {
+	if (numBaseEntriesDone_ >= capacity_) {
+		overflowed_ = true;
+	}
+	else {
+		writeEntry(0, {
+		                  .min = (int16_t)(pendingMin_ >> 16),
+		                  .max = (int16_t)(pendingMax_ >> 16),
+		                  .rms = (uint16_t)std::sqrt((float)pendingSumSquares_ / pendingNumValues_),
+		              });
+		numBaseEntriesDone_++;
+	}
+
+	pendingMin_ = 0;
+	pendingMax_ = 0;
+	pendingSumSquares_ = 0;
+	pendingNumValues_ = 0;
+}
+
+template <int32_t byteDepth>
+static void feedValues(uint8_t const* data, int32_t numValues, int32_t* min, int32_t* max, uint64_t* sumSquares) {
+	int32_t minHere = *min;
+	int32_t maxHere = *max;
+	uint64_t sumSquaresHere = *sumSquares;
+	for (int32_t i = 0; i < numValues; i++) {
+		int32_t value = readValue<byteDepth>(&data[i * byteDepth]);
+		minHere = std::min(minHere, value);
+		maxHere = std::max(maxHere, value);
+		int32_t value16 = value >> 16;
+		sumSquaresHere += (uint32_t)(value16 * value16);
+	}
+	*min = minHere;
+	*max = maxHere;
+	*sumSquares = sumSquaresHere;
+}
+
+void SamplePeaks::addFrames(uint8_t const* data, int32_t numFrames, int32_t numChannels, int32_t byteDepth) {
+	if (!entries_) {
+		return;
+	}
+
+	while (numFrames > 0) {
+		int32_t framesTilEntryEnd = kFramesPerBaseEntry - (numFramesFed_ & (kFramesPerBaseEntry - 1));
+		int32_t numFramesNow = std::min(numFrames, framesTilEntryEnd);
+		int32_t numValues = numFramesNow * numChannels;
+
+		if (!pendingNumValues_) {
+			pendingMin_ = 2147483647;
+			pendingMax_ = -2147483648;
+		}
+
+		switch (byteDepth) {
+		case 1:
+			feedValues<1>(data, numValues, &pendingMin_, &pendingMax_, &pendingSumSquares_);
+			break;
+		case 2:
+			feedValues<2>(data, numValues, &pendingMin_, &pendingMax_, &pendingSumSquares_);
+			break;
+		case 3:
+			feedValues<3>(data, numValues, &pendingMin_, &pendingMax_, &pendingSumSquares_);
+			break;
+		default:
+			feedValues<4>(data, numValues, &pendingMin_, &pendingMax_, &pendingSumSquares_);
+			break;
+		}
+
+		pendingNumValues_ += numValues;
+		numFramesFed_ += numFramesNow;
+		data += numValues * byteDepth;
+		numFrames -= numFramesNow;
+
+		if (numFramesNow == framesTilEntryEnd) {
+			finishBaseEntry();
+		}
+	}
+}
+
+void SamplePeaks::finish() {
+	if (!entries_) {
+		return;
+	}
+	if (pendingNumValues_) {
+		finishBaseEntry();
+	}
+	if (overflowed_ || !numBaseEntriesDone_) {
+		status_ = Status::FAILED;
+		return;
+	}
+
+	// Only the last entry on each level above the base can still be missing or stale - it's made from the last one or
+	// two below it, so going upwards a level at a time, any odd one left over gets carried up on its own and any pair
+	// that includes something carried up from further down gets combined again
+	uint32_t numEntries = numBaseEntriesDone_;
+	for (int32_t l = 0; l < numLevels_ - 1; l++) {
+		PeakEntry const* levelEntries = &entries_[getLevelOffset(capacity_, l)];
+		PeakEntry* upperEntries = &entries_[getLevelOffset(capacity_, l + 1)];
+		uint32_t last = numEntries - 1;
+		upperEntries[last >> 1] = (last & 1) ? combine(levelEntries[last - 1], levelEntries[last]) : levelEntries[last];
+		numEntries = (numEntries + 1) >> 1;
+	}
+
+	status_ = Status::COMPLETE;
+}
+
+void SamplePeaks::setComplete(uint64_t numFrames) {
+	numFramesFed_ = numFrames;
+	numBaseEntriesDone_ = ((numFrames - 1) >> kBaseMagnitude) + 1;
+	status_ = Status::COMPLETE;
+}
+
+bool SamplePeaks::getSpan(uint64_t startFrame, uint64_t endFrame, PeakEntry* result) const {
+	if (!entries_ || endFrame <= startFrame) {
+		return false;
+	}
+	uint64_t numFrames = endFrame - startFrame;
+	if (numFrames < kFramesPerBaseEntry) {
+		return false;
+	}
+
+	// The coarsest level whose entries are no more than half the stretch, so its ends aren't out by much
+	int32_t level = std::max<int32_t>(std::bit_width(numFrames) - 2 - kBaseMagnitude, 0);
+	level = std::min(level, numLevels_ - 1);
+
+	uint32_t first = startFrame >> (kBaseMagnitude + level);
+	uint32_t last = (endFrame - 1) >> (kBaseMagnitude + level);
+	if (last >= getNumEntriesDone(level)) {
+		return false;
+	}
+
+	PeakEntry const* levelEntries = &entries_[getLevelOffset(capacity_, level)];
+	PeakEntry span = levelEntries[first];
+	for (uint32_t i = first + 1; i <= last; i++) {
+		span = combine(span, levelEntries[i]);
+	}
+	*result = span;
+	return true;
+}
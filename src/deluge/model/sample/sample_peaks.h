@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/// The loudest and quietest values, and the RMS, of a stretch of a Sample - all channels together. Values are the top
+/// 16 bits of the 32-bit sample values.
+struct PeakEntry {
+	int16_t min;
+	int16_t max;
+	uint16_t rms;
+};
+
+/// A Sample's waveform overview: min, max and RMS for each 512 frames, then for each 1024, and so on up, doubling each
+/// level until one entry covers the whole Sample. Looking up any stretch of more than 512 frames only has to combine a
+/// handful of entries, so drawing a long Sample zoomed out never has to read its audio data.
+///
+/// Gets fed the audio in order, either by SampleRecorder as it records, or by SamplePeaksBuilder from the file. Entries
+/// can be looked up while that's still happening, for the part that's been fed in so far.
+class SamplePeaks {
+public:
+	static constexpr int32_t kBaseMagnitude = 9;
+	static constexpr int32_t kFramesPerBaseEntry = 1 << kBaseMagnitude;
+
+	enum class Status : uint8_t {
+		NONE,     // Nobody's asked for them
+		PENDING,  // Being fed, or waiting for SamplePeaksBuilder to get to them
+		COMPLETE, // All fed in and finish()ed
+		FAILED,   // Couldn't get the memory, or the file couldn't be read. Don't try again
+	};
+
+	SamplePeaks() = default;
+	~SamplePeaks();
+	SamplePeaks(SamplePeaks const&) = delete;
+	SamplePeaks& operator=(SamplePeaks const&) = delete;
+
+	/// Gets memory for this many frames. Returns false if there wasn't enough
+	bool setup(uint64_t numFrames);
+	/// Makes room for more frames than setup() was given, keeping everything fed in so far. Can take a while, so not
+	/// from the audio routine. Returns false if there wasn't enough memory, in which case the old memory is kept.
+	bool grow(uint64_t numFrames);
+	/// Frees everything, and goes back to Status::NONE
+	void clear();
+
+	/// Feeds in interleaved sample data, byteDepth bytes per value, little-endian and signed - i.e. as a Cluster holds
+	/// it once converted. Anything past the number of frames there's room for gets ignored, and means the peaks can
+	/// never be COMPLETE.
+	void addFrames(uint8_t const* data, int32_t numFrames, int32_t numChannels, int32_t byteDepth);
+	/// Call after the last addFrames()
+	void finish();
+
+	/// Combines the entries covering [startFrame, endFrame). Returns false if that's too short a stretch for the
+	/// peaks to be any use - better to read the real data - or if it hasn't been fed in yet.
+	bool getSpan(uint64_t startFrame, uint64_t endFrame, PeakEntry* result) const;
+
+	[[nodiscard]] Status getStatus() const { return status_; }
+	void setStatus(Status status) { status_ = status; }
+	[[nodiscard]] uint64_t getNumFramesFed() const { return numFramesFed_; }
+	[[nodiscard]] uint64_t getCapacityFrames() const { return (uint64_t)capacity_ << kBaseMagnitude; }
+
+	/// For reading and writing them as a whole, e.g. to a file. All levels, one after the other.
+	[[nodiscard]] PeakEntry* getEntries() const { return entries_; }
+	[[nodiscard]] uint32_t getTotalNumEntries() const { return getLevelOffset(capacity_, numLevels_); }
+	/// Marks peaks whose entries have all just been filled in, e.g. from a file, as COMPLETE
+	void setComplete(uint64_t numFrames);
+
+private:
+	static int32_t getNumLevels(uint32_t numBaseEntries);
+	static uint32_t getLevelOffset(uint32_t numBaseEntries, int32_t level);
+	[[nodiscard]] uint32_t getNumEntriesDone(int32_t level) const;
+	void writeEntry(int32_t level, PeakEntry entry);
+	void finishBaseEntry();
+
+	PeakEntry* entries_ = nullptr;
+	uint32_t capacity_ = 0;         // Entries in the base level there's room for
+	uint32_t numBaseEntriesDone_ = 0;
+	int32_t numLevels_ = 0;
+	uint64_t numFramesFed_ = 0;
+	bool overflowed_ = false;
+	Status status_ = Status::NONE;
+
+	// The base entry being fed
+	int32_t pendingMin_ = 0;
+	int32_t pendingMax_ = 0;
+	uint64_t pendingSumSquares_ = 0;
+	int32_t pendingNumValues_ = 0;
+};
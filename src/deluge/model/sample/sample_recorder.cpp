@@ -21,6 +21,7 @@
 #include "gui/ui/browser/sample_browser.h"
 #include "gui/ui/root_ui.h"
 #include "gui/ui_timer_manager.h"
+#include "hid/display/display.h"
 #include "memory/general_memory_allocator.h"
 #include "model/clip/audio_clip.h"
 #include "model/sample/sample.h"
@@ -28,6 +29,7 @@
 #include "processing/stem_export/stem_export.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "task_scheduler.h"
 #include <new>
 
 extern "C" {
@@ -46,6 +48,9 @@ extern uint8_t currentlyAccessingCard;
 
 #define MAX_FILE_SIZE_MAGNITUDE 32
 
+// How long alterFile() works for before letting other tasks have a turn. Less than the audio routine's target interval
+constexpr double kAlterFileTimeSlice = 0.0002;
+
 SampleRecorder::~SampleRecorder() {
 	D_PRINTLN("~SampleRecorder()");
 	if (sample != nullptr) {
@@ -230,6 +235,10 @@ gotError:
 	numSamplesBeenRunning = 0;
 	numSamplesCaptured = 0;
 
+	// Peaks get made as we record, so the waveform can be drawn zoomed out without reading it all back. Room for a
+	// minute to begin with - cardRoutine() makes more as needed
+	sample->peaks.setup(kSampleRate * 60);
+
 	capturedTooMuch = false;
 
 	recordingNumChannels = newNumChannels;
@@ -297,6 +306,12 @@ void SampleRecorder::abort() {
 // Returns error if one occurred just now - not if one was already noted before
 Error SampleRecorder::cardRoutine() {
 
+	// alterFileAndFinish() still has hold of the Sample and its Clusters - even if we've been aborted meanwhile, in
+	// which case it'll notice soon and stop
+	if (alteringFile) {
+		return Error::NONE;
+	}
+
 	// If aborted, delete the file.
 	if (status == RecorderStatus::ABORTED) {
 
@@ -357,6 +372,13 @@ aborted:
 		return Error::NONE;
 	}
 
+	// feedAudio() can't get more memory for the peaks from the audio routine, so make sure it won't need to
+	if (status < RecorderStatus::FINISHED_CAPTURING_BUT_STILL_WRITING
+	    && sample->peaks.getStatus() == SamplePeaks::Status::PENDING
+	    && numSamplesCaptured > (sample->peaks.getCapacityFrames() >> 2) * 3) {
+		sample->peaks.grow(sample->peaks.getCapacityFrames() << 1);
+	}
+
 	Error error = Error::NONE;
 
 	if (!hadCardError) {
@@ -458,26 +480,37 @@ gotError:
 				hadCardError = true;
 				error = Error::SD_CARD;
 			}
-		}
 
-		if (reachedMaxFileSize) {
-			if (autoDeleteWhenDone) {
-				abort();
-			}
-			else {
-				status = RecorderStatus::COMPLETE;
+			// alterFileAndFinish() will set the status once it's done
+			else if (alteringFile) {
+				goto allDoneForNow;
 			}
-			error = Error::MAX_FILE_SIZE_REACHED;
-		}
-		else {
-			status = autoDeleteWhenDone ? RecorderStatus::AWAITING_DELETION : RecorderStatus::COMPLETE;
 		}
+
+		error = setStatusAfterFinalizing(error);
 	}
 
 allDoneForNow:
 	return error;
 }
 
+// Returns the error to show, which will be the one passed in unless the file got too big
+Error SampleRecorder::setStatusAfterFinalizing(Error error) {
+	if (reachedMaxFileSize) {
+		if (autoDeleteWhenDone) {
+			abort();
+		}
+		else {
+			status = RecorderStatus::COMPLETE;
+		}
+		error = Error::MAX_FILE_SIZE_REACHED;
+	}
+	else {
+		status = autoDeleteWhenDone ? RecorderStatus::AWAITING_DELETION : RecorderStatus::COMPLETE;
+	}
+	return error;
+}
+
 Error SampleRecorder::writeAnyCompletedClusters() {
 	while (firstUnwrittenClusterIndex < currentRecordClusterIndex) {
 
@@ -641,15 +674,25 @@ Error SampleRecorder::finalizeRecordedFile() {
 	// If some processing of the recorded audio data needs to happen...
 	if (lshiftAmount || action != MonitoringAction::NONE) {
 
+		// The peaks we made while recording won't match the data anymore. They'll get made again from the file if
+		// they're needed
+		sample->peaks.clear();
+
 		auto closed = this->file->close();
 		if (!closed) {
 			return Error::SD_CARD;
 		}
 
-		Error error = alterFile(action, lshiftAmount, idealFileSizeBeforeAction, dataLengthAfterAction);
-		if (error != Error::NONE) {
-			return error;
+		// That means reading back the whole file, which takes a while, so it's done as a task of its own. It finishes
+		// up from there
+		TaskID task = deluge::coroutine::addCoroutineTask(
+		    alterFileAndFinish(action, lshiftAmount, idealFileSizeBeforeAction, dataLengthAfterAction), 30,
+		    "alter recorded file");
+		if (task < 0) {
+			return Error::INSUFFICIENT_RAM;
 		}
+		alteringFile = true;
+		return Error::NONE;
 	}
 
 	// Or if no action or shifting was required...
@@ -713,6 +756,11 @@ Error SampleRecorder::finalizeRecordedFile() {
 		}
 	}
 
+	setLengthAfterFinalizing(action, dataLengthAfterAction);
+	return Error::NONE;
+}
+
+void SampleRecorder::setLengthAfterFinalizing(MonitoringAction action, uint32_t dataLengthAfterAction) {
 	sample->numChannels = (action != MonitoringAction::NONE || recordingNumChannels == 1) ? 1 : 2;
 	sample->lengthInSamples = dataLengthAfterAction / (sample->byteDepth * sample->numChannels);
 	sample->audioDataLengthBytes =
@@ -723,8 +771,33 @@ Error SampleRecorder::finalizeRecordedFile() {
 	if (sample->tempFilePathForRecording.isEmpty()) {
 		sampleBrowser.lastFilePathLoaded.set(&sample->filePath);
 	}
+}
 
-	return Error::NONE;
+// The rest of finalizeRecordedFile() and cardRoutine(), for when the file needed altering
+deluge::coroutine::Coroutine<void> SampleRecorder::alterFileAndFinish(MonitoringAction action, int32_t lshiftAmount,
+                                                                      uint32_t idealFileSizeBeforeAction,
+                                                                      uint32_t dataLengthAfterAction) {
+	auto alteration = alterFile(action, lshiftAmount, idealFileSizeBeforeAction, dataLengthAfterAction);
+	Error error = alteration ? co_await std::move(alteration) : Error::INSUFFICIENT_RAM;
+	alteringFile = false;
+
+	// cardRoutine() will delete the file now that we're out of the way
+	if (status == RecorderStatus::ABORTED) {
+		co_return;
+	}
+
+	if (error == Error::NONE) {
+		setLengthAfterFinalizing(action, dataLengthAfterAction);
+	}
+	else {
+		hadCardError = true;
+		error = Error::SD_CARD;
+	}
+
+	error = setStatusAfterFinalizing(error);
+	if (error != Error::NONE) {
+		display->displayError(error);
+	}
 }
 
 void SampleRecorder::updateDataLengthInFirstCluster(Cluster* cluster) {
@@ -831,6 +904,7 @@ Error SampleRecorder::createNextCluster() {
 // action, or after being fed a few more samples to make up for latency.
 void SampleRecorder::finishCapturing() {
 	status = RecorderStatus::FINISHED_CAPTURING_BUT_STILL_WRITING;
+	sample->peaks.finish();
 	if (getRootUI()) {
 		getRootUI()->sampleNeedsReRendering(sample);
 	}
@@ -1025,6 +1099,7 @@ doFinishCapturing:
 				} while (inputAddress < endInputNow);
 			}
 
+			sample->peaks.addFrames((uint8_t const*)writePos, numSamplesThisCycle, recordingNumChannels, 3);
 			writePos = writePosNow;
 
 			numSamplesCaptured += numSamplesThisCycle;
@@ -1133,22 +1208,21 @@ void SampleRecorder::setExtraBytesOnPreviousCluster(Cluster* currentCluster, int
 	}
 }
 
-Error SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount, uint32_t idealFileSizeBeforeAction,
-                                uint64_t dataLengthAfterAction) {
+/// Rewrites the recorded audio data in the file, reading the file back a Cluster at a time. Gives the rest of the
+/// system a turn every kAlterFileTimeSlice, and stops early if the recording gets aborted meanwhile
+deluge::coroutine::Coroutine<Error> SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount,
+                                                              uint32_t idealFileSizeBeforeAction,
+                                                              uint64_t dataLengthAfterAction) {
 
 	D_PRINTLN("altering file");
 	int32_t currentReadClusterIndex = 0;
 	int32_t currentWriteClusterIndex = 0;
 
-	Cluster* currentReadCluster = sample->clusters.getElement(0)->getCluster(
-	    sample, 0, CLUSTER_LOAD_IMMEDIATELY); // Remember, this adds a "reason"
+	Cluster* currentReadCluster = co_await readClusterForAltering(0); // Remember, this adds a "reason"
 	if (!currentReadCluster) {
-		return Error::SD_CARD;
+		co_return Error::SD_CARD;
 	}
 
-	// Bug hunting - newly gotten Cluster
-	currentReadCluster->numReasonsHeldBySampleRecorder++;
-
 	int32_t numClustersBeforeAction =
 	    ((idealFileSizeBeforeAction - 1) >> audioFileManager.clusterSizeMagnitude) + 1; // Rounds up
 	if (ALPHA_OR_BETA_VERSION && numClustersBeforeAction > sample->clusters.getNumElements()) {
@@ -1158,8 +1232,7 @@ Error SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount, u
 	Cluster* nextReadCluster = NULL;
 
 	if (numClustersBeforeAction >= 2) {
-		nextReadCluster = sample->clusters.getElement(1)->getCluster(
-		    sample, 1, CLUSTER_LOAD_IMMEDIATELY); // Remember, this adds a "reason"
+		nextReadCluster = co_await readClusterForAltering(1); // Remember, this adds a "reason"
 		if (!nextReadCluster) {
 
 			// Some bug-hunting
@@ -1169,11 +1242,8 @@ Error SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount, u
 			currentReadCluster->numReasonsHeldBySampleRecorder--;
 
 			audioFileManager.removeReasonFromCluster(currentReadCluster, "E017");
-			return Error::SD_CARD;
+			co_return Error::SD_CARD;
 		}
-
-		// Bug hunting - newly gotten Cluster
-		nextReadCluster->numReasonsHeldBySampleRecorder++;
 	}
 
 	Cluster* currentWriteCluster =
@@ -1213,18 +1283,26 @@ Error SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount, u
 	}
 
 	uint32_t count = 0;
+	double sliceStartTime = getSystemTime();
 
 	// TODO: this is really inefficient - checks a bunch of stuff for every single audio sample. Should check in
 	// advance how many samples we can process at a time
 
 	while (true) {
 
-		if (!(count & 0b11111111)) { // 10x 1's seems to work ok. So we go down to 8 to be sure
-			AudioEngine::routineWithClusterLoading();
-
-			uiTimerManager.routine();
+		if (!(count & 0b11111111) && getSystemTime() - sliceStartTime > kAlterFileTimeSlice) {
+			co_await deluge::coroutine::nextTick();
+			sliceStartTime = getSystemTime();
 
-			PIC::flush();
+			// If the recording's been thrown away meanwhile, there's no point finishing
+			if (status == RecorderStatus::ABORTED) {
+				releaseCluster(currentReadCluster, "E460");
+				if (nextReadCluster) {
+					releaseCluster(nextReadCluster, "E461");
+				}
+				releaseCluster(currentWriteCluster, "E462");
+				co_return Error::ABORTED_BY_USER;
+			}
 		}
 
 		count++;
@@ -1319,7 +1397,7 @@ writeFailed:
 
 					audioFileManager.removeReasonFromCluster(nextReadCluster, "E025");
 				}
-				return Error::SD_CARD;
+				co_return Error::SD_CARD;
 			}
 
 			// Ok, move on and start thinking about the next Cluster now
@@ -1376,9 +1454,8 @@ writeFailed:
 
 			// If there are further read Clusters...
 			if (currentReadClusterIndex < numClustersBeforeAction - 1) {
-				nextReadCluster = sample->clusters.getElement(currentReadClusterIndex + 1)
-				                      ->getCluster(sample, currentReadClusterIndex + 1,
-				                                   CLUSTER_LOAD_IMMEDIATELY); // Remember, this adds a "reason"
+				nextReadCluster =
+				    co_await readClusterForAltering(currentReadClusterIndex + 1); // Remember, this adds a "reason"
 
 				// If that failed, remove other reasons and get out
 				if (!nextReadCluster) {
@@ -1399,11 +1476,8 @@ writeFailed:
 
 					audioFileManager.removeReasonFromCluster(currentWriteCluster, "E022");
 					currentWriteCluster = NULL;
-					return Error::SD_CARD;
+					co_return Error::SD_CARD;
 				}
-
-				// Bug hunting - newly gotten Cluster
-				nextReadCluster->numReasonsHeldBySampleRecorder++;
 			}
 			else { // Not sure these are strictly necessary...
 				nextReadCluster = NULL;
@@ -1461,7 +1535,7 @@ writeFailed:
 
 		// If writing disk failed, above, we've now removed that "reason", so we can get out
 		if (result) {
-			return Error::SD_CARD;
+			co_return Error::SD_CARD;
 		}
 
 		if (action != MonitoringAction::NONE || capturedTooMuch) {
@@ -1469,18 +1543,18 @@ writeFailed:
 			auto opened = this->file->open(sample->filePath.get(), FA_WRITE);
 
 			if (!opened) {
-				return Error::SD_CARD;
+				co_return Error::SD_CARD;
 			}
 			this->file = opened.value();
 
 			Error error = truncateFileDownToSize(dataLengthAfterAction + sample->audioDataStartPosBytes);
 			if (error != Error::NONE) {
-				return error;
+				co_return error;
 			}
 
 			auto closed = this->file->close();
 			if (!closed) {
-				return Error::SD_CARD;
+				co_return Error::SD_CARD;
 			}
 		}
 	}
@@ -1496,7 +1570,38 @@ writeFailed:
 		currentWriteCluster = NULL;
 	}
 
-	return Error::NONE;
+	co_return Error::NONE;
+}
+
+/// Gets one of our Sample's Clusters for alterFile(), waiting for it to be read from the card if it's not in memory.
+/// Returns nullptr if it couldn't be read; otherwise we've got a "reason" on it
+deluge::coroutine::Coroutine<Cluster*> SampleRecorder::readClusterForAltering(int32_t clusterIndex) {
+	Cluster* cluster = sample->clusters.getElement(clusterIndex)->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE);
+	if (!cluster) {
+		co_return nullptr;
+	}
+
+	if (!cluster->loaded) {
+		co_await sdReadComplete(cluster);
+		if (!cluster->loaded) {
+			audioFileManager.removeReasonFromCluster(cluster, "E463");
+			co_return nullptr;
+		}
+	}
+
+	// Bug hunting - newly gotten Cluster
+	cluster->numReasonsHeldBySampleRecorder++;
+	co_return cluster;
+}
+
+void SampleRecorder::releaseCluster(Cluster* cluster, char const* errorCode) {
+	// Some bug-hunting
+	if (!cluster->numReasonsHeldBySampleRecorder) {
+		FREEZE_WITH_ERROR(errorCode);
+	}
+	cluster->numReasonsHeldBySampleRecorder--;
+
+	audioFileManager.removeReasonFromCluster(cluster, errorCode);
 }
 
 // You must still have the file open when you call this
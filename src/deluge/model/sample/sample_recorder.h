@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "OSLikeStuff/coroutine_task.hpp"
 #include "definitions_cxx.hpp"
 #include "dsp/stereo_sample.h"
 #include "fatfs/fatfs.hpp"
@@ -102,6 +103,9 @@ public:
 	bool recordingExtraMargins = false;
 	bool pointerHeldElsewhere = false;
 	bool capturedTooMuch = false;
+	// Set while alterFileAndFinish() is running as a task. Until it's done, cardRoutine() leaves us alone, and we
+	// mustn't be deleted
+	bool alteringFile = false;
 
 	// Most of these are not captured in the case of BALANCED input for AudioClips
 	bool recordingClippedRecently;
@@ -126,10 +130,16 @@ public:
 private:
 	void setExtraBytesOnPreviousCluster(Cluster* currentCluster, int32_t currentClusterIndex);
 	Error writeCluster(int32_t clusterIndex, size_t numBytes);
-	Error alterFile(MonitoringAction action, int32_t lshiftAmount, uint32_t idealFileSizeBeforeAction,
-
-	                uint64_t dataLengthAfterAction);
+	deluge::coroutine::Coroutine<Error> alterFile(MonitoringAction action, int32_t lshiftAmount,
+	                                              uint32_t idealFileSizeBeforeAction, uint64_t dataLengthAfterAction);
+	deluge::coroutine::Coroutine<void> alterFileAndFinish(MonitoringAction action, int32_t lshiftAmount,
+	                                                      uint32_t idealFileSizeBeforeAction,
+	                                                      uint32_t dataLengthAfterAction);
+	deluge::coroutine::Coroutine<Cluster*> readClusterForAltering(int32_t clusterIndex);
+	void releaseCluster(Cluster* cluster, char const* errorCode);
 	Error finalizeRecordedFile();
+	void setLengthAfterFinalizing(MonitoringAction action, uint32_t dataLengthAfterAction);
+	Error setStatusAfterFinalizing(Error error);
 	Error createNextCluster();
 	Error writeAnyCompletedClusters();
 	void finishCapturing();
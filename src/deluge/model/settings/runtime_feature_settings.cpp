@@ -101,6 +101,32 @@ static void SetupEmulatedDisplaySetting(RuntimeFeatureSetting& setting, deluge::
 	};
 }
 
+static void SetupSamplePrefetchSetting(RuntimeFeatureSetting& setting, deluge::l10n::String displayName,
+                                       std::string_view xmlName, RuntimeFeatureStateSamplePrefetch def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = "Off",
+	        .value = RuntimeFeatureStateSamplePrefetch::NoPrefetch,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "1 beat" : "BEAT",
+	        .value = RuntimeFeatureStateSamplePrefetch::OneBeat,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "1 bar" : "BAR",
+	        .value = RuntimeFeatureStateSamplePrefetch::OneBar,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "2 bars" : "2BAR",
+	        .value = RuntimeFeatureStateSamplePrefetch::TwoBars,
+	    },
+	};
+}
+
 void RuntimeFeatureSettings::init() {
 	using enum deluge::l10n::String;
 	// Drum randomizer
@@ -175,6 +201,30 @@ void RuntimeFeatureSettings::init() {
 	SetupOnOffSetting(settings[RuntimeFeatureSettingType::EnableLaunchEventPlayhead],
 	                  STRING_FOR_COMMUNITY_FEATURE_LAUNCH_EVENT_PLAYHEAD, "enableLaunchEventPlayhead",
 	                  RuntimeFeatureStateToggle::On);
+
+	// SubBlockModulation
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::SubBlockModulation],
+	                  STRING_FOR_COMMUNITY_FEATURE_SUB_BLOCK_MODULATION, "subBlockModulation",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// SamplePrefetch
+	SetupSamplePrefetchSetting(settings[RuntimeFeatureSettingType::SamplePrefetch],
+	                           STRING_FOR_COMMUNITY_FEATURE_SAMPLE_PREFETCH, "samplePrefetch",
+	                           RuntimeFeatureStateSamplePrefetch::OneBeat);
+
+	// SampleCacheOnCard
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::SampleCacheOnCard],
+	                  STRING_FOR_COMMUNITY_FEATURE_SAMPLE_CACHE_ON_CARD, "sampleCacheOnCard",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// TimedMIDIInput
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::TimedMIDIInput],
+	                  STRING_FOR_COMMUNITY_FEATURE_TIMED_MIDI_INPUT, "timedMIDIInput", RuntimeFeatureStateToggle::Off);
+
+	// BinarySongCopies
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::BinarySongCopies],
+	                  STRING_FOR_COMMUNITY_FEATURE_BINARY_SONG_COPIES, "binarySongCopies",
+	                  RuntimeFeatureStateToggle::Off);
 }
 
 void RuntimeFeatureSettings::readSettingsFromFile(StorageManager& bdsm) {
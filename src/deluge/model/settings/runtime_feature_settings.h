@@ -41,6 +41,8 @@ enum RuntimeFeatureStateSyncScalingAction : uint32_t { SyncScaling = 0, Fill = 1
 
 enum RuntimeFeatureStateEmulatedDisplay : uint32_t { Hardware = 0, Toggle = 1, OnBoot = 2 };
 
+enum RuntimeFeatureStateSamplePrefetch : uint32_t { NoPrefetch = 0, OneBeat = 1, OneBar = 2, TwoBars = 3 };
+
 /// Every setting needs to be declared in here
 enum RuntimeFeatureSettingType : uint32_t {
 	DrumRandomizer,
@@ -62,6 +64,11 @@ enum RuntimeFeatureSettingType : uint32_t {
 	EmulatedDisplay,
 	EnableKeyboardViewSidebarMenuExit,
 	EnableLaunchEventPlayhead,
+	SubBlockModulation,
+	SamplePrefetch,
+	SampleCacheOnCard,
+	TimedMIDIInput,
+	BinarySongCopies,
 	MaxElement // Keep as boundary
 };
 
@@ -33,6 +33,7 @@
 #include "hid/matrix/matrix_driver.h"
 #include "io/midi/device_specific/specific_midi_device.h"
 #include "io/midi/midi_engine.h"
+#include "io/midi/midi_routing_index.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action_logger.h"
 #include "model/clip/audio_clip.h"
@@ -275,6 +276,7 @@ void Song::setupDefault() {
 }
 
 void Song::deleteAllOutputs(Output** prevPointer) {
+	midiRoutingIndex.invalidate();
 
 	while (*prevPointer) {
 		AudioEngine::logAction("s6");
@@ -1190,20 +1192,16 @@ void Song::writeToFile(StorageManager& bdsm) {
 
 	writer.writeAttribute("previewNumPads", "144");
 
-	writer.write("\n");
-	writer.printIndents();
-	writer.write("preview=\"");
-
+	uint8_t preview[kDisplayHeight * (kDisplayWidth + kSideBarWidth) * 3];
+	int32_t previewPos = 0;
 	for (int32_t y = 0; y < kDisplayHeight; y++) {
 		for (int32_t x = 0; x < kDisplayWidth + kSideBarWidth; x++) {
 			for (int32_t colour = 0; colour < 3; colour++) {
-				char buffer[3];
-				byteToHex(PadLEDs::imageStore[y][x][colour], buffer);
-				writer.write(buffer);
+				preview[previewPos++] = PadLEDs::imageStore[y][x][colour];
 			}
 		}
 	}
-	writer.write("\"");
+	writer.writeAttributeHexBytes("preview", preview, sizeof(preview));
 
 	if (getRootUI() == &arrangerView) {
 		writer.writeAttribute("inArrangementView", 1);
@@ -1279,6 +1277,12 @@ weAreInArrangementEditorOrInClipInstance:
 	writer.writeAttribute("width", width);
 	writer.writeAttribute("pan", AudioEngine::reverbPan);
 	writer.writeAttribute("model", util::to_underlying(model));
+	if (model == deluge::dsp::Reverb::Model::FDN) {
+		writer.writeAttribute("rate", util::to_underlying(AudioEngine::reverb.getRate()));
+	}
+	if (!reverbImpulseResponsePath.isEmpty()) {
+		writer.writeAttribute("impulseResponse", reverbImpulseResponsePath.get());
+	}
 	writer.writeOpeningTagEnd();
 
 	writer.writeOpeningTagBeginning("compressor");
@@ -1396,7 +1400,7 @@ Error Song::readFromFile(Deserializer& reader) {
 	uint64_t newTimePerTimerTick = (uint64_t)1 << 32; // TODO: make better!
 
 	// reverb mode
-	if (smDeserializer.firmware_version < FirmwareVersion::official({4, 1, 4})) {
+	if (reader.firmware_version < FirmwareVersion::official({4, 1, 4})) {
 		AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::FREEVERB);
 	}
 
@@ -1417,8 +1421,25 @@ Error Song::readFromFile(Deserializer& reader) {
 						else if (model == deluge::dsp::Reverb::Model::MUTABLE) {
 							AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::MUTABLE);
 						}
+						else if (model == deluge::dsp::Reverb::Model::FDN) {
+							AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::FDN);
+						}
+						else if (model == deluge::dsp::Reverb::Model::IMPULSE_RESPONSE) {
+							AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::IMPULSE_RESPONSE);
+						}
 						reader.exitTag("model");
 					}
+					else if (!strcmp(tagName, "rate")) {
+						int32_t rate = reader.readTagOrAttributeValueInt();
+						if (rate >= 0 && rate <= util::to_underlying(deluge::dsp::reverb::FDN::Rate::QUARTER)) {
+							AudioEngine::reverb.setRate(static_cast<deluge::dsp::reverb::FDN::Rate>(rate));
+						}
+						reader.exitTag("rate");
+					}
+					else if (!strcmp(tagName, "impulseResponse")) {
+						reader.readTagOrAttributeValueString(&reverbImpulseResponsePath);
+						reader.exitTag("impulseResponse");
+					}
 					else if (!strcmp(tagName, "roomSize")) {
 						reverbRoomSize = (float)reader.readTagOrAttributeValueInt() / 2147483648u;
 						reader.exitTag("roomSize");
@@ -1576,11 +1597,11 @@ Error Song::readFromFile(Deserializer& reader) {
 		default:
 unknownTag:
 			if (!strcmp(tagName, "firmwareVersion") || !strcmp(tagName, "earliestCompatibleFirmware")) {
-				smDeserializer.tryReadingFirmwareTagFromFile(tagName);
+				reader.tryReadingFirmwareTagFromFile(tagName);
 				reader.exitTag(tagName);
 			}
 			else if (!strcmp(tagName, "preview") || !strcmp(tagName, "previewNumPads")) {
-				smDeserializer.tryReadingFirmwareTagFromFile(tagName);
+				reader.tryReadingFirmwareTagFromFile(tagName);
 				reader.exitTag(tagName);
 			}
 			else if (!strcmp(tagName, "sessionLayout")) {
@@ -1962,7 +1983,7 @@ loadOutput:
 					return result;
 				}
 				else {
-					Error result = smDeserializer.tryReadingFirmwareTagFromFile(tagName);
+					Error result = reader.tryReadingFirmwareTagFromFile(tagName);
 					if (result != Error::NONE && result != Error::RESULT_TAG_UNUSED) {
 						return result;
 					}
@@ -1975,7 +1996,7 @@ loadOutput:
 		}
 	}
 
-	if (smDeserializer.firmware_version >= FirmwareVersion::official({3, 1, 0, "alpha2"})) {
+	if (reader.firmware_version >= FirmwareVersion::official({3, 1, 0, "alpha2"})) {
 		// Basically, like all other "sync" type parameters, the file value and internal value are different for
 		// swingInterval. But unlike other ones, which get converted as we go, we do this one at the end once we
 		// know we have enough info to do the conversion
@@ -2022,7 +2043,7 @@ loadOutput:
 
 			// Correct different non-synced rates of old song files
 			// In a perfect world, we'd do this for Kits, MIDI and CV too
-			if (smDeserializer.firmware_version < FirmwareVersion::official({1, 5, 0, "pretest"})
+			if (reader.firmware_version < FirmwareVersion::official({1, 5, 0, "pretest"})
 			    && thisClip->output->type == OutputType::SYNTH) {
 				if (((InstrumentClip*)thisClip)->arpSettings.mode != ArpMode::OFF
 				    && !((InstrumentClip*)thisClip)->arpSettings.syncLevel) {
@@ -2114,7 +2135,7 @@ skipInstance:
 		}
 
 		// If saved before V2.1, set sample-based synth instruments to linear interpolation, cos that's how it was
-		if (smDeserializer.firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
+		if (reader.firmware_version < FirmwareVersion::official({2, 1, 0, "beta"})) {
 			if (thisOutput->type == OutputType::SYNTH) {
 				SoundInstrument* sound = (SoundInstrument*)thisOutput;
 
@@ -2155,7 +2176,7 @@ skipInstance:
 	}
 
 	// Pre V1.2...
-	if (smDeserializer.firmware_version < FirmwareVersion::official({1, 2, 0})) {
+	if (reader.firmware_version < FirmwareVersion::official({1, 2, 0})) {
 
 		deleteAllBackedUpParamManagers(true); // Before V1.2, lots of extras of these could be created during loading
 		globalEffectable.compensateVolumeForResonance(&paramManager);
@@ -2250,6 +2271,10 @@ readClip:
 // Needs to be in a separate function than the above because the main song XML file needs to be closed first before
 // this is called, because this will open other (sample) files
 void Song::loadAllSamples(bool mayActuallyReadFiles) {
+	if (mayActuallyReadFiles) {
+		// If the IR's gone missing, the reverb just goes quiet when that model's picked
+		AudioEngine::loadReverbImpulseResponse(&reverbImpulseResponsePath);
+	}
 
 	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
 		thisOutput->loadAllAudioFiles(mayActuallyReadFiles);
@@ -2357,8 +2382,11 @@ void Song::renderAudio(StereoSample* outputBuffer, int32_t numSamples, int32_t*
 		bool isClipActiveNow =
 		    (output->getActiveClip() && isClipActive(output->getActiveClip()->getClipBeingRecordedFrom()));
 		DISABLE_ALL_INTERRUPTS();
-		output->renderOutput(modelStack, outputBuffer, outputBuffer + numSamples, numSamples, reverbBuffer,
-		                     volumePostFX >> 1, sideChainHitPending, !isClipActiveNow, isClipActiveNow);
+		{
+			CPUMeter::OutputScope meterScope{output->cpuMeter, numSamples};
+			output->renderOutput(modelStack, outputBuffer, outputBuffer + numSamples, numSamples, reverbBuffer,
+			                     volumePostFX >> 1, sideChainHitPending, !isClipActiveNow, isClipActiveNow);
+		}
 		ENABLE_INTERRUPTS();
 #if DO_AUDIO_LOG
 		char buf[64];
@@ -3261,6 +3289,7 @@ uint32_t Song::getTimePerTimerTickRounded() {
 }
 
 void Song::addOutput(Output* output, bool atStart) {
+	midiRoutingIndex.invalidate();
 
 	if (atStart) {
 		output->next = firstOutput;
@@ -3317,6 +3346,7 @@ int32_t Song::removeOutputFromMainList(
 	}
 
 	// Remove the Output from the main list
+	midiRoutingIndex.invalidate();
 	Output** prevPointer;
 	int32_t outputIndex = 0;
 	for (prevPointer = &firstOutput; *prevPointer != output; prevPointer = &(*prevPointer)->next) {
@@ -3383,6 +3413,7 @@ void Song::replaceInstrument(Instrument* oldOutput, Instrument* newOutput, bool
 	oldOutput->stopAnyAuditioning(modelStack);
 
 	// Remove the oldInstrument from the list of Instruments
+	midiRoutingIndex.invalidate();
 	Output** prevPointer;
 	for (prevPointer = &firstOutput; *prevPointer != oldOutput; prevPointer = &(*prevPointer)->next) {}
 	newOutput->next = oldOutput->next;
@@ -5162,6 +5193,7 @@ void Song::replaceOutputLowLevel(Output* newOutput, Output* oldOutput) {
 
 	oldOutput->stopAnyAuditioning(modelStack);
 
+	midiRoutingIndex.invalidate();
 	Output** prevPointer;
 	for (prevPointer = &firstOutput; *prevPointer != oldOutput; prevPointer = &(*prevPointer)->next) {}
 	newOutput->next = oldOutput->next;
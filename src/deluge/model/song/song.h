@@ -372,6 +372,8 @@ public:
 	int32_t reverbSidechainAttack;
 	int32_t reverbSidechainRelease;
 	SyncLevel reverbSidechainSync;
+	// The reverb's IMPULSE_RESPONSE model plays this, if it's set. Kept even when some other model's picked
+	String reverbImpulseResponsePath;
 
 	// START ~ new Automation Arranger View Variables
 	int32_t lastSelectedParamID; // last selected Parameter to be edited in Automation Arranger View
@@ -31,11 +31,13 @@
 #include "model/sample/sample_cache.h"
 #include "model/sample/sample_holder_for_voice.h"
 #include "model/song/song.h"
+#include "model/voice/voice_filter_batch.h"
 #include "model/voice/voice_sample.h"
 #include "modulation/params/param_set.h"
 #include "modulation/patch/patch_cable_set.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/cpu_meter.h"
 #include "processing/live/live_pitch_shifter.h"
 #include "processing/render_wave.h"
 #include "processing/sound/sound.h"
@@ -600,6 +602,7 @@ void Voice::noteOff(ModelStackWithVoice* modelStack, bool allowReleaseStage) {
 	else {
 		previouslyIgnoredNoteOff = true;
 	}
+	AudioEngine::voicePriorityQueue.update(this);
 
 	if (sound->synthMode != SynthMode::FM) {
 		for (int32_t s = 0; s < kNumSources; s++) {
@@ -700,20 +703,89 @@ uint32_t Voice::getLocalLFOPhaseIncrement() {
 	}
 }
 
-// Before calling this, you must set the filterSetConfig's doLPF and doHPF to default values
+// Whether any of this Voice's own modulation sources which reach its volume are moving fast enough right now that
+// patching them once per block would zipper - that is, whether an envelope's current stage, or a cycle of LFO2, is over
+// in less than kSubBlockModulationMaxPeriod samples. Envelope 0 always goes to volume; the others only count if they're
+// patched to it.
+bool Voice::wantsSubBlockModulation(PatchCableSet* patchCableSet) {
+	Destination* volume = patchCableSet->getDestinationForParam(params::LOCAL_VOLUME);
+	uint32_t sourcesPatched = volume ? volume->sources : 0;
+
+	if ((sourcesPatched & (1 << util::to_underlying(PatchSource::LFO_LOCAL)))
+	    && getLocalLFOPhaseIncrement() > UINT32_MAX / kSubBlockModulationMaxPeriod) {
+		return true;
+	}
+	for (int32_t e = 0; e < kNumEnvelopes; e++) {
+		if (e != 0 && !(sourcesPatched & (1 << (util::to_underlying(PatchSource::ENVELOPE_0) + e)))) {
+			continue;
+		}
+
+		// How far through the stage Envelope::render() moves each sample, out of 8388608
+		uint32_t increment;
+		switch (envelopes[e].state) {
+		case EnvelopeStage::ATTACK:
+			increment = paramFinalValues[params::LOCAL_ENV_0_ATTACK + e];
+			break;
+		case EnvelopeStage::DECAY:
+			increment = paramFinalValues[params::LOCAL_ENV_0_DECAY + e];
+			break;
+		case EnvelopeStage::RELEASE:
+			increment = paramFinalValues[params::LOCAL_ENV_0_RELEASE + e];
+			if (e == 0 && overrideAmplitudeEnvelopeReleaseRate) {
+				increment = overrideAmplitudeEnvelopeReleaseRate;
+			}
+			break;
+		case EnvelopeStage::FAST_RELEASE:
+			increment = envelopes[e].fastReleaseIncrement;
+			break;
+		default:
+			continue; // Not moving
+		}
+		if (increment > 8388608 / kSubBlockModulationMaxPeriod) {
+			return true;
+		}
+	}
+	return false;
+}
 
+// Steps the envelopes and LFO, and re-patches whatever they're patched to, every kSubBlockModulationNumSamples - but
+// renders the audio just once, for the whole block, with the overall amplitude ramped through its value at the end of
+// each slice. That way a fast envelope or LFO on the volume doesn't zipper, and the extra cost is only the modulation
+// and patching, not the oscillators and filters. Anything else they're patched to still changes once per block.
 // Returns false if became inactive and needs unassigning
-[[gnu::hot]] bool Voice::render(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples,
-                                bool soundRenderingInStereo, bool applyingPanAtVoiceLevel, uint32_t sourcesChanged,
-                                bool doLPF, bool doHPF, int32_t externalPitchAdjust) {
+bool Voice::renderInSubBlocks(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples,
+                              bool soundRenderingInStereo, bool applyingPanAtVoiceLevel, uint32_t sourcesChanged,
+                              bool doLPF, bool doHPF, int32_t externalPitchAdjust) {
+	CPUMeter::StageScope meterStage{CPUMeter::Stage::VOICES};
 
-	GeneralMemoryAllocator::get().checkStack("Voice::render");
+	SubBlockAmplitudes subBlocks;
+	subBlocks.numSlicesDone = (numSamples - 1) / kSubBlockModulationNumSamples;
+	for (int32_t i = 0; i < subBlocks.numSlicesDone; i++) {
+		stepModulation(modelStack, kSubBlockModulationNumSamples, sourcesChanged);
+		subBlocks.values[i] = getOverallOscAmplitude();
+
+		// The Sound-level changes have been patched in now. Changes to our own sources get picked up by each step
+		sourcesChanged = 0;
+	}
+
+	return render(modelStack, soundBuffer, numSamples, soundRenderingInStereo, applyingPanAtVoiceLevel, sourcesChanged,
+	              doLPF, doHPF, externalPitchAdjust, nullptr, &subBlocks);
+}
 
+// Apply envelope 0 to volume. This takes effect as a cut only; when the envelope is at max height, volume is
+// unaffected. Important that we use lshiftAndSaturate here - otherwise, number can overflow if combining high
+// velocity patching with big LFO
+int32_t Voice::getOverallOscAmplitude() {
+	return lshiftAndSaturate<2>(
+	    multiply_32x32_rshift32(paramFinalValues[params::LOCAL_VOLUME],
+	                            (sourceValues[util::to_underlying(PatchSource::ENVELOPE_0)] >> 1) + 1073741824));
+}
+
+// Moves the envelopes, LFO2 and any MPE smoothing on by numSamples, then patches whichever sources have changed
+void Voice::stepModulation(ModelStackWithVoice* modelStack, int32_t numSamples, uint32_t sourcesChanged) {
 	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
 	Sound* sound = (Sound*)modelStack->modControllable;
 
-	bool didStereoTempBuffer = false;
-
 	// If we've previously ignored a note-off, we need to check that the user hasn't changed the preset so that we're
 	// now waiting for a note-off again
 	if (previouslyIgnoredNoteOff && sound->allowNoteTails(modelStack, true)) {
@@ -739,10 +811,6 @@ uint32_t Voice::getLocalLFOPhaseIncrement() {
 		}
 	}
 
-	bool unassignVoiceAfter =
-	    (envelopes[0].state
-	     == EnvelopeStage::OFF); //(envelopes[0].state >= EnvelopeStage::DECAY &&
-	                             // localSourceValues[PatchSource::ENVELOPE_0 - Local::FIRST_SOURCE] == -2147483648);
 	// Local LFO
 	if (paramManager->getPatchCableSet()->sourcesPatchedToAnything[GLOBALITY_LOCAL]
 	    & (1 << util::to_underlying(PatchSource::LFO_LOCAL))) {
@@ -791,6 +859,33 @@ uint32_t Voice::getLocalLFOPhaseIncrement() {
 		}
 		patcher.performPatching(sourcesChanged, sound, paramManager);
 	}
+}
+
+// Before calling this, you must set the filterSetConfig's doLPF and doHPF to default values
+
+// Returns false if became inactive and needs unassigning
+[[gnu::hot]] bool Voice::render(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples,
+                                bool soundRenderingInStereo, bool applyingPanAtVoiceLevel, uint32_t sourcesChanged,
+                                bool doLPF, bool doHPF, int32_t externalPitchAdjust, VoiceFilterBatch* filterBatch,
+                                SubBlockAmplitudes const* subBlocks) {
+	CPUMeter::StageScope meterStage{CPUMeter::Stage::VOICES};
+
+	GeneralMemoryAllocator::get().checkStack("Voice::render");
+
+	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
+	Sound* sound = (Sound*)modelStack->modControllable;
+
+	bool didStereoTempBuffer = false;
+
+	// With sub-block modulation, renderInSubBlocks() has already stepped through all but the last slice
+	stepModulation(modelStack,
+	               subBlocks ? numSamples - subBlocks->numSlicesDone * kSubBlockModulationNumSamples : numSamples,
+	               sourcesChanged);
+
+	bool unassignVoiceAfter =
+	    (envelopes[0].state
+	     == EnvelopeStage::OFF); //(envelopes[0].state >= EnvelopeStage::DECAY &&
+	                             // localSourceValues[PatchSource::ENVELOPE_0 - Local::FIRST_SOURCE] == -2147483648);
 
 	// Sort out pitch
 	int32_t overallPitchAdjust = paramFinalValues[params::LOCAL_PITCH_ADJUST];
@@ -959,12 +1054,7 @@ skipAutoRelease: {}
 		}
 	}
 
-	// Apply envelope 0 to volume. This takes effect as a cut only; when the envelope is at max height, volume is
-	// unaffected. Important that we use lshiftAndSaturate here - otherwise, number can overflow if combining high
-	// velocity patching with big LFO
-	int32_t overallOscAmplitude = lshiftAndSaturate<2>(
-	    multiply_32x32_rshift32(paramFinalValues[params::LOCAL_VOLUME],
-	                            (sourceValues[util::to_underlying(PatchSource::ENVELOPE_0)] >> 1) + 1073741824));
+	int32_t overallOscAmplitude = getOverallOscAmplitude();
 
 	// This is the gain which gets applied to compensate for any change in gain that the filter is going to cause
 	int32_t filterGain;
@@ -1098,7 +1188,8 @@ skipAutoRelease: {}
 		sourceAmplitudesNow[s] = sourceAmplitudesLastTime[s];
 	}
 
-	int32_t amplitudeL, amplitudeR;
+	int32_t amplitudeL = 0;
+	int32_t amplitudeR = 0;
 	bool doPanning;
 
 	// two first indicies are reserved in case we need stereo for unison spread
@@ -1481,65 +1572,13 @@ skipUnisonPart: {}
 		// Filters
 		filterSet.renderLongStereo(oscBuffer, oscBufferEnd);
 
-		// No clipping
-		if (!sound->clippingAmount) {
-
-			int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-			StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
-			int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-			do {
-				int32_t outputSampleL = *(oscBufferPos++);
-				int32_t outputSampleR = *(oscBufferPos++);
-
-				overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-				if (synthMode != SynthMode::FM) {
-					outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
-					outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
-				}
-
-				// Write to the output buffer, panning or not
-				if (doPanning) {
-					outputSample->addPannedStereo(outputSampleL, outputSampleR, amplitudeL, amplitudeR);
-				}
-				else {
-					outputSample->addStereo(outputSampleL, outputSampleR);
-				}
-
-				outputSample++;
-			} while (oscBufferPos != oscBufferEnd);
+		Output output{overallOscAmplitudeLastTime, overallOscillatorAmplitudeIncrement,
+		              synthMode != SynthMode::FM, soundRenderingInStereo, doPanning, amplitudeL, amplitudeR};
+		if (subBlocks) {
+			outputInSubBlocks(sound, oscBuffer, true, numSamples, soundBuffer, output, *subBlocks, overallOscAmplitude);
 		}
-
-		// Yes clipping
 		else {
-
-			int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-			StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
-			int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-			do {
-				int32_t outputSampleL = *(oscBufferPos++);
-				int32_t outputSampleR = *(oscBufferPos++);
-
-				overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-				if (synthMode != SynthMode::FM) {
-					outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
-					outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
-				}
-
-				sound->saturate(&outputSampleL, &lastSaturationTanHWorkingValue[0]);
-				sound->saturate(&outputSampleR, &lastSaturationTanHWorkingValue[1]);
-
-				// Write to the output buffer, panning or not
-				if (doPanning) {
-					outputSample->addPannedStereo(outputSampleL, outputSampleR, amplitudeL, amplitudeR);
-				}
-				else {
-					outputSample->addStereo(outputSampleL, outputSampleR);
-				}
-
-				outputSample++;
-			} while (oscBufferPos != oscBufferEnd);
+			outputStereo(sound, oscBuffer, numSamples, soundBuffer, output);
 		}
 	}
 	else {
@@ -1562,83 +1601,196 @@ skipUnisonPart: {}
 			dsp::foldBufferPolyApproximation(oscBuffer, oscBufferEnd, foldAmount);
 		}
 
-		filterSet.renderLong(oscBuffer, oscBufferEnd, numSamples);
+		Output output{overallOscAmplitudeLastTime, overallOscillatorAmplitudeIncrement,
+		              synthMode != SynthMode::FM, soundRenderingInStereo, doPanning, amplitudeL, amplitudeR};
 
-		// No clipping
-		if (!sound->clippingAmount) {
-			int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-			int32_t* __restrict__ outputSample = soundBuffer;
-			int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
+		// A Voice that's finishing gets unassigned as soon as this returns, so can't be left waiting in a batch
+		if (filterBatch == nullptr || unassignVoiceAfter || !filterBatch->add(this, oscBuffer, output)) {
+			filterSet.renderLong(oscBuffer, oscBufferEnd, numSamples);
+			if (subBlocks) {
+				outputInSubBlocks(sound, oscBuffer, false, numSamples, soundBuffer, output, *subBlocks,
+				                  overallOscAmplitude);
+			}
+			else {
+				outputMono(sound, oscBuffer, numSamples, soundBuffer, output);
+			}
+		}
+	}
 
-			do {
-				int32_t output = *oscBufferPos;
+renderingDone:
 
-				if (synthMode != SynthMode::FM) {
-					overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-					output = multiply_32x32_rshift32_rounded(output, overallOscAmplitudeNow) << 1;
-				}
+	for (int32_t s = 0; s < kNumSources; s++) {
+		sourceAmplitudesLastTime[s] = sourceAmplitudes[s];
+		sourceWaveIndexesLastTime[s] = paramFinalValues[params::LOCAL_OSC_A_WAVE_INDEX + s];
+	}
+	for (int32_t m = 0; m < kNumModulators; m++) {
+		modulatorAmplitudeLastTime[m] = paramFinalValues[params::LOCAL_MODULATOR_0_VOLUME + m];
+	}
+	overallOscAmplitudeLastTime = overallOscAmplitude;
 
-				if (soundRenderingInStereo) {
-					if (doPanning) {
-						((StereoSample*)outputSample)->addPannedMono(output, amplitudeL, amplitudeR);
-					}
-					else {
-						((StereoSample*)outputSample)->addMono(output);
-					}
-					outputSample += 2;
+	return !unassignVoiceAfter;
+}
+
+// Applies the overall amplitude and any clipping to what's come out of the filters, and adds it to the Sound's buffer
+void Voice::outputMono(Sound* sound, int32_t const* oscBuffer, int32_t numSamples, int32_t* soundBuffer,
+                       Output const& output) {
+	int32_t const* const oscBufferEnd = oscBuffer + numSamples;
+
+	// No clipping
+	if (!sound->clippingAmount) {
+		int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
+		int32_t* __restrict__ outputSample = soundBuffer;
+		int32_t overallOscAmplitudeNow = output.amplitudeStart;
+
+		do {
+			int32_t value = *oscBufferPos;
+
+			if (output.applyAmplitude) {
+				overallOscAmplitudeNow += output.amplitudeIncrement;
+				value = multiply_32x32_rshift32_rounded(value, overallOscAmplitudeNow) << 1;
+			}
+
+			if (output.soundRenderingInStereo) {
+				if (output.doPanning) {
+					((StereoSample*)outputSample)->addPannedMono(value, output.amplitudeL, output.amplitudeR);
 				}
 				else {
-					*outputSample += output;
-					outputSample++;
+					((StereoSample*)outputSample)->addMono(value);
 				}
-			} while (++oscBufferPos != oscBufferEnd);
-		}
+				outputSample += 2;
+			}
+			else {
+				*outputSample += value;
+				outputSample++;
+			}
+		} while (++oscBufferPos != oscBufferEnd);
+	}
 
-		// Yes clipping
-		else {
-			int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-			int32_t* __restrict__ outputSample = soundBuffer;
-			int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
+	// Yes clipping
+	else {
+		int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
+		int32_t* __restrict__ outputSample = soundBuffer;
+		int32_t overallOscAmplitudeNow = output.amplitudeStart;
 
-			do {
-				int32_t output = *oscBufferPos;
+		do {
+			int32_t value = *oscBufferPos;
 
-				if (synthMode != SynthMode::FM) {
-					overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-					output = multiply_32x32_rshift32_rounded(output, overallOscAmplitudeNow) << 1;
-				}
+			if (output.applyAmplitude) {
+				overallOscAmplitudeNow += output.amplitudeIncrement;
+				value = multiply_32x32_rshift32_rounded(value, overallOscAmplitudeNow) << 1;
+			}
 
-				sound->saturate(&output, &lastSaturationTanHWorkingValue[0]);
+			sound->saturate(&value, &lastSaturationTanHWorkingValue[0]);
 
-				if (soundRenderingInStereo) {
-					if (doPanning) {
-						((StereoSample*)outputSample)->addPannedMono(output, amplitudeL, amplitudeR);
-					}
-					else {
-						((StereoSample*)outputSample)->addMono(output);
-					}
-					outputSample += 2;
+			if (output.soundRenderingInStereo) {
+				if (output.doPanning) {
+					((StereoSample*)outputSample)->addPannedMono(value, output.amplitudeL, output.amplitudeR);
 				}
 				else {
-					*outputSample += output;
-					outputSample++;
+					((StereoSample*)outputSample)->addMono(value);
 				}
-			} while (++oscBufferPos != oscBufferEnd);
-		}
+				outputSample += 2;
+			}
+			else {
+				*outputSample += value;
+				outputSample++;
+			}
+		} while (++oscBufferPos != oscBufferEnd);
 	}
+}
 
-renderingDone:
+// The same, for a Voice which rendered into a stereo buffer, which only happens if the Sound's rendering in stereo
+void Voice::outputStereo(Sound* sound, int32_t const* oscBuffer, int32_t numSamples, int32_t* soundBuffer,
+                         Output const& output) {
+	int32_t const* const oscBufferEnd = oscBuffer + (numSamples << 1);
 
-	for (int32_t s = 0; s < kNumSources; s++) {
-		sourceAmplitudesLastTime[s] = sourceAmplitudes[s];
-		sourceWaveIndexesLastTime[s] = paramFinalValues[params::LOCAL_OSC_A_WAVE_INDEX + s];
+	// No clipping
+	if (!sound->clippingAmount) {
+
+		int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
+		StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
+		int32_t overallOscAmplitudeNow = output.amplitudeStart;
+
+		do {
+			int32_t outputSampleL = *(oscBufferPos++);
+			int32_t outputSampleR = *(oscBufferPos++);
+
+			overallOscAmplitudeNow += output.amplitudeIncrement;
+			if (output.applyAmplitude) {
+				outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
+				outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
+			}
+
+			// Write to the output buffer, panning or not
+			if (output.doPanning) {
+				outputSample->addPannedStereo(outputSampleL, outputSampleR, output.amplitudeL, output.amplitudeR);
+			}
+			else {
+				outputSample->addStereo(outputSampleL, outputSampleR);
+			}
+
+			outputSample++;
+		} while (oscBufferPos != oscBufferEnd);
 	}
-	for (int32_t m = 0; m < kNumModulators; m++) {
-		modulatorAmplitudeLastTime[m] = paramFinalValues[params::LOCAL_MODULATOR_0_VOLUME + m];
+
+	// Yes clipping
+	else {
+
+		int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
+		StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
+		int32_t overallOscAmplitudeNow = output.amplitudeStart;
+
+		do {
+			int32_t outputSampleL = *(oscBufferPos++);
+			int32_t outputSampleR = *(oscBufferPos++);
+
+			overallOscAmplitudeNow += output.amplitudeIncrement;
+			if (output.applyAmplitude) {
+				outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
+				outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
+			}
+
+			sound->saturate(&outputSampleL, &lastSaturationTanHWorkingValue[0]);
+			sound->saturate(&outputSampleR, &lastSaturationTanHWorkingValue[1]);
+
+			// Write to the output buffer, panning or not
+			if (output.doPanning) {
+				outputSample->addPannedStereo(outputSampleL, outputSampleR, output.amplitudeL, output.amplitudeR);
+			}
+			else {
+				outputSample->addStereo(outputSampleL, outputSampleR);
+			}
+
+			outputSample++;
+		} while (oscBufferPos != oscBufferEnd);
 	}
-	overallOscAmplitudeLastTime = overallOscAmplitude;
+}
 
-	return !unassignVoiceAfter;
+// Does outputMono() or outputStereo() a slice at a time, so the overall amplitude gets ramped through its value at the
+// end of each, rather than straight from where it was last time to amplitudeEnd
+void Voice::outputInSubBlocks(Sound* sound, int32_t const* oscBuffer, bool stereoOscBuffer, int32_t numSamples,
+                              int32_t* soundBuffer, Output output, SubBlockAmplitudes const& subBlocks,
+                              int32_t amplitudeEnd) {
+	for (int32_t i = 0; i <= subBlocks.numSlicesDone; i++) {
+		int32_t sliceStart = i * kSubBlockModulationNumSamples;
+		bool lastSlice = (i == subBlocks.numSlicesDone);
+		int32_t numSamplesThisSlice = lastSlice ? numSamples - sliceStart : kSubBlockModulationNumSamples;
+
+		output.amplitudeIncrement =
+		    (int32_t)((lastSlice ? amplitudeEnd : subBlocks.values[i]) - output.amplitudeStart) / numSamplesThisSlice;
+
+		if (stereoOscBuffer) {
+			outputStereo(sound, oscBuffer + (sliceStart << 1), numSamplesThisSlice, soundBuffer + (sliceStart << 1),
+			             output);
+		}
+		else {
+			outputMono(sound, oscBuffer + sliceStart, numSamplesThisSlice,
+			           soundBuffer + (sliceStart << output.soundRenderingInStereo), output);
+		}
+
+		// Carry on from wherever that slice's ramp actually got to
+		output.amplitudeStart += output.amplitudeIncrement * numSamplesThisSlice;
+	}
 }
 
 bool Voice::areAllUnisonPartsInactive(ModelStackWithVoice* modelStack) {
@@ -3234,6 +3386,7 @@ storePhase:
 bool Voice::doFastRelease(uint32_t releaseIncrement) {
 	if (doneFirstRender) {
 		envelopes[0].unconditionalRelease(EnvelopeStage::FAST_RELEASE, releaseIncrement);
+		AudioEngine::voicePriorityQueue.update(this);
 		return true;
 	}
 
@@ -3246,6 +3399,7 @@ bool Voice::doFastRelease(uint32_t releaseIncrement) {
 bool Voice::doImmediateRelease() {
 	if (doneFirstRender) {
 		envelopes[0].unconditionalOff();
+		AudioEngine::voicePriorityQueue.update(this);
 		return true;
 	}
 
@@ -3281,4 +3435,15 @@ uint32_t Voice::getPriorityRating() {
 	    // Bits  0-23 - time entered
 	    + ((uint32_t)(-envelopes[0].timeEnteredState) & (0xFFFFFFFF >> 8));
 }
+
+// Which culls would skip this Voice because it's already on its way out
+VoiceCullView Voice::getCullView() {
+	if (envelopes[0].state == EnvelopeStage::OFF) {
+		return VoiceCullView::OFF;
+	}
+	if (envelopes[0].state == EnvelopeStage::FAST_RELEASE && envelopes[0].fastReleaseIncrement >= SOFT_CULL_INCREMENT) {
+		return VoiceCullView::RELEASING;
+	}
+	return VoiceCullView::SUSTAINING;
+}
 #pragma GCC diagnostic pop
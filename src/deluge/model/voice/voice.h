@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "dsp/filter/filter_set.h"
+#include "model/voice/voice_priority_queue.h"
 #include "model/voice/voice_sample_playback_guide.h"
 #include "model/voice/voice_unison_part.h"
 #include "modulation/envelope.h"
@@ -28,6 +29,16 @@
 
 class StereoSample;
 class ModelStackWithVoice;
+class PatchCableSet;
+class VoiceFilterBatch;
+
+/// With RuntimeFeatureSettingType::SubBlockModulation on, Voices whose volume is moving fast get their envelopes and
+/// LFO stepped, and patched, in slices of this many samples rather than once per audio block. The audio still gets
+/// rendered once per block, with the overall amplitude ramped through its value at the end of each slice
+constexpr int32_t kSubBlockModulationNumSamples = 16;
+constexpr int32_t kMaxNumSubBlocks = SSI_TX_BUFFER_NUM_SAMPLES / kSubBlockModulationNumSamples;
+/// And "fast" means an envelope stage, or an LFO cycle, shorter than this many samples - about 90ms
+constexpr uint32_t kSubBlockModulationMaxPeriod = 4096;
 using namespace deluge;
 class Voice final {
 public:
@@ -85,11 +96,42 @@ public:
 
 	Voice* nextUnassigned;
 
+	// Links into AudioEngine::voicePriorityQueue, and into assignedToSound->voicesForCulling
+	PairingHeapNode<Voice> cullNode{this};
+	PairingHeapNode<Voice> soundCullNode{this};
+
 	uint32_t getLocalLFOPhaseIncrement();
 	void setAsUnassigned(ModelStackWithVoice* modelStack, bool deletingSong = false);
+	/// What renderInSubBlocks() hands render(): the overall amplitude at the end of each slice it's already stepped the
+	/// modulation through. That's every slice but the last, which render() steps along with rendering the audio
+	struct SubBlockAmplitudes {
+		int32_t numSlicesDone;
+		int32_t values[kMaxNumSubBlocks];
+	};
+
+	/// If filterBatch is given, a mono Voice whose filters can be batched leaves its output with it, to be filtered and
+	/// mixed in along with others of the same Sound when the batch is flushed
 	bool render(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples, bool soundRenderingInStereo,
 	            bool applyingPanAtVoiceLevel, uint32_t sourcesChanged, bool doLPF, bool doHPF,
-	            int32_t externalPitchAdjust);
+	            int32_t externalPitchAdjust, VoiceFilterBatch* filterBatch = nullptr,
+	            SubBlockAmplitudes const* subBlocks = nullptr);
+	bool renderInSubBlocks(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples,
+	                       bool soundRenderingInStereo, bool applyingPanAtVoiceLevel, uint32_t sourcesChanged,
+	                       bool doLPF, bool doHPF, int32_t externalPitchAdjust);
+	bool wantsSubBlockModulation(PatchCableSet* patchCableSet);
+
+	/// What render() works out for getting a Voice's filtered output into the Sound's buffer
+	struct Output {
+		int32_t amplitudeStart;
+		int32_t amplitudeIncrement;
+		bool applyAmplitude;
+		bool soundRenderingInStereo;
+		bool doPanning;
+		int32_t amplitudeL;
+		int32_t amplitudeR;
+	};
+	void outputMono(Sound* sound, int32_t const* oscBuffer, int32_t numSamples, int32_t* soundBuffer,
+	                Output const& output);
 
 	void calculatePhaseIncrements(ModelStackWithVoice* modelStack);
 	bool sampleZoneChanged(ModelStackWithVoice* modelStack, int32_t s, MarkerType markerType);
@@ -104,6 +146,7 @@ public:
 	bool hasReleaseStage();
 	void unassignStuff(bool deletingSong);
 	uint32_t getPriorityRating();
+	VoiceCullView getCullView();
 	void expressionEventImmediate(Sound* sound, int32_t voiceLevelValue, int32_t s);
 	void expressionEventSmooth(int32_t newValue, int32_t s);
 
@@ -140,6 +183,13 @@ private:
 	                             int32_t amplitude, uint32_t phaseIncrement, int32_t feedbackAmount,
 	                             int32_t* lastFeedbackValue, int32_t amplitudeIncrement);
 	bool areAllUnisonPartsInactive(ModelStackWithVoice* modelStackWithVoice);
+	void stepModulation(ModelStackWithVoice* modelStack, int32_t numSamples, uint32_t sourcesChanged);
+	int32_t getOverallOscAmplitude();
+	void outputStereo(Sound* sound, int32_t const* oscBuffer, int32_t numSamples, int32_t* soundBuffer,
+	                  Output const& output);
+	void outputInSubBlocks(Sound* sound, int32_t const* oscBuffer, bool stereoOscBuffer, int32_t numSamples,
+	                       int32_t* soundBuffer, Output output, SubBlockAmplitudes const& subBlocks,
+	                       int32_t amplitudeEnd);
 	void setupPorta(Sound* sound);
 	int32_t combineExpressionValues(Sound* sound, int32_t whichExpressionDimension);
 };
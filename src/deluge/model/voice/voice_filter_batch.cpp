@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/voice/voice_filter_batch.h"
+#include "definitions_cxx.hpp"
+#include <span>
+
+using deluge::dsp::filter::MultiVoiceFilter;
+
+namespace {
+// One frame after another, each of kNumLanes samples, one per Voice
+PLACE_INTERNAL_FRUNK int32_t laneBuffer[SSI_TX_BUFFER_NUM_SAMPLES * VoiceFilterBatch::kNumLanes]
+    __attribute__((aligned(CACHE_LINE_SIZE)));
+PLACE_INTERNAL_FRUNK int32_t voiceBuffer[SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
+} // namespace
+
+bool VoiceFilterBatch::add(Voice* voice, int32_t const* oscBuffer, Voice::Output const& output) {
+	if (!MultiVoiceFilter::canBatch(voice->filterSet)) {
+		return false;
+	}
+	if (numVoices_ && !MultiVoiceFilter::canBatchTogether(*filterSets_[0], voice->filterSet)) {
+		flush();
+	}
+
+	int32_t lane = numVoices_++;
+	voices_[lane] = voice;
+	filterSets_[lane] = &voice->filterSet;
+	outputs_[lane] = output;
+	for (int32_t i = 0; i < numSamples_; i++) {
+		laneBuffer[i * kNumLanes + lane] = oscBuffer[i];
+	}
+
+	if (numVoices_ == kNumLanes) {
+		flush();
+	}
+	return true;
+}
+
+void VoiceFilterBatch::flush() {
+	if (!numVoices_) {
+		return;
+	}
+
+	MultiVoiceFilter::render(std::span{filterSets_.data(), (size_t)numVoices_}, laneBuffer, numSamples_);
+
+	for (int32_t lane = 0; lane < numVoices_; lane++) {
+		for (int32_t i = 0; i < numSamples_; i++) {
+			voiceBuffer[i] = laneBuffer[i * kNumLanes + lane];
+		}
+		voices_[lane]->outputMono(sound_, voiceBuffer, numSamples_, soundBuffer_, outputs_[lane]);
+	}
+	numVoices_ = 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "dsp/filter/multi_voice_filter.h"
+#include "model/voice/voice.h"
+#include <array>
+#include <cstdint>
+
+class Sound;
+
+/// Collects the unfiltered output of a Sound's mono Voices while they render, and runs their filters
+/// dsp::filter::MultiVoiceFilter::kNumLanes Voices at a time, mixing each one into the Sound's buffer once filtered.
+/// Voices only get batched with others whose filters have the same modes - one that doesn't match the batch so far
+/// sends that off first.
+class VoiceFilterBatch {
+public:
+	static constexpr int32_t kNumLanes = deluge::dsp::filter::MultiVoiceFilter::kNumLanes;
+
+	VoiceFilterBatch(Sound* sound, int32_t* soundBuffer, int32_t numSamples)
+	    : sound_(sound), soundBuffer_(soundBuffer), numSamples_(numSamples) {}
+
+	/// Takes a copy of the Voice's oscillator output. Returns false if its filters can't be batched right now, in which
+	/// case the caller has to filter and output it itself
+	bool add(Voice* voice, int32_t const* oscBuffer, Voice::Output const& output);
+
+	/// Filters and mixes in all the Voices waiting. Has to happen before anything else reads the Sound's buffer
+	void flush();
+
+private:
+	Sound* sound_;
+	int32_t* soundBuffer_;
+	int32_t numSamples_;
+
+	int32_t numVoices_ = 0;
+	std::array<Voice*, kNumLanes> voices_;
+	std::array<deluge::dsp::filter::FilterSet*, kNumLanes> filterSets_;
+	std::array<Voice::Output, kNumLanes> outputs_;
+};
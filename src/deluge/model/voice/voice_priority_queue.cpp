@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/voice/voice_priority_queue.h"
+#include "model/voice/voice.h"
+#include "model/voice/voice_vector.h"
+#include "processing/engines/audio_engine.h"
+#include "processing/sound/sound.h"
+#include "util/misc.h"
+
+Voice* VoiceCullHeaps::getWorst(VoiceCullView lastView) const {
+	VoiceHeap::Node* best = nullptr;
+	for (int32_t view = 0; view <= util::to_underlying(lastView); view++) {
+		VoiceHeap::Node* top = views[view].top();
+		if (top && (!best || top->key > best->key)) {
+			best = top;
+		}
+	}
+	return best ? best->owner : nullptr;
+}
+
+void VoicePriorityQueue::add(Voice* voice) {
+	uint32_t rating = voice->getPriorityRating();
+	int32_t view = util::to_underlying(voice->getCullView());
+	allVoices.views[view].insert(&voice->cullNode, rating);
+	voice->assignedToSound->voicesForCulling.views[view].insert(&voice->soundCullNode, rating);
+}
+
+void VoicePriorityQueue::remove(Voice* voice) {
+	for (int32_t view = 0; view < kNumVoiceCullViews; view++) {
+		allVoices.views[view].remove(&voice->cullNode);
+		voice->assignedToSound->voicesForCulling.views[view].remove(&voice->soundCullNode);
+	}
+}
+
+void VoicePriorityQueue::update(Voice* voice) {
+	if (!voice->cullNode.heap) {
+		return;
+	}
+
+	uint32_t rating = voice->getPriorityRating();
+	int32_t view = util::to_underlying(voice->getCullView());
+	VoiceHeap& heap = allVoices.views[view];
+
+	if (heap.contains(&voice->cullNode)) {
+		heap.updateKey(&voice->cullNode, rating);
+		voice->assignedToSound->voicesForCulling.views[view].updateKey(&voice->soundCullNode, rating);
+	}
+
+	// Moved between views, so it has to swap heaps
+	else {
+		remove(voice);
+		allVoices.views[view].insert(&voice->cullNode, rating);
+		voice->assignedToSound->voicesForCulling.views[view].insert(&voice->soundCullNode, rating);
+	}
+}
+
+void VoicePriorityQueue::updateAllForSound(Sound* sound) {
+	int32_t ends[2];
+	AudioEngine::activeVoices.getRangeForSound(sound, ends);
+	for (int32_t v = ends[0]; v < ends[1]; v++) {
+		update(AudioEngine::activeVoices.getVoice(v));
+	}
+}
+
+Voice* VoicePriorityQueue::getVoiceToCull(VoiceCullView lastView, Sound* stopFrom) const {
+	if (stopFrom) {
+		return stopFrom->voicesForCulling.getWorst(lastView);
+	}
+	return allVoices.getWorst(lastView);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/container/heap/intrusive_pairing_heap.hpp"
+#include <cstdint>
+#include <functional>
+
+class Voice;
+class Sound;
+
+/// Voices which are already on their way out are kept apart from the rest, so that culls can skip straight past them
+/// without looking at them. Ordered from "still worth culling" to "nothing left to cull".
+enum class VoiceCullView : uint8_t {
+	SUSTAINING,
+	RELEASING, // Fast-releasing at soft-cull speed or faster
+	OFF,       // Envelope finished - will be unassigned at its next render
+};
+constexpr int32_t kNumVoiceCullViews = 3;
+
+/// Highest Voice::getPriorityRating() on top, i.e. the Voice we'd most like to get rid of
+using VoiceHeap = deluge::IntrusivePairingHeap<Voice, std::greater<uint32_t>>;
+
+/// One heap per VoiceCullView. There's one of these for all Voices, and one in each Sound for just its own.
+class VoiceCullHeaps {
+public:
+	/// Returns the Voice with the highest priority rating out of views SUSTAINING through lastView inclusive, or
+	/// nullptr if there are none.
+	Voice* getWorst(VoiceCullView lastView) const;
+
+	VoiceHeap views[kNumVoiceCullViews];
+};
+
+/// Keeps every active Voice ordered by its priority rating, so that culling the k worst Voices costs O(k log n)
+/// rather than a full scan of activeVoices each time. Ratings only change when a Voice's first envelope changes state
+/// or when its Sound gains or loses Voices, so whoever causes one of those must call update() / updateAllForSound().
+class VoicePriorityQueue {
+public:
+	void add(Voice* voice);
+	void remove(Voice* voice);
+
+	/// Re-reads the Voice's priority rating and moves it if it changed. Does nothing if the Voice isn't in the queue.
+	void update(Voice* voice);
+
+	/// For when something every Voice of the Sound shares in its rating (voice count, priority setting) has changed
+	void updateAllForSound(Sound* sound);
+
+	/// Returns the Voice to cull out of views SUSTAINING through lastView, or nullptr. If stopFrom is supplied, only
+	/// that Sound's Voices are considered.
+	Voice* getVoiceToCull(VoiceCullView lastView, Sound* stopFrom) const;
+
+private:
+	VoiceCullHeaps allVoices;
+};
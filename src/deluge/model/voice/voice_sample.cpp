@@ -25,8 +25,10 @@
 #include "model/voice/voice.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/cpu_meter.h"
 #include "processing/source.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/sample_cache_store.h"
 #include "storage/cluster/cluster.h"
 #include "storage/multi_range/multisample_range.h"
 
@@ -423,6 +425,7 @@ bool VoiceSample::render(SamplePlaybackGuide* guide, int32_t* __restrict__ outpu
                          int32_t timeStretchRatio, int32_t amplitude, int32_t amplitudeIncrement,
                          int32_t interpolationBufferSize, InterpolationMode desiredInterpolationMode,
                          int32_t priorityRating) {
+	CPUMeter::StageScope meterStage{CPUMeter::Stage::SAMPLES};
 
 	int32_t playDirection = guide->playDirection;
 
@@ -601,6 +604,9 @@ timeStretchingConsidered:
 	int32_t numChannelsInOutputBuffer = (sampleSourceNumChannels == 2 && AudioEngine::renderInStereo) ? 2 : 1;
 	int32_t whichKernel;
 	uint64_t combinedIncrement;
+	// Falls back to the normal sinc interpolation - or linear - along with SMOOTH when the CPU's struggling
+	bool highPrecision = (desiredInterpolationMode == InterpolationMode::PRECISE
+	                      && interpolationBufferSize == kInterpolationMaxNumSamples);
 
 	amplitude <<= 3;
 	amplitudeIncrement <<= 3;
@@ -1105,7 +1111,7 @@ readNonTimestretched:
 				readSamplesResampled((int32_t**)&outputBufferWritePos, numSamplesThisNonTimestretchedRead, sample,
 				                     jumpAmount, sampleSourceNumChannels, numChannelsInOutputBuffer, phaseIncrement,
 				                     &amplitude, amplitudeIncrement, interpolationBufferSize, (cache != NULL),
-				                     &cacheWritePos, &doneAnySamplesYet, NULL, false, whichKernel);
+				                     &cacheWritePos, &doneAnySamplesYet, NULL, false, whichKernel, highPrecision);
 			}
 
 			if (cache) {
@@ -1331,7 +1337,7 @@ readNewerHead:
 #else
 					    false,
 #endif
-					    PLAY_HEAD_NEWER, whichKernel, priorityRating);
+					    PLAY_HEAD_NEWER, whichKernel, priorityRating, highPrecision);
 
 					if (!success) {
 						return false;
@@ -1367,7 +1373,7 @@ readOlderHeadUnbuffered:
 #else
 					    false,
 #endif
-					    PLAY_HEAD_OLDER, whichKernel, priorityRating);
+					    PLAY_HEAD_OLDER, whichKernel, priorityRating, highPrecision);
 
 					if (!success) {
 						return false;
@@ -1778,6 +1784,7 @@ bool VoiceSample::possiblySetUpCache(SampleControls* sampleControls, SamplePlayb
 	if (cache) {
 		// D_PRINTLN("cache gotten");
 		cacheBytePos = 0;
+		sampleCacheStore.requestRestore(cache); // Get anything that's been stolen, or was saved last time, back in
 
 		setupCacheLoopPoints(guide, (Sample*)guide->audioFileHolder->audioFile, loopingType);
 		bool result = reassessReassessmentLocation(guide, (Sample*)guide->audioFileHolder->audioFile, priorityRating);
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "util/container/array/ordered_resizeable_array_with_multi_word_key.h"
+#include "util/container/array/typed_resizeable_array.hpp"
 
 class Voice;
 class Sound;
@@ -27,12 +28,13 @@ struct VoiceVectorElement {
 	Voice* voice;
 };
 
-class VoiceVector : public OrderedResizeableArrayWithMultiWordKey {
+class VoiceVector
+    : public deluge::container::ResizeableArray<VoiceVectorElement, OrderedResizeableArrayWithMultiWordKey> {
 public:
 	VoiceVector();
 
 	void getRangeForSound(Sound* sound, int32_t* __restrict__ ends);
 	void checkVoiceExists(Voice* voice, Sound* sound, char const* errorCode);
 
-	inline Voice* getVoice(int32_t index) { return ((VoiceVectorElement*)getElementAddress(index))->voice; }
+	inline Voice* getVoice(int32_t index) { return (*this)[index].voice; }
 };
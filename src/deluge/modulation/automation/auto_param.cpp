@@ -166,7 +166,7 @@ void AutoParam::setCurrentValueInResponseToUserInput(int32_t value, ModelStackWi
 				int32_t prevNodeI = nodes.search(livePos + (int32_t)reversed, reversed ? GREATER_OR_EQUAL : LESS);
 				if (prevNodeI >= 0 && prevNodeI < nodes.getNumElements()) { // If there was a Node before livePos...
 investigatePrevNode:
-					ParamNode* prevNode = (ParamNode*)nodes.getElementAddress(prevNodeI);
+					ParamNode* prevNode = &nodes[prevNodeI];
 					int32_t ticksAgo = livePos - prevNode->pos;
 					if (reversed) {
 						ticksAgo = -ticksAgo;
@@ -1430,10 +1430,10 @@ Error AutoParam::beenCloned(bool copyAutomation, int32_t reverseDirectionWithLen
 			error = nodes.insertAtIndex(0, numNodes);
 
 			if (error == Error::NONE) {
-				ParamNode* rightmostNode = (ParamNode*)oldNodes.getElementAddress(numNodes - 1);
+				ParamNode* rightmostNode = &oldNodes[numNodes - 1];
 				int32_t oldNodeToLeftValue = rightmostNode->value;
 
-				ParamNode* leftmostNode = (ParamNode*)oldNodes.getElementAddress(0);
+				ParamNode* leftmostNode = &oldNodes[0];
 				bool anythingAtZero = !leftmostNode->pos;
 
 				for (int32_t iOld = 0; iOld < numNodes; iOld++) {
@@ -1442,14 +1442,14 @@ Error AutoParam::beenCloned(bool copyAutomation, int32_t reverseDirectionWithLen
 						iNew += numNodes;
 					}
 
-					ParamNode* oldNode = (ParamNode*)oldNodes.getElementAddress(iOld);
-					ParamNode* newNode = (ParamNode*)nodes.getElementAddress(iNew);
+					ParamNode* oldNode = &oldNodes[iOld];
+					ParamNode* newNode = &nodes[iNew];
 
 					int32_t iOldToRight = iOld + 1;
 					if (iOldToRight == numNodes) {
 						iOldToRight = 0;
 					}
-					ParamNode* oldNodeToRight = (ParamNode*)oldNodes.getElementAddress(iOldToRight);
+					ParamNode* oldNodeToRight = &oldNodes[iOldToRight];
 
 					int32_t newPos = -oldNode->pos;
 					if (newPos < 0) {
@@ -1498,7 +1498,7 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 	// If pingponging, we have to do our own complicated thing.
 	if (shouldPingpong) {
 
-		ParamNode* nodeAfterWrap = (ParamNode*)nodes.getElementAddress(0);
+		ParamNode* nodeAfterWrap = &nodes[0];
 		bool nothingAtZero = nodeAfterWrap->pos;
 
 		// We may have to create a new node at pos 0 to represent the fact that a pingpong would suddenly occur in the
@@ -1508,7 +1508,7 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 
 			// This block is a quick simple alternative to calling getValueAtPos(), which would also require a
 			// modelStack and check for a bunch of unnecessary stuff.
-			ParamNode* nodeBeforeWrap = (ParamNode*)nodes.getElementAddress(nodes.getNumElements() - 1);
+			ParamNode* nodeBeforeWrap = &nodes[nodes.getNumElements() - 1];
 
 			bool nodeAfterWrapIsInterpolated =
 			    nodeAfterWrap->interpolated; // Make copy, cos we need this even after our pointer is no longer valid,
@@ -1531,7 +1531,7 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 				return;
 			}
 
-			ParamNode* zeroNode = (ParamNode*)nodes.getElementAddress(0);
+			ParamNode* zeroNode = &nodes[0];
 			zeroNode->pos = 0;
 			zeroNode->value = valueAtZero;
 			zeroNode->interpolated = nodeAfterWrapIsInterpolated;
@@ -1566,7 +1566,7 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 					}
 				}
 
-				ParamNode* oldNode = (ParamNode*)nodes.getElementAddress(iOld);
+				ParamNode* oldNode = &nodes[iOld];
 				int32_t newPos = oldNode->pos;
 
 				if (r & 1) {
@@ -1592,7 +1592,7 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 						if (iOldToLeft < 0) {
 							iOldToLeft += numNodesBefore;
 						}
-						ParamNode* oldNodeToLeft = (ParamNode*)nodes.getElementAddress(iOldToLeft);
+						ParamNode* oldNodeToLeft = &nodes[iOldToLeft];
 						newValue = oldNodeToLeft->value;
 					}
 
@@ -1600,12 +1600,12 @@ void AutoParam::generateRepeats(uint32_t oldLength, uint32_t newLength, bool sho
 					if (iOldToRight >= numNodesBefore) {
 						iOldToRight = 0;
 					}
-					ParamNode* oldNodeToRight = (ParamNode*)nodes.getElementAddress(iOldToRight);
+					ParamNode* oldNodeToRight = &nodes[iOldToRight];
 					newInterpolated = oldNodeToRight->interpolated;
 				}
 
 				int32_t iNew = iNewWithinRepeat + numNodesBefore * r;
-				ParamNode* newNode = (ParamNode*)nodes.getElementAddress(iNew);
+				ParamNode* newNode = &nodes[iNew];
 
 				newNode->pos = newPos;
 				newNode->value = newValue;
@@ -1664,7 +1664,7 @@ void AutoParam::appendParam(AutoParam* otherParam, int32_t oldLength, int32_t re
 			return;
 		}
 
-		ParamNode* zeroNode = (ParamNode*)nodes.getElementAddress(newZeroNodeI);
+		ParamNode* zeroNode = &nodes[newZeroNodeI];
 		zeroNode->pos = oldLength;
 		zeroNode->value = valueAtZero;
 		zeroNode->interpolated = true;
@@ -1717,7 +1717,7 @@ void AutoParam::appendParam(AutoParam* otherParam, int32_t oldLength, int32_t re
 			newInterpolated = oldNodeToRight->interpolated;
 
 			int32_t iNew = iNewWithinRepeat + oldNumNodes;
-			ParamNode* newNode = (ParamNode*)nodes.getElementAddress(iNew);
+			ParamNode* newNode = &nodes[iNew];
 
 			newNode->pos = newPos;
 			newNode->value = newValue;
@@ -1842,29 +1842,23 @@ addNewNodeAt0IfNecessary:
 	}
 }
 
+// Caller must have begun a hex blob
 void AutoParam::writeToFile(Serializer& writer, bool writeAutomation, int32_t* valueForOverride) {
-	char buffer[9];
-
-	writer.write("0x");
-
 	int32_t valueNow = (valueForOverride && isAutomated()) ? *valueForOverride : currentValue;
 
-	intToHex(valueNow, buffer);
-	writer.write(buffer);
+	writer.writeHexBlobInt(valueNow);
 
 	if (writeAutomation) {
 
 		for (int32_t i = 0; i < nodes.getNumElements(); i++) {
 			ParamNode* thisNode = nodes.getElement(i);
-			intToHex(thisNode->value, buffer);
-			writer.write(buffer);
+			writer.writeHexBlobInt(thisNode->value);
 
 			uint32_t pos = thisNode->pos;
 			if (thisNode->interpolated) {
 				pos |= ((uint32_t)1 << 31);
 			}
-			intToHex(pos, buffer);
-			writer.write(buffer);
+			writer.writeHexBlobInt(pos);
 		}
 	}
 }
@@ -2648,7 +2642,7 @@ void AutoParam::nudgeNonInterpolatingNodesAtPos(int32_t pos, int32_t offset, int
 			action->recordParamChangeDefinitely(modelStack, false);
 		}
 
-		ParamNode* node = (ParamNode*)nodes.getElementAddress(nodeI);
+		ParamNode* node = &nodes[nodeI];
 		if (!node->interpolated) {
 
 			int32_t newNodePos = pos + offset;
@@ -2670,7 +2664,7 @@ doWrap:
 				// Delete the old node
 				nodes.deleteAtIndex(nodeI);
 
-				ParamNode* nextNode = (ParamNode*)nodes.getElementAddress(nextNodeI);
+				ParamNode* nextNode = &nodes[nextNodeI];
 
 				// If that next node is at the pos we're wanting to nudge to, and would hence get deleted, we can just
 				// copy to it
@@ -2699,7 +2693,7 @@ doWrap:
 						}
 					}
 
-					nextNode = (ParamNode*)nodes.getElementAddress(nextNodeI);
+					nextNode = &nodes[nextNodeI];
 					nextNode->pos = newNodePos;
 
 setNodeValue:
@@ -2727,7 +2721,7 @@ setNodeValue:
 
 				// Or if some node, have a look at it, and delete it if it's been collided with
 				else {
-					ParamNode* nextNode = (ParamNode*)nodes.getElementAddress(nextNodeI);
+					ParamNode* nextNode = &nodes[nextNodeI];
 					if (nextNode->pos == newNodePos) {
 						nodes.deleteAtIndex(nextNodeI);
 					}
@@ -2849,7 +2843,7 @@ void AutoParam::insertStolenNodes(ModelStackWithAutoParam const* modelStack, int
 		if (destI == -1) {
 			break;
 		}
-		ParamNode* destNode = (ParamNode*)nodes.getElementAddress(destI);
+		ParamNode* destNode = &nodes[destI];
 
 		memcpy(destNode, stolenNode, sizeof(ParamNode));
 		//*destNode = *stolenNode;
@@ -2880,7 +2874,7 @@ int32_t AutoParam::getDistanceToNextNode(ModelStackWithAutoParam const* modelSta
 		i = 0;
 	}
 
-	ParamNode* node = (ParamNode*)nodes.getElementAddress(i);
+	ParamNode* node = &nodes[i];
 
 	int32_t distance = node->pos - pos;
 	if (reversed) {
@@ -305,9 +305,9 @@ void MIDIParamCollection::writeToFile(Serializer& writer) {
 				writer.writeTag("cc", cc);
 			}
 
-			writer.writeOpeningTag("value", false);
+			writer.writeTagHexBlobBegin("value");
 			midiParam->param.writeToFile(writer, true);
-			writer.writeClosingTag("value", false);
+			writer.writeHexBlobEnd();
 
 			writer.writeClosingTag("param");
 		}
@@ -21,20 +21,5 @@
 #include <cstdint>
 #include <string.h>
 
-ParamNodeVector::ParamNodeVector() : OrderedResizeableArrayWith32bitKey(sizeof(ParamNode)) {
-}
-
-ParamNode* ParamNodeVector::getElement(int32_t index) {
-	if (index < 0 || index >= getNumElements()) {
-		return NULL;
-	}
-	return (ParamNode*)getElementAddress(index);
-}
-
-ParamNode* ParamNodeVector::getFirst() {
-	return getElement(0);
-}
-
-ParamNode* ParamNodeVector::getLast() {
-	return getElement(getNumElements() - 1);
+ParamNodeVector::ParamNodeVector() {
 }
@@ -17,15 +17,11 @@
 
 #pragma once
 
-#include "util/container/array/ordered_resizeable_array.h"
+#include "util/container/array/typed_resizeable_array.hpp"
 
 class ParamNode;
 
-class ParamNodeVector : public OrderedResizeableArrayWith32bitKey {
+class ParamNodeVector : public deluge::container::OrderedResizeableArray<ParamNode> {
 public:
 	ParamNodeVector();
-
-	ParamNode* getElement(int32_t index);
-	ParamNode* getFirst();
-	ParamNode* getLast();
 };
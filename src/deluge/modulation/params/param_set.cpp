@@ -173,12 +173,9 @@ void ParamSet::writeParamAsAttribute(Serializer& writer, char const* name, int32
 
 	int32_t* valueForOverride = valuesForOverride ? &valuesForOverride[p] : NULL;
 
-	writer.write("\n");
-	writer.printIndents();
-	writer.write(name);
-	writer.write("=\"");
+	writer.writeAttributeHexBlobBegin(name);
 	params[p].writeToFile(writer, writeAutomation, valueForOverride);
-	writer.write("\"");
+	writer.writeHexBlobEnd();
 }
 
 void ParamSet::readParam(Deserializer& reader, ParamCollectionSummary* summary, int32_t p,
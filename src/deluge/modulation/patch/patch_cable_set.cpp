@@ -946,11 +946,9 @@ void PatchCableSet::writePatchCablesToFile(Serializer& writer, bool writeAutomat
 		                      params::paramNameForFile(params::Kind::UNPATCHED_SOUND,
 		                                               patchCables[c].destinationParamDescriptor.getJustTheParam()));
 
-		writer.write("\n");
-		writer.printIndents();
-		writer.write("amount=\"");
+		writer.writeAttributeHexBlobBegin("amount");
 		patchCables[c].param.writeToFile(writer, writeAutomation);
-		writer.write("\"");
+		writer.writeHexBlobEnd();
 
 		// See if another cable(s) controls the range/depth of this cable
 		ParamDescriptor paramDescriptor = patchCables[c].destinationParamDescriptor;
@@ -967,11 +965,9 @@ void PatchCableSet::writePatchCablesToFile(Serializer& writer, bool writeAutomat
 				writer.writeOpeningTagBeginning("patchCable");
 				writer.writeAttribute("source", sourceToString(patchCables[d].from));
 
-				writer.write("\n");
-				writer.printIndents();
-				writer.write("amount=\"");
+				writer.writeAttributeHexBlobBegin("amount");
 				patchCables[d].param.writeToFile(writer, writeAutomation);
-				writer.write("\"");
+				writer.writeHexBlobEnd();
 				writer.closeTag();
 			}
 		}
@@ -37,6 +37,7 @@
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
 #include "io/midi/midi_follow.h"
+#include "io/midi/midi_routing_index.h"
 #include "io/midi/midi_transpose.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action.h"
@@ -65,6 +66,7 @@
 #include "processing/sound/sound_instrument.h"
 #include "processing/stem_export/stem_export.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/cluster_prefetcher.h"
 #include "storage/flash_storage.h"
 #include "storage/storage_manager.h"
 #include "util/cfunctions.h"
@@ -1252,7 +1254,9 @@ void PlaybackHandler::doSongSwap(bool preservePlayPosition) {
 
 	// Swap stuff over
 	AudioEngine::unassignAllVoices(true);
+	clusterPrefetcher.releaseAll();
 	currentSong = preLoadedSong;
+	midiRoutingIndex.invalidate();
 	AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
 	preLoadedSong = NULL;
 	loadSongUI.deletedPartsOfOldSong = false;
@@ -1598,21 +1602,7 @@ void PlaybackHandler::inputTick(bool fromTriggerClock, uint32_t time) {
 		setupPlaybackUsingExternalClock(true);
 	}
 
-	uint32_t timeTilInputTick;
-
-	// The 40 here is a fine-tuned amount to stop everything wrapping wrong when CPU load heavy. 28 to 98 seemed to work
-	// correctly
-	if (time) {
-		timeTilInputTick =
-		    (((uint32_t)(time - (uint32_t)AudioEngine::i2sTXBufferPos) >> (2 + NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE))
-		     + 40)
-		    & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
-	}
-	else {
-		timeTilInputTick = 0;
-	}
-
-	uint32_t timeThisInputTick = AudioEngine::audioSampleTimer + timeTilInputTick;
+	uint32_t timeThisInputTick = time ? AudioEngine::getRenderTimeForTxBufferPos(time) : AudioEngine::audioSampleTimer;
 
 	// If we're doing tempo magnitude matching, do all that
 	if (tempoMagnitudeMatchingActiveNow) {
@@ -2672,6 +2662,10 @@ bool PlaybackHandler::offerNoteToLearnedThings(MIDIDevice* fromDevice, bool on,
 		foundAnything = tryGlobalMIDICommandsOff(fromDevice, channel, note);
 	}
 
+	if (!midiRoutingIndex.anyCommandLearnedTo(channel, note)) {
+		return foundAnything;
+	}
+
 	// Go through all sections
 	for (int32_t s = 0; s < kMaxNumSections; s++) {
 		if (currentSong->sections[s].launchMIDICommand.equalsNoteOrCC(fromDevice, channel, note)) {
@@ -2923,38 +2917,44 @@ void PlaybackHandler::midiCCReceived(MIDIDevice* fromDevice, uint8_t channel, ui
 	}
 
 	// See if midi cc received has been learned to a song param
-	ModelStackWithThreeMainThings* modelStackWithThreeMainThings =
-	    currentSong->setupModelStackWithSongAsTimelineCounter(modelStackMemory);
-	if (modelStackWithThreeMainThings) {
-		ModControllableAudio* modControllable = (ModControllableAudio*)modelStackWithThreeMainThings->modControllable;
-		if (modControllable) {
-			modControllable->offerReceivedCCToLearnedParamsForSong(fromDevice, channel, ccNumber, value,
-			                                                       modelStackWithThreeMainThings);
-		}
-	}
-
-	// Go through all Outputs...
-	for (Output* thisOutput = currentSong->firstOutput; thisOutput; thisOutput = thisOutput->next) {
-
-		// If it has an activeClip... (Hmm, interesting, we don't allow MIDI control of params when no activeClip? Yeah
-		// this checks out, as the various offerReceivedCCToLearnedParams()'s require a timelineCounter, but this seems
-		// restrictive for the user...)
-		if (thisOutput->getActiveClip()) {
-
-			ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
-			    modelStack->addTimelineCounter(thisOutput->getActiveClip());
-
-			if (!isMPE) {
-				// See if it's learned to a parameter
-				// NOTE: this call may change modelStackWithTimelineCounter->timelineCounter etc!
-				thisOutput->offerReceivedCCToLearnedParams(fromDevice, channel, ccNumber, value,
-				                                           modelStackWithTimelineCounter);
+	if (midiRoutingIndex.anySongParamLearnedTo(channel, ccNumber)) {
+		ModelStackWithThreeMainThings* modelStackWithThreeMainThings =
+		    currentSong->setupModelStackWithSongAsTimelineCounter(modelStackMemory);
+		if (modelStackWithThreeMainThings) {
+			ModControllableAudio* modControllable =
+			    (ModControllableAudio*)modelStackWithThreeMainThings->modControllable;
+			if (modControllable) {
+				modControllable->offerReceivedCCToLearnedParamsForSong(fromDevice, channel, ccNumber, value,
+				                                                       modelStackWithThreeMainThings);
 			}
-
-			thisOutput->offerReceivedCC(modelStackWithTimelineCounter, fromDevice, channel, ccNumber, value,
-			                            doingMidiThru);
 		}
 	}
+
+	// Go through just the Outputs with something learned to this CC or channel...
+	int32_t channelOrZone = fromDevice->ports[MIDI_DIRECTION_INPUT_TO_DELUGE].channelToZone(channel);
+	midiRoutingIndex.forEachOutputForCC(
+	    channel, channelOrZone, ccNumber, [&](Output* thisOutput, bool paramLearned, bool inputLearned) {
+		    // If it has an activeClip... (Hmm, interesting, we don't allow MIDI control of params when no activeClip?
+		    // Yeah this checks out, as the various offerReceivedCCToLearnedParams()'s require a timelineCounter, but
+		    // this seems restrictive for the user...)
+		    if (thisOutput->getActiveClip()) {
+
+			    ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
+			        modelStack->addTimelineCounter(thisOutput->getActiveClip());
+
+			    if (!isMPE && paramLearned) {
+				    // See if it's learned to a parameter
+				    // NOTE: this call may change modelStackWithTimelineCounter->timelineCounter etc!
+				    thisOutput->offerReceivedCCToLearnedParams(fromDevice, channel, ccNumber, value,
+				                                               modelStackWithTimelineCounter);
+			    }
+
+			    if (inputLearned) {
+				    thisOutput->offerReceivedCC(modelStackWithTimelineCounter, fromDevice, channel, ccNumber, value,
+				                                doingMidiThru);
+			    }
+		    }
+	    });
 }
 
 // noteCode -1 means channel-wide, including for MPE input (which then means it could still then just apply to one
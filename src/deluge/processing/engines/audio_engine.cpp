@@ -18,6 +18,7 @@
 #include "processing/engines/audio_engine.h"
 #include "definitions_cxx.hpp"
 #include "dsp/envelope_follower/absolute_value.h"
+#include "dsp/interpolation/precise.h"
 #include "dsp/reverb/reverb.hpp"
 #include "dsp/timestretch/time_stretcher.h"
 #include "extern.h"
@@ -40,10 +41,12 @@
 #include "model/sample/sample_recorder.h"
 #include "model/song/song.h"
 #include "model/voice/voice.h"
+#include "model/voice/voice_priority_queue.h"
 #include "model/voice/voice_sample.h"
 #include "model/voice/voice_vector.h"
 #include "modulation/patch/patch_cable_set.h"
 #include "processing/audio_output.h"
+#include "processing/engines/cpu_meter.h"
 #include "processing/engines/cv_engine.h"
 #include "processing/live/live_input_buffer.h"
 #include "processing/metronome/metronome.h"
@@ -52,6 +55,7 @@
 #include "processing/sound/sound_instrument.h"
 #include "processing/stem_export/stem_export.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/impulse_response_loader.h"
 #include "storage/flash_storage.h"
 #include "storage/multi_range/multisample_range.h"
 #include "storage/storage_manager.h"
@@ -115,6 +119,11 @@ namespace AudioEngine {
 constexpr int32_t kNumVoicesStatic = 48;
 constexpr int32_t kNumVoiceSamplesStatic = 48;
 constexpr int32_t kNumTimeStretchersStatic = 48;
+// and the slab pools hold this many more of each - past that, they have to come from the regions, which the audio
+// routine can't do. TimeStretchers are only for time-stretched samples, so need fewer
+constexpr int32_t kNumVoicesPooled = 48;
+constexpr int32_t kNumVoiceSamplesPooled = 48;
+constexpr int32_t kNumTimeStretchersPooled = 16;
 
 // used for culling. This can be high now since it's decoupled from the time between renders, and
 // will spill into a second render and output if needed so as long as we always render 128 samples in under 128/44100
@@ -180,6 +189,7 @@ bool routineBeenCalled;
 uint8_t numHopsEndedThisRoutineCall;
 
 VoiceVector activeVoices{};
+VoicePriorityQueue voicePriorityQueue{};
 
 LiveInputBuffer* liveInputBuffers[3];
 
@@ -229,6 +239,8 @@ void init() {
 
 	sampleForPreview->sideChainSendLevel = 2147483647;
 
+	deluge::dsp::interpolation::initPreciseKernels();
+
 	for (int32_t i = 0; i < kNumVoiceSamplesStatic; i++) {
 		voiceSamples[i].nextUnassigned = (i == kNumVoiceSamplesStatic - 1) ? NULL : &voiceSamples[i + 1];
 	}
@@ -240,6 +252,13 @@ void init() {
 		staticVoices[i].nextUnassigned = (i == kNumVoicesStatic - 1) ? NULL : &staticVoices[i + 1];
 	}
 
+	// In SlabPoolType order
+	GeneralMemoryAllocator::get().setupSlabPools({
+	    {sizeof(Voice), kNumVoicesPooled},
+	    {sizeof(VoiceSample), kNumVoiceSamplesPooled},
+	    {sizeof(TimeStretcher), kNumTimeStretchersPooled},
+	});
+
 	i2sTXBufferPos = (uint32_t)getTxBufferStart();
 
 	i2sRXBufferPos = (uint32_t)getRxBufferStart()
@@ -293,27 +312,12 @@ int32_t numAudioLogItems = 0;
 Voice* cullVoice(bool saveVoice, CullType type, size_t numSamples, Sound* stopFrom) {
 	// Only include audio if doing a hard cull and not saving the voice
 	bool includeAudio = !saveVoice && type == HARD;
-	// Skip releasing voices if doing a soft cull and definitely culling
-	bool skipReleasing = (type == SOFT_ALWAYS);
-	uint32_t bestRating = 0;
-	Voice* bestVoice = NULL;
-	for (int32_t v = 0; v < activeVoices.getNumElements(); v++) {
-		Voice* thisVoice = activeVoices.getVoice(v);
-
-		uint32_t ratingThisVoice = thisVoice->getPriorityRating();
-
-		if (ratingThisVoice > bestRating) {
-			// if we're not skipping releasing voices, or if we are and this one isn't in fast release
-			if (!skipReleasing
-			    || (thisVoice->envelopes[0].state <= EnvelopeStage::FAST_RELEASE
-			        && thisVoice->envelopes[0].fastReleaseIncrement < SOFT_CULL_INCREMENT)) {
-				if (stopFrom == nullptr || thisVoice->assignedToSound == stopFrom) {
-					bestRating = ratingThisVoice;
-					bestVoice = thisVoice;
-				}
-			}
-		}
-	}
+	// Skip releasing voices if doing a soft cull and definitely culling, and skip voices which are already off if
+	// forcing, so that forcing several culls in a row actually gets rid of several voices
+	VoiceCullView lastView = (type == SOFT_ALWAYS) ? VoiceCullView::SUSTAINING
+	                         : (type == FORCE)     ? VoiceCullView::RELEASING
+	                                               : VoiceCullView::OFF;
+	Voice* bestVoice = voicePriorityQueue.getVoiceToCull(lastView, stopFrom);
 
 	if (bestVoice) {
 		activeVoices.checkVoiceExists(
@@ -577,6 +581,9 @@ void renderAudio(size_t numSamples);
 		numSamples = (numSamples + 2) & ~3;
 	}
 
+	// Before ticks, which can shorten the window further, and need to know where it ends when they do
+	midiEngine.actionDueTimedInput(numSamples);
+
 	int32_t timeWithinWindowAtWhichMIDIOrGateOccurs;
 	tickSongFinalizeWindows(numSamples, timeWithinWindowAtWhichMIDIOrGateOccurs);
 
@@ -596,6 +603,8 @@ void renderAudio(size_t numSamples);
 	bypassCulling = false;
 }
 void renderAudio(size_t numSamples) {
+	CPUMeter::BlockScope meterBlock{numSamples};
+
 	memset(&renderingBuffer, 0, numSamples * sizeof(StereoSample));
 	memset(&reverbBuffer, 0, numSamples * sizeof(StereoSample));
 
@@ -730,6 +739,8 @@ startAgain:
 	}
 }
 void renderReverb(size_t numSamples) {
+	CPUMeter::StageScope meterStage{CPUMeter::Stage::REVERB};
+
 	if (currentSong && mustUpdateReverbParamsBeforeNextRender) {
 		updateReverbParams();
 		mustUpdateReverbParamsBeforeNextRender = false;
@@ -933,6 +944,58 @@ void scheduleMidiGateOutISR(uint32_t saddrPosAtStart, int32_t unadjustedNumSampl
 	}
 }
 
+// How long renderOffline() keeps going for each time, so the card and UI still get a look in
+constexpr double kOfflineRenderSliceTime = 0.002;
+// Finished clusters a SampleRecorder can have waiting to be written before offline rendering waits for the card
+constexpr int32_t kOfflineMaxUnwrittenClusters = 4;
+
+bool mayKeepRenderingOffline() {
+	// The voices will be wanting these clusters soon. They can't get loaded while we're in here
+	if (audioFileManager.loadingQueue.getNumElements()) {
+		return false;
+	}
+
+	for (SampleRecorder* recorder = firstRecorder; recorder; recorder = recorder->next) {
+		if (recorder->currentRecordClusterIndex - recorder->firstUnwrittenClusterIndex > kOfflineMaxUnwrittenClusters) {
+			return false;
+		}
+	}
+
+	// Let StemExport end the recording exactly when it goes quiet
+	return !(stemExport.stopOutputRecordingAtSilence && stemExport.reachedSilenceAfterPlayback());
+}
+
+// For stem export: renders as fast as the CPU allows rather than as fast as the codec takes it. Playback's timed off
+// audioSampleTimer, so it just goes faster too, and StemExport records the mix as it's rendered. Always does at least
+// one window, so things still move on, if slowly, if the card can't keep up.
+void renderOffline() {
+	// Nothing goes to the codec, but it would otherwise keep looping whatever was last in its buffer. And it doesn't
+	// like all zeroes
+	for (int32_t* pos = getTxBufferStart(); pos != getTxBufferEnd(); pos += NUM_MONO_OUTPUT_CHANNELS) {
+		pos[0] = pos[1] = ((pos - getTxBufferStart()) >> NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE) & 1;
+	}
+
+	// There's no deadline, so nothing should get culled or made cheaper
+	cpuDireness = 0;
+
+	double timeStarted = getSystemTime();
+	do {
+		size_t numSamples = SSI_TX_BUFFER_NUM_SAMPLES;
+		midiEngine.actionDueTimedInput(numSamples);
+		int32_t timeWithinWindowAtWhichMIDIOrGateOccurs;
+		tickSongFinalizeWindows(numSamples, timeWithinWindowAtWhichMIDIOrGateOccurs);
+
+		numSamplesLastTime = numSamples;
+		renderAudio(numSamples);
+		renderingBufferOutputPos = renderingBufferOutputEnd; // Nothing to output - the recorder's already been fed
+		audioSampleTimer += numSamples;
+
+		if (!sdRoutineLock) {
+			doRecorderCardRoutines();
+		}
+	} while (getSystemTime() < timeStarted + kOfflineRenderSliceTime && mayKeepRenderingOffline());
+}
+
 void routine() {
 
 	logAction("AudioDriver::routine");
@@ -961,10 +1024,14 @@ void routine() {
 			numRoutines += 1;
 		}
 	}
+	else if (stemExport.renderingOffline) {
+		renderOffline();
+	}
 	else {
 		auto timeNow = getSystemTime();
 		while (getSystemTime() < timeNow + 32 / 44100.) {
 			size_t numSamples = 32;
+			midiEngine.actionDueTimedInput(numSamples);
 			int32_t timeWithinWindowAtWhichMIDIOrGateOccurs;
 			tickSongFinalizeWindows(numSamples, timeWithinWindowAtWhichMIDIOrGateOccurs);
 
@@ -980,6 +1047,15 @@ void routine() {
 	audioRoutineLocked = false;
 }
 
+uint32_t getRenderTimeForTxBufferPos(uint32_t txBufferPos) {
+	// The 40 here is a fine-tuned amount to stop everything wrapping wrong when CPU load heavy. 28 to 98 seemed to work
+	// correctly
+	uint32_t timeTil =
+	    (((uint32_t)(txBufferPos - i2sTXBufferPos) >> (2 + NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE)) + 40)
+	    & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
+	return audioSampleTimer + timeTil;
+}
+
 int32_t getNumSamplesLeftToOutputFromPreviousRender() {
 	return ((uint32_t)renderingBufferOutputEnd - (uint32_t)renderingBufferOutputPos) >> 3;
 }
@@ -1298,6 +1374,29 @@ void stopAnyPreviewing() {
 	}
 }
 
+// Of the IR that's in reverb's convolver now
+String reverbImpulseResponsePath;
+
+Error loadReverbImpulseResponse(String* filePath) {
+	if (filePath->equals(&reverbImpulseResponsePath)) {
+		return Error::NONE;
+	}
+
+	if (filePath->isEmpty()) {
+		reverb.getConvolver().unload();
+		reverbImpulseResponsePath.clear();
+		return Error::NONE;
+	}
+
+	// If this fails, whatever IR was there before is still there
+	Error error =
+	    loadImpulseResponse(filePath, &reverb.getConvolver(), dsp::reverb::Convolution::kPartitionMagnitude);
+	if (error == Error::NONE) {
+		reverbImpulseResponsePath.set(filePath);
+	}
+	return error;
+}
+
 void getReverbParamsFromSong(Song* song) {
 	reverb.setRoomSize(song->reverbRoomSize);
 	reverb.setDamping(song->reverbDamp);
@@ -1323,7 +1422,8 @@ Voice* solicitVoice(Sound* forSound) {
 
 	else {
 
-		void* memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(Voice));
+		// From the audio routine, a full pool means culling rather than searching the regions
+		void* memory = GeneralMemoryAllocator::get().allocPooled(SlabPoolType::VOICE, !audioRoutineLocked);
 		if (!memory) {
 			if (activeVoices.getNumElements()) {
 				memory = cullVoice(true, HARD, numSamplesLastTime, forSound);
@@ -1364,6 +1464,7 @@ void unassignVoice(Voice* voice, Sound* sound, ModelStackWithSoundFlags* modelSt
 
 	activeVoices.checkVoiceExists(voice, sound, "E195");
 
+	voicePriorityQueue.remove(voice);
 	voice->setAsUnassigned(modelStack ? modelStack->addVoice(voice) : nullptr);
 	if (removeFromVector) {
 		uint32_t keyWords[2];
@@ -1394,7 +1495,7 @@ VoiceSample* solicitVoiceSample() {
 		return toReturn;
 	}
 	else {
-		void* memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(VoiceSample));
+		void* memory = GeneralMemoryAllocator::get().allocPooled(SlabPoolType::VOICE_SAMPLE, !audioRoutineLocked);
 		if (!memory) {
 			return NULL;
 		}
@@ -1422,7 +1523,7 @@ TimeStretcher* solicitTimeStretcher() {
 	}
 
 	else {
-		void* memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(TimeStretcher));
+		void* memory = GeneralMemoryAllocator::get().allocPooled(SlabPoolType::TIME_STRETCHER, !audioRoutineLocked);
 		if (!memory) {
 			return NULL;
 		}
@@ -1618,6 +1719,16 @@ bool isAnyInternalRecordingHappening() {
 	return false;
 }
 
+bool isAnyRecorderAlteringFile() {
+	for (SampleRecorder* recorder = firstRecorder; recorder; recorder = recorder->next) {
+		if (recorder->alteringFile) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // namespace AudioEngine
 
 //     for (Voice* thisVoice = voices; thisVoice != &voices[numVoices]; thisVoice++) {
@@ -38,6 +38,7 @@ class TimeStretcher;
 class String;
 class SideChain;
 class VoiceVector;
+class VoicePriorityQueue;
 class Freeverb;
 class Metronome;
 class RMSFeedbackCompressor;
@@ -144,6 +145,9 @@ void logAction(char const* string);
 void logAction(int32_t number);
 
 void getReverbParamsFromSong(Song* song);
+/// Loads the impulse response the reverb's IMPULSE_RESPONSE model plays, unless it's already the one loaded. An empty
+/// path unloads it, which frees its memory.
+Error loadReverbImpulseResponse(String* filePath);
 
 VoiceSample* solicitVoiceSample();
 void voiceSampleUnassigned(VoiceSample* voiceSample);
@@ -157,6 +161,10 @@ void doRecorderCardRoutines();
 
 int32_t getNumSamplesLeftToOutputFromPreviousRender();
 
+/// For something timestamped with where the codec's DMA was reading when it happened, like incoming MIDI, the
+/// audioSampleTimer value to action it at - which is always the same latency after it actually happened
+uint32_t getRenderTimeForTxBufferPos(uint32_t txBufferPos);
+
 void registerSideChainHit(int32_t strength);
 
 SampleRecorder* getNewRecorder(int32_t numChannels, AudioRecordingFolder folderID, AudioInputChannel mode,
@@ -164,6 +172,8 @@ SampleRecorder* getNewRecorder(int32_t numChannels, AudioRecordingFolder folderI
                                int32_t buttonPressLatency = 0);
 void discardRecorder(SampleRecorder* recorder);
 bool isAnyInternalRecordingHappening();
+/// Whether any SampleRecorder is still rewriting its file after recording, which it does as a task of its own
+bool isAnyRecorderAlteringFile();
 
 #ifdef FLIGHTDATA
 char log[32][64];
@@ -194,6 +204,7 @@ extern uint8_t numHopsEndedThisRoutineCall;
 extern SideChain reverbSidechain;
 extern uint32_t timeThereWasLastSomeReverb;
 extern VoiceVector activeVoices;
+extern VoicePriorityQueue voicePriorityQueue;
 extern deluge::dsp::Reverb reverb;
 extern uint32_t nextVoiceState;
 extern SoundDrum* sampleForPreview;
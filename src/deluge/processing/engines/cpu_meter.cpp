@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/cpu_meter.h"
+#include "definitions_cxx.hpp"
+#include "model/drum/drum.h"
+#include "model/instrument/kit.h"
+#include "model/output.h"
+#include "model/song/song.h"
+#include "processing/sound/sound_drum.h"
+
+namespace CPUMeter {
+
+namespace {
+// Where counts go from outside a BlockScope, so they don't need checking for
+Counters discarded;
+uint32_t numSamplesMeasured = 0;
+
+constexpr uint64_t kCyclesPerSample = Debug::sec / kSampleRate;
+} // namespace
+
+Counters master;
+
+namespace internal {
+Counters* currentOutput = &discarded;
+Counters* currentSound = nullptr;
+Stage currentStage = Stage::OTHER;
+uint32_t stageStartTime = 0;
+} // namespace internal
+
+uint64_t Counters::total() const {
+	uint64_t sum = 0;
+	for (uint64_t stageCycles : cycles) {
+		sum += stageCycles;
+	}
+	return sum;
+}
+
+BlockScope::BlockScope(size_t numSamples) : numSamples_(numSamples) {
+	internal::stageStartTime = Debug::readCycleCounter();
+	internal::currentOutput = &master;
+	internal::currentSound = nullptr;
+	internal::currentStage = Stage::OTHER;
+}
+
+BlockScope::~BlockScope() {
+	internal::chargeCurrentStage();
+	internal::currentOutput = &discarded;
+	numSamplesMeasured += numSamples_;
+}
+
+void reset() {
+	master.reset();
+	if (currentSong != nullptr) {
+		for (Output* output = currentSong->firstOutput; output; output = output->next) {
+			output->cpuMeter.reset();
+			if (output->type == OutputType::KIT) {
+				for (Drum* drum = static_cast<Kit*>(output)->firstDrum; drum; drum = drum->next) {
+					if (drum->type == DrumType::SOUND) {
+						static_cast<SoundDrum*>(drum)->cpuMeter.reset();
+					}
+				}
+			}
+		}
+	}
+	numSamplesMeasured = 0;
+}
+
+uint32_t getNumSamplesMeasured() {
+	return numSamplesMeasured;
+}
+
+uint32_t getPerMille(uint64_t cycles) {
+	if (numSamplesMeasured == 0) {
+		return 0;
+	}
+	return (cycles * 1000) / (numSamplesMeasured * kCyclesPerSample);
+}
+
+uint32_t getPeakPerMille(uint32_t cyclesPerSample) {
+	return ((uint64_t)cyclesPerSample * 1000) / kCyclesPerSample;
+}
+
+char const* getStageName(Stage stage) {
+	switch (stage) {
+	case Stage::OTHER:
+		return "other";
+	case Stage::VOICES:
+		return "voices";
+	case Stage::SAMPLES:
+		return "samples";
+	case Stage::SOUND:
+		return "sound";
+	case Stage::MOD_FX:
+		return "mod fx";
+	case Stage::DELAY:
+		return "delay";
+	case Stage::REVERB:
+		return "reverb";
+	}
+	return "";
+}
+
+} // namespace CPUMeter
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/debug/print.h"
+#include "util/misc.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Counts the CPU cycles the audio routine spends in each stage of rendering, per Output and per Sound, so it can be
+/// seen which track or effect is eating the CPU. Always on: each stage boundary is one read of the cycle counter and a
+/// couple of adds. Stages don't nest in the counts - time spent reading samples inside a Voice's render counts as
+/// SAMPLES, not VOICES - so a Sound or Output's stages add up to its total.
+namespace CPUMeter {
+
+enum class Stage : uint8_t {
+	OTHER,   ///< Outside any of the stages below - clip and output bookkeeping, mostly
+	VOICES,  ///< Voice::render, including the filters
+	SAMPLES, ///< Reading and resampling sample data, for voices and audio clips
+	SOUND,   ///< Sound::render's own work - patching, voice management, sidechain, panning
+	MOD_FX,  ///< ModControllableAudio::processFX, other than the delay
+	DELAY,
+	REVERB,
+};
+constexpr size_t kNumStages = 7;
+
+struct Counters {
+	std::array<uint64_t, kNumStages> cycles{};
+	/// The most an Output's rendered in one window, in cycles per sample. Only kept for Outputs
+	uint32_t peakCyclesPerSample = 0;
+
+	[[nodiscard]] uint64_t total() const;
+	void reset() { *this = {}; }
+};
+
+/// For everything outside any Output - reverb, master FX, sample preview
+extern Counters master;
+
+/// Clears every count, starting a new measurement
+void reset();
+/// Samples rendered since the last reset
+uint32_t getNumSamplesMeasured();
+/// A count as a share of the CPU since the last reset, in tenths of a percent
+uint32_t getPerMille(uint64_t cycles);
+/// The same for a peak, which is already per sample
+uint32_t getPeakPerMille(uint32_t cyclesPerSample);
+char const* getStageName(Stage stage);
+
+namespace internal {
+extern Counters* currentOutput;
+extern Counters* currentSound;
+extern Stage currentStage;
+extern uint32_t stageStartTime;
+
+[[gnu::always_inline]] inline uint32_t chargeCurrentStage() {
+	uint32_t now = Debug::readCycleCounter();
+	uint32_t elapsed = now - stageStartTime;
+	stageStartTime = now;
+	size_t stage = util::to_underlying(currentStage);
+	currentOutput->cycles[stage] += elapsed;
+	if (currentSound != nullptr) {
+		currentSound->cycles[stage] += elapsed;
+	}
+	return now;
+}
+} // namespace internal
+
+/// Around one whole render by the audio routine. Outside of one, nothing gets counted.
+class BlockScope {
+public:
+	explicit BlockScope(size_t numSamples);
+	~BlockScope();
+
+private:
+	size_t numSamples_;
+};
+
+/// Counts what happens inside it towards an Output, as OTHER unless it's in some other stage
+class OutputScope {
+public:
+	[[gnu::always_inline]] OutputScope(Counters& counters, int32_t numSamples)
+	    : previousOutput_(internal::currentOutput), previousStage_(internal::currentStage),
+	      numSamples_(std::max<int32_t>(numSamples, 1)) {
+		startTime_ = internal::chargeCurrentStage();
+		internal::currentOutput = &counters;
+		internal::currentStage = Stage::OTHER;
+	}
+	[[gnu::always_inline]] ~OutputScope() {
+		uint32_t cyclesPerSample = (internal::chargeCurrentStage() - startTime_) / numSamples_;
+		if (cyclesPerSample > internal::currentOutput->peakCyclesPerSample) {
+			internal::currentOutput->peakCyclesPerSample = cyclesPerSample;
+		}
+		internal::currentOutput = previousOutput_;
+		internal::currentStage = previousStage_;
+	}
+
+private:
+	Counters* previousOutput_;
+	Stage previousStage_;
+	uint32_t numSamples_;
+	uint32_t startTime_;
+};
+
+/// Counts what happens inside it towards a Sound, as well as towards whichever Output it's in
+class SoundScope {
+public:
+	[[gnu::always_inline]] explicit SoundScope(Counters& counters)
+	    : previousSound_(internal::currentSound), previousStage_(internal::currentStage) {
+		internal::chargeCurrentStage();
+		internal::currentSound = &counters;
+		internal::currentStage = Stage::SOUND;
+	}
+	[[gnu::always_inline]] ~SoundScope() {
+		internal::chargeCurrentStage();
+		internal::currentSound = previousSound_;
+		internal::currentStage = previousStage_;
+	}
+
+private:
+	Counters* previousSound_;
+	Stage previousStage_;
+};
+
+class StageScope {
+public:
+	[[gnu::always_inline]] explicit StageScope(Stage stage) : previousStage_(internal::currentStage) {
+		internal::chargeCurrentStage();
+		internal::currentStage = stage;
+	}
+	[[gnu::always_inline]] ~StageScope() {
+		internal::chargeCurrentStage();
+		internal::currentStage = previousStage_;
+	}
+
+private:
+	Stage previousStage_;
+};
+
+} // namespace CPUMeter
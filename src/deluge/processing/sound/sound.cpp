@@ -38,6 +38,7 @@
 #include "model/song/song.h"
 #include "model/timeline_counter.h"
 #include "model/voice/voice.h"
+#include "model/voice/voice_filter_batch.h"
 #include "model/voice/voice_sample.h"
 #include "model/voice/voice_vector.h"
 #include "modulation/params/param.h"
@@ -290,7 +291,7 @@ void Sound::setupAsDefaultSynth(ParamManager* paramManager) {
 
 void Sound::possiblySetupDefaultExpressionPatching(ParamManager* paramManager) {
 
-	if (smDeserializer.firmware_version < FirmwareVersion::official({4, 0, 0, "beta"})) {
+	if (activeDeserializer->firmware_version < FirmwareVersion::official({4, 0, 0, "beta"})) {
 
 		if (!paramManager->getPatchCableSet()->isSourcePatchedToSomethingManuallyCheckCables(PatchSource::AFTERTOUCH)
 		    && !paramManager->getPatchCableSet()->isSourcePatchedToSomethingManuallyCheckCables(PatchSource::X)
@@ -691,7 +692,7 @@ Error Sound::readTagFromFile(Deserializer& reader, char const* tagName, ParamMan
 				reader.exitTag("arpMode");
 			}
 			else if (!strcmp(tagName, "mode")
-			         && smDeserializer.firmware_version < FirmwareVersion::community({1, 2, 0})) {
+			         && reader.firmware_version < FirmwareVersion::community({1, 2, 0})) {
 				// Import the old "mode" into the new splitted params "arpMode", "noteMode", and "octaveMode
 				// but only if the new params are not already read and set,
 				// that is, if we detect they have a value other than default
@@ -1316,7 +1317,7 @@ Error Sound::readTagFromFile(Deserializer& reader, char const* tagName, ParamMan
 		}
 		else if (readTagFromFile(reader, tagName)) {}
 		else {
-			result = smDeserializer.tryReadingFirmwareTagFromFile(tagName);
+			result = reader.tryReadingFirmwareTagFromFile(tagName);
 			if (result != Error::NONE && result != Error::RESULT_TAG_UNUSED) {
 				return result;
 			}
@@ -1657,6 +1658,12 @@ justUnassign:
 				for (int32_t e = 0; e < kNumEnvelopes; e++) {
 					newVoice->envelopes[e].resumeAttack(envelopePositions[e]);
 				}
+				AudioEngine::voicePriorityQueue.update(newVoice);
+			}
+			else {
+				// Only gets its priority rating now that its envelopes are set up
+				AudioEngine::voicePriorityQueue.add(newVoice);
+				voiceCountChanged();
 			}
 		}
 
@@ -1949,6 +1956,20 @@ bool Sound::isNoiseActiveEver(ParamManagerForTimeline* paramManager) {
 	        && paramManager->getPatchedParamSet()->params[params::LOCAL_NOISE_VOLUME].containsSomething(-2147483648));
 }
 
+// Live input can only be rendered as it arrives, so e.g. stem export has to go at real time if this is true
+bool Sound::usesLiveInput() {
+	if (synthMode == SynthMode::FM) {
+		return false;
+	}
+	for (int32_t s = 0; s < kNumSources; s++) {
+		OscType oscType = sources[s].oscType;
+		if (oscType == OscType::INPUT_L || oscType == OscType::INPUT_R || oscType == OscType::INPUT_STEREO) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool Sound::renderingOscillatorSyncCurrently(ParamManagerForTimeline* paramManager) {
 	if (!oscillatorSync) {
 		return false;
@@ -2181,6 +2202,7 @@ void Sound::stopParamLPF(ModelStackWithSoundFlags* modelStack) {
 void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outputBuffer, int32_t numSamples,
                    int32_t* reverbBuffer, int32_t sideChainHitPending, int32_t reverbAmountAdjust,
                    bool shouldLimitDelayFeedback, int32_t pitchAdjust) {
+	CPUMeter::SoundScope meterScope{cpuMeter};
 
 	if (skippingRendering) {
 		compressor.gainReduction = 0;
@@ -2316,8 +2338,16 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 		bool doneFirstVoice = false;
 		*/
 
+		// Only worth slicing up if the block is long enough for block-rate modulation to be heard. FM works the overall
+		// amplitude into each carrier's instead, once per block, so slicing wouldn't change anything
+		bool subBlockModulation = (numSamples > kSubBlockModulationNumSamples && getSynthMode() != SynthMode::FM
+		                           && runtimeFeatureSettings.isOn(RuntimeFeatureSettingType::SubBlockModulation));
+
 		int32_t ends[2];
 		AudioEngine::activeVoices.getRangeForSound(this, ends);
+		// Filters of several voices can run side by side, so long as there are several voices to do it for
+		VoiceFilterBatch filterBatch{this, soundBuffer, numSamples};
+		VoiceFilterBatch* filterBatchToUse = (ends[1] - ends[0] > 1) ? &filterBatch : nullptr;
 		for (int32_t v = ends[0]; v < ends[1]; v++) {
 			Voice* thisVoice = AudioEngine::activeVoices.getVoice(v);
 			/*
@@ -2333,14 +2363,31 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 
 			ModelStackWithVoice* modelStackWithVoice = modelStackWithSoundFlags->addVoice(thisVoice);
 
-			bool stillGoing = thisVoice->render(modelStackWithVoice, soundBuffer, numSamples, renderingInStereo,
-			                                    applyingPanAtVoiceLevel, sourcesChanged, doLPF, doHPF, pitchAdjust);
+			bool stillGoing;
+			if (subBlockModulation && thisVoice->wantsSubBlockModulation(paramManager->getPatchCableSet()))
+			    [[unlikely]] {
+				stillGoing =
+				    thisVoice->renderInSubBlocks(modelStackWithVoice, soundBuffer, numSamples, renderingInStereo,
+				                                 applyingPanAtVoiceLevel, sourcesChanged, doLPF, doHPF, pitchAdjust);
+			}
+			else {
+				stillGoing = thisVoice->render(modelStackWithVoice, soundBuffer, numSamples, renderingInStereo,
+				                               applyingPanAtVoiceLevel, sourcesChanged, doLPF, doHPF, pitchAdjust,
+				                               filterBatchToUse);
+			}
 			if (!stillGoing) {
 				AudioEngine::activeVoices.checkVoiceExists(thisVoice, this, "E201");
 				AudioEngine::unassignVoice(thisVoice, this, modelStackWithSoundFlags);
 				v--;
 				ends[1]--;
 			}
+			else {
+				AudioEngine::voicePriorityQueue.update(thisVoice); // Its envelope may have changed stage
+			}
+		}
+		{
+			CPUMeter::StageScope meterStage{CPUMeter::Stage::VOICES};
+			filterBatch.flush();
 		}
 
 		// If just rendered in mono, double that up to stereo now
@@ -2861,6 +2908,14 @@ void Sound::voiceUnassigned(ModelStackWithVoice* modelStack) {
 
 	numVoicesAssigned--;
 	reassessRenderSkippingStatus(modelStack);
+	voiceCountChanged();
+}
+
+// The voice count makes up part of each Voice's priority rating, though it stops mattering above 7
+void Sound::voiceCountChanged() {
+	if (numVoicesAssigned < 8) {
+		AudioEngine::voicePriorityQueue.updateAllForSound(this);
+	}
 }
 
 // modelStack may be NULL if no voices currently active
@@ -3117,7 +3172,7 @@ Error Sound::readFromFile(Deserializer& reader, ModelStackWithModControllable* m
 
 	// If we actually got a paramManager, we can do resonance compensation on it
 	if (paramManager.containsAnyMainParamCollections()) {
-		if (smDeserializer.firmware_version < FirmwareVersion::official({1, 2, 0})) {
+		if (reader.firmware_version < FirmwareVersion::official({1, 2, 0})) {
 			compensateVolumeForResonance(modelStack->addParamManager(&paramManager));
 		}
 
@@ -3156,7 +3211,7 @@ Error Sound::createParamManagerForLoading(ParamManagerForTimeline* paramManager)
 void Sound::compensateVolumeForResonance(ModelStackWithThreeMainThings* modelStack) {
 
 	// If it was an old-firmware file, we need to compensate for resonance
-	if (smDeserializer.firmware_version < FirmwareVersion::official({1, 2, 0}) && synthMode != SynthMode::FM) {
+	if (activeDeserializer->firmware_version < FirmwareVersion::official({1, 2, 0}) && synthMode != SynthMode::FM) {
 		if (modelStack->paramManager->resonanceBackwardsCompatibilityProcessed) {
 			return;
 		}
@@ -3282,6 +3337,12 @@ Error Sound::readSourceFromFile(Deserializer& reader, int32_t s, ParamManagerFor
 			}
 			reader.exitTag("linearInterpolation");
 		}
+		else if (!strcmp(tagName, "highPrecisionInterpolation")) {
+			if (reader.readTagOrAttributeValueInt()) {
+				source->sampleControls.interpolationMode = InterpolationMode::PRECISE;
+			}
+			reader.exitTag("highPrecisionInterpolation");
+		}
 		else if (!strcmp(tagName, "retrigPhase")) {
 			oscRetriggerPhase[s] = reader.readTagOrAttributeValueInt();
 			reader.exitTag("retrigPhase");
@@ -3486,6 +3547,9 @@ void Sound::writeSourceToFile(Serializer& writer, int32_t s, char const* tagName
 		if (source->sampleControls.interpolationMode == InterpolationMode::LINEAR) {
 			writer.writeAttribute("linearInterpolation", 1);
 		}
+		else if (source->sampleControls.interpolationMode == InterpolationMode::PRECISE) {
+			writer.writeAttribute("highPrecisionInterpolation", 1);
+		}
 
 		int32_t numRanges = source->ranges.getNumElements();
 
@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "model/mod_controllable/mod_controllable_audio.h"
+#include "model/voice/voice_priority_queue.h"
 #include "modulation/arpeggiator.h"
 #include "modulation/knob.h"
 #include "modulation/lfo.h"
@@ -27,6 +28,7 @@
 #include "modulation/params/param_set.h"
 #include "modulation/patch/patcher.h"
 #include "modulation/sidechain/sidechain.h"
+#include "processing/engines/cpu_meter.h"
 #include "processing/source.h"
 #include "util/misc.h"
 
@@ -135,6 +137,9 @@ public:
 	uint32_t startSkippingRenderingAtTime; // Valid when not 0. Allows a wait-time before render skipping starts, for if
 	                                       // mod fx are on
 
+	// Cycles spent rendering this Sound, its Voices and its FX. For a Kit's drums - a synth's Output has its own
+	CPUMeter::Counters cpuMeter;
+
 	virtual ArpeggiatorSettings* getArpSettings(InstrumentClip* clip = NULL) = 0;
 	virtual void setSkippingRendering(bool newSkipping);
 
@@ -182,6 +187,7 @@ public:
 	bool isSourceActiveEverDisregardingMissingSample(int32_t s, ParamManager* paramManager);
 	bool isSourceActiveEver(int32_t s, ParamManager* paramManager);
 	bool isNoiseActiveEver(ParamManagerForTimeline* paramManager);
+	bool usesLiveInput();
 	void noteOn(ModelStackWithThreeMainThings* modelStack, ArpeggiatorBase* arpeggiator, int32_t noteCode,
 	            int16_t const* mpeValues, uint32_t sampleSyncLength = 0, int32_t ticksLate = 0,
 	            uint32_t samplesLate = 0, int32_t velocity = 64, int32_t fromMIDIChannel = 16);
@@ -267,10 +273,12 @@ public:
 		}
 	}
 	int32_t numVoicesAssigned;
+	VoiceCullHeaps voicesForCulling; // Just this Sound's Voices - see AudioEngine::voicePriorityQueue
 	uint32_t getSyncedLFOPhaseIncrement(const LFOConfig& config);
 
 private:
 	uint32_t getGlobalLFOPhaseIncrement();
+	void voiceCountChanged();
 	void recalculateModulatorTransposer(uint8_t m, ModelStackWithSoundFlags* modelStack);
 	void setupUnisonDetuners(ModelStackWithSoundFlags* modelStack);
 	void setupUnisonStereoSpread();
@@ -87,6 +87,7 @@ void SoundDrum::resetTimeEnteredState() {
 	for (int32_t v = ends[0]; v < ends[1]; v++) {
 		Voice* thisVoice = AudioEngine::activeVoices.getVoice(v);
 		thisVoice->envelopes[0].resetTimeEntered();
+		AudioEngine::voicePriorityQueue.update(thisVoice);
 	}
 }
 
@@ -515,6 +515,7 @@ bool SoundInstrument::noteIsOn(int32_t noteCode, bool resetTimeEntered) {
 		    && thisVoice->envelopes[0].state < EnvelopeStage::RELEASE) { // Ignore releasing notes. Is this right?
 			if (resetTimeEntered) {
 				thisVoice->envelopes[0].resetTimeEntered();
+				AudioEngine::voicePriorityQueue.update(thisVoice);
 			}
 			return true;
 		}
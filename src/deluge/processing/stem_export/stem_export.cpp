@@ -28,12 +28,16 @@
 #include "hid/led/indicator_leds.h"
 #include "model/clip/clip.h"
 #include "model/clip/instrument_clip.h"
+#include "model/instrument/kit.h"
 #include "model/note/note_row.h"
 #include "model/song/song.h"
 #include "playback/mode/arrangement.h"
 #include "playback/mode/session.h"
 #include "playback/playback_handler.h"
+#include "processing/audio_output.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/sound/sound_drum.h"
+#include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
 #include "task_scheduler.h"
 #include <new>
@@ -53,6 +57,7 @@ StemExport::StemExport() {
 	currentStemExportType = StemExportType::CLIP;
 	processStarted = false;
 	stopOutputRecordingAtSilence = false;
+	renderingOffline = false;
 
 	highestUsedStemFolderNumber = -1;
 	wavFileNameForStemExportSet = false;
@@ -69,6 +74,7 @@ StemExport::StemExport() {
 void StemExport::startStemExportProcess(StemExportType stemExportType) {
 	currentStemExportType = stemExportType;
 	processStarted = true;
+	renderingOffline = !songUsesLiveInput();
 
 	// exit save UI mode and turn off save button LED
 	exitUIMode(UI_MODE_HOLDING_SAVE_BUTTON);
@@ -167,13 +173,45 @@ bool StemExport::checkForLoopEnd() {
 
 /// if playback has stopped, we want to check for silence so we can stop recording
 void StemExport::checkForSilence() {
-	if (!playbackHandler.isEitherClockActive() && playbackHandler.recording == RecordingMode::OFF) {
-		// if silence is found and you are currently resampling, stop recording soon
-		if (std::max(AudioEngine::approxRMSLevel.l, AudioEngine::approxRMSLevel.r) < 9) {
-			audioRecorder.endRecordingSoon();
-			stopOutputRecordingAtSilence = false;
+	// if silence is found and you are currently resampling, stop recording soon
+	if (reachedSilenceAfterPlayback()) {
+		audioRecorder.endRecordingSoon();
+		stopOutputRecordingAtSilence = false;
+	}
+}
+
+/// whether playback has stopped and the tails have rung out. Offline rendering stops for a moment when this happens,
+/// so checkForSilence() gets to end the recording right there
+bool StemExport::reachedSilenceAfterPlayback() {
+	return !playbackHandler.isEitherClockActive() && playbackHandler.recording == RecordingMode::OFF
+	       && std::max(AudioEngine::approxRMSLevel.l, AudioEngine::approxRMSLevel.r) < 9;
+}
+
+/// live input can only be recorded as it arrives, so a song which monitors or plays it has to be exported in real
+/// time. This is checked for the whole song up front, rather than per stem
+bool StemExport::songUsesLiveInput() {
+	for (Output* output = currentSong->firstOutput; output; output = output->next) {
+		if (output->type == OutputType::AUDIO) {
+			AudioOutput* audioOutput = (AudioOutput*)output;
+			if (audioOutput->echoing && audioOutput->inputChannel > AudioInputChannel::NONE
+			    && audioOutput->inputChannel < AUDIO_INPUT_CHANNEL_FIRST_INTERNAL_OPTION) {
+				return true;
+			}
+		}
+		else if (output->type == OutputType::SYNTH) {
+			if (((SoundInstrument*)output)->usesLiveInput()) {
+				return true;
+			}
+		}
+		else if (output->type == OutputType::KIT) {
+			for (Drum* drum = ((Kit*)output)->firstDrum; drum; drum = drum->next) {
+				if (drum->type == DrumType::SOUND && ((SoundDrum*)drum)->usesLiveInput()) {
+					return true;
+				}
+			}
 		}
 	}
+	return false;
 }
 
 /// disarms and prepares all the instruments so that they can be exported
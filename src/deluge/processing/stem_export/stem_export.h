@@ -35,8 +35,12 @@ public:
 	void stopOutputRecordingAndPlayback();
 	bool checkForLoopEnd();
 	void checkForSilence();
+	bool reachedSilenceAfterPlayback();
+	bool songUsesLiveInput();
 	bool processStarted;
 	bool stopOutputRecordingAtSilence;
+	// Whether AudioEngine renders as fast as it can rather than at real time. Only not the case if there's live input
+	bool renderingOffline;
 	StemExportType currentStemExportType;
 
 	// export instruments
@@ -31,13 +31,16 @@
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/cluster/cluster.h"
+#include "storage/cluster/cluster_run.h"
 #include "storage/storage_manager.h"
 #include "storage/wave_table/wave_table.h"
 #include "storage/wave_table/wave_table_reader.h"
+#include "task_scheduler.h"
 #include <new>
 #include <string.h>
 
 extern "C" {
+#include "RZA1/sdhi/inc/sdif.h"
 #include "fatfs/diskio.h"
 #include "fatfs/ff.h"
 
@@ -51,6 +54,8 @@ LBA_t clst2sect(           /* !=0:Sector number, 0:Failed (invalid cluster#) */
 );
 
 DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
+DRESULT disk_read_scattered_without_streaming_first(BYTE pdrv, SD_READ_SEGMENT const* segments, int numSegments,
+                                                    DWORD sector);
 
 extern uint8_t currentlyAccessingCard;
 }
@@ -212,6 +217,11 @@ clusterSizeChangedButItsOk:
 // must not call this during the card or audio routines.
 void AudioFileManager::deleteAnyTempRecordedSamplesFromMemory() {
 
+	// A recorder that's still altering its file has hold of its Sample until that's done
+	if (AudioEngine::isAnyRecorderAlteringFile()) {
+		yield([]() { return !AudioEngine::isAnyRecorderAlteringFile(); });
+	}
+
 	// Also though, in case any of these Samples were still being recorded before the Song-delete, we need to make sure
 	// SampleRecorder::cardRoutine() gets called first to "detach" the Sample from the recorder. So, do this:
 	AudioEngine::doRecorderCardRoutines();
@@ -918,6 +928,28 @@ void AudioFileManager::deallocateCluster(Cluster* cluster) {
 
 #define REPORT_LOAD_TIME 0
 
+// 0 means there's nothing to read, which shouldn't really still happen
+int32_t AudioFileManager::getNumSectorsToLoad(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	int32_t numSectors = clusterSize >> 9;
+
+	// If this is the last Cluster, and we do know what the audio data length is...
+	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
+		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
+		uint32_t startByteThisCluster = cluster->clusterIndex << clusterSizeMagnitude;
+		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
+		if (bytesToRead <= 0) {
+			D_PRINTLN("fail thing");
+			return 0;
+		}
+		if (bytesToRead < clusterSize) {
+			numSectors = ((bytesToRead - 1) >> 9) + 1;
+		}
+		// Otherwise, just leave it at the normal number of sectors
+	}
+	return numSectors;
+}
+
 bool AudioFileManager::loadCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
 
 	if (currentlyAccessingCard) {
@@ -963,23 +995,9 @@ getOutEarly:
 		return false;
 	}
 
-	int32_t clusterIndex = cluster->clusterIndex;
-
-	int32_t numSectors = clusterSize >> 9;
-
-	// If this is the last Cluster, and we do know what the audio data length is...
-	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
-		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
-		uint32_t startByteThisCluster = clusterIndex << clusterSizeMagnitude;
-		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
-		if (bytesToRead <= 0) {
-			D_PRINTLN("fail thing"); // Shouldn't really still happen
-			goto getOutEarly;
-		}
-		if (bytesToRead < clusterSize) {
-			numSectors = ((bytesToRead - 1) >> 9) + 1;
-		}
-		// Otherwise, just leave it at the normal number of sectors
+	int32_t numSectors = getNumSectorsToLoad(cluster);
+	if (!numSectors) {
+		goto getOutEarly;
 	}
 
 #if ALPHA_OR_BETA_VERSION
@@ -1034,6 +1052,28 @@ getOutEarly:
 		goto getOutEarly;
 	}
 
+	finishLoadingCluster(cluster, minNumReasonsAfter);
+
+	clusterBeingLoaded = NULL;
+	removeReasonFromCluster(cluster, "E034");
+
+#if ALPHA_OR_BETA_VERSION
+	if (cluster->numReasonsToBeLoaded < minNumReasonsAfter) {
+		FREEZE_WITH_ERROR("i037");
+	}
+	if (cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster != cluster) {
+		FREEZE_WITH_ERROR("E438");
+	}
+#endif
+
+	return true;
+}
+
+// Converts a freshly read Cluster's data, and swaps the bytes which overhang its ends with any loaded neighbours
+void AudioFileManager::finishLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
+	Sample* sample = cluster->sample;
+	int32_t clusterIndex = cluster->clusterIndex;
+
 	cluster->convertDataIfNecessary();
 
 #if ALPHA_OR_BETA_VERSION
@@ -1224,18 +1264,82 @@ copy7ToMe:
 	}
 
 	cluster->loaded = true;
+}
+
+// Finds how many of the Clusters following this one in its Sample are also waiting to be loaded, and sit straight after
+// it on the card, so they can all be read with one command. Those get taken out of loadingQueue. Returns the number of
+// Clusters in the run, including the first.
+int32_t AudioFileManager::gatherClusterRun(Cluster* first, Cluster** run) {
+	Sample* sample = first->sample;
+	int32_t sectorsPerCluster = clusterSize >> 9;
+	int32_t numSectors = getNumSectorsToLoad(first);
+	int32_t runLength = 1;
+	run[0] = first;
+
+	// Only a Cluster which fills its whole space on the card can have the next one read straight after it
+	while (runLength < kMaxClustersPerRead && numSectors == sectorsPerCluster * runLength
+	       && numSectors + sectorsPerCluster <= kMaxSectorsPerRead) {
+		uint32_t prevIndex = run[runLength - 1]->clusterIndex;
+		if (prevIndex + 1 >= sample->clusters.getNumElements()) {
+			break;
+		}
+		SampleCluster* sampleCluster = sample->clusters.getElement(prevIndex + 1);
+		Cluster* next = sampleCluster->cluster;
+		if (!next || next->loaded || next->type != ClusterType::Sample
+		    || sampleCluster->sdAddress != sample->clusters.getElement(prevIndex)->sdAddress + sectorsPerCluster) {
+			break;
+		}
+		int32_t numSectorsNext = getNumSectorsToLoad(next);
+		if (!numSectorsNext || !loadingQueue.removeIfPresent(next)) {
+			break;
+		}
+		run[runLength++] = next;
+		numSectors += numSectorsNext;
+	}
+
+	return runLength;
+}
+
+// Loads a run from gatherClusterRun() with one card read. If that fails, the Clusters after the first go back in
+// loadingQueue with the priority they had, and the first is left to the caller, as with loadCluster().
+bool AudioFileManager::loadClusterRun(std::span<Cluster*> run) {
+	if (currentlyAccessingCard || clusterBeingLoaded || AudioEngine::audioRoutineLocked) {
+		for (Cluster* cluster : run.subspan(1)) {
+			enqueueCluster(cluster, cluster->loadingQueueNode.key);
+		}
+		return false;
+	}
+
+	SD_READ_SEGMENT segments[kMaxClustersPerRead];
+	for (size_t i = 0; i < run.size(); i++) {
+		if (run[i]->type != ClusterType::Sample) {
+			FREEZE_WITH_ERROR("E205");
+		}
+		addReasonToCluster(run[i]); // So none of them can hit 0 reasons and get deallocated while we're reading
+		segments[i] = {(unsigned char*)run[i]->data, getNumSectorsToLoad(run[i])};
+	}
 
+	AudioEngine::logAction("loadClusterRun");
+
+	Sample* sample = run[0]->sample;
+	clusterBeingLoaded = run[0];
+	minNumReasonsForClusterBeingLoaded = 1;
+	DRESULT result = disk_read_scattered_without_streaming_first(
+	    SD_PORT, segments, run.size(), sample->clusters.getElement(run[0]->clusterIndex)->sdAddress);
 	clusterBeingLoaded = NULL;
-	removeReasonFromCluster(cluster, "E034");
 
-#if ALPHA_OR_BETA_VERSION
-	if (cluster->numReasonsToBeLoaded < minNumReasonsAfter) {
-		FREEZE_WITH_ERROR("i037");
+	if (result) {
+		abandonClusterRun(run, loadingQueue, [this](Cluster* cluster) { removeReasonFromCluster(cluster, "E033"); });
+		return false;
 	}
-	if (cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster != cluster) {
-		FREEZE_WITH_ERROR("E438");
+
+	// In order, so each one can swap its overhanging bytes with the one before it
+	for (Cluster* cluster : run) {
+		clusterBeingLoaded = cluster;
+		finishLoadingCluster(cluster, 0);
+		clusterBeingLoaded = NULL;
+		removeReasonFromCluster(cluster, "E034");
 	}
-#endif
 
 	return true;
 }
@@ -1340,8 +1444,11 @@ performActionsAndGetOut:
 			FREEZE_WITH_ERROR("E235"); // Cos Chris F got an E205
 		}
 
+		Cluster* run[kMaxClustersPerRead];
+		int32_t runLength = gatherClusterRun(cluster, run);
+
 		allowSomeUserActionsEvenWhenInCardRoutine = true; // Sorry!!
-		bool success = loadCluster(cluster);
+		bool success = (runLength > 1) ? loadClusterRun({run, (size_t)runLength}) : loadCluster(cluster);
 		allowSomeUserActionsEvenWhenInCardRoutine = false;
 
 		// If that didn't work, presumably because the SD card got ejected...
@@ -1369,7 +1476,7 @@ performActionsAndGetOut:
 			}
 		}
 
-		count++;
+		count += runLength;
 		if (count >= maxNum) {
 			break; // Keep things sane?
 		}
@@ -1381,7 +1488,7 @@ performActionsAndGetOut:
 }
 
 // Currently there's no risk of trying to enqueue a cluster multiple times, because this function only gets called
-// after it's freshly allocated
+// after it's freshly allocated. If that changes, the queue will just take the new priorityRating.
 Error AudioFileManager::enqueueCluster(Cluster* cluster, uint32_t priorityRating) {
 	return loadingQueue.add(cluster, priorityRating);
 }
@@ -1444,10 +1551,18 @@ void AudioFileManager::removeReasonFromCluster(Cluster* cluster, char const* err
 }
 
 bool AudioFileManager::loadingQueueHasAnyLowestPriorityElements() {
-	int32_t numElements = loadingQueue.getNumElements();
-	return (numElements
-	        && ((PriorityQueueElement*)audioFileManager.loadingQueue.getElementAddress(numElements - 1))->priorityRating
-	               == 0xFFFFFFFF);
+	return loadingQueue.hasAnyLowestPriorityElements();
+}
+
+deluge::coroutine::Wait sdReadComplete(Cluster* cluster) {
+	return deluge::coroutine::until(
+	    [](void* context) {
+		    auto* cluster = static_cast<Cluster*>(context);
+		    return cluster->loaded
+		           || (cluster != audioFileManager.clusterBeingLoaded
+		               && !audioFileManager.loadingQueue.checkPresent(cluster));
+	    },
+	    cluster);
 }
 
 // Caller must also set alternateAudioFileLoadPath.
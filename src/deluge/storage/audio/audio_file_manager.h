@@ -16,10 +16,12 @@
  */
 
 #pragma once
+#include "OSLikeStuff/coroutine_task.hpp"
 #include "definitions_cxx.hpp"
 #include "storage/audio/audio_file_vector.h"
 #include "storage/cluster/cluster_priority_queue.h"
 #include <cstdint>
+#include <span>
 #include <stdint.h>
 
 extern "C" {
@@ -40,6 +42,11 @@ enum class AlternateLoadDirStatus {
 	DOES_EXIST,
 };
 
+/// Most Clusters loadAnyEnqueuedClusters() will read with one command, and most card sectors in total - which is also
+/// the most the SD driver does with one command anyway
+constexpr int32_t kMaxClustersPerRead = 8;
+constexpr int32_t kMaxSectorsPerRead = 256;
+
 char const* const audioRecordingFolderNames[] = {"SAMPLES/CLIPS", "SAMPLES/RECORD", "SAMPLES/RESAMPLE",
                                                  "SAMPLES/STEMS"};
 
@@ -52,7 +59,8 @@ char const* const audioRecordingFolderNames[] = {"SAMPLES/CLIPS", "SAMPLES/RECOR
  * The Deluge deals in these Clusters, whatever size they may be for the card, which makes
  * sense because one Cluster always exists in one physical place on the SD card (or any disk),
  * so may be easily loaded in one operation by DMA. Whereas consecutive clusters making up an
- * (audio) file are often placed in completely different physical locations.
+ * (audio) file are often placed in completely different physical locations. When they aren't, and several
+ * consecutive Clusters of a file are waiting to be loaded, they're read with a single command.
  *
  * For a Sample associated with a Sound or AudioClip, the Deluge keeps the first two Clusters of that file
  * (from its set start-point and subject to reversing) permanently loaded in RAM, so playback of the
@@ -86,7 +94,7 @@ public:
 	                                    AudioFileType type, bool makeWaveTableWorkAtAllCosts = false);
 	Cluster* allocateCluster(ClusterType type = ClusterType::Sample, bool shouldAddReasons = true,
 	                         void* dontStealFromThing = NULL);
-	Error enqueueCluster(Cluster* cluster, uint32_t priorityRating = 0xFFFFFFFF);
+	Error enqueueCluster(Cluster* cluster, uint32_t priorityRating = kClusterLowestPriority);
 	bool loadCluster(Cluster* cluster, int32_t minNumReasonsAfter = 0);
 	void loadAnyEnqueuedClusters(int32_t maxNum = 128, bool mayProcessUserActionsBetween = false);
 	void addReasonToCluster(Cluster* cluster);
@@ -135,6 +143,10 @@ public:
 	bool highestUsedAudioRecordingNumberNeedsReChecking[kNumAudioRecordingFolders];
 
 private:
+	int32_t getNumSectorsToLoad(Cluster* cluster);
+	void finishLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter);
+	int32_t gatherClusterRun(Cluster* first, Cluster** run);
+	bool loadClusterRun(std::span<Cluster*> run);
 	void setClusterSize(uint32_t newSize);
 	void cardReinserted();
 	int32_t readBytes(char* buffer, int32_t num, int32_t* byteIndexWithinCluster, Cluster** currentCluster,
@@ -144,3 +156,7 @@ private:
 };
 
 extern AudioFileManager audioFileManager;
+
+/// For coroutine tasks: carries on once an enqueued Cluster has been read from the card. If it drops out of the loading
+/// queue without that happening it carries on anyway, with the Cluster still not loaded - so check.
+deluge::coroutine::Wait sdReadComplete(Cluster* cluster);
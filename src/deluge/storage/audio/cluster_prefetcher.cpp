@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/cluster_prefetcher.h"
+#include "definitions_cxx.hpp"
+#include "model/clip/audio_clip.h"
+#include "model/clip/clip_instance.h"
+#include "model/clip/instrument_clip.h"
+#include "model/drum/drum.h"
+#include "model/note/note.h"
+#include "model/note/note_row.h"
+#include "model/output.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_cluster.h"
+#include "model/sample/sample_holder_for_voice.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "model/song/clip_iterators.h"
+#include "model/song/song.h"
+#include "playback/mode/arrangement.h"
+#include "playback/mode/session.h"
+#include "playback/playback_handler.h"
+#include "processing/sound/sound_drum.h"
+#include "processing/sound/sound_instrument.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "storage/multi_range/multi_range.h"
+#include <algorithm>
+
+ClusterPrefetcher clusterPrefetcher{};
+
+// Sooner events get a more urgent rating, but never one that could reach kClusterLowestPriority
+constexpr int32_t kMaxTicksInPriorityRating = 0xFFFFFF;
+
+namespace {
+
+void raisePriorityOfClusters(Cluster** clusters, uint32_t priorityRating) {
+	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
+		if (clusters[l] && !clusters[l]->loaded) {
+			audioFileManager.loadingQueue.raisePriorityIfPresent(clusters[l], priorityRating);
+		}
+	}
+}
+
+} // namespace
+
+int32_t ClusterPrefetcher::getLookaheadTicks() {
+	switch (runtimeFeatureSettings.get(RuntimeFeatureSettingType::SamplePrefetch)) {
+	case RuntimeFeatureStateSamplePrefetch::OneBeat:
+		return currentSong->getQuarterNoteLength();
+	case RuntimeFeatureStateSamplePrefetch::OneBar:
+		return currentSong->getBarLength();
+	case RuntimeFeatureStateSamplePrefetch::TwoBars:
+		return currentSong->getBarLength() * 2;
+	default:
+		return 0;
+	}
+}
+
+void ClusterPrefetcher::routine() {
+	if (!currentSong || !playbackHandler.isEitherClockActive() || playbackHandler.ticksLeftInCountIn) {
+		if (numHeld_) {
+			releaseAll();
+		}
+		return;
+	}
+
+	currentTick_ = playbackHandler.lastSwungTickActioned;
+	releaseExpired();
+
+	lookaheadTicks_ = getLookaheadTicks();
+	if (!lookaheadTicks_) {
+		return;
+	}
+
+	// Clips which are already playing
+	for (Clip* clip : AllClips::everywhere(currentSong)) {
+		if (currentSong->isClipActive(clip)) {
+			prefetchUpcomingInActiveClip(clip);
+		}
+	}
+
+	// And ones which are about to start
+	if (currentPlaybackMode == &arrangement) {
+		int32_t arrangementPos = arrangement.lastProcessedPos;
+		for (Output* output = currentSong->firstOutput; output; output = output->next) {
+			int32_t numInstances = output->clipInstances.getNumElements();
+			for (int32_t i = output->clipInstances.search(arrangementPos + 1, GREATER_OR_EQUAL); i < numInstances;
+			     i++) {
+				ClipInstance* instance = output->clipInstances.getElement(i);
+				int32_t ticksUntil = instance->pos - arrangementPos;
+				if (ticksUntil >= lookaheadTicks_) {
+					break;
+				}
+				if (instance->clip) {
+					prefetchClipFromStart(instance->clip, ticksUntil);
+				}
+			}
+		}
+	}
+	else if (session.launchEventAtSwungTickCount) {
+		int64_t ticksUntil = session.launchEventAtSwungTickCount - currentTick_;
+		if (ticksUntil >= 0 && ticksUntil < lookaheadTicks_) {
+			for (Clip* clip : AllClips::inSession(currentSong)) {
+				if (clip->armState != ArmState::OFF && !currentSong->isClipActive(clip)) {
+					prefetchClipFromStart(clip, (int32_t)ticksUntil);
+				}
+			}
+		}
+	}
+}
+
+void ClusterPrefetcher::prefetchUpcomingInActiveClip(Clip* clip) {
+	if (clip->type == ClipType::AUDIO) {
+		// All that could need loading soon is the start again, when it loops
+		int32_t ticksUntilLoop = clip->loopLength - clip->lastProcessedPos;
+		if (!clip->currentlyPlayingReversed && ticksUntilLoop < lookaheadTicks_) {
+			AudioClip* audioClip = (AudioClip*)clip;
+			prefetchSampleHolder(&audioClip->sampleHolder, audioClip->sampleControls.reversed, ticksUntilLoop);
+		}
+		return;
+	}
+
+	InstrumentClip* instrumentClip = (InstrumentClip*)clip;
+	for (int32_t i = 0; i < instrumentClip->noteRows.getNumElements(); i++) {
+		NoteRow* noteRow = instrumentClip->noteRows.getElement(i);
+		bool independent = noteRow->hasIndependentPlayPos();
+		if (independent ? noteRow->currentlyPlayingReversedIfIndependent : clip->currentlyPlayingReversed) {
+			continue; // Working out what's coming up backwards isn't worth it
+		}
+		int32_t pos = independent ? noteRow->lastProcessedPosIfIndependent : clip->lastProcessedPos;
+		prefetchNotes(instrumentClip, noteRow, pos + 1, lookaheadTicks_, 1);
+	}
+}
+
+void ClusterPrefetcher::prefetchClipFromStart(Clip* clip, int32_t ticksUntilStart) {
+	if (clip->type == ClipType::AUDIO) {
+		AudioClip* audioClip = (AudioClip*)clip;
+		prefetchSampleHolder(&audioClip->sampleHolder, audioClip->sampleControls.reversed, ticksUntilStart);
+		return;
+	}
+
+	InstrumentClip* instrumentClip = (InstrumentClip*)clip;
+	for (int32_t i = 0; i < instrumentClip->noteRows.getNumElements(); i++) {
+		prefetchNotes(instrumentClip, instrumentClip->noteRows.getElement(i), 0, lookaheadTicks_ - ticksUntilStart,
+		              ticksUntilStart);
+	}
+}
+
+// Only the first note in the window matters - any later ones on the same NoteRow will trigger the same Sample
+void ClusterPrefetcher::prefetchNotes(InstrumentClip* clip, NoteRow* noteRow, int32_t fromPos, int32_t numTicks,
+                                      int32_t ticksUntilFromPos) {
+	if (noteRow->muted || noteRow->hasNoNotes()) {
+		return;
+	}
+
+	Sound* sound;
+	int32_t noteCode;
+	if (clip->output->type == OutputType::KIT) {
+		if (!noteRow->drum || noteRow->drum->type != DrumType::SOUND) {
+			return;
+		}
+		sound = (SoundDrum*)noteRow->drum;
+		noteCode = kNoteForDrum;
+	}
+	else if (clip->output->type == OutputType::SYNTH) {
+		sound = (SoundInstrument*)clip->output;
+		noteCode = noteRow->getNoteCode();
+	}
+	else {
+		return;
+	}
+
+	int32_t rowLength = noteRow->loopLengthIfIndependent ? noteRow->loopLengthIfIndependent : clip->loopLength;
+	if (rowLength <= 0) {
+		return;
+	}
+	fromPos %= rowLength;
+	int32_t endPos = fromPos + std::min(numTicks, rowLength);
+
+	NoteVector& notes = noteRow->notes;
+	int32_t i = notes.search(fromPos, GREATER_OR_EQUAL);
+	int32_t notePos;
+	if (i < notes.getNumElements() && notes[i].pos < endPos) {
+		notePos = notes[i].pos;
+	}
+	// Or if the window wraps around past the end of the NoteRow
+	else if (endPos > rowLength && notes[0].pos < endPos - rowLength) {
+		notePos = notes[0].pos + rowLength;
+	}
+	else {
+		return;
+	}
+
+	prefetchSound(sound, noteCode, ticksUntilFromPos + notePos - fromPos);
+}
+
+void ClusterPrefetcher::prefetchSound(Sound* sound, int32_t noteCode, int32_t ticksUntil) {
+	for (int32_t s = 0; s < kNumSources; s++) {
+		Source* source = &sound->sources[s];
+		if (source->oscType != OscType::SAMPLE) {
+			continue;
+		}
+		MultiRange* range = source->getRange(noteCode + sound->transpose);
+		if (!range) {
+			continue;
+		}
+		SampleHolderForVoice* holder = (SampleHolderForVoice*)range->getAudioFileHolder();
+		prefetchSampleHolder(holder, source->sampleControls.reversed, ticksUntil);
+		if (holder->loopStartPos) {
+			raisePriorityOfClusters(holder->clustersForLoopStart,
+			                        kClusterPrefetchPriority + std::min(ticksUntil, kMaxTicksInPriorityRating));
+		}
+	}
+}
+
+void ClusterPrefetcher::prefetchSampleHolder(SampleHolder* holder, bool reversed, int32_t ticksUntil) {
+	if (holder->audioFileType != AudioFileType::SAMPLE || !holder->audioFile) {
+		return;
+	}
+	Sample* sample = (Sample*)holder->audioFile;
+	if (sample->unloadable) {
+		return;
+	}
+
+	uint32_t priorityRating = kClusterPrefetchPriority + std::min(ticksUntil, kMaxTicksInPriorityRating);
+	raisePriorityOfClusters(holder->clustersForStart, priorityRating);
+
+	Cluster* lastClusterForStart = nullptr;
+	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
+		if (holder->clustersForStart[l]) {
+			lastClusterForStart = holder->clustersForStart[l];
+		}
+	}
+	if (!lastClusterForStart) {
+		return;
+	}
+
+	int32_t clusterIndex = lastClusterForStart->clusterIndex + (reversed ? -1 : 1);
+	if (clusterIndex < sample->getFirstClusterIndexWithAudioData()
+	    || clusterIndex >= sample->getFirstClusterIndexWithNoAudioData()) {
+		return;
+	}
+
+	// Keep it until the Voice has had time to claim it for itself
+	holdCluster(sample, clusterIndex, priorityRating, currentTick_ + ticksUntil + lookaheadTicks_);
+}
+
+void ClusterPrefetcher::holdCluster(Sample* sample, int32_t clusterIndex, uint32_t priorityRating,
+                                    int64_t releaseAtTick) {
+	SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+
+	if (sampleCluster->cluster) {
+		for (int32_t i = 0; i < numHeld_; i++) {
+			if (held_[i].cluster == sampleCluster->cluster) {
+				held_[i].releaseAtTick = std::max(held_[i].releaseAtTick, releaseAtTick);
+				if (!held_[i].cluster->loaded) {
+					audioFileManager.loadingQueue.raisePriorityIfPresent(held_[i].cluster, priorityRating);
+				}
+				return;
+			}
+		}
+	}
+
+	if (numHeld_ == kMaxHeldClusters) {
+		return;
+	}
+
+	// Adds a reason, and enqueues it if it's not loaded
+	Cluster* cluster = sampleCluster->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE, priorityRating);
+	if (!cluster) {
+		return;
+	}
+	sample->addReason(); // So the Sample can't be deleted while we're holding one of its Clusters
+	held_[numHeld_++] = {cluster, releaseAtTick};
+}
+
+void ClusterPrefetcher::releaseExpired() {
+	for (int32_t i = 0; i < numHeld_;) {
+		if (held_[i].releaseAtTick > currentTick_) {
+			i++;
+			continue;
+		}
+		Cluster* cluster = held_[i].cluster;
+		Sample* sample = cluster->sample;
+		held_[i] = held_[--numHeld_];
+		audioFileManager.removeReasonFromCluster(cluster, "E454");
+		sample->removeReason("E455");
+	}
+}
+
+void ClusterPrefetcher::releaseAll() {
+	currentTick_ = INT64_MAX;
+	releaseExpired();
+}
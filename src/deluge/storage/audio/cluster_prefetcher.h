@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+class Clip;
+class Cluster;
+class InstrumentClip;
+class NoteRow;
+class Sample;
+class SampleHolder;
+class Sound;
+
+/// Looks a little way ahead of playback, for notes and Clips which are about to start, and makes sure the Clusters
+/// their Samples will start from are on their way in from the card before any Voice asks for them.
+///
+/// The first few Clusters of every Sample in the Song are already held by its SampleHolders, so for those it's just a
+/// matter of making them more urgent than anything queued at kClusterLowestPriority (e.g. while the Song's still
+/// loading). The Cluster straight after those would only be enqueued once the Voice was already playing, so this
+/// claims it itself, holding a "reason" on it until just after the event it was for.
+class ClusterPrefetcher {
+public:
+	ClusterPrefetcher() = default;
+
+	/// Call regularly while playing - not from the audio routine
+	void routine();
+	/// Gives back every Cluster being held. Call when playback stops, or before deleting the Song
+	void releaseAll();
+
+	[[nodiscard]] int32_t getNumHeld() const { return numHeld_; }
+
+private:
+	struct HeldCluster {
+		Cluster* cluster;
+		int64_t releaseAtTick; // In swung ticks
+	};
+
+	static constexpr int32_t kMaxHeldClusters = 32;
+
+	int32_t getLookaheadTicks();
+	void releaseExpired();
+	void prefetchUpcomingInActiveClip(Clip* clip);
+	void prefetchClipFromStart(Clip* clip, int32_t ticksUntilStart);
+	void prefetchNotes(InstrumentClip* clip, NoteRow* noteRow, int32_t fromPos, int32_t numTicks,
+	                   int32_t ticksUntilFromPos);
+	void prefetchSound(Sound* sound, int32_t noteCode, int32_t ticksUntil);
+	void prefetchSampleHolder(SampleHolder* holder, bool reversed, int32_t ticksUntil);
+	void holdCluster(Sample* sample, int32_t clusterIndex, uint32_t priorityRating, int64_t releaseAtTick);
+
+	std::array<HeldCluster, kMaxHeldClusters> held_{};
+	int32_t numHeld_ = 0;
+	int64_t currentTick_ = 0;
+	int32_t lookaheadTicks_ = 0;
+};
+
+extern ClusterPrefetcher clusterPrefetcher;
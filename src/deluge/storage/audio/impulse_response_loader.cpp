@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/impulse_response_loader.h"
+#include "dsp/convolution/partitioned_convolver.h"
+#include "io/debug/log.h"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using deluge::dsp::PartitionedConvolver;
+
+Error loadImpulseResponse(String* filePath, PartitionedConvolver* convolver, int32_t partitionMagnitude) {
+	Error error;
+	Sample* sample = (Sample*)audioFileManager.getAudioFileFromFilename(filePath, true, &error, nullptr,
+	                                                                     AudioFileType::SAMPLE);
+	if (!sample) {
+		return (error != Error::NONE) ? error : Error::FILE_NOT_FOUND;
+	}
+
+	sample->addReason(); // So it can't be stolen while we read it
+	error = loadImpulseResponse(sample, convolver, partitionMagnitude);
+	sample->removeReason("irl0");
+	return error;
+}
+
+Error loadImpulseResponse(Sample* sample, PartitionedConvolver* convolver, int32_t partitionMagnitude) {
+	AudioEngine::logAction("loadImpulseResponse");
+
+	int32_t length = std::min<uint64_t>(sample->lengthInSamples, PartitionedConvolver::kMaxImpulseResponseLength);
+	if (length <= 0) {
+		return Error::FILE_CORRUPTED;
+	}
+	int32_t numIRChannels = std::min<int32_t>(sample->numChannels, 2);
+
+	q31_t* ir = (q31_t*)GeneralMemoryAllocator::get().allocLowSpeed(length * numIRChannels * sizeof(q31_t));
+	if (!ir) {
+		return Error::INSUFFICIENT_RAM;
+	}
+	q31_t* irChannels[2] = {ir, &ir[length]};
+
+	// If the audio data ends before lengthInSamples says, whatever's left is silence
+	memset(ir, 0, length * numIRChannels * sizeof(q31_t));
+
+	// Read it in, the same way Sample::determinePitch() does - a whole sample at a time, with the next Cluster kept
+	// loaded so any sample overlapping the end of this one is there to read
+	Error error = Error::NONE;
+	uint32_t currentOffset = sample->audioDataStartPosBytes;
+	int32_t currentClusterIndex = currentOffset >> audioFileManager.clusterSizeMagnitude;
+	Cluster* cluster = sample->clusters.getElement(currentClusterIndex)
+	                       ->getCluster(sample, currentClusterIndex, CLUSTER_LOAD_IMMEDIATELY, 0, &error);
+	Cluster* nextCluster = nullptr;
+	if (!cluster) {
+		D_PRINTLN("IR: failed to load first cluster");
+		goto getOut;
+	}
+
+	for (int32_t i = 0; i < length; i++) {
+		if (!(i & 255)) {
+			AudioEngine::routineWithClusterLoading(); // --------------------------------------
+		}
+
+		for (int32_t c = 0; c < sample->numChannels; c++) {
+			if (!nextCluster && currentClusterIndex + 1 < sample->getFirstClusterIndexWithNoAudioData()) {
+				nextCluster = sample->clusters.getElement(currentClusterIndex + 1)
+				                  ->getCluster(sample, currentClusterIndex + 1, CLUSTER_LOAD_IMMEDIATELY, 0, &error);
+				if (!nextCluster) {
+					D_PRINTLN("IR: failed to load next cluster");
+					audioFileManager.removeReasonFromCluster(cluster, "irl1");
+					goto getOut;
+				}
+			}
+
+			if (c < numIRChannels) {
+				irChannels[c][i] =
+				    *(int32_t*)&cluster
+				         ->data[(currentOffset & (audioFileManager.clusterSize - 1)) - 4 + sample->byteDepth]
+				    & sample->bitMask;
+			}
+
+			currentOffset += sample->byteDepth;
+
+			int32_t newClusterIndex = currentOffset >> audioFileManager.clusterSizeMagnitude;
+			if (newClusterIndex != currentClusterIndex) {
+				currentClusterIndex = newClusterIndex;
+				audioFileManager.removeReasonFromCluster(cluster, "irl2");
+				cluster = nextCluster;
+				nextCluster = nullptr;
+				if (!cluster) { // Only if that was the very end of the audio data
+					break;
+				}
+			}
+		}
+		if (!cluster) {
+			break;
+		}
+	}
+
+	if (cluster) {
+		audioFileManager.removeReasonFromCluster(cluster, "irl3");
+	}
+	if (nextCluster) {
+		audioFileManager.removeReasonFromCluster(nextCluster, "irl4");
+	}
+
+	{
+		// Normalize, to the average channel's energy
+		double energy = 0;
+		for (int32_t i = 0; i < length * numIRChannels; i++) {
+			double value = ir[i] * (1.0 / 2147483648.0);
+			energy += value * value;
+		}
+		energy /= numIRChannels;
+
+		if (energy > 0) {
+			float gain = 1 / std::sqrt(energy);
+			for (int32_t i = 0; i < length * numIRChannels; i++) {
+				ir[i] = std::clamp<float>(ir[i] * gain, -2147483648.0f, 2147483520.0f);
+			}
+		}
+	}
+
+	error = convolver->setImpulseResponse(irChannels[0], (numIRChannels == 2) ? irChannels[1] : nullptr, length,
+	                                      partitionMagnitude);
+
+getOut:
+	delugeDealloc(ir);
+	return error;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+
+class Sample;
+class String;
+namespace deluge::dsp {
+class PartitionedConvolver;
+}
+
+// Impulse responses are ordinary WAV or AIFF files, loaded through the AudioFileManager like any other Sample, then
+// copied into the convolver. Mono or stereo - for more channels, just the first two are used. The sample rate is taken
+// at face value, so an IR recorded at another rate comes out slightly stretched.
+//
+// They're normalized to unit energy on the way in, so that the convolver's output is at about the same level as its
+// input, however long and however loud the IR.
+
+// partitionMagnitude is passed on to PartitionedConvolver::setImpulseResponse().
+
+Error loadImpulseResponse(String* filePath, deluge::dsp::PartitionedConvolver* convolver, int32_t partitionMagnitude);
+Error loadImpulseResponse(Sample* sample, deluge::dsp::PartitionedConvolver* convolver, int32_t partitionMagnitude);
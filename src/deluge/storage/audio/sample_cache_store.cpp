@@ -0,0 +1,531 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/sample_cache_store.h"
+#include "io/debug/log.h"
+#include "memory/memory_allocator_interface.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_cache.h"
+#include "model/sample/sample_cluster.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "util/d_string.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+extern "C" {
+extern uint8_t currentlyAccessingCard;
+}
+
+SampleCacheStore sampleCacheStore{};
+
+namespace {
+
+constexpr char kCacheDir[] = "SAMPLES/.CACHE"; // The browsers don't show anything starting with a dot
+constexpr char kCacheFileMagic[4] = {'D', 'S', 'C', '1'};
+// Bump this if anything changes how caches get rendered, so the old files stop being used
+constexpr uint8_t kCacheFileVersion = 2;
+// The data starts a sector in, so Clusters line up with the card's sectors
+constexpr uint32_t kDataOffset = 512;
+
+// Everything in a cache file's header apart from lastUse and numBytes has to match the cache as it is now, or the
+// file's for something else
+struct CacheFileHeader {
+	char magic[4];
+	uint8_t version;
+	uint8_t numChannels;
+	uint8_t byteDepth;
+	uint8_t reversed;
+	uint64_t numFrames;
+	uint32_t audioDataStartPosBytes;
+	uint32_t firstClusterSDAddress; // Catches the Sample's file having been replaced, or a different card
+	int32_t phaseIncrement;
+	int32_t timeStretchRatio;
+	int32_t skipSamplesAtStart;
+	int32_t waveformLengthBytes;
+	uint8_t clusterSizeMagnitude;
+	uint8_t reserved[7];
+	uint32_t lastUse; // For deleting the least recently used files first, once there are too many
+	int32_t numBytes; // How much of the cache, from the start, follows
+};
+static_assert(sizeof(CacheFileHeader) == 56);
+static_assert(sizeof(CacheFileHeader) <= kDataOffset);
+
+// FNV-1a
+uint32_t hashBytes(void const* bytes, size_t numBytes, uint32_t hash = 2166136261u) {
+	for (size_t i = 0; i < numBytes; i++) {
+		hash = (hash ^ ((uint8_t const*)bytes)[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// 8 hex digits for the Sample, 8 for the cache's parameters, ".CAC"
+constexpr size_t kFileNameLength = 20;
+constexpr size_t kPathLength = sizeof(kCacheDir) + 1 + kFileNameLength; // With the slash and the null
+
+void getCacheFileName(SampleCache* cache, char* name) {
+	char const* samplePath = cache->sample->filePath.get();
+	int32_t keyWords[4] = {cache->phaseIncrement, cache->timeStretchRatio, cache->skipSamplesAtStart, cache->reversed};
+
+	intToHex(hashBytes(samplePath, strlen(samplePath)), name);
+	intToHex(hashBytes(keyWords, sizeof(keyWords)), name + 8);
+	strcpy(name + 16, ".CAC");
+}
+
+bool isCacheFileName(char const* name) {
+	return strlen(name) == kFileNameLength && !strcmp(name + 16, ".CAC");
+}
+
+void getPathInCacheDir(char const* fileName, char* path) {
+	strcpy(path, kCacheDir);
+	path[sizeof(kCacheDir) - 1] = '/';
+	strcpy(path + sizeof(kCacheDir), fileName);
+}
+
+void getCacheFilePath(SampleCache* cache, char* path) {
+	char name[kFileNameLength + 1];
+	getCacheFileName(cache, name);
+	getPathInCacheDir(name, path);
+}
+
+// 0 if it's not a cache file this version understands, so those go first
+uint32_t readLastUse(FIL* file, char const* path) {
+	if (f_open(file, path, FA_READ) != FR_OK) {
+		return 0;
+	}
+	CacheFileHeader header;
+	UINT bytesRead;
+	FRESULT result = f_read(file, &header, sizeof(header), &bytesRead);
+	f_close(file);
+	if (result != FR_OK || bytesRead != sizeof(header) || memcmp(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic))
+	    || header.version != kCacheFileVersion) {
+		return 0;
+	}
+	return header.lastUse;
+}
+
+void fillHeader(SampleCache* cache, CacheFileHeader* header) {
+	Sample* sample = cache->sample;
+	memset(header, 0, sizeof(CacheFileHeader));
+	memcpy(header->magic, kCacheFileMagic, sizeof(kCacheFileMagic));
+	header->version = kCacheFileVersion;
+	header->numChannels = sample->numChannels;
+	header->byteDepth = sample->byteDepth;
+	header->reversed = cache->reversed;
+	header->numFrames = sample->lengthInSamples;
+	header->audioDataStartPosBytes = sample->audioDataStartPosBytes;
+	header->firstClusterSDAddress = sample->clusters.getElement(0)->sdAddress;
+	header->phaseIncrement = cache->phaseIncrement;
+	header->timeStretchRatio = cache->timeStretchRatio;
+	header->skipSamplesAtStart = cache->skipSamplesAtStart;
+	header->waveformLengthBytes = cache->waveformLengthBytes;
+	header->clusterSizeMagnitude = audioFileManager.clusterSizeMagnitude;
+}
+
+// A file only ever ends where a Cluster does, so anything else means it's been mangled
+bool isValidNumBytes(SampleCache* cache, int32_t numBytes) {
+	if (numBytes < 0 || numBytes > cache->waveformLengthBytes) {
+		return false;
+	}
+	return !numBytes
+	       || numBytes == cache->getClusterEndBytePos((numBytes >> audioFileManager.clusterSizeMagnitude) - 1);
+}
+
+} // namespace
+
+void SampleCacheStore::requestSpill(SampleCache* cache) {
+	if (cache->cardState == SampleCache::CardState::UNAVAILABLE) {
+		return;
+	}
+	enqueue(cache);
+}
+
+void SampleCacheStore::requestRestore(SampleCache* cache) {
+	if (cache->cardState == SampleCache::CardState::UNAVAILABLE) {
+		return;
+	}
+	cache->wantsRestoring = true;
+	enqueue(cache);
+}
+
+void SampleCacheStore::enqueue(SampleCache* cache) {
+	if (cache->queuedForCard) {
+		return;
+	}
+	if (!runtimeFeatureSettings.isOn(RuntimeFeatureSettingType::SampleCacheOnCard)) {
+		return;
+	}
+	if (numQueued_ >= kMaxQueued) {
+		return; // We'll get asked again when the next Cluster's finished, or the next voice starts
+	}
+
+	cache->queuedForCard = true;
+	queue_[numQueued_++] = cache;
+}
+
+void SampleCacheStore::dequeue(int32_t i) {
+	queue_[i]->queuedForCard = false;
+	queue_[i]->wantsRestoring = false;
+	numQueued_--;
+	std::copy(&queue_[i + 1], &queue_[numQueued_ + 1], &queue_[i]);
+}
+
+void SampleCacheStore::forget(SampleCache* cache) {
+	if (!cache->queuedForCard) {
+		return;
+	}
+	for (int32_t i = 0; i < numQueued_; i++) {
+		if (queue_[i] == cache) {
+			dequeue(i);
+			return;
+		}
+	}
+}
+
+void SampleCacheStore::routine() {
+	if (!numQueued_) {
+		return;
+	}
+
+	if (!runtimeFeatureSettings.isOn(RuntimeFeatureSettingType::SampleCacheOnCard)) {
+		while (numQueued_) {
+			dequeue(0);
+		}
+		return;
+	}
+
+	// Only ever use the card when nothing more important wants it
+	if (currentlyAccessingCard || audioFileManager.loadingQueue.getNumElements()) {
+		return;
+	}
+
+	// Nothing gets written till we know how much is there already. And once a spill's found there's no room, it waits
+	// till something old's been deleted
+	if (!counted_ || scanning_) {
+		scanNextFile();
+		return;
+	}
+
+	SampleCache* cache = queue_[0];
+	Sample* sample = cache->sample;
+
+	// Samples no longer in use are liable to be stolen, caches and all, whenever something needs memory - including
+	// while we're waiting on the card. Those ones can go without
+	if (!sample->numReasonsToBeLoaded) {
+		dequeue(0);
+		return;
+	}
+	sample->addReason();
+
+	bool stillGoing;
+	if (cache->cardState == SampleCache::CardState::UNKNOWN) {
+		stillGoing = openCacheFile(cache);
+	}
+	else {
+		stillGoing = (cache->cardState == SampleCache::CardState::AVAILABLE) && doNextJob(cache);
+	}
+
+	// The audio routine might have queued more while the card was busy, but queue_[0] is still this cache
+	bool wantsRestoring = cache->wantsRestoring;
+	dequeue(0);
+	if (stillGoing) {
+		cache->wantsRestoring = wantsRestoring;
+		enqueue(cache); // To the back, so one long cache doesn't hold up all the others
+	}
+	if (!numQueued_) {
+		full_ = false; // Queued caches' files don't get deleted - but now there aren't any
+	}
+	sample->removeReason("E459");
+}
+
+// Reads the header of any existing file for the cache, or starts a new one
+bool SampleCacheStore::openCacheFile(SampleCache* cache) {
+	Sample* sample = cache->sample;
+	cache->cardState = SampleCache::CardState::UNAVAILABLE;
+	if (sample->unloadable || !sample->tempFilePathForRecording.isEmpty() || !sample->clusters.getNumElements()) {
+		return false; // Recordings which haven't been saved yet don't get their caches kept
+	}
+
+	char path[kPathLength];
+	getCacheFilePath(cache, path);
+
+	CacheFileHeader expected;
+	fillHeader(cache, &expected);
+
+	uint32_t numBytesReplaced = 0;
+	FRESULT result = f_open(&file_, path, FA_READ);
+	if (result == FR_OK) {
+		numBytesReplaced = f_size(&file_);
+		CacheFileHeader header;
+		UINT bytesRead;
+		result = f_read(&file_, &header, sizeof(header), &bytesRead);
+		f_close(&file_);
+
+		if (result == FR_OK && bytesRead == sizeof(header)) {
+			expected.lastUse = header.lastUse;
+			expected.numBytes = header.numBytes;
+			if (!memcmp(&header, &expected, sizeof(header)) && isValidNumBytes(cache, header.numBytes)) {
+				D_PRINTLN("found cache on card, %d bytes", header.numBytes);
+				cache->cardBytePos = header.numBytes;
+				cache->cardState = SampleCache::CardState::AVAILABLE;
+				markUsed(cache);
+				return true;
+			}
+		}
+	}
+
+	// No usable file, so start a new one
+	f_mkdir("SAMPLES");
+	f_mkdir(kCacheDir); // Fine if these already exist - the f_open() will tell us if anything's really wrong
+
+	result = f_open(&file_, path, FA_CREATE_ALWAYS | FA_WRITE);
+	if (result != FR_OK) {
+		return false; // E.g. card's write-protected
+	}
+	expected.lastUse = ++lastUse_;
+	expected.numBytes = 0;
+	UINT bytesWritten;
+	result = f_write(&file_, &expected, sizeof(expected), &bytesWritten);
+	bool success = (result == FR_OK && bytesWritten == sizeof(expected));
+	result = f_close(&file_);
+	bytesOnCard_ -= std::min(numBytesReplaced, bytesOnCard_);
+	if (!success || result != FR_OK) {
+		f_unlink(path);
+		return false;
+	}
+
+	bytesOnCard_ += sizeof(expected);
+	cache->cardLastUse = lastUse_;
+	cache->cardBytePos = 0;
+	cache->cardState = SampleCache::CardState::AVAILABLE;
+	return true;
+}
+
+// Writes into the cache's file that it's the most recently used one. Fine if that fails - it'll just get deleted sooner
+void SampleCacheStore::markUsed(SampleCache* cache) {
+	if (cache->cardLastUse && cache->cardLastUse == lastUse_) {
+		return; // Nothing else has been used since
+	}
+
+	char path[kPathLength];
+	getCacheFilePath(cache, path);
+	if (f_open(&file_, path, FA_WRITE) == FR_OK) {
+		uint32_t lastUse = lastUse_ + 1;
+		UINT bytesWritten;
+		if (f_lseek(&file_, offsetof(CacheFileHeader, lastUse)) == FR_OK) {
+			f_write(&file_, &lastUse, sizeof(lastUse), &bytesWritten);
+		}
+		f_close(&file_);
+	}
+	cache->cardLastUse = ++lastUse_;
+}
+
+// Does one Cluster's worth of whatever's most useful. Returns whether there might be more to do
+bool SampleCacheStore::doNextJob(SampleCache* cache) {
+
+	// Restoring comes first, because a voice is about to want it
+	if (cache->wantsRestoring) {
+		markUsed(cache);
+		int32_t clusterIndex = cache->writeBytePos >> audioFileManager.clusterSizeMagnitude;
+		if (cache->writeBytePos < cache->waveformLengthBytes
+		    && cache->getClusterEndBytePos(clusterIndex) <= cache->cardBytePos) {
+			return restoreCluster(cache, clusterIndex);
+		}
+		cache->wantsRestoring = false;
+	}
+
+	int32_t clusterIndex = cache->cardBytePos >> audioFileManager.clusterSizeMagnitude;
+	if (cache->getClusterEndBytePos(clusterIndex) <= cache->writeBytePos) {
+		return spillCluster(cache, clusterIndex);
+	}
+	return false;
+}
+
+bool SampleCacheStore::spillCluster(SampleCache* cache, int32_t clusterIndex) {
+	// No room, so first go and find the least recently used file to delete - unless the last look found nothing which
+	// could be
+	if (bytesOnCard_ + kDataOffset + audioFileManager.clusterSize > kMaxBytesOnCard) {
+		if (full_) {
+			return false;
+		}
+		scanNextFile();
+		return true;
+	}
+
+	int32_t bytesPerSample = cache->sample->numChannels * kCacheByteDepth;
+	uint8_t* buffer = (uint8_t*)allocLowSpeed(audioFileManager.clusterSize + bytesPerSample, cache);
+	if (!buffer) {
+		return false;
+	}
+
+	// Copy it out first, so nothing the audio routine does while the card's busy can change it under us
+	int32_t startBytePos = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	UINT numBytes = cache->copyClusterOut(clusterIndex, buffer);
+
+	char path[kPathLength];
+	getCacheFilePath(cache, path);
+
+	bool success = false;
+	FRESULT result = f_open(&file_, path, FA_WRITE);
+	if (result == FR_OK) {
+		uint32_t numBytesBefore = f_size(&file_);
+		UINT bytesWritten;
+		result = f_lseek(&file_, kDataOffset + startBytePos);
+		if (result == FR_OK) {
+			result = f_write(&file_, buffer, numBytes, &bytesWritten);
+			success = (result == FR_OK && bytesWritten == numBytes);
+		}
+
+		// Only once the data's there, say it is
+		int32_t newCardBytePos = startBytePos + numBytes;
+		if (success) {
+			result = f_lseek(&file_, offsetof(CacheFileHeader, numBytes));
+			if (result == FR_OK) {
+				result = f_write(&file_, &newCardBytePos, sizeof(newCardBytePos), &bytesWritten);
+			}
+			success = (result == FR_OK && bytesWritten == sizeof(newCardBytePos));
+		}
+		bytesOnCard_ += f_size(&file_) - numBytesBefore;
+		result = f_close(&file_);
+		success = success && (result == FR_OK);
+		if (success) {
+			cache->cardBytePos = newCardBytePos;
+		}
+	}
+	delugeDealloc(buffer);
+
+	if (!success) {
+		D_PRINTLN("couldn't write cache to card");
+		cache->cardState = SampleCache::CardState::UNAVAILABLE;
+	}
+	return success;
+}
+
+bool SampleCacheStore::restoreCluster(SampleCache* cache, int32_t clusterIndex) {
+	Cluster* cluster = audioFileManager.allocateCluster(ClusterType::SAMPLE_CACHE, false, cache);
+	if (!cluster) {
+		cache->wantsRestoring = false; // No room for it. Might still be able to spill, though
+		return true;
+	}
+
+	int32_t startBytePos = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	UINT numBytes = cache->getClusterEndBytePos(clusterIndex) - startBytePos;
+
+	char path[kPathLength];
+	getCacheFilePath(cache, path);
+
+	bool success = false;
+	FRESULT result = f_open(&file_, path, FA_READ);
+	if (result == FR_OK) {
+		result = f_lseek(&file_, kDataOffset + startBytePos);
+		if (result == FR_OK) {
+			UINT bytesRead;
+			result = f_read(&file_, cluster->data, numBytes, &bytesRead);
+			success = (result == FR_OK && bytesRead == numBytes);
+		}
+		f_close(&file_);
+	}
+
+	if (!success) {
+		D_PRINTLN("couldn't read cache from card");
+		audioFileManager.deallocateCluster(cluster);
+		cache->cardState = SampleCache::CardState::UNAVAILABLE;
+		return false;
+	}
+
+	// If the voice got there first, or something earlier got stolen meanwhile, it's no use now
+	if (!cache->adoptClusterFromCard(clusterIndex, cluster)) {
+		audioFileManager.deallocateCluster(cluster);
+	}
+	return true;
+}
+
+// One file, or the start or end of the folder, per call
+void SampleCacheStore::scanNextFile() {
+	if (!scanning_) {
+		if (f_opendir(&dir_, kCacheDir) != FR_OK) {
+			// No folder - so nothing in it, or nothing we could delete if there was
+			full_ = counted_;
+			counted_ = true;
+			return;
+		}
+		scanning_ = true;
+		scanBytes_ = 0;
+		oldestLastUse_ = UINT32_MAX;
+		oldestFileName_[0] = 0;
+		return;
+	}
+
+	FILINFO info;
+	if (f_readdir(&dir_, &info) != FR_OK || !info.fname[0]) {
+		f_closedir(&dir_);
+		scanning_ = false;
+		finishScan();
+		return;
+	}
+	if ((info.fattrib & AM_DIR) || !isCacheFileName(info.fname)) {
+		return;
+	}
+
+	char path[kPathLength];
+	getPathInCacheDir(info.fname, path);
+	uint32_t lastUse = readLastUse(&file_, path);
+	scanBytes_ += info.fsize;
+	lastUse_ = std::max(lastUse_, lastUse);
+	if (lastUse < oldestLastUse_ && !isQueued(info.fname)) {
+		oldestLastUse_ = lastUse;
+		oldestNumBytes_ = info.fsize;
+		strcpy(oldestFileName_, info.fname);
+	}
+}
+
+void SampleCacheStore::finishScan() {
+	if (!counted_) {
+		bytesOnCard_ = scanBytes_;
+		counted_ = true;
+	}
+	if (bytesOnCard_ + kDataOffset + audioFileManager.clusterSize <= kMaxBytesOnCard) {
+		return;
+	}
+
+	// A cache might have been queued since its file was looked at
+	if (!oldestFileName_[0] || isQueued(oldestFileName_)) {
+		full_ = true;
+		return;
+	}
+	char path[kPathLength];
+	getPathInCacheDir(oldestFileName_, path);
+	if (f_unlink(path) != FR_OK) {
+		full_ = true;
+		return;
+	}
+	D_PRINTLN("deleted cache file from card, %d bytes", oldestNumBytes_);
+	bytesOnCard_ -= std::min(oldestNumBytes_, bytesOnCard_);
+}
+
+bool SampleCacheStore::isQueued(char const* fileName) {
+	for (int32_t i = 0; i < numQueued_; i++) {
+		char queuedFileName[kFileNameLength + 1];
+		getCacheFileName(queue_[i], queuedFileName);
+		if (!strcmp(fileName, queuedFileName)) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "fatfs/ff.h"
+#include <array>
+#include <cstdint>
+
+class SampleCache;
+
+/// A second tier for SampleCaches, when the Sample Cache on Card community feature is on. Each finished Cluster of a
+/// cache gets copied to a file in SAMPLES/.CACHE, and once a voice wants the cache again, any Clusters which have been
+/// stolen since get read back in from there ahead of it rather than rendered again. The files are named after the
+/// Sample and the cache's parameters, and are checked against the Sample's file before being used. Once the files add
+/// up to kMaxBytesOnCard, the least recently used ones get deleted to make room.
+class SampleCacheStore {
+public:
+	SampleCacheStore() = default;
+
+	/// Call when a Cluster of the cache has been finished. May be called from the audio routine
+	void requestSpill(SampleCache* cache);
+	/// Call when a voice starts using the cache. May be called from the audio routine
+	void requestRestore(SampleCache* cache);
+	/// Call before a cache is destructed
+	void forget(SampleCache* cache);
+	/// Call regularly - not from the audio routine
+	void routine();
+
+private:
+	static constexpr int32_t kMaxQueued = 16;
+	static constexpr uint32_t kMaxBytesOnCard = 1 << 30;
+
+	void enqueue(SampleCache* cache);
+	void dequeue(int32_t i);
+	bool openCacheFile(SampleCache* cache);
+	void markUsed(SampleCache* cache);
+	bool doNextJob(SampleCache* cache);
+	bool spillCluster(SampleCache* cache, int32_t clusterIndex);
+	bool restoreCluster(SampleCache* cache, int32_t clusterIndex);
+	void scanNextFile();
+	void finishScan();
+	bool isQueued(char const* fileName);
+
+	std::array<SampleCache*, kMaxQueued> queue_{}; // The first is the one to be worked on next
+	int32_t numQueued_ = 0;
+
+	FIL file_;
+
+	// The cache folder gets looked through a file at a time - first to add up what's there, then whenever room's needed,
+	// to find the least recently used file
+	DIR dir_;
+	bool scanning_ = false;
+	bool counted_ = false;
+	bool full_ = false; // Over budget, and the last scan found nothing it was allowed to delete
+	uint32_t bytesOnCard_ = 0;
+	uint32_t lastUse_ = 0; // Goes up each time a cache gets used, and gets written into its file
+	uint32_t scanBytes_;
+	uint32_t oldestLastUse_;
+	uint32_t oldestNumBytes_;
+	char oldestFileName_[24];
+};
+
+extern SampleCacheStore sampleCacheStore;
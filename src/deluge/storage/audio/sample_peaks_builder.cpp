@@ -0,0 +1,311 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/sample_peaks_builder.h"
+#include "dsp/convert/sample_format.h"
+#include "gui/ui/root_ui.h"
+#include "io/debug/log.h"
+#include "memory/memory_allocator_interface.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_cluster.h"
+#include "storage/audio/audio_file_manager.h"
+#include "util/d_string.h"
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+extern uint8_t currentlyAccessingCard;
+}
+
+SamplePeaksBuilder samplePeaksBuilder{};
+
+namespace {
+
+constexpr char kPeaksFileMagic[4] = {'D', 'P', 'K', '1'};
+constexpr uint8_t kPeaksFileVersion = 1;
+
+// Everything in a peaks file's header has to match the Sample as loaded, or the file's out of date
+struct PeaksFileHeader {
+	char magic[4];
+	uint8_t version;
+	uint8_t baseMagnitude;
+	uint8_t numChannels;
+	uint8_t byteDepth;
+	uint32_t audioDataStartPosBytes;
+	uint32_t firstClusterSDAddress; // Catches the file having been replaced, or a different card
+	uint64_t numFrames;
+	uint32_t numEntries;
+	uint32_t reserved;
+};
+static_assert(sizeof(PeaksFileHeader) == 32);
+static_assert(sizeof(PeakEntry) == 6);
+
+// The file the audio's actually in. Recordings which haven't been saved yet are only at their temp path, and don't
+// get peaks files
+char const* getAudioFilePath(Sample* sample) {
+	if (!sample->loadedFromAlternatePath.isEmpty()) {
+		return sample->loadedFromAlternatePath.get();
+	}
+	return sample->filePath.get();
+}
+
+Error getPeaksFilePath(Sample* sample, String* path) {
+	Error error = path->set(getAudioFilePath(sample));
+	if (error != Error::NONE) {
+		return error;
+	}
+	return path->concatenate(".peaks");
+}
+
+void fillHeader(Sample* sample, PeaksFileHeader* header) {
+	memset(header, 0, sizeof(PeaksFileHeader));
+	memcpy(header->magic, kPeaksFileMagic, sizeof(kPeaksFileMagic));
+	header->version = kPeaksFileVersion;
+	header->baseMagnitude = SamplePeaks::kBaseMagnitude;
+	header->numChannels = sample->numChannels;
+	header->byteDepth = sample->byteDepth;
+	header->audioDataStartPosBytes = sample->audioDataStartPosBytes;
+	header->firstClusterSDAddress = sample->clusters.getElement(0)->sdAddress;
+	header->numFrames = sample->lengthInSamples;
+}
+
+} // namespace
+
+void SamplePeaksBuilder::request(Sample* sample) {
+	if (sample->peaks.getStatus() != SamplePeaks::Status::NONE) {
+		return;
+	}
+	if (sample->unloadable || !sample->tempFilePathForRecording.isEmpty() || !sample->lengthInSamples
+	    || !sample->clusters.getNumElements()) {
+		return;
+	}
+	if (numQueued_ >= kMaxQueued) {
+		return; // We'll get asked again next time it's drawn
+	}
+
+	sample->peaks.setStatus(SamplePeaks::Status::PENDING);
+	sample->addReason(); // So it can't be deleted while it's queued
+	queue_[numQueued_++] = sample;
+}
+
+void SamplePeaksBuilder::routine() {
+	if (!numQueued_) {
+		return;
+	}
+
+	// Only ever use the card when nothing more important wants it
+	if (currentlyAccessingCard || audioFileManager.loadingQueue.getNumElements()) {
+		return;
+	}
+
+	Sample* sample = queue_[0];
+	if (sample->unloadable) {
+		finishJob(false);
+		return;
+	}
+
+	if (!fileOpen_) {
+		if (loadPeaksFile(sample)) {
+			finishJob(true);
+			return;
+		}
+		if (!startJob(sample)) {
+			finishJob(false);
+		}
+		return;
+	}
+
+	if (!readChunk(sample)) {
+		finishJob(false);
+		return;
+	}
+
+	if (!bytesLeft_) {
+		sample->peaks.finish();
+		bool success = (sample->peaks.getStatus() == SamplePeaks::Status::COMPLETE);
+		if (success) {
+			savePeaksFile(sample);
+		}
+		finishJob(success);
+	}
+}
+
+void SamplePeaksBuilder::cancelAll() {
+	if (fileOpen_) {
+		f_close(&file_);
+		fileOpen_ = false;
+	}
+	if (readBuffer_) {
+		delugeDealloc(readBuffer_);
+		readBuffer_ = nullptr;
+	}
+
+	for (int32_t i = 0; i < numQueued_; i++) {
+		queue_[i]->peaks.clear();
+		queue_[i]->removeReason("E456");
+	}
+	numQueued_ = 0;
+}
+
+bool SamplePeaksBuilder::startJob(Sample* sample) {
+	int32_t frameBytes = sample->numChannels * sample->byteDepth;
+	if (!frameBytes) {
+		return false;
+	}
+
+	if (!sample->peaks.setup(sample->lengthInSamples)) {
+		return false;
+	}
+
+	readBuffer_ = (uint8_t*)allocLowSpeed(kReadChunkBytes);
+	if (!readBuffer_) {
+		return false;
+	}
+
+	FRESULT result = f_open(&file_, getAudioFilePath(sample), FA_READ);
+	if (result != FR_OK) {
+		return false;
+	}
+	fileOpen_ = true;
+
+	result = f_lseek(&file_, sample->audioDataStartPosBytes);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	bytesLeft_ = sample->lengthInSamples * frameBytes;
+	sample->peaks.setStatus(SamplePeaks::Status::PENDING);
+	D_PRINTLN("making peaks for %s", sample->filePath.get());
+	return true;
+}
+
+bool SamplePeaksBuilder::readChunk(Sample* sample) {
+	int32_t frameBytes = sample->numChannels * sample->byteDepth;
+
+	// Whole frames, and whole 32-bit words, so the data can be converted just like a Cluster's
+	int32_t chunkBytes = kReadChunkBytes - (kReadChunkBytes % (frameBytes * 4));
+	UINT bytesToRead = std::min<uint64_t>(bytesLeft_, chunkBytes);
+	UINT bytesRead;
+	FRESULT result = f_read(&file_, readBuffer_, bytesToRead, &bytesRead);
+	if (result != FR_OK || bytesRead != bytesToRead) {
+		return false;
+	}
+
+	int32_t numFrames = bytesRead / frameBytes;
+	if (sample->rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+		deluge::dsp::convert::swapBytes24(readBuffer_, numFrames * sample->numChannels);
+	}
+	else if (sample->rawDataFormat) {
+		sample->convertData((int32_t*)readBuffer_, (bytesRead + 3) >> 2);
+	}
+
+	sample->peaks.addFrames(readBuffer_, numFrames, sample->numChannels, sample->byteDepth);
+	bytesLeft_ -= bytesRead;
+	return true;
+}
+
+bool SamplePeaksBuilder::loadPeaksFile(Sample* sample) {
+	String path;
+	if (getPeaksFilePath(sample, &path) != Error::NONE) {
+		return false;
+	}
+
+	FRESULT result = f_open(&file_, path.get(), FA_READ);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	PeaksFileHeader header;
+	PeaksFileHeader expected;
+	fillHeader(sample, &expected);
+
+	bool success = false;
+	UINT bytesRead;
+	result = f_read(&file_, &header, sizeof(header), &bytesRead);
+	if (result == FR_OK && bytesRead == sizeof(header)) {
+		expected.numEntries = header.numEntries;
+		if (!memcmp(&header, &expected, sizeof(header)) && sample->peaks.setup(header.numFrames)
+		    && sample->peaks.getTotalNumEntries() == header.numEntries) {
+			UINT entriesBytes = header.numEntries * sizeof(PeakEntry);
+			result = f_read(&file_, sample->peaks.getEntries(), entriesBytes, &bytesRead);
+			success = (result == FR_OK && bytesRead == entriesBytes);
+		}
+	}
+	f_close(&file_);
+
+	if (!success) {
+		sample->peaks.clear();
+		return false;
+	}
+	sample->peaks.setComplete(header.numFrames);
+	return true;
+}
+
+void SamplePeaksBuilder::savePeaksFile(Sample* sample) {
+	String path;
+	if (getPeaksFilePath(sample, &path) != Error::NONE) {
+		return;
+	}
+
+	FIL peaksFile;
+	FRESULT result = f_open(&peaksFile, path.get(), FA_CREATE_ALWAYS | FA_WRITE);
+	if (result != FR_OK) {
+		return; // E.g. card's write-protected. We'll just make them again next time
+	}
+
+	PeaksFileHeader header;
+	fillHeader(sample, &header);
+	header.numEntries = sample->peaks.getTotalNumEntries();
+
+	UINT entriesBytes = header.numEntries * sizeof(PeakEntry);
+	UINT bytesWritten;
+	result = f_write(&peaksFile, &header, sizeof(header), &bytesWritten);
+	bool success = (result == FR_OK && bytesWritten == sizeof(header));
+	if (success) {
+		result = f_write(&peaksFile, sample->peaks.getEntries(), entriesBytes, &bytesWritten);
+		success = (result == FR_OK && bytesWritten == entriesBytes);
+	}
+	result = f_close(&peaksFile);
+
+	if (!success || result != FR_OK) {
+		f_unlink(path.get()); // Don't leave a half-written one to trip over next time
+	}
+}
+
+void SamplePeaksBuilder::finishJob(bool success) {
+	if (fileOpen_) {
+		f_close(&file_);
+		fileOpen_ = false;
+	}
+	if (readBuffer_) {
+		delugeDealloc(readBuffer_);
+		readBuffer_ = nullptr;
+	}
+
+	Sample* sample = queue_[0];
+	if (!success) {
+		sample->peaks.clear();
+		sample->peaks.setStatus(SamplePeaks::Status::FAILED);
+	}
+	else if (getRootUI()) {
+		getRootUI()->sampleNeedsReRendering(sample);
+	}
+
+	numQueued_--;
+	std::copy(&queue_[1], &queue_[numQueued_ + 1], &queue_[0]);
+	sample->removeReason("E457");
+}
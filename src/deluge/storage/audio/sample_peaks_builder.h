@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "fatfs/ff.h"
+#include <array>
+#include <cstdint>
+
+class Sample;
+
+/// Makes SamplePeaks for Samples which are getting drawn zoomed out, a chunk of the file at a time whenever the card
+/// isn't needed for anything else. Finished peaks get saved next to the Sample's file, as "<file name>.peaks", and
+/// next time they're just read back in from there.
+class SamplePeaksBuilder {
+public:
+	SamplePeaksBuilder() = default;
+
+	/// Queues the Sample to have its peaks made or loaded, unless that's already happened or been tried
+	void request(Sample* sample);
+	/// Call regularly - not from the audio routine
+	void routine();
+	/// Stops work on everything queued, which will then be able to be requested again. Call before deleting the Song
+	void cancelAll();
+
+private:
+	static constexpr int32_t kMaxQueued = 8;
+	static constexpr int32_t kReadChunkBytes = 32768;
+
+	bool startJob(Sample* sample);
+	bool readChunk(Sample* sample);
+	bool loadPeaksFile(Sample* sample);
+	void savePeaksFile(Sample* sample);
+	void finishJob(bool success);
+
+	std::array<Sample*, kMaxQueued> queue_{}; // The first is the one being worked on
+	int32_t numQueued_ = 0;
+
+	FIL file_;
+	bool fileOpen_ = false;
+	uint64_t bytesLeft_ = 0;
+	uint8_t* readBuffer_ = nullptr;
+};
+
+extern SamplePeaksBuilder samplePeaksBuilder;
@@ -0,0 +1,319 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/binary/binary_conversion.h"
+#include "storage/binary/binary_serializer.h"
+#include "storage/storage_manager.h"
+#include "util/d_string.h"
+#include <string.h>
+
+using namespace deluge::storage::binary;
+
+namespace {
+
+// Deeper than anything we write, so anything past this is a broken file rather than one we should blow the stack on
+constexpr int32_t kMaxTagDepth = 64;
+
+// Number of chars we look at to see if a value is a plain number - enough for "-2147483648", or "0x" and 8 digits
+constexpr int32_t kNumericValueMaxChars = 11;
+
+// Hex runs shorter than this aren't worth switching segments for
+constexpr int32_t kMinHexRunLength = 8;
+
+/// Takes the chars of an XML value and gives them to a BinarySerializer, storing long runs of uppercase hex digits -
+/// note data, automation, and so on - as bytes
+class HexRunPacker {
+public:
+	HexRunPacker(BinarySerializer& writer) : writer(writer) {}
+
+	void add(char thisChar) {
+		if (isUpperHexDigit(thisChar)) {
+			run[runLength++] = thisChar;
+			if (runLength == kRunBufferSize) {
+				flushRun(false);
+			}
+		}
+		else {
+			flushRun(true);
+			writer.writeTextValueChars(&thisChar, 1);
+		}
+	}
+
+	void finish() { flushRun(true); }
+
+private:
+	static constexpr int32_t kRunBufferSize = 64;
+
+	void flushRun(bool runEnded) {
+		if (!runLength) {
+			runIsLong = runIsLong && !runEnded;
+			return;
+		}
+
+		if (runIsLong || runLength >= kMinHexRunLength) {
+			uint8_t bytes[kRunBufferSize / 2];
+			int32_t numBytes = runLength >> 1;
+			for (int32_t i = 0; i < numBytes; i++) {
+				bytes[i] = hexToIntFixedLength(&run[i * 2], 2);
+			}
+			writer.writeTextValueHexBytes(bytes, numBytes);
+
+			bool haveOddChar = (runLength & 1);
+			if (runEnded) {
+				if (haveOddChar) {
+					writer.writeTextValueChars(&run[runLength - 1], 1);
+				}
+				runLength = 0;
+				runIsLong = false;
+			}
+			else {
+				// Carry on the run, even if what's left of it is short
+				run[0] = run[runLength - 1];
+				runLength = haveOddChar ? 1 : 0;
+				runIsLong = true;
+			}
+		}
+		else {
+			writer.writeTextValueChars(run, runLength);
+			runLength = 0;
+		}
+	}
+
+	BinarySerializer& writer;
+	char run[kRunBufferSize];
+	int32_t runLength = 0;
+	bool runIsLong = false;
+};
+
+void copyXMLValue(XMLDeserializer& reader, BinarySerializer& writer, char const* name, bool asTag) {
+	char nameCopy[kFilenameBufferSize];
+	strncpy(nameCopy, name, kFilenameBufferSize - 1);
+	nameCopy[kFilenameBufferSize - 1] = 0;
+
+	char start[kNumericValueMaxChars + 1];
+	int32_t numChars = 0;
+	bool valueEnded = !reader.prepareToReadTagOrAttributeValueOneCharAtATime();
+	while (!valueEnded && numChars < kNumericValueMaxChars) {
+		char thisChar = reader.readNextCharOfTagOrAttributeValue();
+		if (!thisChar) {
+			valueEnded = true;
+		}
+		else {
+			start[numChars++] = thisChar;
+		}
+	}
+	start[numChars] = 0;
+
+	// Numbers only get stored as such if they'll come back out exactly as they went in
+	if (valueEnded) {
+		int32_t number;
+		uint32_t hexNumber;
+		int32_t numHexChars;
+		if (textIsCanonicalInt(start, &number)) {
+			writer.writeIntValue(nameCopy, number, asTag);
+			return;
+		}
+		if (textIsCanonicalHex(start, &hexNumber, &numHexChars)) {
+			writer.writeHexValue(nameCopy, hexNumber, numHexChars, asTag);
+			return;
+		}
+	}
+
+	writer.writeTextValueBegin(nameCopy, asTag);
+	HexRunPacker packer(writer);
+	for (int32_t i = 0; i < numChars; i++) {
+		packer.add(start[i]);
+	}
+	if (!valueEnded) {
+		while (char thisChar = reader.readNextCharOfTagOrAttributeValue()) {
+			packer.add(thisChar);
+		}
+	}
+	packer.finish();
+	writer.writeTextValueEnd();
+}
+
+Error copyXMLContents(XMLDeserializer& reader, BinarySerializer& writer, int32_t depth) {
+	if (depth > kMaxTagDepth) {
+		return Error::FILE_CORRUPTED;
+	}
+
+	char const* name;
+	while (*(name = reader.readNextTagOrAttributeName())) {
+		switch (reader.getKindOfLastName()) {
+		case XMLDeserializer::NameKind::ATTRIBUTE:
+			copyXMLValue(reader, writer, name, false);
+			break;
+
+		case XMLDeserializer::NameKind::TAG_VALUE:
+			copyXMLValue(reader, writer, name, true);
+			break;
+
+		case XMLDeserializer::NameKind::EMPTY_TAG:
+			writer.writeOpeningTagBeginning(name);
+			writer.closeTag();
+			break;
+
+		case XMLDeserializer::NameKind::TAG_CONTENTS: {
+			writer.writeOpeningTagBeginning(name);
+			Error error = copyXMLContents(reader, writer, depth + 1);
+			if (error != Error::NONE) {
+				return error;
+			}
+			writer.closeTag();
+			break;
+		}
+		}
+		reader.exitTag();
+	}
+
+	return Error::NONE;
+}
+
+void copyBinaryValue(BinaryDeserializer& reader, XMLSerializer& writer) {
+	if (!reader.prepareToReadTagOrAttributeValueOneCharAtATime()) {
+		return;
+	}
+
+	char buffer[65];
+	int32_t numChars = 0;
+	while (char thisChar = reader.readNextCharOfTagOrAttributeValue()) {
+		buffer[numChars++] = thisChar;
+		if (numChars == 64) {
+			buffer[numChars] = 0;
+			writer.write(buffer);
+			numChars = 0;
+		}
+	}
+	buffer[numChars] = 0;
+	writer.write(buffer);
+}
+
+Error copyBinaryContents(BinaryDeserializer& reader, XMLSerializer& writer, char const* tagName, int32_t depth) {
+	if (depth > kMaxTagDepth) {
+		return Error::FILE_CORRUPTED;
+	}
+
+	bool haveContents = false;
+	char const* name;
+	while (*(name = reader.readNextTagOrAttributeName())) {
+		RecordKind kind = reader.getKindOfLastName();
+
+		// XML can only have attributes before a tag's contents, so any after that become tags. Deserializer users
+		// don't tell the two apart.
+		if (kind == RecordKind::ATTRIBUTE && !haveContents) {
+			writer.write("\n");
+			writer.printIndents();
+			writer.write(name);
+			writer.write("=\"");
+			copyBinaryValue(reader, writer);
+			writer.write("\"");
+		}
+		else {
+			if (!haveContents) {
+				writer.writeOpeningTagEnd();
+				haveContents = true;
+			}
+
+			if (kind == RecordKind::OPEN) {
+				String childName;
+				Error error = childName.set(name);
+				if (error != Error::NONE) {
+					return error;
+				}
+				writer.writeOpeningTagBeginning(childName.get());
+				error = copyBinaryContents(reader, writer, childName.get(), depth + 1);
+				if (error != Error::NONE) {
+					return error;
+				}
+			}
+			else {
+				writer.printIndents();
+				writer.write("<");
+				writer.write(name);
+				writer.write(">");
+				copyBinaryValue(reader, writer);
+				writer.write("</");
+				writer.write(name);
+				writer.write(">\n");
+			}
+		}
+		reader.exitTag();
+	}
+
+	if (haveContents) {
+		writer.writeClosingTag(tagName);
+	}
+	else {
+		writer.closeTag();
+	}
+	return Error::NONE;
+}
+
+} // namespace
+
+Error convertXMLFileToBinary(char const* xmlPath, char const* binaryPath, char const* firstTagName,
+                             bool mayOverwrite) {
+	FilePointer filePointer;
+	if (!storageManager.fileExists(xmlPath, &filePointer)) {
+		return Error::FILE_NOT_FOUND;
+	}
+
+	Error error = storageManager.openXMLFile(&filePointer, smDeserializer, firstTagName);
+	if (error != Error::NONE) {
+		return error;
+	}
+
+	BinarySerializer writer;
+	error = storageManager.createBinaryFile(binaryPath, writer, mayOverwrite, false, &filePointer);
+	if (error != Error::NONE) {
+		storageManager.closeFile();
+		return error;
+	}
+
+	writer.writeOpeningTagBeginning(firstTagName);
+	error = copyXMLContents(smDeserializer, writer, 0);
+	if (error == Error::NONE) {
+		writer.closeTag();
+	}
+	storageManager.closeFile();
+
+	Error closeError = writer.closeFileAfterWriting(binaryPath);
+	return (error != Error::NONE) ? error : closeError;
+}
+
+Error convertBinaryFileToXML(char const* binaryPath, char const* xmlPath, char const* firstTagName,
+                             bool mayOverwrite) {
+	BinaryDeserializer reader;
+	Error error = storageManager.openBinaryFile(binaryPath, reader, firstTagName);
+	if (error != Error::NONE) {
+		return error;
+	}
+
+	error = storageManager.createXMLFile(xmlPath, smSerializer, mayOverwrite, false);
+	if (error != Error::NONE) {
+		reader.closeFile();
+		return error;
+	}
+
+	smSerializer.writeOpeningTagBeginning(firstTagName);
+	error = copyBinaryContents(reader, smSerializer, firstTagName, 0);
+	reader.closeFile();
+
+	Error closeError = smSerializer.closeFileAfterWriting(xmlPath);
+	return (error != Error::NONE) ? error : closeError;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/binary/binary_format.h"
+#include <cstring>
+
+namespace deluge::storage::binary {
+
+int32_t encodeVarint(uint32_t value, uint8_t* output) {
+	int32_t numBytes = 0;
+	while (value >= 0x80) {
+		output[numBytes++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	output[numBytes++] = value;
+	return numBytes;
+}
+
+int32_t decodeVarint(uint8_t const* input, int32_t numBytesAvailable, uint32_t* value) {
+	uint32_t result = 0;
+	for (int32_t i = 0; i < kMaxVarintBytes && i < numBytesAvailable; i++) {
+		result |= (uint32_t)(input[i] & 0x7F) << (i * 7);
+		if (!(input[i] & 0x80)) {
+			*value = result;
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+bool textIsCanonicalInt(char const* text, int32_t* value) {
+	char const* pos = text;
+	bool isNegative = (*pos == '-');
+	if (isNegative) {
+		pos++;
+	}
+
+	// No empty numbers, no leading zeros, and no "-0"
+	if (*pos < '0' || *pos > '9' || (*pos == '0' && (pos[1] || isNegative))) {
+		return false;
+	}
+
+	int64_t number = 0;
+	for (; *pos; pos++) {
+		if (*pos < '0' || *pos > '9') {
+			return false;
+		}
+		number = number * 10 + (*pos - '0');
+		if (number > (int64_t)INT32_MAX + 1) {
+			return false;
+		}
+	}
+
+	if (isNegative) {
+		number = -number;
+	}
+	if (number > INT32_MAX) {
+		return false;
+	}
+	*value = (int32_t)number;
+	return true;
+}
+
+bool textIsCanonicalHex(char const* text, uint32_t* value, int32_t* numChars) {
+	if (text[0] != '0' || text[1] != 'x') {
+		return false;
+	}
+
+	uint32_t number = 0;
+	int32_t i = 0;
+	for (char const* pos = &text[2]; *pos; pos++, i++) {
+		if (i == 8 || !isUpperHexDigit(*pos)) {
+			return false;
+		}
+		number = (number << 4) | (uint32_t)((*pos <= '9') ? (*pos - '0') : (*pos - 'A' + 10));
+	}
+	if (!i) {
+		return false;
+	}
+
+	*value = number;
+	*numChars = i;
+	return true;
+}
+
+void NameTable::clear() {
+	numNames = 0;
+	poolUsed = 0;
+	memset(hashSlots, 0, sizeof(hashSlots));
+}
+
+uint32_t NameTable::hash(char const* name, int32_t length) {
+	uint32_t h = 2166136261u; // FNV-1a
+	for (int32_t i = 0; i < length; i++) {
+		h = (h ^ (uint8_t)name[i]) * 16777619u;
+	}
+	return h;
+}
+
+int32_t NameTable::find(char const* name, int32_t length) const {
+	uint32_t slot = hash(name, length) & (kNumHashSlots - 1);
+	while (hashSlots[slot]) {
+		int32_t id = hashSlots[slot] - 1;
+		char const* existing = &pool[offsets[id]];
+		if (!strncmp(existing, name, length) && !existing[length]) {
+			return id;
+		}
+		slot = (slot + 1) & (kNumHashSlots - 1);
+	}
+	return -1;
+}
+
+int32_t NameTable::add(char const* name, int32_t length) {
+	if (numNames == kMaxNames || poolUsed + length + 1 > kPoolSize) {
+		return -1;
+	}
+
+	int32_t id = numNames++;
+	offsets[id] = poolUsed;
+	memcpy(&pool[poolUsed], name, length);
+	pool[poolUsed + length] = 0;
+	poolUsed += length + 1;
+
+	uint32_t slot = hash(name, length) & (kNumHashSlots - 1);
+	while (hashSlots[slot]) {
+		slot = (slot + 1) & (kNumHashSlots - 1);
+	}
+	hashSlots[slot] = id + 1;
+
+	return id;
+}
+
+char const* NameTable::get(uint32_t id) const {
+	if (id >= (uint32_t)numNames) {
+		return nullptr;
+	}
+	return &pool[offsets[id]];
+}
+
+} // namespace deluge::storage::binary
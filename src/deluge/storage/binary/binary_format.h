@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * The binary song / preset format holds exactly what the XML one does - a tree of tags, each with named values - so
+ * that everything that reads and writes through Serializer / Deserializer works with either.
+ *
+ * A file is kMagic, then kFormatVersion, then the size and first cluster of the XML file it's a copy of (little-endian,
+ * 4 bytes each, or both 0 if it isn't one), then a stream of records. Each record begins with a header byte:
+ *   bits 0-2: RecordKind
+ *   bits 3-4: ValueType, for ATTRIBUTE and TAG_VALUE
+ *   bit 6:    kHeaderNewName - the name follows as a varint length and its chars, and gets the next name ID
+ *   bit 7:    kHeaderInlineName - same, but the name table was full so it doesn't get an ID
+ * If neither name bit is set (and it's not a CLOSE), a varint name ID follows instead. Then for values:
+ *   INT:  zigzag varint
+ *   HEX:  varint, then one byte saying how many hex digits it had
+ *   TEXT: a run of segments, each a varint of (length << 1 | isHexBytes) then that many bytes, ending with a 0. Hex
+ *         segments hold bytes which read back as two uppercase hex digits each, so note data and automation take half
+ *         the space they did, and readers that want bytes can just copy them.
+ */
+
+namespace deluge::storage::binary {
+
+constexpr char kMagic[4] = {'D', 'B', 'I', 'N'};
+constexpr uint8_t kFormatVersion = 1;
+constexpr int32_t kFileHeaderSize = sizeof(kMagic) + 1 + 8;
+
+enum class RecordKind : uint8_t {
+	CLOSE,     // End of the current OPEN tag
+	OPEN,      // A tag with contents of its own
+	ATTRIBUTE, // A named value
+	TAG_VALUE, // A tag with nothing but a value in it, like <name>value</name>
+};
+
+enum class ValueType : uint8_t {
+	INT,
+	HEX,
+	TEXT,
+};
+
+constexpr uint8_t kHeaderKindMask = 0b00000111;
+constexpr uint8_t kHeaderTypeShift = 3;
+constexpr uint8_t kHeaderTypeMask = 0b00011000;
+constexpr uint8_t kHeaderNewName = 0b01000000;
+constexpr uint8_t kHeaderInlineName = 0b10000000;
+
+constexpr int32_t kMaxVarintBytes = 5;
+constexpr int32_t kMaxSegmentLength = 128;
+
+constexpr uint8_t makeHeader(RecordKind kind, ValueType type = ValueType::INT) {
+	return static_cast<uint8_t>(kind) | (static_cast<uint8_t>(type) << kHeaderTypeShift);
+}
+constexpr RecordKind headerKind(uint8_t header) {
+	return static_cast<RecordKind>(header & kHeaderKindMask);
+}
+constexpr ValueType headerType(uint8_t header) {
+	return static_cast<ValueType>((header & kHeaderTypeMask) >> kHeaderTypeShift);
+}
+
+constexpr uint32_t zigzagEncode(int32_t value) {
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+constexpr int32_t zigzagDecode(uint32_t value) {
+	return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/// Returns number of bytes written, at most kMaxVarintBytes
+int32_t encodeVarint(uint32_t value, uint8_t* output);
+
+/// Returns number of bytes used, or 0 if the varint ran past numBytesAvailable or was too long
+int32_t decodeVarint(uint8_t const* input, int32_t numBytesAvailable, uint32_t* value);
+
+/// Whether text would come back out exactly the same after being stored as an INT
+bool textIsCanonicalInt(char const* text, int32_t* value);
+
+/// Whether text would come back out exactly the same after being stored as a HEX - "0x" and 1 to 8 uppercase digits
+bool textIsCanonicalHex(char const* text, uint32_t* value, int32_t* numChars);
+
+constexpr bool isUpperHexDigit(char ch) {
+	return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F');
+}
+
+/// Interns tag and attribute names, so each is only spelled out once per file. The writer and reader each keep one,
+/// and since they're fed the same names in the same order they hand out the same IDs.
+class NameTable {
+public:
+	static constexpr int32_t kMaxNames = 1024;
+	static constexpr int32_t kPoolSize = 8192;
+
+	NameTable() { clear(); }
+	void clear();
+
+	/// Returns the name's ID, or -1 if it's not in the table
+	[[nodiscard]] int32_t find(char const* name, int32_t length) const;
+
+	/// Returns the new ID, or -1 if the table is full
+	int32_t add(char const* name, int32_t length);
+
+	/// Returns nullptr for an ID we've not handed out
+	[[nodiscard]] char const* get(uint32_t id) const;
+
+	[[nodiscard]] int32_t getNumNames() const { return numNames; }
+
+private:
+	static constexpr int32_t kNumHashSlots = kMaxNames * 2;
+
+	static uint32_t hash(char const* name, int32_t length);
+
+	int32_t numNames;
+	int32_t poolUsed;
+	uint16_t offsets[kMaxNames];
+	uint16_t hashSlots[kNumHashSlots]; // Name ID + 1, or 0 for empty
+	char pool[kPoolSize];
+};
+
+} // namespace deluge::storage::binary
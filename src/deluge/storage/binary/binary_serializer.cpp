@@ -0,0 +1,1004 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/binary/binary_serializer.h"
+#include "drivers/pic/pic.h"
+#include "gui/ui_timer_manager.h"
+#include "hid/display/display.h"
+#include "io/debug/log.h"
+#include "memory/general_memory_allocator.h"
+#include "processing/engines/audio_engine.h"
+#include "util/d_string.h"
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+extern "C" {
+#include "RZA1/oled/oled_low_level.h"
+}
+
+using namespace deluge::storage::binary;
+
+namespace {
+
+constexpr int32_t kFileBufferSize = 32768;
+
+// Buffers get a cache line of space either side, as the card reads and writes them by DMA
+uint8_t* allocFileBuffer() {
+	void* temp = GeneralMemoryAllocator::get().allocLowSpeed(kFileBufferSize + CACHE_LINE_SIZE * 2);
+	return temp ? (uint8_t*)temp + CACHE_LINE_SIZE : nullptr;
+}
+
+void deallocFileBuffer(uint8_t* buffer) {
+	if (buffer) {
+		GeneralMemoryAllocator::get().dealloc(buffer - CACHE_LINE_SIZE);
+	}
+}
+
+NameTable* allocNameTable() {
+	void* memory = GeneralMemoryAllocator::get().allocLowSpeed(sizeof(NameTable));
+	return memory ? new (memory) NameTable() : nullptr;
+}
+
+void deallocNameTable(NameTable* names) {
+	if (names) {
+		names->~NameTable();
+		GeneralMemoryAllocator::get().dealloc(names);
+	}
+}
+
+void writeUint32(uint8_t* bytes, uint32_t value) {
+	for (int32_t i = 0; i < 4; i++) {
+		bytes[i] = value >> (i * 8);
+	}
+}
+
+uint32_t readUint32(uint8_t const* bytes) {
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+bool hexCharToNibble(char ch, int32_t* nibble) {
+	if (ch >= '0' && ch <= '9') {
+		*nibble = ch - '0';
+	}
+	else if (ch >= 'a' && ch <= 'f') {
+		*nibble = ch - 'a' + 10;
+	}
+	else if (ch >= 'A' && ch <= 'F') {
+		*nibble = ch - 'A' + 10;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+// Let the rest of the Deluge carry on while we're busy with the card
+void doOtherRoutines(bool includingAudio) {
+	if (includingAudio) {
+		AudioEngine::routineWithClusterLoading();
+	}
+	uiTimerManager.routine();
+	if (display->haveOLED()) {
+		oledRoutine();
+	}
+	PIC::flush();
+}
+
+} // namespace
+
+/*******************************************************************************
+
+    BinarySerializer
+
+********************************************************************************/
+
+BinarySerializer::BinarySerializer()
+    : writeBuffer(nullptr), names(nullptr), writeBufferPos(0), fileTotalBytesWritten(0), numRecordsWritten(0),
+      fileAccessFailedDuringWrite(false), segmentLength(0), segmentIsHexBytes(false) {
+}
+
+BinarySerializer::~BinarySerializer() {
+	deallocFileBuffer(writeBuffer);
+	deallocNameTable(names);
+}
+
+Error BinarySerializer::beginFile(FIL const& newFile, FilePointer const* source) {
+	if (!writeBuffer) {
+		writeBuffer = allocFileBuffer();
+	}
+	if (!names) {
+		names = allocNameTable();
+	}
+	if (!writeBuffer || !names) {
+		f_close((FIL*)&newFile);
+		return Error::INSUFFICIENT_RAM;
+	}
+
+	file = newFile;
+	names->clear();
+	writeBufferPos = 0;
+	fileTotalBytesWritten = 0;
+	numRecordsWritten = 0;
+	fileAccessFailedDuringWrite = false;
+	segmentLength = 0;
+
+	uint8_t header[kFileHeaderSize];
+	memcpy(header, kMagic, sizeof(kMagic));
+	header[sizeof(kMagic)] = kFormatVersion;
+	writeUint32(&header[sizeof(kMagic) + 1], source ? source->objsize : 0);
+	writeUint32(&header[sizeof(kMagic) + 5], source ? source->sclust : 0);
+	writeBytes(header, kFileHeaderSize);
+	return Error::NONE;
+}
+
+void BinarySerializer::writeBytes(uint8_t const* data, int32_t numBytes) {
+	while (numBytes) {
+		if (writeBufferPos == kFileBufferSize) {
+			if (fileAccessFailedDuringWrite) {
+				return;
+			}
+			if (writeBufferToFile() != Error::NONE) {
+				fileAccessFailedDuringWrite = true;
+				return;
+			}
+			writeBufferPos = 0;
+		}
+
+		int32_t numBytesNow = std::min(numBytes, kFileBufferSize - writeBufferPos);
+		memcpy(&writeBuffer[writeBufferPos], data, numBytesNow);
+		writeBufferPos += numBytesNow;
+		data += numBytesNow;
+		numBytes -= numBytesNow;
+	}
+}
+
+void BinarySerializer::writeVarint(uint32_t value) {
+	uint8_t bytes[kMaxVarintBytes];
+	writeBytes(bytes, encodeVarint(value, bytes));
+}
+
+void BinarySerializer::recordWritten() {
+	numRecordsWritten++;
+	if (!(numRecordsWritten & 63)) {
+		AudioEngine::logAction("writeBinaryRecord");
+		doOtherRoutines(false);
+	}
+}
+
+void BinarySerializer::writeHeader(RecordKind kind, ValueType type, char const* name) {
+	uint8_t header = makeHeader(kind, type);
+
+	if (kind != RecordKind::CLOSE) {
+		int32_t length = strlen(name);
+		int32_t id = names->find(name, length);
+		if (id >= 0) {
+			writeBytes(&header, 1);
+			writeVarint(id);
+		}
+		else {
+			// The reader can only intern names that fit its buffer, so we'd better not intern any others either
+			bool interned = (length < kFilenameBufferSize && names->add(name, length) >= 0);
+			header |= interned ? kHeaderNewName : kHeaderInlineName;
+			writeBytes(&header, 1);
+			writeVarint(length);
+			writeBytes((uint8_t const*)name, length);
+		}
+	}
+	else {
+		writeBytes(&header, 1);
+	}
+
+	recordWritten();
+}
+
+void BinarySerializer::writeIntValue(char const* name, int32_t number, bool asTag) {
+	writeHeader(asTag ? RecordKind::TAG_VALUE : RecordKind::ATTRIBUTE, ValueType::INT, name);
+	writeVarint(zigzagEncode(number));
+}
+
+void BinarySerializer::writeHexValue(char const* name, uint32_t number, int32_t numChars, bool asTag) {
+	writeHeader(asTag ? RecordKind::TAG_VALUE : RecordKind::ATTRIBUTE, ValueType::HEX, name);
+	writeVarint(number);
+	uint8_t numCharsByte = numChars;
+	writeBytes(&numCharsByte, 1);
+}
+
+void BinarySerializer::writeTextValueBegin(char const* name, bool asTag) {
+	writeHeader(asTag ? RecordKind::TAG_VALUE : RecordKind::ATTRIBUTE, ValueType::TEXT, name);
+	segmentLength = 0;
+}
+
+void BinarySerializer::flushSegment() {
+	if (segmentLength) {
+		writeVarint((segmentLength << 1) | segmentIsHexBytes);
+		writeBytes(segment, segmentLength);
+		segmentLength = 0;
+	}
+}
+
+void BinarySerializer::writeTextValueChars(char const* chars, int32_t numChars) {
+	if (segmentIsHexBytes) {
+		flushSegment();
+		segmentIsHexBytes = false;
+	}
+	while (numChars) {
+		if (segmentLength == kMaxSegmentLength) {
+			flushSegment();
+		}
+		int32_t numCharsNow = std::min(numChars, kMaxSegmentLength - segmentLength);
+		memcpy(&segment[segmentLength], chars, numCharsNow);
+		segmentLength += numCharsNow;
+		chars += numCharsNow;
+		numChars -= numCharsNow;
+	}
+}
+
+void BinarySerializer::writeTextValueHexBytes(uint8_t const* data, int32_t numBytes) {
+	if (!segmentIsHexBytes) {
+		flushSegment();
+		segmentIsHexBytes = true;
+	}
+	while (numBytes) {
+		if (segmentLength == kMaxSegmentLength) {
+			flushSegment();
+		}
+		int32_t numBytesNow = std::min(numBytes, kMaxSegmentLength - segmentLength);
+		memcpy(&segment[segmentLength], data, numBytesNow);
+		segmentLength += numBytesNow;
+		data += numBytesNow;
+		numBytes -= numBytesNow;
+	}
+}
+
+void BinarySerializer::writeTextValueEnd() {
+	flushSegment();
+	writeVarint(0);
+}
+
+void BinarySerializer::writeAttribute(char const* name, int32_t number, bool onNewLine) {
+	writeIntValue(name, number, false);
+}
+
+void BinarySerializer::writeAttribute(char const* name, char const* value, bool onNewLine) {
+	writeTextValueBegin(name, false);
+	writeTextValueChars(value, strlen(value));
+	writeTextValueEnd();
+}
+
+void BinarySerializer::writeAttributeHex(char const* name, int32_t number, int32_t numChars, bool onNewLine) {
+	writeHexValue(name, number, numChars, false);
+}
+
+void BinarySerializer::writeAttributeHexBytes(char const* name, uint8_t* data, int32_t numBytes, bool onNewLine) {
+	writeTextValueBegin(name, false);
+	writeTextValueHexBytes(data, numBytes);
+	writeTextValueEnd();
+}
+
+void BinarySerializer::writeAttributeHexBlobBegin(char const* name, bool onNewLine) {
+	writeTextValueBegin(name, false);
+	writeTextValueChars("0x", 2);
+}
+
+void BinarySerializer::writeTagHexBlobBegin(char const* tag) {
+	writeTextValueBegin(tag, true);
+	writeTextValueChars("0x", 2);
+}
+
+void BinarySerializer::writeHexBlobBytes(uint8_t const* data, int32_t numBytes) {
+	writeTextValueHexBytes(data, numBytes);
+}
+
+void BinarySerializer::writeHexBlobEnd() {
+	writeTextValueEnd();
+}
+
+void BinarySerializer::writeTag(char const* tag, int32_t number) {
+	writeIntValue(tag, number, true);
+}
+
+void BinarySerializer::writeTag(char const* tag, char const* contents) {
+	writeTextValueBegin(tag, true);
+	writeTextValueChars(contents, strlen(contents));
+	writeTextValueEnd();
+}
+
+void BinarySerializer::writeOpeningTag(char const* tag, bool startNewLineAfter) {
+	writeHeader(RecordKind::OPEN, ValueType::INT, tag);
+}
+
+void BinarySerializer::writeOpeningTagBeginning(char const* tag) {
+	writeHeader(RecordKind::OPEN, ValueType::INT, tag);
+}
+
+void BinarySerializer::closeTag() {
+	writeHeader(RecordKind::CLOSE, ValueType::INT, nullptr);
+}
+
+void BinarySerializer::writeClosingTag(char const* tag, bool shouldPrintIndents) {
+	writeHeader(RecordKind::CLOSE, ValueType::INT, nullptr);
+}
+
+// Raw text has no meaning here. Anything which used to write its own attributes this way should use the hex blob
+// functions instead.
+void BinarySerializer::write(char const* output) {
+	D_PRINTLN("BinarySerializer::write() ignored:  %s", output);
+}
+
+Error BinarySerializer::writeBufferToFile() {
+	UINT bytesWritten;
+	FRESULT result = f_write(&file, writeBuffer, writeBufferPos, &bytesWritten);
+	if (result != FR_OK || bytesWritten != writeBufferPos) {
+		return Error::SD_CARD;
+	}
+
+	fileTotalBytesWritten += writeBufferPos;
+	return Error::NONE;
+}
+
+Error BinarySerializer::closeFileAfterWriting(char const* path, char const* beginningString, char const* endString) {
+	if (fileAccessFailedDuringWrite) {
+		return Error::WRITE_FAIL; // As for XML, don't let f_close() flush anything after a failure
+	}
+	if (writeBufferToFile() != Error::NONE) {
+		return Error::WRITE_FAIL;
+	}
+
+	FRESULT result = f_close(&file);
+	if (result) {
+		return Error::WRITE_FAIL;
+	}
+
+	if (path) {
+		result = f_open(&file, path, FA_READ);
+		if (result) {
+			return Error::WRITE_FAIL;
+		}
+
+		bool allGood = (f_size(&file) == fileTotalBytesWritten);
+		if (allGood) {
+			uint8_t header[kFileHeaderSize];
+			UINT bytesRead;
+			result = f_read(&file, header, kFileHeaderSize, &bytesRead);
+			allGood = (!result && bytesRead == kFileHeaderSize && !memcmp(header, kMagic, sizeof(kMagic))
+			           && header[sizeof(kMagic)] == kFormatVersion);
+		}
+
+		result = f_close(&file);
+		if (result || !allGood) {
+			return Error::WRITE_FAIL;
+		}
+	}
+
+	return Error::NONE;
+}
+
+/*******************************************************************************
+
+    BinaryDeserializer
+
+********************************************************************************/
+
+BinaryDeserializer::BinaryDeserializer()
+    : fileAccessFailedDuring(false), readBuffer(nullptr), names(nullptr), readBufferEndPos(0), readBufferPos(0),
+      reachedEnd(true), numRecordsRead(0), tagDepthCaller(0), tagDepthFile(0), lastKind(RecordKind::CLOSE),
+      valueType(ValueType::INT), valueState(ValueState::NONE), segmentBytesRemaining(0), segmentIsHexBytes(false),
+      textEnded(true), heldChar(0), valueCharsPos(0) {
+}
+
+BinaryDeserializer::~BinaryDeserializer() {
+	deallocFileBuffer(readBuffer);
+	deallocNameTable(names);
+}
+
+Error BinaryDeserializer::openFile(char const* path, char const* firstTagName, char const* altTagName,
+                                   bool ignoreIncorrectFirmware, FilePointer const* source) {
+
+	AudioEngine::logAction("openBinaryFile");
+
+	if (!readBuffer) {
+		readBuffer = allocFileBuffer();
+	}
+	if (!names) {
+		names = allocNameTable();
+	}
+	if (!readBuffer || !names) {
+		return Error::INSUFFICIENT_RAM;
+	}
+
+	FRESULT result = f_open(&file, path, FA_READ);
+	if (result) {
+		return Error::FILE_NOT_FOUND;
+	}
+
+	readBufferPos = 0;
+	readBufferEndPos = 0;
+	reachedEnd = false;
+	fileAccessFailedDuring = false;
+	numRecordsRead = 0;
+	tagDepthFile = 0;
+	tagDepthCaller = 0;
+	valueState = ValueState::NONE;
+	names->clear();
+
+	firmware_version = FirmwareVersion{FirmwareVersion::Type::OFFICIAL, {}};
+
+	uint8_t header[kFileHeaderSize];
+	if (readBytes(header, kFileHeaderSize) != kFileHeaderSize || memcmp(header, kMagic, sizeof(kMagic))
+	    || header[sizeof(kMagic)] != kFormatVersion) {
+		closeFile();
+		return Error::FILE_CORRUPTED;
+	}
+
+	// A copy of some other version of the file it's meant to be a copy of is no copy at all
+	if (source
+	    && (readUint32(&header[sizeof(kMagic) + 1]) != source->objsize
+	        || readUint32(&header[sizeof(kMagic) + 5]) != source->sclust)) {
+		closeFile();
+		return Error::FILE_NOT_FOUND;
+	}
+
+	char const* tagName;
+	while (*(tagName = readNextTagOrAttributeName())) {
+
+		if (!strcmp(tagName, firstTagName) || !strcmp(tagName, altTagName)) {
+			return Error::NONE;
+		}
+
+		Error error = tryReadingFirmwareTagFromFile(tagName, ignoreIncorrectFirmware);
+		if (error != Error::NONE && error != Error::RESULT_TAG_UNUSED) {
+			return error;
+		}
+		exitTag(tagName);
+	}
+
+	closeFile();
+	return Error::FILE_CORRUPTED;
+}
+
+void BinaryDeserializer::closeFile() {
+	f_close(&file);
+	reachedEnd = true;
+
+	// Loading's rare enough not to hang on to these in between
+	deallocFileBuffer(readBuffer);
+	readBuffer = nullptr;
+	deallocNameTable(names);
+	names = nullptr;
+}
+
+Error BinaryDeserializer::tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware) {
+
+	if (!strcmp(tagName, "firmwareVersion")) {
+		char const* firmware_version_string = readTagOrAttributeValue();
+		firmware_version = FirmwareVersion::parse(firmware_version_string);
+	}
+
+	// If this tag doesn't exist, it's from old firmware so is ok
+	else if (!strcmp(tagName, "earliestCompatibleFirmware")) {
+		char const* firmware_version_string = readTagOrAttributeValue();
+		auto earliestFirmware = FirmwareVersion::parse(firmware_version_string);
+		if (earliestFirmware > FirmwareVersion::current() && !ignoreIncorrectFirmware) {
+			closeFile();
+			return Error::FILE_FIRMWARE_VERSION_TOO_NEW;
+		}
+	}
+
+	else {
+		return Error::RESULT_TAG_UNUSED;
+	}
+
+	return Error::NONE;
+}
+
+bool BinaryDeserializer::readBufferIfNecessary() {
+	if (readBufferPos < readBufferEndPos) {
+		return true;
+	}
+	if (reachedEnd) {
+		return false;
+	}
+
+	AudioEngine::logAction("readBinaryFileCluster");
+
+	FRESULT result = f_read(&file, readBuffer, kFileBufferSize, &readBufferEndPos);
+	if (result) {
+		fileAccessFailedDuring = true;
+		readBufferEndPos = 0;
+	}
+	readBufferPos = 0;
+
+	if (!readBufferEndPos) {
+		reachedEnd = true;
+		return false;
+	}
+	return true;
+}
+
+bool BinaryDeserializer::readByte(uint8_t* byte) {
+	if (!readBufferIfNecessary()) {
+		return false;
+	}
+	*byte = readBuffer[readBufferPos++];
+	return true;
+}
+
+// A varint that's too long means the file's corrupted, so we treat that as the end of it
+bool BinaryDeserializer::readVarint(uint32_t* value) {
+	uint32_t result = 0;
+	for (int32_t i = 0; i < kMaxVarintBytes; i++) {
+		uint8_t byte;
+		if (!readByte(&byte)) {
+			return false;
+		}
+		result |= (uint32_t)(byte & 0x7F) << (i * 7);
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	reachedEnd = true;
+	return false;
+}
+
+// destination may be NULL to just skip. Returns how many bytes there actually were
+int32_t BinaryDeserializer::readBytes(uint8_t* destination, int32_t numBytes) {
+	int32_t numBytesRead = 0;
+	while (numBytesRead < numBytes && readBufferIfNecessary()) {
+		int32_t numBytesNow = std::min<int32_t>(numBytes - numBytesRead, readBufferEndPos - readBufferPos);
+		if (destination) {
+			memcpy(&destination[numBytesRead], &readBuffer[readBufferPos], numBytesNow);
+		}
+		readBufferPos += numBytesNow;
+		numBytesRead += numBytesNow;
+	}
+	return numBytesRead;
+}
+
+void BinaryDeserializer::recordRead() {
+	numRecordsRead++; // Increment first, cos we don't want to call SD routine immediately when it's 0
+	if (!(numRecordsRead & 63)) {
+		doOtherRoutines(true);
+	}
+}
+
+// Returns NULL if the file's corrupted
+char const* BinaryDeserializer::readName(uint8_t header) {
+	if (header & (kHeaderNewName | kHeaderInlineName)) {
+		uint32_t length;
+		if (!readVarint(&length) || length >= kFilenameBufferSize
+		    || readBytes((uint8_t*)nameBuffer, length) != (int32_t)length) {
+			return nullptr;
+		}
+		nameBuffer[length] = 0;
+
+		if (header & kHeaderNewName) {
+			int32_t id = names->add(nameBuffer, length);
+			if (id >= 0) {
+				return names->get(id);
+			}
+		}
+		return nameBuffer;
+	}
+
+	uint32_t id;
+	if (!readVarint(&id)) {
+		return nullptr;
+	}
+	return names->get(id);
+}
+
+char const* BinaryDeserializer::readNextTagOrAttributeName() {
+
+	// If the caller didn't want the last value, get past it
+	if (valueState != ValueState::NONE) {
+		skipRestOfValue();
+	}
+
+	uint8_t header;
+	if (!readByte(&header)) {
+		return "";
+	}
+	recordRead();
+
+	lastKind = headerKind(header);
+	switch (lastKind) {
+	case RecordKind::CLOSE:
+		tagDepthFile--;
+		return "";
+
+	case RecordKind::OPEN:
+		break;
+
+	case RecordKind::ATTRIBUTE:
+	case RecordKind::TAG_VALUE:
+		valueType = headerType(header);
+		valueState = ValueState::PENDING;
+		break;
+
+	default:
+		reachedEnd = true;
+		return "";
+	}
+
+	char const* name = readName(header);
+	if (!name) {
+		reachedEnd = true;
+		valueState = ValueState::NONE;
+		return "";
+	}
+
+	tagDepthFile++;
+	tagDepthCaller++;
+	AudioEngine::logAction(name);
+	return name;
+}
+
+void BinaryDeserializer::valueDone() {
+	valueState = ValueState::NONE;
+	tagDepthFile--;
+}
+
+// Returns whether there's another byte to read in the current TEXT value
+bool BinaryDeserializer::startNextSegmentIfNecessary() {
+	while (!segmentBytesRemaining) {
+		uint32_t segmentHeader;
+		if (textEnded || !readVarint(&segmentHeader) || !segmentHeader) {
+			textEnded = true;
+			return false;
+		}
+		segmentBytesRemaining = segmentHeader >> 1;
+		segmentIsHexBytes = segmentHeader & 1;
+	}
+	return true;
+}
+
+// Gets the value ready for getNextChar(). Returns false if there's no value here - i.e. the last name was for a tag
+// with contents.
+bool BinaryDeserializer::startReadingValueAsChars() {
+	if (valueState != ValueState::PENDING) {
+		return (valueState != ValueState::NONE);
+	}
+
+	uint32_t number;
+	switch (valueType) {
+	case ValueType::INT:
+		if (!readVarint(&number)) {
+			number = 0;
+		}
+		intToString(zigzagDecode(number), valueChars);
+		break;
+
+	case ValueType::HEX: {
+		uint8_t numChars;
+		if (!readVarint(&number) || !readByte(&numChars)) {
+			number = 0;
+			numChars = 1;
+		}
+		numChars = std::clamp<uint8_t>(numChars, 1, 8);
+		valueChars[0] = '0';
+		valueChars[1] = 'x';
+		intToHex(number, &valueChars[2], numChars);
+		break;
+	}
+
+	case ValueType::TEXT:
+		valueState = ValueState::IN_TEXT;
+		segmentBytesRemaining = 0;
+		textEnded = false;
+		heldChar = 0;
+		return true;
+
+	default:
+		reachedEnd = true;
+		valueDone();
+		return false;
+	}
+
+	valueState = ValueState::IN_CHARS;
+	valueCharsPos = 0;
+	return true;
+}
+
+// Returns false at the end of the value, but leaves it to the caller to call valueDone()
+bool BinaryDeserializer::getNextChar(char* thisChar) {
+	if (valueState == ValueState::IN_CHARS) {
+		if (!valueChars[valueCharsPos]) {
+			return false;
+		}
+		*thisChar = valueChars[valueCharsPos++];
+		return true;
+	}
+
+	if (valueState != ValueState::IN_TEXT) {
+		return false;
+	}
+
+	if (heldChar) {
+		*thisChar = heldChar;
+		heldChar = 0;
+		return true;
+	}
+
+	uint8_t byte;
+	if (!startNextSegmentIfNecessary() || !readByte(&byte)) {
+		textEnded = true;
+		return false;
+	}
+	segmentBytesRemaining--;
+
+	if (segmentIsHexBytes) {
+		*thisChar = halfByteToHexChar(byte >> 4);
+		heldChar = halfByteToHexChar(byte & 15);
+	}
+	else {
+		*thisChar = byte;
+	}
+	return true;
+}
+
+void BinaryDeserializer::skipRestOfValue() {
+	switch (valueState) {
+	case ValueState::NONE:
+		return;
+
+	case ValueState::PENDING:
+		if (valueType != ValueType::TEXT) {
+			startReadingValueAsChars(); // Quickest way past an INT or HEX
+			break;
+		}
+		startReadingValueAsChars();
+		// No break
+
+	case ValueState::IN_TEXT:
+		while (startNextSegmentIfNecessary()) {
+			segmentBytesRemaining -= readBytes(nullptr, segmentBytesRemaining);
+			if (segmentBytesRemaining) {
+				break; // File ended
+			}
+		}
+		break;
+
+	case ValueState::IN_CHARS:
+		break;
+	}
+
+	if (valueState != ValueState::NONE) {
+		valueDone();
+	}
+}
+
+bool BinaryDeserializer::prepareToReadTagOrAttributeValueOneCharAtATime() {
+	return startReadingValueAsChars();
+}
+
+char BinaryDeserializer::readNextCharOfTagOrAttributeValue() {
+	char thisChar;
+	if (getNextChar(&thisChar)) {
+		return thisChar;
+	}
+	if (valueState == ValueState::IN_TEXT || valueState == ValueState::IN_CHARS) {
+		valueDone();
+	}
+	return 0;
+}
+
+int32_t BinaryDeserializer::getNumCharsRemainingInValue() {
+	switch (valueState) {
+	case ValueState::IN_CHARS:
+		return strlen(&valueChars[valueCharsPos]);
+
+	case ValueState::IN_TEXT: {
+		int32_t numChars = heldChar ? 1 : 0;
+		if (startNextSegmentIfNecessary()) {
+			numChars += segmentIsHexBytes ? (segmentBytesRemaining * 2) : segmentBytesRemaining;
+		}
+		return numChars;
+	}
+
+	default:
+		return 0;
+	}
+}
+
+// Unlike XML, a value never gets spread across two clusters' worth of buffer, so we always copy into stringBuffer
+char const* BinaryDeserializer::readNextCharsOfTagOrAttributeValue(int32_t numChars) {
+	if (valueState != ValueState::IN_TEXT && valueState != ValueState::IN_CHARS) {
+		return NULL;
+	}
+
+	for (int32_t i = 0; i < numChars; i++) {
+		if (!getNextChar(&stringBuffer[i])) {
+			valueDone();
+			return NULL;
+		}
+	}
+	recordRead();
+	return stringBuffer;
+}
+
+char const* BinaryDeserializer::readTagOrAttributeValue() {
+	if (!startReadingValueAsChars()) {
+		return "";
+	}
+
+	int32_t numChars = 0;
+	while (numChars < kFilenameBufferSize - 1 && getNextChar(&stringBuffer[numChars])) {
+		numChars++;
+	}
+	stringBuffer[numChars] = 0;
+
+	skipRestOfValue();
+	return stringBuffer;
+}
+
+int32_t BinaryDeserializer::readTagOrAttributeValueInt() {
+	if (valueState == ValueState::PENDING && valueType == ValueType::INT) {
+		uint32_t number;
+		bool success = readVarint(&number);
+		valueDone();
+		return success ? zigzagDecode(number) : 0;
+	}
+
+	// Otherwise, read it the way XML would have: digits up until anything that isn't one
+	char const* text = readTagOrAttributeValue();
+	bool isNegative = (*text == '-');
+	if (isNegative) {
+		text++;
+	}
+	uint32_t number = 0;
+	for (; *text >= '0' && *text <= '9'; text++) {
+		number = number * 10 + (*text - '0');
+	}
+
+	if (isNegative) {
+		return (number >= 2147483648) ? -2147483648 : -(int32_t)number;
+	}
+	return number;
+}
+
+int32_t BinaryDeserializer::readTagOrAttributeValueHex(int32_t errorValue) {
+	if (valueState == ValueState::PENDING && valueType == ValueType::HEX) {
+		uint32_t number;
+		uint8_t numChars;
+		bool success = readVarint(&number) && readByte(&numChars);
+		valueDone();
+		return success ? number : errorValue;
+	}
+
+	char const* string = readTagOrAttributeValue();
+	if (string[0] != '0' || string[1] != 'x') {
+		return errorValue;
+	}
+	return hexToInt(&string[2]);
+}
+
+int BinaryDeserializer::readTagOrAttributeValueHexBytes(uint8_t* bytes, int32_t maxLen) {
+	if (!startReadingValueAsChars()) {
+		return 0;
+	}
+
+	int32_t numBytesRead = 0;
+	while (numBytesRead < maxLen) {
+
+		// Where we've got stored bytes, they can just be copied
+		if (valueState == ValueState::IN_TEXT && !heldChar && startNextSegmentIfNecessary() && segmentIsHexBytes) {
+			int32_t numBytesNow = std::min(segmentBytesRemaining, maxLen - numBytesRead);
+			int32_t numBytesGot = readBytes(&bytes[numBytesRead], numBytesNow);
+			segmentBytesRemaining -= numBytesGot;
+			numBytesRead += numBytesGot;
+			if (numBytesGot < numBytesNow) {
+				break; // File ended
+			}
+			continue;
+		}
+
+		// Otherwise it's hex digits, and we stop at anything that isn't one
+		char highChar, lowChar;
+		int32_t highNibble, lowNibble;
+		if (!getNextChar(&highChar) || !hexCharToNibble(highChar, &highNibble) || !getNextChar(&lowChar)
+		    || !hexCharToNibble(lowChar, &lowNibble)) {
+			break;
+		}
+		bytes[numBytesRead++] = (highNibble << 4) | lowNibble;
+	}
+
+	skipRestOfValue();
+	return numBytesRead;
+}
+
+int BinaryDeserializer::readHexBytesUntil(uint8_t* bytes, int32_t maxLen, char endPos) {
+	return readTagOrAttributeValueHexBytes(bytes, maxLen);
+}
+
+Error BinaryDeserializer::readTagOrAttributeValueString(String* string) {
+	if (!startReadingValueAsChars()) {
+		return Error::FILE_CORRUPTED; // Same as XML, if there's no value here
+	}
+
+	string->clear();
+	int32_t stringPos = 0;
+	while (true) {
+		int32_t numChars = 0;
+		while (numChars < kFilenameBufferSize && getNextChar(&stringBuffer[numChars])) {
+			numChars++;
+		}
+		if (!numChars) {
+			break;
+		}
+
+		Error error = string->concatenateAtPos(stringBuffer, stringPos, numChars);
+		if (error != Error::NONE) {
+			skipRestOfValue();
+			return error;
+		}
+		stringPos += numChars;
+	}
+
+	skipRestOfValue();
+	return Error::NONE;
+}
+
+void BinaryDeserializer::exitTag(char const* exitTagName) {
+	// back out the file depth to one less than the caller depth
+	while (tagDepthFile >= tagDepthCaller) {
+
+		if (valueState != ValueState::NONE) {
+			skipRestOfValue();
+			continue;
+		}
+
+		uint8_t header;
+		if (!readByte(&header)) {
+			return;
+		}
+		recordRead();
+
+		switch (headerKind(header)) {
+		case RecordKind::CLOSE:
+			tagDepthFile--;
+			break;
+
+		case RecordKind::OPEN:
+			if (!readName(header)) {
+				reachedEnd = true;
+				return;
+			}
+			tagDepthFile++;
+			break;
+
+		case RecordKind::ATTRIBUTE:
+		case RecordKind::TAG_VALUE:
+			if (!readName(header)) {
+				reachedEnd = true;
+				return;
+			}
+			valueType = headerType(header);
+			valueState = ValueState::PENDING;
+			tagDepthFile++; // And skipRestOfValue() takes it back off
+			break;
+
+		default:
+			reachedEnd = true;
+			return;
+		}
+	}
+
+	// As in XMLDeserializer, the file is the authority on where we are
+	tagDepthCaller = tagDepthFile;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "storage/binary/binary_format.h"
+#include "storage/storage_manager.h"
+
+// See binary_format.h for the layout. These have their own FIL, rather than using fileSystemStuff.currentFile, so that
+// a binary file can be open at the same time as an XML one - which is what converting between the two needs.
+
+class BinarySerializer : public Serializer {
+public:
+	BinarySerializer();
+	virtual ~BinarySerializer();
+
+	/// Takes over an already-created file and writes the header. source is the XML file this is a copy of, if it is one
+	Error beginFile(FIL const& newFile, FilePointer const* source = nullptr);
+
+	void writeAttribute(char const* name, int32_t number, bool onNewLine = true) override;
+	void writeAttribute(char const* name, char const* value, bool onNewLine = true) override;
+	void writeAttributeHex(char const* name, int32_t number, int32_t numChars, bool onNewLine = true) override;
+	void writeAttributeHexBytes(char const* name, uint8_t* data, int32_t numBytes, bool onNewLine = true) override;
+
+	void writeAttributeHexBlobBegin(char const* name, bool onNewLine = true) override;
+	void writeTagHexBlobBegin(char const* tag) override;
+	void writeHexBlobBytes(uint8_t const* data, int32_t numBytes) override;
+	void writeHexBlobEnd() override;
+
+	void writeTag(char const* tag, int32_t number) override;
+	void writeTag(char const* tag, char const* contents) override;
+	void writeOpeningTag(char const* tag, bool startNewLineAfter = true) override;
+	void writeOpeningTagBeginning(char const* tag) override;
+	void writeOpeningTagEnd(bool startNewLineAfter = true) override {}
+	void closeTag() override;
+	void writeClosingTag(char const* tag, bool shouldPrintIndents = true) override;
+	void printIndents() override {}
+	void write(char const* output) override;
+
+	/// beginningString and endString are for checking XML, so are ignored here - we check the header instead
+	Error closeFileAfterWriting(char const* path = nullptr, char const* beginningString = nullptr,
+	                            char const* endString = nullptr) override;
+
+	// For copying values across from another format without knowing what they are. Begin, then add text and / or
+	// hex bytes in any order, then end.
+	void writeTextValueBegin(char const* name, bool asTag);
+	void writeTextValueChars(char const* chars, int32_t numChars);
+	void writeTextValueHexBytes(uint8_t const* data, int32_t numBytes);
+	void writeTextValueEnd();
+	void writeIntValue(char const* name, int32_t number, bool asTag);
+	void writeHexValue(char const* name, uint32_t number, int32_t numChars, bool asTag);
+
+private:
+	void writeHeader(deluge::storage::binary::RecordKind kind, deluge::storage::binary::ValueType type,
+	                 char const* name);
+	void writeVarint(uint32_t value);
+	void writeBytes(uint8_t const* data, int32_t numBytes);
+	void flushSegment();
+	void recordWritten();
+	Error writeBufferToFile();
+
+	FIL file;
+	uint8_t* writeBuffer;
+	deluge::storage::binary::NameTable* names;
+
+	int32_t writeBufferPos;
+	int32_t fileTotalBytesWritten;
+	int32_t numRecordsWritten;
+	bool fileAccessFailedDuringWrite;
+
+	// Current TEXT value's segment, not yet written
+	uint8_t segment[deluge::storage::binary::kMaxSegmentLength];
+	int32_t segmentLength;
+	bool segmentIsHexBytes;
+};
+
+class BinaryDeserializer : public Deserializer {
+public:
+	BinaryDeserializer();
+	virtual ~BinaryDeserializer();
+
+	/// Opens the file and reads through to the first tag with one of the given names, as XMLDeserializer::openXMLFile()
+	/// does. If there's an error, the file's left closed. Given a source, the file must be a copy of that XML file as it
+	/// is now, or it's FILE_NOT_FOUND.
+	Error openFile(char const* path, char const* firstTagName, char const* altTagName = "",
+	               bool ignoreIncorrectFirmware = false, FilePointer const* source = nullptr);
+	/// Also frees the buffers, which get allocated again when the next file's opened
+	void closeFile();
+
+	bool prepareToReadTagOrAttributeValueOneCharAtATime() override;
+	char readNextCharOfTagOrAttributeValue() override;
+	int32_t getNumCharsRemainingInValue() override;
+
+	int readHexBytesUntil(uint8_t* bytes, int32_t maxLen, char endPos) override;
+	char const* readNextTagOrAttributeName() override;
+	char const* readTagOrAttributeValue() override;
+	int32_t readTagOrAttributeValueInt() override;
+	int32_t readTagOrAttributeValueHex(int32_t errorValue) override;
+	int readTagOrAttributeValueHexBytes(uint8_t* bytes, int32_t maxLen) override;
+
+	char const* readNextCharsOfTagOrAttributeValue(int32_t numChars) override;
+	Error readTagOrAttributeValueString(String* string) override;
+	void exitTag(char const* exitTagName = NULL) override;
+
+	Error tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware = false) override;
+
+	/// For walking a file without knowing what's in it - what the last name from readNextTagOrAttributeName() was for
+	[[nodiscard]] deluge::storage::binary::RecordKind getKindOfLastName() const { return lastKind; }
+
+	bool fileAccessFailedDuring;
+
+private:
+	enum class ValueState : uint8_t {
+		NONE,    // Not at a value
+		PENDING, // Got the name, nothing of the value read yet
+		IN_TEXT, // Partway through a TEXT value
+		IN_CHARS // Partway through an INT or HEX, which has been rendered into valueChars
+	};
+
+	bool readByte(uint8_t* byte);
+	bool readVarint(uint32_t* value);
+	int32_t readBytes(uint8_t* destination, int32_t numBytes);
+	bool readBufferIfNecessary();
+	void recordRead();
+
+	char const* readName(uint8_t header);
+	bool startReadingValueAsChars();
+	bool getNextChar(char* thisChar);
+	bool startNextSegmentIfNecessary();
+	void skipRestOfValue();
+	void valueDone();
+
+	FIL file;
+	uint8_t* readBuffer;
+	deluge::storage::binary::NameTable* names;
+
+	UINT readBufferEndPos;
+	int32_t readBufferPos;
+	bool reachedEnd;
+	int32_t numRecordsRead;
+
+	int32_t tagDepthCaller; // Same meanings as in XMLDeserializer
+	int32_t tagDepthFile;
+
+	deluge::storage::binary::RecordKind lastKind;
+	deluge::storage::binary::ValueType valueType;
+	ValueState valueState;
+
+	// For IN_TEXT
+	int32_t segmentBytesRemaining;
+	bool segmentIsHexBytes;
+	bool textEnded;
+	char heldChar; // Second hex digit of a byte we've given out the first digit of, or 0
+
+	// For IN_CHARS
+	char valueChars[12];
+	int32_t valueCharsPos;
+
+	char nameBuffer[kFilenameBufferSize]; // For names that didn't get interned
+	char stringBuffer[kFilenameBufferSize];
+};
@@ -17,6 +17,7 @@
 
 #include "storage/cluster/cluster.h"
 #include "definitions_cxx.hpp"
+#include "dsp/convert/sample_format.h"
 #include "model/sample/sample.h"
 #include "model/sample/sample_cache.h"
 #include "processing/engines/audio_engine.h"
@@ -80,18 +81,15 @@ void Cluster::convertDataIfNecessary() {
 				endPos = &data[audioFileManager.clusterSize - 2];
 			}
 
-			while (true) {
+			while (pos < endPos) {
 				char const* endPosNow = pos + 1024; // Every this many bytes, we'll pause and do an audio routine
 				if (endPosNow > endPos) {
 					endPosNow = endPos;
 				}
 
-				while (pos < endPosNow) {
-					uint8_t temp = pos[0];
-					pos[0] = pos[2];
-					pos[2] = temp;
-					pos += 3;
-				}
+				int32_t numSamplesNow = (endPosNow - pos + 2) / 3;
+				deluge::dsp::convert::swapBytes24((uint8_t*)pos, numSamplesNow);
+				pos += numSamplesNow * 3;
 
 				if (pos >= endPos) {
 					break;
@@ -125,14 +123,23 @@ void Cluster::convertDataIfNecessary() {
 
 			// uint16_t startTime = MTU2.TCNT_0;
 
-			for (; pos < endPos; pos++) {
+			while (pos < endPos) {
+				// Do an audio routine each time we reach a 1024-byte boundary
+				int32_t* endPosNow = (int32_t*)(((uintptr_t)pos + 1024) & ~(uintptr_t)0b1111111111);
+				if (endPosNow > endPos) {
+					endPosNow = endPos;
+				}
+
+				int32_t numWordsNow = ((char*)endPosNow - (char*)pos + 3) >> 2;
+				sample->convertData(pos, numWordsNow);
+				pos += numWordsNow;
 
-				if (!((uint32_t)pos & 0b1111111100)) {
-					AudioEngine::logAction("from convert-data");
-					AudioEngine::routine(); // ----------------------------------------------------
+				if (pos >= endPos) {
+					break;
 				}
 
-				sample->convertOneData(pos);
+				AudioEngine::logAction("from convert-data");
+				AudioEngine::routine(); // ----------------------------------------------------
 			}
 
 			/*
@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "memory/stealable.h"
+#include "util/container/heap/intrusive_pairing_heap.hpp"
 #include <cstdint>
 
 class Sample;
@@ -46,6 +47,9 @@ public:
 	char firstThreeBytesPreDataConversion[3];
 	bool loaded;
 
+	/// Links this Cluster into AudioFileManager::loadingQueue while it's waiting to be loaded
+	deluge::PairingHeapNode<Cluster> loadingQueueNode{this};
+
 	char dummy[CACHE_LINE_SIZE];
 
 	char data[CACHE_LINE_SIZE];
@@ -16,56 +16,65 @@
  */
 
 #include "storage/cluster/cluster_priority_queue.h"
-#include "definitions_cxx.hpp"
+#include "storage/cluster/cluster.h"
 
-class Cluster;
+// Can't actually fail, since the node lives in the Cluster, but callers are used to checking
+Error ClusterPriorityQueue::add(Cluster* cluster, uint32_t priorityRating) {
+	if (heap.contains(&cluster->loadingQueueNode)) {
+		updatePriority(cluster, priorityRating);
+		return Error::NONE;
+	}
 
-ClusterPriorityQueue::ClusterPriorityQueue()
-    : OrderedResizeableArrayWith32bitKey(sizeof(PriorityQueueElement), 32, 31) {
+	heap.insert(&cluster->loadingQueueNode, priorityRating);
+	if (priorityRating == kClusterLowestPriority) {
+		numLowestPriority++;
+	}
+	return Error::NONE;
 }
 
-// Returns error
-Error ClusterPriorityQueue::add(Cluster* cluster, uint32_t priorityRating) {
-	int32_t i = insertAtKey((int32_t)cluster);
-	if (i == -1) {
-		return Error::INSUFFICIENT_RAM;
+// Cluster must already be in the queue
+void ClusterPriorityQueue::updatePriority(Cluster* cluster, uint32_t priorityRating) {
+	forgetRating(cluster->loadingQueueNode.key);
+	heap.updateKey(&cluster->loadingQueueNode, priorityRating);
+	if (priorityRating == kClusterLowestPriority) {
+		numLowestPriority++;
 	}
+}
 
-	PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
-	element->priorityRating = priorityRating;
-	element->cluster = cluster;
-	return Error::NONE;
+bool ClusterPriorityQueue::raisePriorityIfPresent(Cluster* cluster, uint32_t priorityRating) {
+	if (!heap.contains(&cluster->loadingQueueNode)) {
+		return false;
+	}
+	if (priorityRating < cluster->loadingQueueNode.key) {
+		updatePriority(cluster, priorityRating);
+	}
+	return true;
 }
 
 Cluster* ClusterPriorityQueue::grabHead() {
-	if (!numElements) {
+	deluge::PairingHeapNode<Cluster>* node = heap.pop();
+	if (!node) {
 		return NULL;
 	}
-	Cluster* toReturn = ((PriorityQueueElement*)getElementAddress(0))->cluster;
-	deleteAtIndex(0);
-	return toReturn;
+	forgetRating(node->key);
+	return node->owner;
 }
 
 // Returns whether it was present
 bool ClusterPriorityQueue::removeIfPresent(Cluster* cluster) {
-	for (int32_t i = 0; i < numElements; i++) {
-		PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
-		if (element->cluster == cluster) {
-			deleteAtIndex(i);
-			return true;
-		}
+	if (!heap.remove(&cluster->loadingQueueNode)) {
+		return false;
 	}
+	forgetRating(cluster->loadingQueueNode.key);
+	return true;
+}
 
-	return false;
+bool ClusterPriorityQueue::checkPresent(Cluster* cluster) const {
+	return heap.contains(&cluster->loadingQueueNode);
 }
 
-bool ClusterPriorityQueue::checkPresent(Cluster* cluster) {
-	for (int32_t i = 0; i < numElements; i++) {
-		PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
-		if (element->cluster == cluster) {
-			return true;
-		}
+void ClusterPriorityQueue::forgetRating(uint32_t priorityRating) {
+	if (priorityRating == kClusterLowestPriority) {
+		numLowestPriority--;
 	}
-
-	return false;
 }
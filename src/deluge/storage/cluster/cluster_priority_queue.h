@@ -17,21 +17,39 @@
 
 #pragma once
 
-#include "util/container/array/ordered_resizeable_array.h"
+#include "definitions_cxx.hpp"
+#include "util/container/heap/intrusive_pairing_heap.hpp"
 
 class Cluster;
 
-struct PriorityQueueElement {
-	uint32_t priorityRating;
-	Cluster* cluster;
-};
+/// The priorityRating Clusters get when nothing's in a hurry for them - e.g. when loading a song
+constexpr uint32_t kClusterLowestPriority = 0xFFFFFFFF;
+
+/// The most urgent priorityRating ClusterPrefetcher gives - behind any Voice's (see Voice::getPriorityRating()), but
+/// ahead of kClusterLowestPriority
+constexpr uint32_t kClusterPrefetchPriority = 0xFE000000;
 
-class ClusterPriorityQueue final : public OrderedResizeableArrayWith32bitKey {
+/// Clusters waiting to be loaded from the card, most urgent (lowest priorityRating) first. Each Cluster carries its own
+/// node, so there's no allocation and finding a Cluster in the queue doesn't need a search.
+class ClusterPriorityQueue final {
 public:
-	ClusterPriorityQueue();
+	ClusterPriorityQueue() = default;
 
+	/// If the Cluster's already queued, it just gets its priorityRating changed
 	Error add(Cluster* cluster, uint32_t priorityRating);
+	void updatePriority(Cluster* cluster, uint32_t priorityRating);
+	/// Only ever makes a queued Cluster more urgent. Returns whether it was present
+	bool raisePriorityIfPresent(Cluster* cluster, uint32_t priorityRating);
 	Cluster* grabHead();
 	bool removeIfPresent(Cluster* cluster);
-	bool checkPresent(Cluster* cluster);
+	bool checkPresent(Cluster* cluster) const;
+
+	[[nodiscard]] int32_t getNumElements() const { return heap.size(); }
+	[[nodiscard]] bool hasAnyLowestPriorityElements() const { return numLowestPriority != 0; }
+
+private:
+	void forgetRating(uint32_t priorityRating);
+
+	deluge::IntrusivePairingHeap<Cluster> heap;
+	int32_t numLowestPriority = 0;
 };
@@ -0,0 +1,39 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+/// What AudioFileManager::loadClusterRun() does with a run of Clusters when the card read for it fails. Each one has
+/// had a reason to be loaded added for the read, which comes off again here. The Clusters after the first go back in
+/// the queue with the priority they had, and that has to happen before their reason comes off. If it was a Cluster's
+/// last reason, removeReason() then finds it in the queue and deallocates it, as for any other queued Cluster that's
+/// no longer wanted. Otherwise it would get filed away as stealable with nothing loaded into it. The first Cluster is
+/// left to the caller, as when a single Cluster fails to load.
+///
+/// A template so it can be tested without the rest of AudioFileManager.
+template <typename ClusterT, typename Queue, typename RemoveReason>
+void abandonClusterRun(std::span<ClusterT*> run, Queue& queue, RemoveReason&& removeReason) {
+	for (size_t i = 0; i < run.size(); i++) {
+		if (i) {
+			queue.add(run[i], run[i]->loadingQueueNode.key);
+		}
+		removeReason(run[i]);
+	}
+}
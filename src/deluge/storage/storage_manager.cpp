@@ -30,6 +30,7 @@
 #include "model/instrument/cv_instrument.h"
 #include "model/instrument/kit.h"
 #include "model/instrument/midi_instrument.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "modulation/midi/midi_param.h"
 #include "modulation/midi/midi_param_collection.h"
@@ -37,6 +38,8 @@
 #include "processing/sound/sound_drum.h"
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/binary/binary_conversion.h"
+#include "storage/binary/binary_serializer.h"
 #include "util/firmware_version.h"
 #include "util/functions.h"
 #include "util/try.h"
@@ -56,10 +59,26 @@ void routineForSD(void);
 }
 
 StorageManager storageManager{};
+
+namespace {
+
+// Reads binary copies of songs, so it has to outlive the load - things that finish it off go by its firmware_version
+BinaryDeserializer binarySongReader;
+
+Error getBinaryCopyPath(String* copyPath, char const* filePath) {
+	Error error = copyPath->set(filePath);
+	if (error != Error::NONE) {
+		return error;
+	}
+	return copyPath->concatenate(".bin");
+}
+
+} // namespace
 FILINFO staticFNO;
 DIR staticDIR;
 XMLSerializer smSerializer;
 XMLDeserializer smDeserializer;
+Deserializer* activeDeserializer = &smDeserializer;
 
 char charAtEndOfValue;
 
@@ -191,6 +210,21 @@ Error StorageManager::createXMLFile(char const* filePath, XMLSerializer& writer,
 	return Error::NONE;
 }
 
+Error StorageManager::createBinaryFile(char const* filePath, BinarySerializer& writer, bool mayOverwrite,
+                                       bool displayErrors, FilePointer const* source) {
+
+	auto created = createFile(filePath, mayOverwrite);
+	if (!created) {
+		if (displayErrors) {
+			display->removeWorkingAnimation();
+			display->displayError(created.error());
+		}
+		return created.error();
+	}
+
+	return writer.beginFile(created.value().inner(), source);
+}
+
 bool StorageManager::fileExists(char const* pathName) {
 	Error error = initSD();
 	if (error != Error::NONE) {
@@ -366,7 +400,7 @@ deleteInstrumentAndGetOut:
 
 		// Prior to V2.0 (or was it only in V1.0 on the 40-pad?) Kits didn't have anything that would have caused the
 		// paramManager to be created when we read the Kit just now. So, just make one.
-		if (smDeserializer.firmware_version < FirmwareVersion::official({2, 2, 0, "beta"})
+		if (activeDeserializer->firmware_version < FirmwareVersion::official({2, 2, 0, "beta"})
 		    && outputType == OutputType::KIT) {
 			ParamManagerForTimeline paramManager;
 			error = paramManager.setupUnpatched();
@@ -589,7 +623,16 @@ void Serializer::writeFirmwareVersion() {
 	writeAttribute("firmwareVersion", kFirmwareVersionStringShort);
 }
 
-XMLSerializer::XMLSerializer() : fileWriteBufferCurrentPos(0), ms(NULL) {
+void Serializer::writeHexBlobInt(uint32_t number, int32_t numBytes) {
+	uint8_t bytes[4];
+	for (int32_t i = numBytes - 1; i >= 0; i--) {
+		bytes[i] = number & 0xFF;
+		number >>= 8;
+	}
+	writeHexBlobBytes(bytes, numBytes);
+}
+
+XMLSerializer::XMLSerializer() : fileWriteBufferCurrentPos(0), ms(NULL), hexBlobTag(nullptr) {
 	void* temp = GeneralMemoryAllocator::get().allocLowSpeed(32768 + CACHE_LINE_SIZE * 2);
 	writeClusterBuffer = (char*)temp + CACHE_LINE_SIZE;
 }
@@ -695,6 +738,47 @@ void XMLSerializer::writeAttributeHexBytes(char const* name, uint8_t* data, int3
 	write("\"");
 }
 
+void XMLSerializer::writeAttributeHexBlobBegin(char const* name, bool onNewLine) {
+	if (onNewLine) {
+		write("\n");
+		printIndents();
+	}
+	else {
+		write(" ");
+	}
+	write(name);
+	write("=\"0x");
+	hexBlobTag = nullptr;
+}
+
+void XMLSerializer::writeTagHexBlobBegin(char const* tag) {
+	printIndents();
+	write("<");
+	write(tag);
+	write(">0x");
+	hexBlobTag = tag;
+}
+
+void XMLSerializer::writeHexBlobBytes(uint8_t const* data, int32_t numBytes) {
+	char buffer[3];
+	for (int32_t i = 0; i < numBytes; i++) {
+		byteToHex(data[i], buffer);
+		write(buffer);
+	}
+}
+
+void XMLSerializer::writeHexBlobEnd() {
+	if (hexBlobTag) {
+		write("</");
+		write(hexBlobTag);
+		write(">\n");
+		hexBlobTag = nullptr;
+	}
+	else {
+		write("\"");
+	}
+}
+
 void XMLSerializer::writeAttribute(char const* name, char const* value, bool onNewLine) {
 
 	if (onNewLine) {
@@ -1682,6 +1766,46 @@ void XMLDeserializer::exitTag(char const* exitTagName) {
 	tagDepthCaller = tagDepthFile;
 }
 
+XMLDeserializer::NameKind XMLDeserializer::getKindOfLastName() {
+	// "/>" straight after the name has already taken the file back out of the tag
+	if (tagDepthFile < tagDepthCaller) {
+		return NameKind::EMPTY_TAG;
+	}
+
+	switch (xmlArea) {
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return NameKind::ATTRIBUTE;
+
+	case BETWEEN_TAGS:
+		// Whitespace before a '<' is just formatting, so it doesn't matter that we skip it. Text never starts with any,
+		// as we write it.
+		while (true) {
+			readXMLFileClusterIfNecessary();
+			if (xmlReachedEnd) {
+				return NameKind::TAG_CONTENTS;
+			}
+			switch (fileClusterBuffer[fileReadBufferCurrentPos]) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				fileReadBufferCurrentPos++;
+				break;
+
+			case '<':
+				return NameKind::TAG_CONTENTS;
+
+			default:
+				return NameKind::TAG_VALUE;
+			}
+		}
+
+	default:
+		return NameKind::TAG_CONTENTS;
+	}
+}
+
 Error StorageManager::openXMLFile(FilePointer* filePointer, XMLDeserializer& reader, char const* firstTagName,
                                   char const* altTagName, bool ignoreIncorrectFirmware) {
 
@@ -1689,6 +1813,7 @@ Error StorageManager::openXMLFile(FilePointer* filePointer, XMLDeserializer& rea
 
 	// Prep to read first Cluster shortly
 	reader.msd = this;
+	activeDeserializer = &reader;
 	Error err = reader.openXMLFile(filePointer, firstTagName, altTagName, ignoreIncorrectFirmware);
 	if (err == Error::NONE)
 		return Error::NONE;
@@ -1697,6 +1822,59 @@ Error StorageManager::openXMLFile(FilePointer* filePointer, XMLDeserializer& rea
 	return Error::FILE_CORRUPTED;
 }
 
+Error StorageManager::openBinaryFile(char const* filePath, BinaryDeserializer& reader, char const* firstTagName,
+                                     char const* altTagName, bool ignoreIncorrectFirmware, FilePointer const* source) {
+
+	AudioEngine::logAction("openBinaryFile");
+
+	Error error = initSD();
+	if (error != Error::NONE) {
+		return error;
+	}
+	return reader.openFile(filePath, firstTagName, altTagName, ignoreIncorrectFirmware, source);
+}
+
+Error StorageManager::openSongFile(FilePointer* filePointer, char const* filePath, Deserializer** getReader) {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::BinarySongCopies) == RuntimeFeatureStateToggle::On) {
+		String copyPath;
+		if (getBinaryCopyPath(&copyPath, filePath) == Error::NONE
+		    && openBinaryFile(copyPath.get(), binarySongReader, "song", "", false, filePointer) == Error::NONE) {
+			activeDeserializer = &binarySongReader;
+			*getReader = &binarySongReader;
+			return Error::NONE;
+		}
+	}
+
+	// No copy, or not one of the song as it is now
+	*getReader = &smDeserializer;
+	return openXMLFile(filePointer, smDeserializer, "song");
+}
+
+bool StorageManager::closeSongFile(Deserializer& reader) {
+	if (&reader == &binarySongReader) {
+		binarySongReader.closeFile();
+		return !binarySongReader.fileAccessFailedDuring;
+	}
+	return closeFile();
+}
+
+void StorageManager::writeBinaryCopyOfSong(char const* filePath) {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::BinarySongCopies) != RuntimeFeatureStateToggle::On) {
+		return; // Any old copy won't match the song now, so it'll just not get used
+	}
+
+	String copyPath;
+	if (getBinaryCopyPath(&copyPath, filePath) != Error::NONE) {
+		return;
+	}
+
+	AudioEngine::logAction("writeBinaryCopyOfSong");
+	Error error = convertXMLFileToBinary(filePath, copyPath.get(), "song", true);
+	if (error != Error::NONE) {
+		f_unlink(copyPath.get()); // Don't leave part of one behind
+	}
+}
+
 Error XMLDeserializer::openXMLFile(FilePointer* filePointer, char const* firstTagName, char const* altTagName,
                                    bool ignoreIncorrectFirmware) {
 
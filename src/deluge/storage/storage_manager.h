@@ -61,6 +61,17 @@ public:
 	virtual void writeAttributeHex(char const* name, int32_t number, int32_t numChars, bool onNewLine = true) = 0;
 	virtual void writeAttributeHexBytes(char const* name, uint8_t* data, int32_t numBytes, bool onNewLine = true) = 0;
 
+	/// For long "0x..." values - note data, automation and the like. XML gets the hex just as it always has, while a
+	/// binary file stores the bytes themselves. Call writeHexBlobBytes() as many times as needed, then
+	/// writeHexBlobEnd().
+	virtual void writeAttributeHexBlobBegin(char const* name, bool onNewLine = true) = 0;
+	virtual void writeTagHexBlobBegin(char const* tag) = 0;
+	virtual void writeHexBlobBytes(uint8_t const* data, int32_t numBytes) = 0;
+	virtual void writeHexBlobEnd() = 0;
+
+	/// Big-endian, so it reads as hex the same way intToHex() would have written it
+	void writeHexBlobInt(uint32_t number, int32_t numBytes = 4);
+
 	virtual void writeTag(char const* tag, int32_t number) = 0;
 	virtual void writeTag(char const* tag, char const* contents) = 0;
 	virtual void writeOpeningTag(char const* tag, bool startNewLineAfter = true) = 0;
@@ -96,6 +107,11 @@ public:
 	void writeAttributeHex(char const* name, int32_t number, int32_t numChars, bool onNewLine = true) override;
 	void writeAttributeHexBytes(char const* name, uint8_t* data, int32_t numBytes, bool onNewLine = true);
 
+	void writeAttributeHexBlobBegin(char const* name, bool onNewLine = true) override;
+	void writeTagHexBlobBegin(char const* tag) override;
+	void writeHexBlobBytes(uint8_t const* data, int32_t numBytes) override;
+	void writeHexBlobEnd() override;
+
 	void writeTag(char const* tag, int32_t number) override;
 	void writeTag(char const* tag, char const* contents) override;
 	void writeOpeningTag(char const* tag, bool startNewLineAfter = true) override;
@@ -115,6 +131,7 @@ public:
 	int32_t fileWriteBufferCurrentPos;
 	int32_t fileTotalBytesWritten;
 	bool fileAccessFailedDuringWrite;
+	char const* hexBlobTag; // nullptr if the current hex blob is an attribute
 
 	Error writeXMLBufferToFile();
 	Error closeFileAfterWriting(char const* path = nullptr, char const* beginningString = nullptr,
@@ -137,6 +154,11 @@ public:
 	virtual char const* readNextCharsOfTagOrAttributeValue(int32_t numChars) = 0;
 	virtual Error readTagOrAttributeValueString(String* string) = 0;
 	virtual void exitTag(char const* exitTagName = NULL) = 0;
+
+	virtual Error tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware = false) = 0;
+
+	/// Of the file being read, as its firmwareVersion tag said
+	FirmwareVersion firmware_version = FirmwareVersion::current();
 };
 
 class XMLDeserializer : public Deserializer {
@@ -162,6 +184,15 @@ public:
 	Error openXMLFile(FilePointer* filePointer, char const* firstTagName, char const* altTagName = "",
 	                  bool ignoreIncorrectFirmware = false);
 
+	enum class NameKind : uint8_t {
+		ATTRIBUTE,
+		TAG_VALUE,    // A tag with just text in it
+		TAG_CONTENTS, // A tag with attributes or tags in it, or nothing at all
+		EMPTY_TAG,    // A tag written as <name/>, which is already closed
+	};
+	/// For walking a file without knowing what's in it. Call straight after readNextTagOrAttributeName().
+	NameKind getKindOfLastName();
+
 	StorageManager* msd;
 
 public:
@@ -179,8 +210,7 @@ public:
 
 	char stringBuffer[kFilenameBufferSize];
 
-	FirmwareVersion firmware_version = FirmwareVersion::current();
-	Error tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware = false);
+	Error tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware = false) override;
 
 	void skipUntilChar(char endChar);
 	uint32_t readCharXML(char* thisChar);
@@ -204,6 +234,13 @@ public:
 extern XMLSerializer smSerializer;
 extern XMLDeserializer smDeserializer;
 
+/// Whichever Deserializer last opened a song or preset to load - smDeserializer, or a BinaryDeserializer reading a
+/// binary copy. Anything that finishes off a load once the file's been read goes by its firmware_version.
+extern Deserializer* activeDeserializer;
+
+class BinarySerializer;
+class BinaryDeserializer;
+
 class StorageManager {
 public:
 	StorageManager();
@@ -214,6 +251,20 @@ public:
 	                    bool displayErrors = true);
 	Error openXMLFile(FilePointer* filePointer, XMLDeserializer& reader, char const* firstTagName,
 	                  char const* altTagName = "", bool ignoreIncorrectFirmware = false);
+	Error createBinaryFile(char const* pathName, BinarySerializer& writer, bool mayOverwrite = false,
+	                       bool displayErrors = true, FilePointer const* source = nullptr);
+	Error openBinaryFile(char const* pathName, BinaryDeserializer& reader, char const* firstTagName,
+	                     char const* altTagName = "", bool ignoreIncorrectFirmware = false,
+	                     FilePointer const* source = nullptr);
+
+	// With the Binary Song Copies community feature on, each song saved gets a copy in the binary format next to it,
+	// at its path plus ".bin", which loads much quicker. It only gets used while it's still a copy of the XML as it is.
+	/// Opens the song to be loaded - through its binary copy if it's got one, and otherwise the XML - and sets getReader
+	/// to whichever Deserializer to read it with. Afterwards, closeSongFile() must be given that.
+	Error openSongFile(FilePointer* filePointer, char const* filePath, Deserializer** getReader);
+	bool closeSongFile(Deserializer& reader);
+	/// After a song's saved to filePath, makes its binary copy, if they're turned on
+	void writeBinaryCopyOfSong(char const* filePath);
 
 	Error initSD();
 	bool closeFile();
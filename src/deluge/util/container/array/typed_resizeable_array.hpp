@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/container/array/ordered_resizeable_array.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace deluge::container {
+
+/// Typed front-end for ::ResizeableArray (or any of its subclasses, given as Base). Storage, growth and memory
+/// stealing are all still done by the type-erased base - this just gives element access with the element size known at
+/// compile time, so the hot paths don't need a multiply by a runtime elementSize, and can walk the elements as plain
+/// contiguous runs instead of re-wrapping every index.
+///
+/// The elements are still moved around with memmove, so T must be trivially relocatable - which everything kept in
+/// these arrays already was.
+template <typename T, typename Base = ::ResizeableArray>
+class ResizeableArray : public Base {
+public:
+	/// Any further arguments go to Base's constructor, after the element size
+	template <typename... Args>
+	explicit ResizeableArray(Args... args) : Base(sizeof(T), args...) {}
+
+	[[gnu::always_inline]] inline T& operator[](int32_t index) {
+		int32_t absoluteIndex = index + this->memoryStart;
+		if (absoluteIndex >= this->memorySize) {
+			absoluteIndex -= this->memorySize;
+		}
+		return static_cast<T*>(this->memory)[absoluteIndex];
+	}
+
+	/// Returns nullptr if out of range
+	[[gnu::always_inline]] inline T* getElement(int32_t index) {
+		if (index < 0 || index >= this->numElements) {
+			return nullptr;
+		}
+		return &(*this)[index];
+	}
+
+	inline T* getFirst() { return getElement(0); }
+	inline T* getLast() { return getElement(this->numElements - 1); }
+
+	/// Whether the elements currently sit in one run, not wrapping round the end of the memory
+	[[nodiscard]] inline bool isContiguous() const { return this->memoryStart + this->numElements <= this->memorySize; }
+
+	/// The elements in order, as up to two contiguous runs. The second is empty unless the storage currently wraps.
+	/// Only valid until the array is next modified.
+	inline std::array<std::span<T>, 2> getRuns() {
+		T* elements = static_cast<T*>(this->memory);
+		int32_t numBeforeWrap = this->memorySize - this->memoryStart;
+		if (this->numElements <= numBeforeWrap) {
+			return {std::span<T>(elements + this->memoryStart, this->numElements), std::span<T>()};
+		}
+		return {std::span<T>(elements + this->memoryStart, numBeforeWrap),
+		        std::span<T>(elements, this->numElements - numBeforeWrap)};
+	}
+
+	/// Calls function on each element, in order. The array mustn't be modified meanwhile.
+	template <typename F>
+	inline void forEach(F function) {
+		for (std::span<T> run : getRuns()) {
+			for (T& element : run) {
+				function(element);
+			}
+		}
+	}
+};
+
+/// Typed front-end for ::OrderedResizeableArrayWith32bitKey. As there, the key must be the first member of T, and
+/// 32 bits. The searches here shadow the base's (they don't override), doing their comparisons on typed elements, and
+/// straight on the memory when it doesn't wrap. Everything else - searchDual(), searchMultiple(), shiftHorizontal() and
+/// so on - is still the base's, and sees the same elements.
+template <typename T, typename Key = int32_t, typename Base = ::OrderedResizeableArrayWith32bitKey>
+class OrderedResizeableArray : public ResizeableArray<T, Base> {
+	static_assert(std::is_integral_v<Key> && sizeof(Key) == sizeof(int32_t), "Key must be a 32-bit integer");
+
+public:
+	using ResizeableArray<T, Base>::ResizeableArray;
+
+	[[gnu::always_inline]] static inline Key getKey(T const& element) {
+		return *reinterpret_cast<Key const*>(&element);
+	}
+	[[gnu::always_inline]] static inline void setKey(T& element, Key key) { *reinterpret_cast<Key*>(&element) = key; }
+
+	inline Key getKeyAtIndex(int32_t i) { return getKey((*this)[i]); }
+	inline void setKeyAtIndex(Key key, int32_t i) { setKey((*this)[i], key); }
+
+	/// Same results as ::OrderedResizeableArray::search()
+	int32_t search(Key key, int32_t comparison, int32_t rangeBegin, int32_t rangeEnd) {
+		if (this->isContiguous()) {
+			T const* __restrict__ elements = static_cast<T const*>(this->memory) + this->memoryStart;
+			while (rangeBegin != rangeEnd) {
+				int32_t proposedIndex = (rangeBegin + rangeEnd) >> 1;
+				if (getKey(elements[proposedIndex]) < key) {
+					rangeBegin = proposedIndex + 1;
+				}
+				else {
+					rangeEnd = proposedIndex;
+				}
+			}
+		}
+		else {
+			while (rangeBegin != rangeEnd) {
+				int32_t proposedIndex = (rangeBegin + rangeEnd) >> 1;
+				if (getKeyAtIndex(proposedIndex) < key) {
+					rangeBegin = proposedIndex + 1;
+				}
+				else {
+					rangeEnd = proposedIndex;
+				}
+			}
+		}
+		return rangeBegin + comparison;
+	}
+	inline int32_t search(Key key, int32_t comparison, int32_t rangeBegin = 0) {
+		return search(key, comparison, rangeBegin, this->numElements);
+	}
+
+	/// Returns -1 if not found
+	int32_t searchExact(Key key) {
+		int32_t i = search(key, GREATER_OR_EQUAL);
+		if (i < this->numElements && getKeyAtIndex(i) == key) {
+			return i;
+		}
+		return -1;
+	}
+
+	/// Returns -1 if couldn't allocate
+	int32_t insertAtKey(Key key, bool isDefinitelyLast = false) {
+		int32_t i = isDefinitelyLast ? this->numElements : search(key, GREATER_OR_EQUAL);
+		if (this->insertAtIndex(i) != Error::NONE) {
+			return -1;
+		}
+		setKeyAtIndex(key, i);
+		return i;
+	}
+
+	void deleteAtKey(Key key) {
+		int32_t i = searchExact(key);
+		if (i != -1) {
+			this->deleteAtIndex(i);
+		}
+	}
+};
+
+} // namespace deluge::container
@@ -62,6 +62,14 @@ void OpenAddressingHashTable::empty(bool destructing) {
 	}
 }
 
+// Removes every element but keeps the memory, so putting as many back again won't have to allocate
+void OpenAddressingHashTable::clear() {
+	if (memory) {
+		memset(memory, 0xFF, numBuckets * elementSize);
+	}
+	numElements = 0;
+}
+
 // See these pages for good hash functions
 // https://stackoverflow.com/questions/664014/what-integer-hash-function-are-good-that-accepts-an-integer-hash-key
 // http://www.azillionmonkeys.com/qed/hash.html
@@ -329,8 +337,8 @@ bool OpenAddressingHashTable::remove(uint32_t key) {
 }
 
 // 32-bit key
-OpenAddressingHashTableWith32bitKey::OpenAddressingHashTableWith32bitKey() {
-	elementSize = sizeof(uint32_t);
+OpenAddressingHashTableWith32bitKey::OpenAddressingHashTableWith32bitKey(int32_t valueSize) {
+	elementSize = sizeof(uint32_t) + valueSize;
 }
 
 uint32_t OpenAddressingHashTableWith32bitKey::getKeyFromAddress(void* address) {
@@ -33,6 +33,7 @@ public:
 	void* lookup(uint32_t key);
 	bool remove(uint32_t key);
 	void empty(bool destructing = false);
+	void clear();
 
 	void* memory;
 	int32_t numBuckets;
@@ -49,7 +50,8 @@ public:
 
 class OpenAddressingHashTableWith32bitKey final : public OpenAddressingHashTable {
 public:
-	OpenAddressingHashTableWith32bitKey();
+	// Each key can have valueSize bytes stored after it, in the bucket that insert() and lookup() return
+	explicit OpenAddressingHashTableWith32bitKey(int32_t valueSize = 0);
 	uint32_t getKeyFromAddress(void* address);
 	void setKeyAtAddress(uint32_t key, void* address);
 	bool doesKeyIndicateEmptyBucket(uint32_t key);
@@ -0,0 +1,227 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace deluge {
+
+template <typename T>
+class PairingHeapBase;
+
+/// Embed one of these in any object that wants to live in an IntrusivePairingHeap. The heap never allocates - all the
+/// links live here - so insertion can't fail, which is what we want for things touched from the audio routine.
+template <typename T>
+struct PairingHeapNode {
+	explicit PairingHeapNode(T* owner) : owner(owner) {}
+	PairingHeapNode(const PairingHeapNode&) = delete;
+	PairingHeapNode& operator=(const PairingHeapNode&) = delete;
+
+	T* const owner;
+	uint32_t key = 0;
+
+	/// The heap this node is currently in, or nullptr. Gives O(1) contains().
+	PairingHeapBase<T>* heap = nullptr;
+
+private:
+	friend class PairingHeapBase<T>;
+
+	PairingHeapNode* child = nullptr;
+	PairingHeapNode* sibling = nullptr;
+	/// For a leftmost child this is its parent, otherwise its left sibling. nullptr for the root.
+	PairingHeapNode* prev = nullptr;
+};
+
+/// Untyped-comparison part of the heap, so that nodes can point back at whichever heap they're in.
+template <typename T>
+class PairingHeapBase {
+public:
+	using Node = PairingHeapNode<T>;
+
+	[[nodiscard]] bool empty() const { return root_ == nullptr; }
+	[[nodiscard]] int32_t size() const { return size_; }
+	[[nodiscard]] bool contains(const Node* node) const { return node->heap == this; }
+
+	/// The node which compares "first", or nullptr if empty
+	[[nodiscard]] Node* top() const { return root_; }
+
+protected:
+	PairingHeapBase() = default;
+	PairingHeapBase(const PairingHeapBase&) = delete;
+	PairingHeapBase& operator=(const PairingHeapBase&) = delete;
+
+	static void resetLinks(Node* node) {
+		node->child = nullptr;
+		node->sibling = nullptr;
+		node->prev = nullptr;
+	}
+
+	/// Cuts a non-root node (along with its subtree) out of the tree
+	static void detach(Node* node) {
+		if (node->prev->child == node) {
+			node->prev->child = node->sibling;
+		}
+		else {
+			node->prev->sibling = node->sibling;
+		}
+		if (node->sibling) {
+			node->sibling->prev = node->prev;
+		}
+		node->sibling = nullptr;
+		node->prev = nullptr;
+	}
+
+	/// Links two roots, returning the new one. `comesFirst(a, b)` says whether a belongs above b.
+	template <typename Compare>
+	static Node* meld(Node* a, Node* b, Compare comesFirst) {
+		if (!a) {
+			return b;
+		}
+		if (!b) {
+			return a;
+		}
+		if (comesFirst(b->key, a->key)) {
+			Node* temp = a;
+			a = b;
+			b = temp;
+		}
+		b->sibling = a->child;
+		if (a->child) {
+			a->child->prev = b;
+		}
+		b->prev = a;
+		a->child = b;
+		return a;
+	}
+
+	/// Standard two-pass pairing of a list of siblings, done iteratively so deep heaps can't blow the stack
+	template <typename Compare>
+	static Node* mergeSiblings(Node* first, Compare comesFirst) {
+		Node* pairs = nullptr; // Linked back-to-front through sibling
+		while (first) {
+			Node* a = first;
+			Node* b = a->sibling;
+			first = b ? b->sibling : nullptr;
+			resetSiblingLinks(a);
+			if (b) {
+				resetSiblingLinks(b);
+				a = meld(a, b, comesFirst);
+			}
+			a->sibling = pairs;
+			pairs = a;
+		}
+
+		Node* result = nullptr;
+		while (pairs) {
+			Node* next = pairs->sibling;
+			pairs->sibling = nullptr;
+			result = meld(result, pairs, comesFirst);
+			pairs = next;
+		}
+		return result;
+	}
+
+	static void resetSiblingLinks(Node* node) {
+		node->sibling = nullptr;
+		node->prev = nullptr;
+	}
+
+	static Node* childOf(Node* node) { return node->child; }
+
+	Node* root_ = nullptr;
+	int32_t size_ = 0;
+};
+
+/// Intrusive pairing heap keyed on a uint32_t held in each node. Insert and key-improvement are O(1); pop, remove and
+/// key-worsening are amortized O(log n). With the default Compare the lowest key sits on top - pass std::greater<> to
+/// keep the highest key there instead.
+template <typename T, typename Compare = std::less<uint32_t>>
+class IntrusivePairingHeap final : public PairingHeapBase<T> {
+	using Base = PairingHeapBase<T>;
+
+public:
+	using Node = typename Base::Node;
+
+	IntrusivePairingHeap() = default;
+
+	void insert(Node* node, uint32_t key) {
+		Base::resetLinks(node);
+		node->key = key;
+		node->heap = this;
+		this->root_ = Base::meld(this->root_, node, Compare{});
+		this->size_++;
+	}
+
+	/// Removes and returns the top node, or nullptr if empty
+	Node* pop() {
+		Node* top = this->root_;
+		if (top) {
+			this->root_ = Base::mergeSiblings(Base::childOf(top), Compare{});
+			forget(top);
+		}
+		return top;
+	}
+
+	/// Returns whether the node was in this heap
+	bool remove(Node* node) {
+		if (!this->contains(node)) {
+			return false;
+		}
+		if (node == this->root_) {
+			pop();
+			return true;
+		}
+		Base::detach(node);
+		Node* children = Base::mergeSiblings(Base::childOf(node), Compare{});
+		this->root_ = Base::meld(this->root_, children, Compare{});
+		forget(node);
+		return true;
+	}
+
+	/// Node must already be in this heap
+	void updateKey(Node* node, uint32_t newKey) {
+		if (newKey == node->key) {
+			return;
+		}
+
+		// Moving towards the top: the node's own subtree stays valid, so just cut it off and re-link it
+		if (Compare{}(newKey, node->key)) {
+			node->key = newKey;
+			if (node != this->root_) {
+				Base::detach(node);
+				this->root_ = Base::meld(this->root_, node, Compare{});
+			}
+		}
+
+		// Moving away from the top: its children may now belong above it, so take it out and put it back
+		else {
+			remove(node);
+			insert(node, newKey);
+		}
+	}
+
+private:
+	void forget(Node* node) {
+		Base::resetLinks(node);
+		node->heap = nullptr;
+		this->size_--;
+	}
+};
+
+} // namespace deluge
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace deluge {
+
+/// Fixed-size ring for passing things from one producer to one consumer without locking - e.g. from an interrupt to
+/// the audio routine, or from one task to another. Each index is only ever written by one side, and the release/acquire
+/// pairs make sure an item's been written before the consumer can see it. Capacity must be a power of two, and one
+/// slot always stays empty, to tell full from empty.
+template <typename T, size_t kCapacity>
+class SPSCRing {
+	static_assert((kCapacity & (kCapacity - 1)) == 0, "SPSCRing capacity must be a power of two");
+
+public:
+	/// Producer only. Returns false if there was no room, in which case the item's dropped
+	bool push(T const& item) {
+		uint32_t writePos = writePos_.load(std::memory_order_relaxed);
+		uint32_t nextWritePos = (writePos + 1) & (kCapacity - 1);
+		if (nextWritePos == readPos_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		items_[writePos] = item;
+		writePos_.store(nextWritePos, std::memory_order_release);
+		return true;
+	}
+
+	/// Consumer only. nullptr if empty
+	[[nodiscard]] T const* front() const {
+		uint32_t readPos = readPos_.load(std::memory_order_relaxed);
+		if (readPos == writePos_.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		return &items_[readPos];
+	}
+
+	/// Consumer only. There must be something there
+	void pop() {
+		uint32_t readPos = readPos_.load(std::memory_order_relaxed);
+		readPos_.store((readPos + 1) & (kCapacity - 1), std::memory_order_release);
+	}
+
+	[[nodiscard]] bool empty() const { return front() == nullptr; }
+
+	[[nodiscard]] size_t size() const {
+		return (writePos_.load(std::memory_order_acquire) - readPos_.load(std::memory_order_acquire))
+		       & (kCapacity - 1);
+	}
+
+	static constexpr size_t capacity() { return kCapacity - 1; }
+
+private:
+	std::array<T, kCapacity> items_{};
+	std::atomic<uint32_t> writePos_{0};
+	std::atomic<uint32_t> readPos_{0};
+};
+
+} // namespace deluge
@@ -55,3 +55,25 @@ TEST(OpenHashTableTest, test32bit) {
 	OpenAddressingHashTableWith32bitKey table;
 	runTest(table);
 }
+
+TEST(OpenHashTableTest, test32bitWithValues) {
+	OpenAddressingHashTableWith32bitKey table(sizeof(uint32_t));
+
+	// Enough to make it grow, so the values have to survive being moved
+	for (uint32_t i = 1; i <= NUM_ELEMENTS_TO_ADD; i++) {
+		uint32_t* bucket = (uint32_t*)table.insert(i);
+		CHECK(bucket);
+		bucket[1] = i * 3;
+	}
+	for (uint32_t i = 1; i <= NUM_ELEMENTS_TO_ADD; i++) {
+		uint32_t* bucket = (uint32_t*)table.lookup(i);
+		CHECK(bucket);
+		CHECK_EQUAL(i * 3, bucket[1]);
+	}
+
+	table.clear();
+	CHECK_EQUAL(0, table.numElements);
+	CHECK_FALSE(table.lookup(1));
+	CHECK(table.insert(1));
+	CHECK_EQUAL(1, table.numElements);
+}
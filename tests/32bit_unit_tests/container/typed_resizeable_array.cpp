@@ -0,0 +1,104 @@
+#include "CppUTest/TestHarness.h"
+#include "memory/memory_allocator_interface.h"
+#include "util/container/array/typed_resizeable_array.hpp"
+#include <cstdint>
+
+namespace {
+
+struct Element {
+	int32_t key;
+	int32_t value;
+};
+
+constexpr int32_t kCapacity = 8;
+
+// A fixed capacity, so nothing needs the allocator to extend anything. The array still frees it when it's destroyed.
+class TestArray : public deluge::container::OrderedResizeableArray<Element> {
+public:
+	TestArray() { setStaticMemory(delugeAlloc(kCapacity * sizeof(Element), false), kCapacity * sizeof(Element)); }
+	int32_t getMemoryStart() const { return memoryStart; }
+};
+
+// Inserting in descending order adds each element at the front, so memoryStart walks left and the storage wraps
+void fillDescending(TestArray& array, int32_t numElements) {
+	for (int32_t i = numElements - 1; i >= 0; i--) {
+		int32_t index = array.insertAtKey(i * 10);
+		CHECK_EQUAL(0, index);
+		array[index].value = i;
+	}
+}
+
+} // namespace
+
+TEST_GROUP(TypedResizeableArrayTest){};
+
+TEST(TypedResizeableArrayTest, accessMatchesUntyped) {
+	TestArray array;
+	fillDescending(array, 6);
+
+	CHECK_EQUAL(6, array.getNumElements());
+	for (int32_t i = 0; i < array.getNumElements(); i++) {
+		POINTERS_EQUAL(array.getElementAddress(i), &array[i]);
+		POINTERS_EQUAL(&array[i], array.getElement(i));
+		CHECK_EQUAL(i * 10, array.getKeyAtIndex(i));
+		CHECK_EQUAL(i, array[i].value);
+	}
+	POINTERS_EQUAL(nullptr, array.getElement(-1));
+	POINTERS_EQUAL(nullptr, array.getElement(6));
+	POINTERS_EQUAL(&array[5], array.getLast());
+}
+
+TEST(TypedResizeableArrayTest, searchMatchesUntypedWhenWrapped) {
+	TestArray array;
+	fillDescending(array, 6);
+	CHECK_FALSE(array.isContiguous());
+
+	::OrderedResizeableArray& untyped = array;
+	for (int32_t key = -5; key <= 60; key++) {
+		CHECK_EQUAL(untyped.search(key, GREATER_OR_EQUAL), array.search(key, GREATER_OR_EQUAL));
+		CHECK_EQUAL(untyped.search(key, LESS), array.search(key, LESS));
+		CHECK_EQUAL(untyped.searchExact(key), array.searchExact(key));
+	}
+}
+
+TEST(TypedResizeableArrayTest, searchMatchesUntypedWhenContiguous) {
+	TestArray array;
+	for (int32_t i = 0; i < 6; i++) {
+		array.insertAtKey(i * 10, true);
+	}
+	CHECK(array.isContiguous());
+
+	::OrderedResizeableArray& untyped = array;
+	for (int32_t key = -5; key <= 60; key++) {
+		CHECK_EQUAL(untyped.search(key, GREATER_OR_EQUAL), array.search(key, GREATER_OR_EQUAL));
+		CHECK_EQUAL(untyped.search(key, LESS, 2, 5), array.search(key, LESS, 2, 5));
+	}
+}
+
+TEST(TypedResizeableArrayTest, runsCoverElementsInOrder) {
+	TestArray array;
+	fillDescending(array, 6);
+
+	auto runs = array.getRuns();
+	CHECK_EQUAL(kCapacity - array.getMemoryStart(), runs[0].size());
+	CHECK_EQUAL(6, runs[0].size() + runs[1].size());
+
+	int32_t expectedKey = 0;
+	array.forEach([&](Element& element) {
+		CHECK_EQUAL(expectedKey, element.key);
+		expectedKey += 10;
+	});
+	CHECK_EQUAL(60, expectedKey);
+}
+
+TEST(TypedResizeableArrayTest, deleteAtKey) {
+	TestArray array;
+	fillDescending(array, 6);
+
+	array.deleteAtKey(20);
+	array.deleteAtKey(25); // Not there
+	CHECK_EQUAL(5, array.getNumElements());
+	CHECK_EQUAL(-1, array.searchExact(20));
+	CHECK_EQUAL(2, array.searchExact(30));
+	CHECK_EQUAL(3, array[2].value);
+}
@@ -0,0 +1,132 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/filter/filter_set.h"
+#include "dsp/filter/multi_voice_filter.h"
+#include "util/waves.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+using namespace deluge::dsp::filter;
+
+namespace {
+
+constexpr int32_t kNumLanes = MultiVoiceFilter::kNumLanes;
+constexpr int32_t kNumSamples = 128;
+constexpr int32_t kNumRenders = 8;
+
+// Kept apart from getNoise()'s generator, which the filters draw from
+uint32_t inputSeed = 1;
+q31_t nextInput() {
+	inputSeed = inputSeed * 1664525 + 1013904223;
+	return (q31_t)inputSeed >> 2;
+}
+
+// Each voice a little different, and everything moving a little each render, so no two lanes are alike
+void configure(FilterSet& filterSet, int32_t voice, int32_t render, FilterMode lpfMode, FilterMode hpfMode,
+               FilterRoute routing, q31_t resonance) {
+	q31_t overallOscAmplitude = 0;
+	filterSet.setConfig(200000000 + voice * 150000000 + render * 1000000, resonance - voice * 1000, lpfMode,
+	                    voice * 50000000, 30000000 + voice * 20000000, resonance, hpfMode, voice * 40000000, 1 << 28,
+	                    routing, false, &overallOscAmplitude);
+}
+
+/// Renders the same voices one at a time with FilterSet::renderLong(), and side by side with MultiVoiceFilter, and
+/// checks they come out the same to the bit - noise included, since a batch draws each voice's noise in turn just as
+/// rendering them one after the other does
+void checkMatchesScalar(FilterMode lpfMode, FilterMode hpfMode, FilterRoute routing) {
+	// Low enough to leave the saturation off, then high enough for each kind of it
+	for (q31_t resonance : {1 << 26, 400000000, 536000000, 950000000}) {
+		for (int32_t numVoices = 1; numVoices <= kNumLanes; numVoices++) {
+			static std::array<FilterSet, kNumLanes> scalar;
+			static std::array<FilterSet, kNumLanes> batched;
+			std::array<FilterSet*, kNumLanes> batchedPointers;
+			q31_t scalarBuffer[kNumSamples];
+
+			// Let any fade from switching modes finish first, as it has to before a voice can be batched
+			for (int32_t v = 0; v < numVoices; v++) {
+				memset((void*)&scalar[v], 0, sizeof(FilterSet));
+				scalar[v].reset();
+				for (int32_t r = 0; r < 10; r++) {
+					configure(scalar[v], v, 0, lpfMode, hpfMode, routing, resonance);
+					for (q31_t& sample : scalarBuffer) {
+						sample = nextInput() >> 1;
+					}
+					scalar[v].renderLong(scalarBuffer, scalarBuffer + kNumSamples, kNumSamples);
+				}
+				batched[v] = scalar[v];
+				batchedPointers[v] = &batched[v];
+			}
+
+			for (int32_t render = 0; render < kNumRenders; render++) {
+				q31_t input[kNumLanes][kNumSamples];
+				q31_t laneBuffer[kNumSamples * kNumLanes] = {};
+				for (int32_t v = 0; v < numVoices; v++) {
+					for (int32_t i = 0; i < kNumSamples; i++) {
+						input[v][i] = nextInput();
+						laneBuffer[i * kNumLanes + v] = input[v][i];
+					}
+				}
+
+				uint32_t noiseSeed = jcong;
+				for (int32_t v = 0; v < numVoices; v++) {
+					configure(scalar[v], v, render, lpfMode, hpfMode, routing, resonance);
+					scalar[v].renderLong(input[v], input[v] + kNumSamples, kNumSamples);
+				}
+				uint32_t noiseSeedAfterScalar = jcong;
+
+				jcong = noiseSeed;
+				for (int32_t v = 0; v < numVoices; v++) {
+					configure(batched[v], v, render, lpfMode, hpfMode, routing, resonance);
+					CHECK(MultiVoiceFilter::canBatch(batched[v]));
+				}
+				MultiVoiceFilter::render(std::span{batchedPointers.data(), (size_t)numVoices}, laneBuffer, kNumSamples);
+				CHECK_EQUAL(noiseSeedAfterScalar, jcong);
+
+				for (int32_t v = 0; v < numVoices; v++) {
+					for (int32_t i = 0; i < kNumSamples; i++) {
+						CHECK_EQUAL(input[v][i], laneBuffer[i * kNumLanes + v]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void checkEachRouting(FilterMode lpfMode, FilterMode hpfMode) {
+	for (FilterRoute routing : {FilterRoute::HIGH_TO_LOW, FilterRoute::LOW_TO_HIGH, FilterRoute::PARALLEL}) {
+		checkMatchesScalar(lpfMode, hpfMode, routing);
+	}
+}
+
+} // namespace
+
+TEST_GROUP(MultiVoiceFilterTest){};
+
+TEST(MultiVoiceFilterTest, lpLadder12MatchesScalar) {
+	checkEachRouting(FilterMode::TRANSISTOR_12DB, FilterMode::OFF);
+}
+
+TEST(MultiVoiceFilterTest, lpLadder24MatchesScalar) {
+	checkEachRouting(FilterMode::TRANSISTOR_24DB, FilterMode::OFF);
+}
+
+TEST(MultiVoiceFilterTest, svfBandMatchesScalar) {
+	checkEachRouting(FilterMode::SVF_BAND, FilterMode::OFF);
+	checkEachRouting(FilterMode::OFF, FilterMode::SVF_BAND);
+}
+
+TEST(MultiVoiceFilterTest, svfNotchMatchesScalar) {
+	checkEachRouting(FilterMode::SVF_NOTCH, FilterMode::OFF);
+	checkEachRouting(FilterMode::OFF, FilterMode::SVF_NOTCH);
+}
+
+TEST(MultiVoiceFilterTest, hpLadderMatchesScalar) {
+	checkEachRouting(FilterMode::OFF, FilterMode::HPLADDER);
+}
+
+TEST(MultiVoiceFilterTest, bothFiltersMatchScalar) {
+	checkEachRouting(FilterMode::TRANSISTOR_24DB, FilterMode::HPLADDER);
+	checkEachRouting(FilterMode::TRANSISTOR_12DB, FilterMode::SVF_BAND);
+	checkEachRouting(FilterMode::SVF_NOTCH, FilterMode::HPLADDER);
+}
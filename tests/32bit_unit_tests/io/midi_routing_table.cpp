@@ -0,0 +1,128 @@
+#include "CppUTest/TestHarness.h"
+#include "definitions_cxx.hpp"
+#include "io/midi/midi_routing_table.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Only ever compared, never used
+Output* output(int32_t n) {
+	return reinterpret_cast<Output*>((uintptr_t)(n + 1) * 16);
+}
+
+struct Offer {
+	Output* output;
+	bool paramLearned;
+	bool inputLearned;
+};
+
+std::vector<Offer> offersFor(MIDIRoutingTable const& table, int32_t channel, int32_t channelOrZone, int32_t ccNumber) {
+	std::vector<Offer> offers;
+	table.forEachOutputForCC(channel, channelOrZone, ccNumber,
+	                         [&](Output* thisOutput, bool paramLearned, bool inputLearned) {
+		                         offers.push_back({thisOutput, paramLearned, inputLearned});
+	                         });
+	return offers;
+}
+
+void checkOffer(Offer const& offer, Output* expectedOutput, bool paramLearned, bool inputLearned) {
+	CHECK(offer.output == expectedOutput);
+	CHECK_EQUAL(paramLearned, offer.paramLearned);
+	CHECK_EQUAL(inputLearned, offer.inputLearned);
+}
+
+} // namespace
+
+TEST_GROUP(MIDIRoutingTable){};
+
+TEST(MIDIRoutingTable, offersInSongOrder) {
+	MIDIRoutingTable table;
+	// Added out of order, so sort() has to put them back in the Song's
+	table.add(output(3), 3, 2, 74);
+	table.add(output(0), 0, 2, 74);
+	table.add(output(2), 2, 2, 74);
+	table.add(output(1), 1, 2, 75);
+	table.sort();
+
+	std::vector<Offer> offers = offersFor(table, 2, 2, 74);
+	CHECK_EQUAL(3, (int32_t)offers.size());
+	checkOffer(offers[0], output(0), true, false);
+	checkOffer(offers[1], output(2), true, false);
+	checkOffer(offers[2], output(3), true, false);
+
+	CHECK_EQUAL(1, (int32_t)offersFor(table, 2, 2, 75).size());
+	CHECK_EQUAL(0, (int32_t)offersFor(table, 3, 3, 74).size());
+	CHECK_EQUAL(0, (int32_t)offersFor(table, 2, 2, 73).size());
+}
+
+TEST(MIDIRoutingTable, offersEachOutputOnce) {
+	MIDIRoutingTable table;
+	// A Kit with two Drums' params learned to the same CC
+	table.add(output(0), 0, 5, 10);
+	table.add(output(0), 0, 5, 10);
+	table.add(output(1), 1, 5, MIDIRoutingTable::kAnyNumber);
+	table.add(output(1), 1, 5, MIDIRoutingTable::kAnyNumber);
+	table.sort();
+
+	std::vector<Offer> offers = offersFor(table, 5, 5, 10);
+	CHECK_EQUAL(2, (int32_t)offers.size());
+	checkOffer(offers[0], output(0), true, false);
+	checkOffer(offers[1], output(1), false, true);
+}
+
+TEST(MIDIRoutingTable, mergesParamsAndInputs) {
+	MIDIRoutingTable table;
+	table.add(output(0), 0, 1, MIDIRoutingTable::kAnyNumber);
+	table.add(output(1), 1, 1, 20);
+	table.add(output(2), 2, 1, 20);
+	table.add(output(2), 2, 1, MIDIRoutingTable::kAnyNumber);
+	table.add(output(3), 3, 1, MIDIRoutingTable::kAnyNumber);
+	table.add(output(4), 4, 1, 20);
+	table.sort();
+
+	std::vector<Offer> offers = offersFor(table, 1, 1, 20);
+	CHECK_EQUAL(5, (int32_t)offers.size());
+	checkOffer(offers[0], output(0), false, true);
+	checkOffer(offers[1], output(1), true, false);
+	checkOffer(offers[2], output(2), true, true);
+	checkOffer(offers[3], output(3), false, true);
+	checkOffer(offers[4], output(4), true, false);
+
+	// Any other CC on the channel still goes to the inputs
+	offers = offersFor(table, 1, 1, 21);
+	CHECK_EQUAL(3, (int32_t)offers.size());
+	checkOffer(offers[0], output(0), false, true);
+	checkOffer(offers[1], output(2), false, true);
+	checkOffer(offers[2], output(3), false, true);
+}
+
+TEST(MIDIRoutingTable, inputsAreFoundByZone) {
+	MIDIRoutingTable table;
+	// One input learned to the lower zone, one to channel 1 itself, and a param learned to the CC on channel 1
+	table.add(output(0), 0, MIDI_CHANNEL_MPE_LOWER_ZONE, MIDIRoutingTable::kAnyNumber);
+	table.add(output(1), 1, 1, MIDIRoutingTable::kAnyNumber);
+	table.add(output(2), 2, 1, 7);
+	table.sort();
+
+	// Channel 1 in the lower zone: params by the channel, inputs by the zone
+	std::vector<Offer> offers = offersFor(table, 1, MIDI_CHANNEL_MPE_LOWER_ZONE, 7);
+	CHECK_EQUAL(2, (int32_t)offers.size());
+	checkOffer(offers[0], output(0), false, true);
+	checkOffer(offers[1], output(2), true, false);
+
+	// Channel 1 with no zone
+	offers = offersFor(table, 1, 1, 7);
+	CHECK_EQUAL(2, (int32_t)offers.size());
+	checkOffer(offers[0], output(1), false, true);
+	checkOffer(offers[1], output(2), true, false);
+}
+
+TEST(MIDIRoutingTable, clearEmptiesIt) {
+	MIDIRoutingTable table;
+	table.add(output(0), 0, 0, 1);
+	table.sort();
+	table.clear();
+	table.sort();
+	CHECK_EQUAL(0, (int32_t)offersFor(table, 0, 0, 1).size());
+}
@@ -331,4 +331,33 @@ TEST(MemoryAllocation, stealableAllocations) {
 	CHECK(efficiency > 0.994);
 	mock().checkExpectations();
 };
+TEST(MemoryAllocation, stats) {
+	MemoryRegionStats stats = memreg.getStats();
+	CHECK_EQUAL(MEM_SIZE, stats.size);
+	CHECK_EQUAL(1, stats.numFreeRuns);
+	CHECK_EQUAL(stats.freeBytes, stats.largestFreeRun);
+	CHECK_EQUAL(0, stats.fragmentation);
+	CHECK_EQUAL(0, stats.numAllocations);
+
+	void* first = memreg.alloc(1000, false, NULL);
+	void* stealable = memreg.alloc(1000, true, NULL);
+	memreg.cache_manager().QueueForReclamation(StealableQueue{0}, new (stealable) StealableTest());
+	void* last = memreg.alloc(1000, false, NULL);
+
+	stats = memreg.getStats();
+	CHECK_EQUAL(2, stats.numAllocations);
+	CHECK_EQUAL(getAllocatedSize(first) + getAllocatedSize(last), stats.allocatedBytes);
+	CHECK_EQUAL(1, stats.numStealables);
+	CHECK_EQUAL(getAllocatedSize(stealable), stats.stealableBytes);
+	CHECK_EQUAL(getAllocatedSize(stealable), stats.stealableBytesPerQueue[0]);
+	// Every space has a header and footer
+	CHECK_EQUAL(MEM_SIZE - 8 - 4 * 8, stats.freeBytes + stats.allocatedBytes + stats.stealableBytes);
+
+	// Freeing the first allocation leaves a hole which can't join up with the rest of the free memory
+	memreg.dealloc(first);
+	stats = memreg.getStats();
+	CHECK_EQUAL(2, stats.numFreeRuns);
+	CHECK(stats.fragmentation > 0);
+	CHECK(stats.largestFreeRun < stats.freeBytes);
+};
 } // namespace
@@ -9,3 +9,7 @@ void AudioEngine::logAction(char const* item) {
 }
 
 bool AudioEngine::bypassCulling;
+int32_t AudioEngine::cpuDireness = 0;
+
+void AudioEngine::routineWithClusterLoading(bool mayProcessUserActionsBetween) {
+}
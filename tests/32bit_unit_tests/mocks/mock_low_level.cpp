@@ -0,0 +1,11 @@
+#include <cstdint>
+
+// What the card routines call to keep the rest of the Deluge going, which there's nothing of here
+
+extern "C" {
+void oledRoutine() {
+}
+
+void uartFlushIfNotSending(int32_t item) {
+}
+}
@@ -0,0 +1,9 @@
+#include <cstdint>
+
+extern "C" {
+#include "RZA1/ostm/ostm.h"
+
+uint32_t getTimerValue(int timerNo) {
+	return 0;
+}
+}
@@ -0,0 +1,9 @@
+#include "gui/ui_timer_manager.h"
+
+UITimerManager::UITimerManager() {
+}
+
+void UITimerManager::routine() {
+}
+
+UITimerManager uiTimerManager{};
@@ -0,0 +1,241 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/binary/binary_serializer.h"
+#include "util/functions.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Files live in memory, each known by its first cluster, which is just its index in here plus 2 as clusters 0 and 1
+// aren't real ones
+struct MockFile {
+	std::string path;
+	std::vector<uint8_t> data;
+};
+std::vector<MockFile> files;
+constexpr DWORD kFirstCluster = 2;
+
+MockFile& fileOf(FIL* fp) {
+	return files[fp->obj.sclust - kFirstCluster];
+}
+
+constexpr char const* kPath = "SONGS/SONG001.XML.bin";
+
+// What a song's file holds, or near enough, with every sort of value the format has
+void writeSong(BinarySerializer& writer) {
+	writer.writeOpeningTagBeginning("song");
+	writer.writeAttribute("firmwareVersion", "c1.2.0");
+	writer.writeAttribute("earliestCompatibleFirmware", "4.1.0-alpha");
+	writer.writeAttribute("xScroll", -96);
+	writer.writeAttributeHex("rootNote", 0x7F, 2);
+	writer.writeOpeningTagEnd();
+
+	writer.writeOpeningTag("instrumentClips");
+	for (int32_t i = 0; i < 3; i++) {
+		writer.writeOpeningTagBeginning("instrumentClip");
+		writer.writeAttribute("length", 384 << i);
+		writer.writeAttribute("instrumentPresetName", "SYNT004");
+		writer.writeAttributeHexBlobBegin("noteData");
+		for (int32_t note = 0; note < 200; note++) {
+			int32_t pos = note * 48;
+			uint8_t bytes[5] = {0, 0, (uint8_t)(pos >> 8), (uint8_t)pos, (uint8_t)(0x40 + i)};
+			writer.writeHexBlobBytes(bytes, 5);
+		}
+		writer.writeHexBlobEnd();
+		writer.closeTag();
+	}
+	writer.writeClosingTag("instrumentClips");
+
+	writer.writeTag("tempoMagnitude", 0);
+	writer.writeTag("name", "120 BPM BEAT");
+	writer.writeClosingTag("song");
+}
+
+// As NoteRow::readFromFile() does it, a note's worth of hex digits at a time
+void readNoteData(Deserializer& reader, int32_t clipIndex) {
+	CHECK(reader.prepareToReadTagOrAttributeValueOneCharAtATime());
+	char const* firstChars = reader.readNextCharsOfTagOrAttributeValue(2);
+	CHECK(firstChars && !memcmp(firstChars, "0x", 2));
+	// Like the XML reader, which only counts to the end of the cluster, this only counts to the end of a segment
+	CHECK(reader.getNumCharsRemainingInValue() > 0);
+	for (int32_t note = 0; note < 200; note++) {
+		char const* hexChars = reader.readNextCharsOfTagOrAttributeValue(10);
+		CHECK(hexChars);
+		CHECK_EQUAL(note * 48, hexToIntFixedLength(hexChars, 8));
+		CHECK_EQUAL(0x40 + clipIndex, hexToIntFixedLength(&hexChars[8], 2));
+	}
+	CHECK(!reader.readNextCharsOfTagOrAttributeValue(10));
+}
+
+// Reads through the song after openFile() has, as Song::readFromFile() would
+void readSong(BinaryDeserializer& reader) {
+	// Song::readFromFile() hands anything it doesn't know on to this
+	for (char const* name : {"firmwareVersion", "earliestCompatibleFirmware"}) {
+		STRCMP_EQUAL(name, reader.readNextTagOrAttributeName());
+		CHECK(reader.tryReadingFirmwareTagFromFile(name) == Error::NONE);
+		reader.exitTag();
+	}
+	CHECK(reader.firmware_version == FirmwareVersion::parse("c1.2.0"));
+
+	STRCMP_EQUAL("xScroll", reader.readNextTagOrAttributeName());
+	CHECK_EQUAL(-96, reader.readTagOrAttributeValueInt());
+	reader.exitTag();
+	STRCMP_EQUAL("rootNote", reader.readNextTagOrAttributeName());
+	CHECK_EQUAL(0x7F, reader.readTagOrAttributeValueHex(0));
+	reader.exitTag();
+
+	STRCMP_EQUAL("instrumentClips", reader.readNextTagOrAttributeName());
+	int32_t clipIndex = 0;
+	while (char const* name = reader.readNextTagOrAttributeName()) {
+		if (!*name) {
+			break;
+		}
+		STRCMP_EQUAL("instrumentClip", name);
+		while (*(name = reader.readNextTagOrAttributeName())) {
+			if (!strcmp(name, "length")) {
+				CHECK_EQUAL(384 << clipIndex, reader.readTagOrAttributeValueInt());
+			}
+			else if (!strcmp(name, "instrumentPresetName")) {
+				STRCMP_EQUAL("SYNT004", reader.readTagOrAttributeValue());
+			}
+			else {
+				STRCMP_EQUAL("noteData", name);
+				readNoteData(reader, clipIndex);
+			}
+			reader.exitTag();
+		}
+		reader.exitTag("instrumentClip");
+		clipIndex++;
+	}
+	CHECK_EQUAL(3, clipIndex);
+	reader.exitTag("instrumentClips");
+
+	STRCMP_EQUAL("tempoMagnitude", reader.readNextTagOrAttributeName());
+	CHECK_EQUAL(0, reader.readTagOrAttributeValueInt());
+	reader.exitTag();
+	STRCMP_EQUAL("name", reader.readNextTagOrAttributeName());
+	STRCMP_EQUAL("120 BPM BEAT", reader.readTagOrAttributeValue());
+	reader.exitTag();
+
+	STRCMP_EQUAL("", reader.readNextTagOrAttributeName());
+}
+
+Error writeFile(FilePointer const* source) {
+	FIL file;
+	if (f_open(&file, kPath, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+		return Error::SD_CARD;
+	}
+	BinarySerializer writer;
+	Error error = writer.beginFile(file, source);
+	if (error != Error::NONE) {
+		return error;
+	}
+	writeSong(writer);
+	return writer.closeFileAfterWriting(kPath);
+}
+
+} // namespace
+
+extern "C" {
+
+FRESULT f_open(FIL* fp, TCHAR const* path, BYTE mode) {
+	size_t index = 0;
+	while (index < files.size() && files[index].path != path) {
+		index++;
+	}
+	if (index == files.size()) {
+		if (!(mode & (FA_CREATE_ALWAYS | FA_CREATE_NEW | FA_OPEN_ALWAYS))) {
+			return FR_NO_FILE;
+		}
+		files.push_back({path, {}});
+	}
+	else if (mode & FA_CREATE_ALWAYS) {
+		files[index].data.clear();
+	}
+
+	memset(fp, 0, sizeof(FIL));
+	fp->obj.sclust = index + kFirstCluster;
+	fp->obj.objsize = files[index].data.size();
+	fp->flag = mode;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp) {
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br) {
+	std::vector<uint8_t>& data = fileOf(fp).data;
+	*br = std::min<UINT>(btr, data.size() - fp->fptr);
+	memcpy(buff, &data[fp->fptr], *br);
+	fp->fptr += *br;
+	return FR_OK;
+}
+
+FRESULT f_write(FIL* fp, void const* buff, UINT btw, UINT* bw) {
+	std::vector<uint8_t>& data = fileOf(fp).data;
+	data.resize(std::max<size_t>(data.size(), fp->fptr + btw));
+	memcpy(&data[fp->fptr], buff, btw);
+	fp->fptr += btw;
+	fp->obj.objsize = data.size();
+	*bw = btw;
+	return FR_OK;
+}
+}
+
+TEST_GROUP(BinarySerializerTests) {
+	void setup() { files.clear(); }
+};
+
+TEST(BinarySerializerTests, roundTrip) {
+	CHECK(writeFile(nullptr) == Error::NONE);
+
+	BinaryDeserializer reader;
+	CHECK(reader.openFile(kPath, "song") == Error::NONE);
+	readSong(reader);
+	reader.closeFile();
+	CHECK(!reader.fileAccessFailedDuring);
+}
+
+TEST(BinarySerializerTests, hexBlobsTakeHalfTheSpace) {
+	CHECK(writeFile(nullptr) == Error::NONE);
+
+	// Three clips of 200 notes, 5 bytes each, would be 6000 chars in the XML
+	CHECK(files[0].data.size() > 3 * 200 * 5);
+	CHECK(files[0].data.size() < 3 * 200 * 5 + 400);
+}
+
+TEST(BinarySerializerTests, copyOfSource) {
+	FilePointer source{.sclust = 1234, .objsize = 56789};
+	CHECK(writeFile(&source) == Error::NONE);
+
+	BinaryDeserializer reader;
+	CHECK(reader.openFile(kPath, "song", "", false, &source) == Error::NONE);
+	readSong(reader);
+	reader.closeFile();
+}
+
+TEST(BinarySerializerTests, copyOfOtherVersionOfSource) {
+	FilePointer source{.sclust = 1234, .objsize = 56789};
+	CHECK(writeFile(&source) == Error::NONE);
+
+	// The XML file got saved again somewhere else on the card, or edited on a computer
+	BinaryDeserializer reader;
+	FilePointer moved{.sclust = 1240, .objsize = 56789};
+	CHECK(reader.openFile(kPath, "song", "", false, &moved) == Error::FILE_NOT_FOUND);
+	FilePointer edited{.sclust = 1234, .objsize = 56790};
+	CHECK(reader.openFile(kPath, "song", "", false, &edited) == Error::FILE_NOT_FOUND);
+}
+
+TEST(BinarySerializerTests, notABinaryFile) {
+	FIL file;
+	f_open(&file, kPath, FA_WRITE | FA_CREATE_ALWAYS);
+	char const xml[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<song\n";
+	UINT bytesWritten;
+	f_write(&file, xml, sizeof(xml), &bytesWritten);
+
+	BinaryDeserializer reader;
+	CHECK(reader.openFile(kPath, "song") == Error::FILE_CORRUPTED);
+}
@@ -0,0 +1,94 @@
+// Just enough of the audio engine and memory manager for the DSP stages to link on the host. Everything else comes
+// from the 32-bit unit tests' mocks.
+
+#include "definitions_cxx.hpp"
+#include "memory/general_memory_allocator.h"
+#include "processing/engines/audio_engine.h"
+#include <cstdlib>
+
+int32_t spareRenderingBuffer[4][SSI_TX_BUFFER_NUM_SAMPLES];
+
+namespace AudioEngine {
+bool renderInStereo = true;
+} // namespace AudioEngine
+
+// Allocations are malloc()ed with their size stored in front, so that getAllocatedSize() works. Nothing is ever
+// extended or shortened on the left, which callers have to cope with on the Deluge anyway.
+namespace {
+constexpr uint32_t kHeaderSize = 16; // Keeps the alignment malloc() gave us
+
+uint32_t& allocatedSize(void* address) {
+	return *(uint32_t*)((uint8_t*)address - kHeaderSize);
+}
+} // namespace
+
+MemoryRegion::MemoryRegion() = default;
+GeneralMemoryAllocator::GeneralMemoryAllocator() = default;
+
+void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, bool mayUseOnChipRam, bool makeStealable,
+                                    void* thingNotToStealFrom) {
+	uint8_t* memory = (uint8_t*)malloc(requiredSize + kHeaderSize);
+	if (!memory) {
+		return nullptr;
+	}
+	void* address = memory + kHeaderSize;
+	allocatedSize(address) = requiredSize;
+	return address;
+}
+
+void GeneralMemoryAllocator::dealloc(void* address) {
+	if (address) {
+		free((uint8_t*)address - kHeaderSize);
+	}
+}
+
+void* GeneralMemoryAllocator::allocExternal(uint32_t requiredSize) {
+	return alloc(requiredSize, false, false, nullptr);
+}
+
+void GeneralMemoryAllocator::deallocExternal(void* address) {
+	dealloc(address);
+}
+
+uint32_t GeneralMemoryAllocator::getAllocatedSize(void* address) {
+	return allocatedSize(address);
+}
+
+uint32_t GeneralMemoryAllocator::shortenRight(void* address, uint32_t newSize) {
+	allocatedSize(address) = newSize;
+	return newSize;
+}
+
+uint32_t GeneralMemoryAllocator::shortenLeft(void* address, uint32_t amountToShorten,
+                                             uint32_t numBytesToMoveRightIfSuccessful) {
+	return 0;
+}
+
+void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, uint32_t idealAmountToExtend,
+                                    uint32_t* getAmountExtendedLeft, uint32_t* getAmountExtendedRight,
+                                    void* thingNotToStealFrom) {
+	*getAmountExtendedLeft = 0;
+	*getAmountExtendedRight = 0;
+}
+
+uint32_t GeneralMemoryAllocator::extendRightAsMuchAsEasilyPossible(void* address) {
+	return 0;
+}
+
+void GeneralMemoryAllocator::checkStack(char const* caller) {
+}
+
+int32_t GeneralMemoryAllocator::getRegion(void* address) {
+	return 0;
+}
+
+extern "C" {
+
+void* delugeAlloc(unsigned int requiredSize, bool mayUseOnChipRam) {
+	return GeneralMemoryAllocator::get().alloc(requiredSize, mayUseOnChipRam, false, nullptr);
+}
+
+void delugeDealloc(void* address) {
+	GeneralMemoryAllocator::get().dealloc(address);
+}
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Renders a few fixed patches through the firmware's DSP, block by block as the audio engine would, and reports the
+// time spent in each stage per sample. Each patch is also written out as a WAV so that a change which makes things
+// faster can be checked for having changed the sound too.
+//
+//   RenderBenchmark [--seconds N] [--wav-dir DIR]
+
+#include "definitions_cxx.hpp"
+#include "dsp/delay/delay.h"
+#include "dsp/filter/filter_set.h"
+#include "dsp/reverb/freeverb/freeverb.hpp"
+#include "dsp/stereo_sample.h"
+#include "util/fixedpoint.h"
+#include "util/waves.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+constexpr int32_t kBlockSize = SSI_TX_BUFFER_NUM_SAMPLES;
+
+enum class Stage {
+	OSCILLATOR,
+	FILTER_SET,
+	DELAY,
+	REVERB,
+	NUM_STAGES,
+};
+constexpr int32_t kNumStages = static_cast<int32_t>(Stage::NUM_STAGES);
+constexpr std::array<char const*, kNumStages> kStageNames = {"oscillator", "filter set", "delay", "reverb"};
+
+enum class Wave {
+	SINE,
+	TRIANGLE,
+	SQUARE,
+};
+
+struct Patch {
+	char const* name;
+	Wave wave;
+	uint32_t phaseIncrement;
+	FilterMode lpfMode;
+	q31_t lpfFrequency;
+	q31_t lpfResonance;
+	FilterMode hpfMode;
+	q31_t hpfFrequency;
+	FilterRoute filterRoute;
+	q31_t delayFeedback; // 0 for no delay
+	int32_t delayRate;
+	bool reverb;
+};
+
+// Roughly a bass, a pad and a lead - between them, every filter family and both FX
+constexpr std::array kPatches = {
+    Patch{"ladder_bass", Wave::SQUARE, 0x00A00000, FilterMode::TRANSISTOR_24DB, 0x0A000000, 0x30000000, FilterMode::OFF,
+          0, FilterRoute::HIGH_TO_LOW, 0, 0, false},
+    Patch{"svf_pad", Wave::TRIANGLE, 0x01400000, FilterMode::SVF_BAND, 0x18000000, 0x20000000, FilterMode::HPLADDER,
+          0x02000000, FilterRoute::PARALLEL, 0x30000000, 0x04000000, true},
+    Patch{"drive_lead", Wave::SINE, 0x02800000, FilterMode::TRANSISTOR_24DB_DRIVE, 0x20000000, 0x10000000,
+          FilterMode::SVF_NOTCH, 0x01000000, FilterRoute::LOW_TO_HIGH, 0x20000000, 0x08000000, true},
+};
+
+/// Cycles where the host has a counter we can read cheaply, otherwise just nanoseconds
+struct StageTotals {
+	uint64_t cycles = 0;
+	uint64_t nanoseconds = 0;
+};
+
+class StageTimer {
+public:
+	StageTimer(StageTotals& totals) : totals(totals), startTime(std::chrono::steady_clock::now()) {
+		startCycles = readCycleCounter();
+	}
+	~StageTimer() {
+		totals.cycles += readCycleCounter() - startCycles;
+		totals.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+		                                                                          - startTime)
+		                          .count();
+	}
+
+	static bool haveCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+private:
+	static uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	StageTotals& totals;
+	std::chrono::steady_clock::time_point startTime;
+	uint64_t startCycles;
+};
+
+class WavWriter {
+public:
+	~WavWriter() { close(); }
+
+	bool open(std::string const& path) {
+		file = fopen(path.c_str(), "wb");
+		if (!file) {
+			return false;
+		}
+		uint8_t header[44] = {0};
+		fwrite(header, 1, sizeof(header), file); // Filled in once we know the length
+		return true;
+	}
+
+	void write(StereoSample const* samples, int32_t numSamples) {
+		if (!file) {
+			return;
+		}
+		for (int32_t i = 0; i < numSamples; i++) {
+			int16_t frame[2] = {clip(samples[i].l), clip(samples[i].r)};
+			fwrite(frame, sizeof(frame), 1, file);
+		}
+		numFrames += numSamples;
+	}
+
+	void close() {
+		if (!file) {
+			return;
+		}
+		uint32_t dataSize = numFrames * 4;
+		uint8_t header[44];
+		memcpy(&header[0], "RIFF", 4);
+		putLE(&header[4], 36 + dataSize, 4);
+		memcpy(&header[8], "WAVEfmt ", 8);
+		putLE(&header[16], 16, 4);
+		putLE(&header[20], 1, 2); // PCM
+		putLE(&header[22], 2, 2);
+		putLE(&header[24], kSampleRate, 4);
+		putLE(&header[28], kSampleRate * 4, 4);
+		putLE(&header[32], 4, 2);
+		putLE(&header[34], 16, 2);
+		memcpy(&header[36], "data", 4);
+		putLE(&header[40], dataSize, 4);
+		fseek(file, 0, SEEK_SET);
+		fwrite(header, 1, sizeof(header), file);
+		fclose(file);
+		file = nullptr;
+	}
+
+private:
+	// The engine's mix is Q31 with a few bits of headroom, as it is before the final output shift
+	static int16_t clip(q31_t sample) {
+		int32_t shifted = sample >> 14;
+		if (shifted > 32767) {
+			return 32767;
+		}
+		if (shifted < -32768) {
+			return -32768;
+		}
+		return shifted;
+	}
+
+	static void putLE(uint8_t* dest, uint32_t value, int32_t numBytes) {
+		for (int32_t i = 0; i < numBytes; i++) {
+			dest[i] = value >> (i * 8);
+		}
+	}
+
+	FILE* file = nullptr;
+	uint32_t numFrames = 0;
+};
+
+void renderOscillator(Patch const& patch, uint32_t* phase, q31_t* buffer) {
+	constexpr q31_t kAmplitude = 1 << 27;
+	for (int32_t i = 0; i < kBlockSize; i++) {
+		*phase += patch.phaseIncrement;
+		q31_t value;
+		switch (patch.wave) {
+		case Wave::SINE:
+			value = getSine(*phase);
+			break;
+		case Wave::TRIANGLE:
+			value = getTriangle(*phase);
+			break;
+		default:
+			value = getSquare(*phase);
+			break;
+		}
+		buffer[i] = multiply_32x32_rshift32(value, kAmplitude) << 3;
+	}
+}
+
+void renderPatch(Patch const& patch, int32_t numBlocks, char const* wavDir, bool haveCycleCounter) {
+	std::array<StageTotals, kNumStages> totals{};
+
+	std::array<q31_t, kBlockSize> oscBuffer{};
+	std::array<StereoSample, kBlockSize> mixBuffer{};
+	std::array<int32_t, kBlockSize> reverbSend{};
+
+	uint32_t phase = 0;
+	deluge::dsp::filter::FilterSet filterSet;
+	filterSet.reset();
+
+	Delay delay;
+	delay.syncLevel = SYNC_LEVEL_NONE;
+
+	auto* reverb = new deluge::dsp::reverb::Freeverb(); // Too big for the stack
+	reverb->setRoomSize(0.7);
+	reverb->setDamping(0.5);
+	reverb->setWidth(1);
+	reverb->setPanLevels(1 << 29, 1 << 29);
+
+	WavWriter wav;
+	if (wavDir) {
+		std::string path = std::string(wavDir) + "/" + patch.name + ".wav";
+		if (!wav.open(path)) {
+			fprintf(stderr, "Couldn't write %s\n", path.c_str());
+		}
+	}
+
+	for (int32_t block = 0; block < numBlocks; block++) {
+		{
+			StageTimer timer(totals[static_cast<int32_t>(Stage::OSCILLATOR)]);
+			renderOscillator(patch, &phase, oscBuffer.data());
+		}
+
+		{
+			StageTimer timer(totals[static_cast<int32_t>(Stage::FILTER_SET)]);
+			filterSet.setConfig(patch.lpfFrequency, patch.lpfResonance, patch.lpfMode, 0, patch.hpfFrequency, 0,
+			                    patch.hpfMode, 0, 134217728 << 1, patch.filterRoute, false, nullptr);
+			filterSet.renderLong(oscBuffer.begin(), oscBuffer.end(), kBlockSize);
+		}
+
+		for (int32_t i = 0; i < kBlockSize; i++) {
+			mixBuffer[i] = StereoSample{.l = oscBuffer[i], .r = oscBuffer[i]};
+		}
+
+		if (patch.delayFeedback) {
+			StageTimer timer(totals[static_cast<int32_t>(Stage::DELAY)]);
+			Delay::State delayWorkingState{};
+			delayWorkingState.delayFeedbackAmount = patch.delayFeedback;
+			delayWorkingState.userDelayRate = patch.delayRate;
+			delay.setupWorkingState(delayWorkingState, 0, true);
+			if (delayWorkingState.doDelay) {
+				delay.process(mixBuffer, delayWorkingState);
+			}
+		}
+
+		if (patch.reverb) {
+			StageTimer timer(totals[static_cast<int32_t>(Stage::REVERB)]);
+			for (int32_t i = 0; i < kBlockSize; i++) {
+				reverbSend[i] = (mixBuffer[i].l >> 1) + (mixBuffer[i].r >> 1);
+			}
+			reverb->process(reverbSend, mixBuffer);
+		}
+
+		wav.write(mixBuffer.data(), kBlockSize);
+	}
+
+	delete reverb;
+
+	uint64_t numSamples = (uint64_t)numBlocks * kBlockSize;
+	printf("\n%s\n", patch.name);
+	printf("  %-12s %14s %12s %12s\n", "stage", "cycles/sample", "ns/sample", "x realtime");
+	for (int32_t s = 0; s < kNumStages; s++) {
+		if (!totals[s].nanoseconds) {
+			continue; // Stage not used by this patch
+		}
+		double nsPerSample = (double)totals[s].nanoseconds / numSamples;
+		printf("  %-12s ", kStageNames[s]);
+		if (haveCycleCounter) {
+			printf("%14.1f ", (double)totals[s].cycles / numSamples);
+		}
+		else {
+			printf("%14s ", "-");
+		}
+		printf("%12.2f %12.0f\n", nsPerSample, 1e9 / (nsPerSample * kSampleRate));
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	double seconds = 10;
+	char const* wavDir = nullptr;
+
+	for (int32_t i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+			seconds = atof(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--wav-dir") && i + 1 < argc) {
+			wavDir = argv[++i];
+		}
+		else {
+			fprintf(stderr, "usage: %s [--seconds N] [--wav-dir DIR]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	int32_t numBlocks = std::max<int32_t>(1, seconds * kSampleRate / kBlockSize);
+	bool haveCycleCounter = StageTimer::haveCycleCounter();
+
+	printf("Rendering %.1f s of audio per patch, in blocks of %d samples\n", (double)numBlocks * kBlockSize / kSampleRate,
+	       kBlockSize);
+	if (!haveCycleCounter) {
+		printf("No cycle counter on this host, so only times are shown\n");
+	}
+
+	for (Patch const& patch : kPatches) {
+		renderPatch(patch, numBlocks, wavDir, haveCycleCounter);
+	}
+
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/binary/binary_format.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace deluge::storage::binary;
+
+TEST_GROUP(BinaryFormatTest){};
+
+TEST(BinaryFormatTest, varintRoundTrip) {
+	uint32_t values[] = {0, 1, 127, 128, 300, 16383, 16384, 0x0FFFFFFF, 0xFFFFFFFF};
+	for (uint32_t value : values) {
+		uint8_t bytes[kMaxVarintBytes];
+		int32_t numBytes = encodeVarint(value, bytes);
+		CHECK(numBytes >= 1 && numBytes <= kMaxVarintBytes);
+
+		uint32_t decoded = 0;
+		CHECK_EQUAL(numBytes, decodeVarint(bytes, numBytes, &decoded));
+		CHECK_EQUAL(value, decoded);
+
+		// Cut short, it shouldn't decode
+		CHECK_EQUAL(0, decodeVarint(bytes, numBytes - 1, &decoded));
+	}
+
+	uint8_t bytes[kMaxVarintBytes];
+	CHECK_EQUAL(1, encodeVarint(127, bytes));
+	CHECK_EQUAL(2, encodeVarint(128, bytes));
+	CHECK_EQUAL(5, encodeVarint(0xFFFFFFFF, bytes));
+}
+
+TEST(BinaryFormatTest, zigzagRoundTrip) {
+	int32_t values[] = {0, 1, -1, 63, -64, 2147483647, -2147483647 - 1};
+	for (int32_t value : values) {
+		CHECK_EQUAL(value, zigzagDecode(zigzagEncode(value)));
+	}
+	CHECK_EQUAL(0, zigzagEncode(0));
+	CHECK_EQUAL(1, zigzagEncode(-1));
+	CHECK_EQUAL(2, zigzagEncode(1));
+}
+
+TEST(BinaryFormatTest, headerRoundTrip) {
+	uint8_t header = makeHeader(RecordKind::TAG_VALUE, ValueType::TEXT) | kHeaderNewName;
+	CHECK(headerKind(header) == RecordKind::TAG_VALUE);
+	CHECK(headerType(header) == ValueType::TEXT);
+	CHECK(headerKind(makeHeader(RecordKind::CLOSE)) == RecordKind::CLOSE);
+}
+
+TEST(BinaryFormatTest, canonicalInt) {
+	int32_t value;
+	CHECK(textIsCanonicalInt("0", &value));
+	CHECK_EQUAL(0, value);
+	CHECK(textIsCanonicalInt("-25", &value));
+	CHECK_EQUAL(-25, value);
+	CHECK(textIsCanonicalInt("2147483647", &value));
+	CHECK_EQUAL(2147483647, value);
+	CHECK(textIsCanonicalInt("-2147483648", &value));
+	CHECK_EQUAL(-2147483647 - 1, value);
+
+	// These wouldn't come back out the same
+	CHECK_FALSE(textIsCanonicalInt("", &value));
+	CHECK_FALSE(textIsCanonicalInt("-", &value));
+	CHECK_FALSE(textIsCanonicalInt("-0", &value));
+	CHECK_FALSE(textIsCanonicalInt("007", &value));
+	CHECK_FALSE(textIsCanonicalInt("+7", &value));
+	CHECK_FALSE(textIsCanonicalInt("12a", &value));
+	CHECK_FALSE(textIsCanonicalInt("2147483648", &value));
+	CHECK_FALSE(textIsCanonicalInt("-2147483649", &value));
+}
+
+TEST(BinaryFormatTest, canonicalHex) {
+	uint32_t value;
+	int32_t numChars;
+	CHECK(textIsCanonicalHex("0x7FFFFFFF", &value, &numChars));
+	CHECK_EQUAL(0x7FFFFFFF, value);
+	CHECK_EQUAL(8, numChars);
+	CHECK(textIsCanonicalHex("0x00A", &value, &numChars));
+	CHECK_EQUAL(0xA, value);
+	CHECK_EQUAL(3, numChars);
+
+	CHECK_FALSE(textIsCanonicalHex("0x", &value, &numChars));
+	CHECK_FALSE(textIsCanonicalHex("0x7fff", &value, &numChars));
+	CHECK_FALSE(textIsCanonicalHex("0x123456789", &value, &numChars));
+	CHECK_FALSE(textIsCanonicalHex("1234", &value, &numChars));
+}
+
+TEST(BinaryFormatTest, nameTable) {
+	static NameTable names;
+	names.clear();
+
+	CHECK_EQUAL(-1, names.find("song", 4));
+	CHECK_EQUAL(0, names.add("song", 4));
+	CHECK_EQUAL(1, names.add("songParams", 10));
+	CHECK_EQUAL(0, names.find("song", 4));
+	CHECK_EQUAL(1, names.find("songParams", 10));
+	CHECK_EQUAL(-1, names.find("son", 3));
+	STRCMP_EQUAL("songParams", names.get(1));
+	CHECK(names.get(2) == nullptr);
+
+	// Finding by length means names needn't be null-terminated
+	CHECK_EQUAL(0, names.find("songX", 4));
+
+	names.clear();
+	CHECK_EQUAL(0, names.getNumNames());
+	CHECK_EQUAL(-1, names.find("song", 4));
+}
+
+TEST(BinaryFormatTest, nameTableFull) {
+	static NameTable names;
+	names.clear();
+
+	char name[8];
+	int32_t i = 0;
+	for (; i < NameTable::kMaxNames; i++) {
+		int32_t length = snprintf(name, sizeof(name), "n%d", (int)i);
+		CHECK_EQUAL(i, names.add(name, length));
+	}
+	CHECK_EQUAL(-1, names.add("extra", 5));
+
+	// And everything is still findable
+	for (i = 0; i < NameTable::kMaxNames; i++) {
+		int32_t length = snprintf(name, sizeof(name), "n%d", (int)i);
+		CHECK_EQUAL(i, names.find(name, length));
+	}
+}
@@ -0,0 +1,96 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/cluster/cluster_run.h"
+#include "util/container/heap/intrusive_pairing_heap.hpp"
+#include <array>
+
+namespace {
+
+// Just what abandonClusterRun() and the queue need of a Cluster, plus where AudioFileManager would have put it
+struct FakeCluster {
+	int32_t numReasonsToBeLoaded = 0;
+	bool deallocated = false;
+	bool stealable = false;
+	deluge::PairingHeapNode<FakeCluster> loadingQueueNode{this};
+};
+
+// Same interface as ClusterPriorityQueue, as far as abandonClusterRun() goes
+struct FakeQueue {
+	void add(FakeCluster* cluster, uint32_t priorityRating) { heap.insert(&cluster->loadingQueueNode, priorityRating); }
+	bool removeIfPresent(FakeCluster* cluster) { return heap.remove(&cluster->loadingQueueNode); }
+	bool checkPresent(FakeCluster* cluster) const { return heap.contains(&cluster->loadingQueueNode); }
+
+	deluge::IntrusivePairingHeap<FakeCluster> heap;
+};
+
+constexpr int32_t kRunLength = 4;
+
+struct FailedRead {
+	std::array<FakeCluster, kRunLength> clusters;
+	std::array<FakeCluster*, kRunLength> run;
+	FakeQueue loadingQueue;
+
+	// What AudioFileManager::removeReasonFromCluster() does
+	void removeReason(FakeCluster* cluster) {
+		cluster->numReasonsToBeLoaded--;
+		if (cluster->numReasonsToBeLoaded == 0) {
+			if (loadingQueue.removeIfPresent(cluster)) {
+				cluster->deallocated = true;
+			}
+			else {
+				cluster->stealable = true;
+			}
+		}
+	}
+
+	// As loadClusterRun() leaves things just before the read: gatherClusterRun() took the run out of the queue, where
+	// each had its own priority, and each got one more reason for the read itself
+	FailedRead() {
+		for (int32_t i = 0; i < kRunLength; i++) {
+			run[i] = &clusters[i];
+			loadingQueue.add(run[i], 1000 + i);
+			loadingQueue.removeIfPresent(run[i]);
+			clusters[i].numReasonsToBeLoaded = 2;
+		}
+	}
+
+	void fail() {
+		abandonClusterRun(std::span<FakeCluster*>{run}, loadingQueue,
+		                  [this](FakeCluster* cluster) { removeReason(cluster); });
+	}
+};
+
+} // namespace
+
+TEST_GROUP(ClusterRunTest){};
+
+TEST(ClusterRunTest, restOfRunGoesBackInQueue) {
+	FailedRead read;
+	read.fail();
+
+	// The first's left to the caller, which will try it again by itself
+	CHECK_FALSE(read.loadingQueue.checkPresent(read.run[0]));
+	CHECK_EQUAL(1, read.run[0]->numReasonsToBeLoaded);
+
+	for (int32_t i = 1; i < kRunLength; i++) {
+		CHECK(read.loadingQueue.checkPresent(read.run[i]));
+		CHECK_EQUAL(1000 + i, read.run[i]->loadingQueueNode.key);
+		CHECK_EQUAL(1, read.run[i]->numReasonsToBeLoaded);
+	}
+	CHECK_EQUAL(kRunLength - 1, read.loadingQueue.heap.size());
+}
+
+TEST(ClusterRunTest, unwantedClusterIsDeallocatedNotStealable) {
+	FailedRead read;
+
+	// The voice that wanted this one stopped while the card was being read
+	read.run[2]->numReasonsToBeLoaded = 1;
+	read.fail();
+
+	CHECK(read.run[2]->deallocated);
+	CHECK_FALSE(read.run[2]->stealable);
+	CHECK_FALSE(read.loadingQueue.checkPresent(read.run[2]));
+
+	CHECK(read.loadingQueue.checkPresent(read.run[1]));
+	CHECK(read.loadingQueue.checkPresent(read.run[3]));
+	CHECK_EQUAL(kRunLength - 2, read.loadingQueue.heap.size());
+}
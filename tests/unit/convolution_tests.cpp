@@ -0,0 +1,196 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/convolution/partitioned_convolver.h"
+#include "dsp/reverb/convolution/convolution.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using deluge::dsp::PartitionedConvolver;
+using deluge::dsp::reverb::Convolution;
+
+namespace {
+
+std::vector<q31_t> makeImpulseResponse(int32_t length, uint32_t seed) {
+	// Decaying noise, scaled so its energy is about 1, as the loader leaves IRs
+	std::mt19937 rng(seed);
+	std::normal_distribution<double> noise;
+	std::vector<q31_t> ir(length);
+	double decay = std::exp(-6.0 / length);
+	double amplitude = 1;
+	double energy = 0;
+	std::vector<double> values(length);
+	for (int32_t i = 0; i < length; i++) {
+		values[i] = noise(rng) * amplitude;
+		energy += values[i] * values[i];
+		amplitude *= decay;
+	}
+	double gain = 0.5 / std::sqrt(energy);
+	for (int32_t i = 0; i < length; i++) {
+		ir[i] = (q31_t)(values[i] * gain * 2147483648.0);
+	}
+	return ir;
+}
+
+std::vector<q31_t> makeInput(int32_t length, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int32_t> sample(-(1 << 28), 1 << 28);
+	std::vector<q31_t> input(length);
+	for (q31_t& value : input) {
+		value = sample(rng);
+	}
+	return input;
+}
+
+double directConvolution(std::vector<q31_t> const& input, std::vector<q31_t> const& ir, int32_t n) {
+	double sum = 0;
+	for (int32_t k = 0; k < (int32_t)ir.size() && k <= n; k++) {
+		sum += (double)input[n - k] * ir[k];
+	}
+	return sum / 2147483648.0;
+}
+
+// Runs the input through in uneven chunks, as the audio engine might, and checks it against the direct convolution
+void checkAgainstDirect(PartitionedConvolver& convolver, std::vector<q31_t> const& irL,
+                        std::vector<q31_t> const& irR, int32_t numSamples) {
+	std::vector<q31_t> inputL = makeInput(numSamples, 1);
+	std::vector<q31_t> inputR = makeInput(numSamples, 2);
+
+	std::vector<StereoSample> buffer(numSamples);
+	for (int32_t i = 0; i < numSamples; i++) {
+		buffer[i] = StereoSample{.l = inputL[i], .r = inputR[i]};
+	}
+	int32_t chunkSizes[] = {128, 1, 77, 128, 3, 100};
+	int32_t pos = 0;
+	for (int32_t c = 0; pos < numSamples; c++) {
+		int32_t chunk = std::min(chunkSizes[c % 6], numSamples - pos);
+		convolver.process(std::span<StereoSample>(&buffer[pos], chunk));
+		pos += chunk;
+	}
+
+	int32_t latency = convolver.getLatency();
+	for (int32_t i = 0; i < latency; i++) {
+		CHECK_EQUAL(0, buffer[i].l);
+		CHECK_EQUAL(0, buffer[i].r);
+	}
+
+	// Allow an error of about -100dB relative to the input level
+	double maxError = 0;
+	for (int32_t n = 0; n + latency < numSamples; n++) {
+		maxError = std::max(maxError, std::fabs(buffer[n + latency].l - directConvolution(inputL, irL, n)));
+		maxError = std::max(maxError, std::fabs(buffer[n + latency].r - directConvolution(inputR, irR, n)));
+	}
+	CHECK((maxError / (1 << 28)) < 1e-5);
+}
+
+} // namespace
+
+TEST_GROUP(ConvolutionTest){};
+
+TEST(ConvolutionTest, unloadedIsSilent) {
+	PartitionedConvolver convolver;
+	CHECK(!convolver.isLoaded());
+	CHECK_EQUAL(0, convolver.getLatency());
+
+	StereoSample buffer[4] = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+	convolver.process(buffer);
+	for (StereoSample& sample : buffer) {
+		CHECK_EQUAL(0, sample.l);
+		CHECK_EQUAL(0, sample.r);
+	}
+}
+
+TEST(ConvolutionTest, impulseGivesImpulseResponse) {
+	std::vector<q31_t> ir = makeImpulseResponse(300, 5);
+	PartitionedConvolver convolver;
+	CHECK(convolver.setImpulseResponse(ir.data(), nullptr, ir.size()) == Error::NONE);
+	CHECK_EQUAL(1 << PartitionedConvolver::kDefaultPartitionMagnitude, convolver.getLatency());
+
+	std::vector<StereoSample> buffer(1024);
+	buffer[0] = StereoSample{.l = ONE_Q31, .r = -ONE_Q31};
+	convolver.process(buffer);
+
+	int32_t latency = convolver.getLatency();
+	for (int32_t i = 0; i < (int32_t)ir.size(); i++) {
+		CHECK(std::abs(buffer[latency + i].l - ir[i]) < 1024);
+		CHECK(std::abs(buffer[latency + i].r + ir[i]) < 1024);
+	}
+	for (int32_t i = latency + ir.size(); i < (int32_t)buffer.size(); i++) {
+		CHECK(std::abs(buffer[i].l) < 1024);
+	}
+}
+
+TEST(ConvolutionTest, monoMatchesDirect) {
+	std::vector<q31_t> ir = makeImpulseResponse(1000, 3);
+	PartitionedConvolver convolver;
+	CHECK(convolver.setImpulseResponse(ir.data(), nullptr, ir.size()) == Error::NONE);
+	checkAgainstDirect(convolver, ir, ir, 3000);
+}
+
+TEST(ConvolutionTest, stereoMatchesDirect) {
+	std::vector<q31_t> irL = makeImpulseResponse(700, 7);
+	std::vector<q31_t> irR = makeImpulseResponse(700, 8);
+	PartitionedConvolver convolver;
+	CHECK(convolver.setImpulseResponse(irL.data(), irR.data(), irL.size(), 5) == Error::NONE);
+	CHECK_EQUAL(32, convolver.getLatency());
+	checkAgainstDirect(convolver, irL, irR, 2000);
+}
+
+TEST(ConvolutionTest, resetClearsTail) {
+	std::vector<q31_t> ir = makeImpulseResponse(500, 9);
+	PartitionedConvolver convolver;
+	CHECK(convolver.setImpulseResponse(ir.data(), nullptr, ir.size()) == Error::NONE);
+
+	std::vector<StereoSample> buffer(256, StereoSample{.l = 1 << 28, .r = 1 << 28});
+	convolver.process(buffer);
+	convolver.reset();
+
+	std::vector<StereoSample> silence(1024);
+	convolver.process(silence);
+	for (StereoSample& sample : silence) {
+		CHECK_EQUAL(0, sample.l);
+		CHECK_EQUAL(0, sample.r);
+	}
+}
+
+TEST(ConvolutionTest, reverbModelSilentUntilLoaded) {
+	PartitionedConvolver convolver;
+	Convolution reverb{convolver};
+	reverb.setPanLevels(ONE_Q31, ONE_Q31);
+
+	std::vector<int32_t> input(256, 1 << 28);
+	std::vector<StereoSample> output(256, StereoSample{.l = 5, .r = 6});
+	reverb.process(input, output);
+	for (StereoSample& sample : output) {
+		CHECK_EQUAL(5, sample.l);
+		CHECK_EQUAL(6, sample.r);
+	}
+}
+
+TEST(ConvolutionTest, reverbModelPlaysIR) {
+	std::vector<q31_t> ir = makeImpulseResponse(2000, 11);
+	PartitionedConvolver convolver;
+	CHECK(convolver.setImpulseResponse(ir.data(), nullptr, ir.size(), Convolution::kPartitionMagnitude)
+	      == Error::NONE);
+	Convolution reverb{convolver};
+	reverb.setPanLevels(ONE_Q31, ONE_Q31);
+
+	// Through in blocks of the audio engine's size, which the model splits up further
+	std::vector<int32_t> input(4096);
+	input[0] = 1 << 30;
+	std::vector<StereoSample> output(input.size());
+	for (size_t pos = 0; pos < input.size(); pos += 128) {
+		reverb.process({&input[pos], 128}, {&output[pos], 128});
+	}
+
+	int32_t latency = convolver.getLatency();
+	CHECK_EQUAL(1 << Convolution::kPartitionMagnitude, latency);
+	for (int32_t i = 0; i < latency; i++) {
+		CHECK_EQUAL(0, output[i].l);
+	}
+	// A mono IR comes out the same on both sides, at a quarter of its level: the impulse is half of full scale, and
+	// full pan level halves it again. The HPF takes a little off
+	for (int32_t i = 0; i < (int32_t)ir.size(); i++) {
+		CHECK_EQUAL(output[latency + i].l, output[latency + i].r);
+		CHECK(std::abs(output[latency + i].l - ir[i] / 4) < (1 << 18));
+	}
+}
@@ -0,0 +1,94 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/reverb/fdn/fdn.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+using deluge::dsp::reverb::FDN;
+
+namespace {
+
+constexpr size_t kBlockSize = 128;
+
+// Sends an impulse in, then runs the reverb for numBlocks with nothing going in, returning the RMS of the output in
+// the first and last quarters. Peaks would depend on the rate, as the impulse gets smoothed out on the way down
+std::array<double, 2> ringOut(FDN& fdn, int32_t numBlocks) {
+	std::array<int32_t, kBlockSize> input{};
+	std::array<StereoSample, kBlockSize> output{};
+	std::array<double, 2> energy{};
+
+	for (int32_t block = 0; block < numBlocks; block++) {
+		input.fill(0);
+		if (block == 0) {
+			input[0] = 0x40000000;
+		}
+		output.fill({0, 0});
+		fdn.process(input, output);
+
+		int32_t quarter = block * 4 / numBlocks;
+		if (quarter != 0 && quarter != 3) {
+			continue;
+		}
+		for (auto& sample : output) {
+			energy[quarter == 3] += (double)sample.l * sample.l + (double)sample.r * sample.r;
+		}
+	}
+	double numSamples = 2. * kBlockSize * (numBlocks / 4);
+	return {std::sqrt(energy[0] / numSamples), std::sqrt(energy[1] / numSamples)};
+}
+
+std::unique_ptr<FDN> makeFDN(FDN::Rate rate) {
+	auto fdn = std::make_unique<FDN>();
+	fdn->setPanLevels(0x7FFFFFFF, 0x7FFFFFFF);
+	fdn->setRoomSize(0.5);
+	fdn->setDamping(0.5);
+	fdn->setRate(rate);
+	return fdn;
+}
+
+} // namespace
+
+TEST_GROUP(FDNReverbTest){};
+
+TEST(FDNReverbTest, tailDecaysAtEveryRate) {
+	for (auto rate : {FDN::Rate::FULL, FDN::Rate::HALF, FDN::Rate::QUARTER}) {
+		auto fdn = makeFDN(rate);
+		// About 5 seconds, which is longer than the decay time for this room size
+		auto levels = ringOut(*fdn, 44100 * 5 / kBlockSize);
+		CHECK(levels[0] > 0x1000);
+		CHECK(levels[1] < levels[0] / 100);
+	}
+}
+
+TEST(FDNReverbTest, ratesSoundAlike) {
+	auto full = makeFDN(FDN::Rate::FULL);
+	auto quarter = makeFDN(FDN::Rate::QUARTER);
+	auto fullLevels = ringOut(*full, 344);
+	auto quarterLevels = ringOut(*quarter, 344);
+
+	// Same level to within about 6dB
+	CHECK(quarterLevels[0] > fullLevels[0] / 2);
+	CHECK(quarterLevels[0] < fullLevels[0] * 2);
+}
+
+TEST(FDNReverbTest, biggerRoomsRingLonger) {
+	auto small = makeFDN(FDN::Rate::HALF);
+	auto big = makeFDN(FDN::Rate::HALF);
+	small->setRoomSize(0.2);
+	big->setRoomSize(0.8);
+	CHECK(big->getDecayTime() > small->getDecayTime());
+
+	auto smallLevels = ringOut(*small, 344);
+	auto bigLevels = ringOut(*big, 344);
+	CHECK(bigLevels[1] > smallLevels[1]);
+}
+
+TEST(FDNReverbTest, staysStableAtTheLongestSetting) {
+	auto fdn = makeFDN(FDN::Rate::FULL);
+	fdn->setRoomSize(1);
+	fdn->setDamping(0);
+
+	auto levels = ringOut(*fdn, 44100 * 20 / kBlockSize);
+	CHECK(levels[1] < levels[0]);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Just enough of the allocator and audio engine for the DSP under test, and NE10's FFTs
+
+#include "NE10.h"
+#include <cstdint>
+#include <cstdlib>
+
+void* allocMaxSpeed(uint32_t requiredSize, void* thingNotToStealFrom) {
+	return malloc(requiredSize);
+}
+
+void* allocLowSpeed(uint32_t requiredSize, void* thingNotToStealFrom) {
+	return malloc(requiredSize);
+}
+
+extern "C" {
+void* delugeAlloc(unsigned int requiredSize, bool mayUseOnChipRam) {
+	return malloc(requiredSize);
+}
+
+void delugeDealloc(void* address) {
+	free(address);
+}
+
+void routineWithClusterLoading() {
+}
+
+// NE10_fft.c refers to this, but we don't build the float FFTs
+ne10_fft_cfg_float32_t ne10_fft_alloc_c2c_float32_c(ne10_int32_t nfft) {
+	return nullptr;
+}
+}
@@ -0,0 +1,92 @@
+#include "CppUTest/TestHarness.h"
+#include "util/container/heap/intrusive_pairing_heap.hpp"
+#include <cstdlib>
+
+namespace {
+
+struct Item {
+	Item() = default;
+	deluge::PairingHeapNode<Item> node{this};
+};
+
+constexpr int32_t kNumItems = 200;
+
+} // namespace
+
+TEST_GROUP(PairingHeapTest){};
+
+TEST(PairingHeapTest, popsInOrder) {
+	Item items[kNumItems];
+	deluge::IntrusivePairingHeap<Item> heap;
+
+	srand(1);
+	for (auto& item : items) {
+		heap.insert(&item.node, rand() % 1000);
+	}
+	CHECK_EQUAL(kNumItems, heap.size());
+
+	uint32_t last = 0;
+	while (!heap.empty()) {
+		auto* node = heap.pop();
+		CHECK(node->key >= last);
+		CHECK_FALSE(heap.contains(node));
+		last = node->key;
+	}
+	CHECK_EQUAL(0, heap.size());
+	CHECK(heap.pop() == nullptr);
+}
+
+TEST(PairingHeapTest, maxHeap) {
+	Item items[kNumItems];
+	deluge::IntrusivePairingHeap<Item, std::greater<uint32_t>> heap;
+
+	for (int32_t i = 0; i < kNumItems; i++) {
+		heap.insert(&items[i].node, i);
+	}
+	CHECK(heap.top()->owner == &items[kNumItems - 1]);
+}
+
+TEST(PairingHeapTest, removeAndUpdate) {
+	Item items[kNumItems];
+	deluge::IntrusivePairingHeap<Item> heap;
+
+	for (int32_t i = 0; i < kNumItems; i++) {
+		heap.insert(&items[i].node, i + 1000);
+	}
+	heap.pop(); // Force some structure so removals aren't all from the root list
+
+	// Remove every third one
+	for (int32_t i = 1; i < kNumItems; i += 3) {
+		CHECK(heap.remove(&items[i].node));
+		CHECK_FALSE(heap.contains(&items[i].node));
+		CHECK_FALSE(heap.remove(&items[i].node));
+	}
+
+	// Move some towards the top, and some away from it
+	heap.updateKey(&items[kNumItems - 2].node, 1);
+	heap.updateKey(&items[2].node, 5000);
+	CHECK(heap.top()->owner == &items[kNumItems - 2]);
+
+	uint32_t last = 0;
+	int32_t count = 0;
+	while (auto* node = heap.pop()) {
+		CHECK(node->key >= last);
+		last = node->key;
+		count++;
+	}
+	CHECK_EQUAL(kNumItems - 1 - (kNumItems - 1 + 2) / 3, count);
+	CHECK_EQUAL(5000, last);
+}
+
+TEST(PairingHeapTest, otherHeapDoesNotContain) {
+	Item item;
+	deluge::IntrusivePairingHeap<Item> a;
+	deluge::IntrusivePairingHeap<Item> b;
+
+	a.insert(&item.node, 7);
+	CHECK(a.contains(&item.node));
+	CHECK_FALSE(b.contains(&item.node));
+	CHECK_FALSE(b.remove(&item.node));
+	CHECK(a.remove(&item.node));
+	CHECK(a.empty());
+}
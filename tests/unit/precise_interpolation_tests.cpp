@@ -0,0 +1,96 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/interpolation/precise.h"
+#include <cstdint>
+#include <cstdlib>
+
+using namespace deluge::dsp::interpolation;
+
+namespace {
+
+constexpr uint32_t kMask24 = 0xFFFFFF00;
+
+// Newest first, as SampleLowLevelReader keeps them
+void fill(int32_t buffer[][kPreciseNumTaps], int32_t c, int32_t value) {
+	for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+		buffer[c][i] = value;
+	}
+}
+
+} // namespace
+
+TEST_GROUP(PreciseInterpolationTest){void setup(){initPreciseKernels();
+}
+}
+;
+
+TEST(PreciseInterpolationTest, phaseZeroGivesTheSampleBackExactly) {
+	int32_t buffer[2][kPreciseNumTaps] = {};
+	for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+		buffer[0][i] = (i * 0x01234500) ^ 0x55555500;
+	}
+
+	int32_t sampleRead[2];
+	interpolatePrecise(sampleRead, buffer, 1, 0, 0, kMask24);
+
+	// Half-scale, and the kernel's 1 is really 0x7FFFFFFF, so it can be out by one at the very bottom
+	int32_t expected = buffer[0][kPreciseNumTaps / 2] >> 1;
+	CHECK(std::abs(sampleRead[0] - expected) <= 1);
+}
+
+TEST(PreciseInterpolationTest, lowBitsSurvive) {
+	// Two 24-bit values which a 16-bit interpolation couldn't tell apart
+	int32_t buffer[2][kPreciseNumTaps];
+	int32_t sampleRead[2][2];
+
+	fill(buffer, 0, 0x12340000);
+	interpolatePrecise(sampleRead[0], buffer, 1, 1 << 23, 3, kMask24);
+	fill(buffer, 0, 0x1234FF00);
+	interpolatePrecise(sampleRead[1], buffer, 1, 1 << 23, 3, kMask24);
+
+	CHECK(sampleRead[1][0] - sampleRead[0][0] > 0x7000);
+}
+
+TEST(PreciseInterpolationTest, unityGainAtEveryPhase) {
+	int32_t buffer[2][kPreciseNumTaps];
+	fill(buffer, 0, 0x40000000);
+
+	for (int32_t k = 0; k < kPreciseNumKernels; k++) {
+		for (uint32_t oscPos = 0; oscPos < (1 << 24); oscPos += 77777) {
+			int32_t sampleRead[2];
+			interpolatePrecise(sampleRead, buffer, 1, oscPos, k, kMask24);
+			CHECK(std::abs(sampleRead[0] - 0x20000000) < 64);
+		}
+	}
+}
+
+TEST(PreciseInterpolationTest, bitMaskGetsApplied) {
+	int32_t buffer[2][kPreciseNumTaps];
+	int32_t sampleRead[2][2];
+
+	// What's below a 16-bit sample is just the end of the one before it
+	fill(buffer, 0, 0x40000000);
+	interpolatePrecise(sampleRead[0], buffer, 1, 1234567, 2, 0xFFFF0000);
+	fill(buffer, 0, 0x4000ABCD);
+	interpolatePrecise(sampleRead[1], buffer, 1, 1234567, 2, 0xFFFF0000);
+
+	CHECK_EQUAL(sampleRead[0][0], sampleRead[1][0]);
+}
+
+TEST(PreciseInterpolationTest, stereoMatchesTwoMonos) {
+	int32_t buffer[2][kPreciseNumTaps];
+	for (int32_t i = 0; i < kPreciseNumTaps; i++) {
+		buffer[0][i] = i * 0x03000000 - 0x20000000;
+		buffer[1][i] = 0x10000000 - i * 0x01800000;
+	}
+
+	int32_t stereo[2];
+	interpolatePrecise(stereo, buffer, 2, 9876543, 4, kMask24);
+
+	int32_t left[2];
+	interpolatePrecise(left, buffer, 1, 9876543, 4, kMask24);
+	int32_t right[2];
+	interpolatePrecise(right, &buffer[1], 1, 9876543, 4, kMask24);
+
+	CHECK_EQUAL(left[0], stereo[0]);
+	CHECK_EQUAL(right[0], stereo[1]);
+}
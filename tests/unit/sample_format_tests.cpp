@@ -0,0 +1,153 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/convert/sample_format.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace deluge::dsp::convert;
+
+namespace {
+
+// What the float conversion should give, worked out the slow way
+int32_t referenceFloatToQ31(uint32_t bits) {
+	float value = std::bit_cast<float>(bits);
+	if (std::isnan(value) || std::fabs(value) >= 1) {
+		return (bits >> 31) ? -2147483647 : 2147483647;
+	}
+	return (int32_t)std::trunc((double)value * 2147483648.0);
+}
+
+// Lengths either side of the vector width, so the tails get tested too
+constexpr size_t kLengths[] = {0, 1, 3, 4, 5, 15, 16, 17, 33, 256};
+
+} // namespace
+
+TEST_GROUP(SampleFormatTest){};
+
+TEST(SampleFormatTest, floatEdgeCases) {
+	float values[] = {0.0f,
+	                  -0.0f,
+	                  1.0f,
+	                  -1.0f,
+	                  0.5f,
+	                  -0.5f,
+	                  0.999999940f,
+	                  -0.999999940f,
+	                  2.0f,
+	                  -3.5f,
+	                  std::numeric_limits<float>::denorm_min(),
+	                  -std::numeric_limits<float>::denorm_min(),
+	                  std::numeric_limits<float>::min(),
+	                  std::numeric_limits<float>::infinity(),
+	                  -std::numeric_limits<float>::infinity(),
+	                  std::numeric_limits<float>::quiet_NaN(),
+	                  1.0f / 2147483648.0f,
+	                  1.0f / 4294967296.0f};
+	constexpr size_t kNumValues = sizeof(values) / sizeof(values[0]);
+
+	uint32_t data[kNumValues];
+	for (size_t i = 0; i < kNumValues; i++) {
+		data[i] = std::bit_cast<uint32_t>(values[i]);
+	}
+	floatToQ31(data, kNumValues);
+
+	for (size_t i = 0; i < kNumValues; i++) {
+		uint32_t bits = std::bit_cast<uint32_t>(values[i]);
+		CHECK_EQUAL(referenceFloatToQ31(bits), (int32_t)data[i]);
+		CHECK_EQUAL(referenceFloatToQ31(bits), floatBitPatternToQ31(bits));
+	}
+
+	CHECK_EQUAL(0, floatBitPatternToQ31(std::bit_cast<uint32_t>(0.0f)));
+	CHECK_EQUAL(2147483647, floatBitPatternToQ31(std::bit_cast<uint32_t>(1.0f)));
+	CHECK_EQUAL(-2147483647, floatBitPatternToQ31(std::bit_cast<uint32_t>(-1.0f)));
+	CHECK_EQUAL(1 << 30, floatBitPatternToQ31(std::bit_cast<uint32_t>(0.5f)));
+}
+
+TEST(SampleFormatTest, floatRandom) {
+	std::mt19937 rng(1234);
+	for (size_t length : kLengths) {
+		std::vector<uint32_t> data(length);
+		for (uint32_t& word : data) {
+			word = rng();
+		}
+		std::vector<uint32_t> original = data;
+
+		floatToQ31(data.data(), length);
+		for (size_t i = 0; i < length; i++) {
+			CHECK_EQUAL(referenceFloatToQ31(original[i]), (int32_t)data[i]);
+		}
+	}
+}
+
+TEST(SampleFormatTest, swapBytes32) {
+	for (size_t length : kLengths) {
+		std::vector<uint32_t> data(length);
+		for (size_t i = 0; i < length; i++) {
+			data[i] = 0x01020304 + i * 0x10101010;
+		}
+		std::vector<uint32_t> original = data;
+
+		swapBytes32(data.data(), length);
+		for (size_t i = 0; i < length; i++) {
+			uint32_t o = original[i];
+			CHECK_EQUAL((o >> 24) | ((o >> 8) & 0xFF00) | ((o << 8) & 0xFF0000) | (o << 24), data[i]);
+		}
+	}
+}
+
+TEST(SampleFormatTest, swapBytes16) {
+	uint32_t word = 0x11223344;
+	swapBytes16(&word, 1);
+	CHECK_EQUAL(0x22114433, word);
+
+	for (size_t length : kLengths) {
+		std::vector<uint32_t> data(length);
+		for (size_t i = 0; i < length; i++) {
+			data[i] = 0xA1B2C3D4 - i * 0x01010101;
+		}
+		std::vector<uint32_t> original = data;
+
+		swapBytes16(data.data(), length);
+		for (size_t i = 0; i < length; i++) {
+			uint32_t o = original[i];
+			CHECK_EQUAL(((o & 0x00FF00FF) << 8) | ((o & 0xFF00FF00) >> 8), data[i]);
+		}
+	}
+}
+
+TEST(SampleFormatTest, flipSign8) {
+	for (size_t length : kLengths) {
+		std::vector<uint32_t> data(length);
+		for (size_t i = 0; i < length; i++) {
+			data[i] = i * 0x01234567;
+		}
+		std::vector<uint32_t> original = data;
+
+		flipSign8(data.data(), length);
+		for (size_t i = 0; i < length; i++) {
+			CHECK_EQUAL(original[i] ^ 0x80808080, data[i]);
+		}
+	}
+}
+
+TEST(SampleFormatTest, swapBytes24) {
+	for (size_t length : kLengths) {
+		// A guard byte after the samples, which mustn't get touched
+		std::vector<uint8_t> data(length * 3 + 1);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = i * 7;
+		}
+		std::vector<uint8_t> original = data;
+
+		swapBytes24(data.data(), length);
+		for (size_t i = 0; i < length; i++) {
+			CHECK_EQUAL(original[i * 3 + 2], data[i * 3]);
+			CHECK_EQUAL(original[i * 3 + 1], data[i * 3 + 1]);
+			CHECK_EQUAL(original[i * 3], data[i * 3 + 2]);
+		}
+		CHECK_EQUAL(original.back(), data.back());
+	}
+}
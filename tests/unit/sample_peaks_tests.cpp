@@ -0,0 +1,192 @@
+#include "CppUTest/TestHarness.h"
+#include "model/sample/sample_peaks.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Little-endian 16-bit stereo, as a WAV file would hold it
+std::vector<uint8_t> makeStereo16(std::vector<int16_t> const& values) {
+	std::vector<uint8_t> bytes;
+	for (int16_t value : values) {
+		bytes.push_back(value & 0xFF);
+		bytes.push_back((value >> 8) & 0xFF);
+	}
+	return bytes;
+}
+
+// A ramp from -16384 up by 1 per frame, right channel the negative of left
+std::vector<int16_t> makeRamp(int32_t numFrames) {
+	std::vector<int16_t> values;
+	for (int32_t i = 0; i < numFrames; i++) {
+		int16_t value = (int16_t)(i - 16384);
+		values.push_back(value);
+		values.push_back((int16_t)-value);
+	}
+	return values;
+}
+
+void checkSpanMatches(SamplePeaks const& peaks, std::vector<int16_t> const& values, uint64_t start, uint64_t end) {
+	PeakEntry entry;
+	CHECK(peaks.getSpan(start, end, &entry));
+
+	// The entries covering the span may reach a little outside it, but never miss any of it
+	int16_t minInside = *std::min_element(&values[start * 2], &values[end * 2]);
+	int16_t maxInside = *std::max_element(&values[start * 2], &values[end * 2]);
+	CHECK(entry.min <= minInside);
+	CHECK(entry.max >= maxInside);
+}
+
+} // namespace
+
+TEST_GROUP(SamplePeaksTest){};
+
+TEST(SamplePeaksTest, spansCoverTheirFrames) {
+	constexpr int32_t kNumFrames = 20000;
+	std::vector<int16_t> values = makeRamp(kNumFrames);
+	std::vector<uint8_t> bytes = makeStereo16(values);
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(kNumFrames));
+	peaks.addFrames(bytes.data(), kNumFrames, 2, 2);
+	peaks.finish();
+	CHECK(peaks.getStatus() == SamplePeaks::Status::COMPLETE);
+	CHECK_EQUAL(kNumFrames, peaks.getNumFramesFed());
+
+	checkSpanMatches(peaks, values, 0, kNumFrames);
+	checkSpanMatches(peaks, values, 1000, 1600);
+	checkSpanMatches(peaks, values, 3000, 11000);
+	checkSpanMatches(peaks, values, 19000, kNumFrames);
+
+	PeakEntry entry;
+	CHECK(peaks.getSpan(0, kNumFrames, &entry));
+	CHECK_EQUAL(-16384, entry.min);
+	CHECK_EQUAL(16384, entry.max);
+}
+
+TEST(SamplePeaksTest, shortSpansAreLeftToTheRealData) {
+	std::vector<uint8_t> bytes = makeStereo16(makeRamp(4096));
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(4096));
+	peaks.addFrames(bytes.data(), 4096, 2, 2);
+	peaks.finish();
+
+	PeakEntry entry;
+	CHECK_FALSE(peaks.getSpan(100, 100 + SamplePeaks::kFramesPerBaseEntry - 1, &entry));
+	CHECK(peaks.getSpan(100, 100 + SamplePeaks::kFramesPerBaseEntry, &entry));
+}
+
+TEST(SamplePeaksTest, feedingInPiecesMatchesFeedingAtOnce) {
+	// Lengths leaving an odd number of entries on various levels, so their last ones get carried up when finishing
+	for (int32_t numFrames : {1536, 5632, 9999, 20000}) {
+		std::vector<uint8_t> bytes = makeStereo16(makeRamp(numFrames));
+
+		SamplePeaks whole;
+		CHECK(whole.setup(numFrames));
+		whole.addFrames(bytes.data(), numFrames, 2, 2);
+		whole.finish();
+
+		SamplePeaks pieces;
+		CHECK(pieces.setup(numFrames));
+		for (int32_t frame = 0; frame < numFrames; frame += 128) {
+			int32_t numFramesThisTime = std::min(128, numFrames - frame);
+			pieces.addFrames(&bytes[frame * 4], numFramesThisTime, 2, 2);
+		}
+		pieces.finish();
+
+		CHECK_EQUAL(whole.getTotalNumEntries(), pieces.getTotalNumEntries());
+		for (uint32_t i = 0; i < whole.getTotalNumEntries(); i++) {
+			CHECK_EQUAL(whole.getEntries()[i].min, pieces.getEntries()[i].min);
+			CHECK_EQUAL(whole.getEntries()[i].max, pieces.getEntries()[i].max);
+			CHECK_EQUAL(whole.getEntries()[i].rms, pieces.getEntries()[i].rms);
+		}
+	}
+}
+
+TEST(SamplePeaksTest, everyLevelIsMadeFromTheOneBelow) {
+	for (int32_t numFrames : {1536, 5632, 9999, 20000}) {
+		std::vector<uint8_t> bytes = makeStereo16(makeRamp(numFrames));
+
+		SamplePeaks peaks;
+		CHECK(peaks.setup(numFrames));
+		peaks.addFrames(bytes.data(), numFrames, 2, 2);
+		peaks.finish();
+
+		// Each entry covers the two below it, or just the one if that's the last on an odd-sized level
+		PeakEntry const* level = peaks.getEntries();
+		uint32_t numEntries = ((numFrames - 1) >> SamplePeaks::kBaseMagnitude) + 1;
+		while (numEntries > 1) {
+			PeakEntry const* upper = level + numEntries;
+			for (uint32_t i = 0; i < (numEntries + 1) >> 1; i++) {
+				uint32_t other = std::min(i * 2 + 1, numEntries - 1);
+				CHECK_EQUAL(std::min(level[i * 2].min, level[other].min), upper[i].min);
+				CHECK_EQUAL(std::max(level[i * 2].max, level[other].max), upper[i].max);
+			}
+			level = upper;
+			numEntries = (numEntries + 1) >> 1;
+		}
+		CHECK_EQUAL(peaks.getTotalNumEntries(), level + 1 - peaks.getEntries());
+		CHECK_EQUAL(-16384, level[0].min);
+		CHECK_EQUAL(16384, level[0].max);
+	}
+}
+
+TEST(SamplePeaksTest, onlyWhatsBeenFedCanBeLookedUp) {
+	std::vector<uint8_t> bytes = makeStereo16(makeRamp(8192));
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(8192));
+	peaks.addFrames(bytes.data(), 4096, 2, 2);
+	CHECK(peaks.getStatus() == SamplePeaks::Status::PENDING);
+
+	PeakEntry entry;
+	CHECK(peaks.getSpan(0, 4096, &entry));
+	CHECK_FALSE(peaks.getSpan(2048, 6144, &entry));
+}
+
+TEST(SamplePeaksTest, growKeepsWhatsBeenFed) {
+	constexpr int32_t kNumFrames = 12000;
+	std::vector<int16_t> values = makeRamp(kNumFrames);
+	std::vector<uint8_t> bytes = makeStereo16(values);
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(3000));
+	peaks.addFrames(bytes.data(), 2048, 2, 2);
+	CHECK(peaks.grow(kNumFrames));
+	peaks.addFrames(&bytes[2048 * 4], kNumFrames - 2048, 2, 2);
+	peaks.finish();
+	CHECK(peaks.getStatus() == SamplePeaks::Status::COMPLETE);
+
+	checkSpanMatches(peaks, values, 0, kNumFrames);
+	checkSpanMatches(peaks, values, 500, 2500);
+}
+
+TEST(SamplePeaksTest, overflowingFails) {
+	std::vector<uint8_t> bytes = makeStereo16(makeRamp(4096));
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(1024));
+	peaks.addFrames(bytes.data(), 4096, 2, 2);
+	peaks.finish();
+	CHECK(peaks.getStatus() == SamplePeaks::Status::FAILED);
+}
+
+TEST(SamplePeaksTest, twentyFourBitValuesUseTheirTopBits) {
+	// Mono, 24-bit: one loud negative frame, the rest silence
+	std::vector<uint8_t> bytes(1024 * 3, 0);
+	bytes[300 * 3 + 0] = 0x00;
+	bytes[300 * 3 + 1] = 0x00;
+	bytes[300 * 3 + 2] = 0x80;
+
+	SamplePeaks peaks;
+	CHECK(peaks.setup(1024));
+	peaks.addFrames(bytes.data(), 1024, 1, 3);
+	peaks.finish();
+
+	PeakEntry entry;
+	CHECK(peaks.getSpan(0, 1024, &entry));
+	CHECK_EQUAL(-32768, entry.min);
+	CHECK_EQUAL(0, entry.max);
+}
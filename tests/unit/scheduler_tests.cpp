@@ -1,5 +1,6 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
+#include "OSLikeStuff/coroutine_task.hpp"
 #include "OSLikeStuff/task_scheduler.cpp"
 #include "cstdint"
 #include "mocks/timer_mocks.h"
@@ -37,6 +38,10 @@ void sleep_20ns() {
 	uint32_t now = getTimerValue(0);
 	passMockTime(0.00002);
 }
+void sleep_500us() {
+	mock().actualCall("sleep_500us");
+	passMockTime(0.0005);
+}
 void sleep_2ms() {
 	mock().actualCall("sleep_2ms");
 	uint32_t now = getTimerValue(0);
@@ -52,12 +57,30 @@ void yield_2ms() {
 
 TEST_GROUP(Scheduler){
 
-    void setup(){taskManager = TaskManager();
+    void setup(){taskManager = TaskManager(SchedulingPolicy::PRIORITY);
 } // namespace
 }
 ;
 
-TEST(Scheduler, schedule) {
+TEST_GROUP(SchedulerEDF){
+
+    void setup(){taskManager = TaskManager(SchedulingPolicy::EDF);
+}
+}
+;
+
+/// For tests which should pass whichever SchedulingPolicy picks the tasks. Defines the test in both groups
+#define SCHEDULER_TEST(name)                                                                                           \
+	void name##Test();                                                                                                 \
+	TEST(Scheduler, name) {                                                                                            \
+		name##Test();                                                                                                  \
+	}                                                                                                                  \
+	TEST(SchedulerEDF, name) {                                                                                         \
+		name##Test();                                                                                                  \
+	}                                                                                                                  \
+	void name##Test()
+
+SCHEDULER_TEST(schedule) {
 
 	mock().clear();
 	// will be called one less time due to the time the sleep takes not being zero
@@ -68,21 +91,22 @@ TEST(Scheduler, schedule) {
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, remove) {
+SCHEDULER_TEST(remove) {
 	static SelfRemoving selfRemoving;
+	selfRemoving = SelfRemoving{};
 
 	TaskID id = addRepeatingTask([]() { selfRemoving.runFiveTimes(); }, 0, 0.001, 0.001, 0.001, "run five times");
 	selfRemoving.id = id;
 	mock().clear();
-	// will be called one less time due to the time the sleep takes not being zero
 	mock().expectNCalls(5, "runFiveTimes");
 
-	// run the scheduler for just under 10ms, calling the function to sleep 50ns every 1ms
-	taskManager.start(0.0095);
+	// long enough for the fifth run either way - under EDF it backs off for a millisecond after each run, so goes every
+	// 2ms
+	taskManager.start(0.0125);
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, scheduleOnce) {
+SCHEDULER_TEST(scheduleOnce) {
 	mock().clear();
 	// will be called one less time due to the time the sleep takes not being zero
 	mock().expectNCalls(1, "sleep_50ns");
@@ -92,7 +116,7 @@ TEST(Scheduler, scheduleOnce) {
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, scheduleConditional) {
+SCHEDULER_TEST(scheduleConditional) {
 	mock().clear();
 	mock().expectNCalls(1, "sleep_50ns");
 	// will load as blocked but immediately pass condition
@@ -103,7 +127,7 @@ TEST(Scheduler, scheduleConditional) {
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, scheduleConditionalDoesntRun) {
+SCHEDULER_TEST(scheduleConditionalDoesntRun) {
 	mock().clear();
 	mock().expectNCalls(0, "sleep_50ns");
 	// will load as blocked but immediately pass condition
@@ -114,7 +138,7 @@ TEST(Scheduler, scheduleConditionalDoesntRun) {
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, backOffTime) {
+SCHEDULER_TEST(backOffTime) {
 	mock().clear();
 	// will be called one less time due to the time the sleep takes not being zero
 	mock().expectNCalls(9, "sleep_50ns");
@@ -137,7 +161,7 @@ TEST(Scheduler, scheduleOnceWithRepeating) {
 	mock().checkExpectations();
 };
 
-TEST(Scheduler, yield) {
+SCHEDULER_TEST(yield) {
 	mock().clear();
 	// runs an extra time as sleep2ms yields
 	mock().expectNCalls(0.01 / 0.001 - 1, "sleep_50ns");
@@ -166,7 +190,7 @@ TEST(Scheduler, removeWithPriZero) {
 };
 
 /// Schedules more than kMaxTask tasks, checks on kMaxTask tasks run
-TEST(Scheduler, tooManyTasks) {
+SCHEDULER_TEST(tooManyTasks) {
 	mock().clear();
 	// will actually register kMaxTasks tasks, after that they're ignored
 	mock().expectNCalls(kMaxTasks, "sleep_50ns");
@@ -191,7 +215,7 @@ void reAdd50() {
 	}
 };
 /// dynamically schedules more than kMaxTask tasks while remaining under kMaxTasks at all times
-TEST(Scheduler, moreThanMaxTotal) {
+SCHEDULER_TEST(moreThanMaxTotal) {
 	numCalls = 0;
 	mock().clear();
 	mock().expectNCalls(50, "reAdd50");
@@ -233,4 +257,201 @@ TEST(Scheduler, overSchedule) {
 	mock().checkExpectations();
 };
 
+TEST(Scheduler, histogramPercentiles) {
+	Histogram histogram;
+	DOUBLES_EQUAL(0, histogram.percentile(0.5), 0);
+	for (int i = 0; i < 90; i++) {
+		histogram.add(0.00005);
+	}
+	for (int i = 0; i < 10; i++) {
+		histogram.add(0.002);
+	}
+	// 50us is in [32, 64) us, 2ms in [1024, 2048) us
+	CHECK(histogram.percentile(0.5) >= 0.000032 && histogram.percentile(0.5) < 0.000064);
+	CHECK(histogram.percentile(0.9) <= 0.000064);
+	CHECK(histogram.percentile(0.99) >= 0.001024 && histogram.percentile(0.99) <= 0.002048);
+}
+
+TEST(Scheduler, histogramFollowsRecentRuns) {
+	Histogram histogram;
+	for (int i = 0; i < 1000; i++) {
+		histogram.add(0.002);
+	}
+	for (int i = 0; i < 4000; i++) {
+		histogram.add(0.00005);
+	}
+	CHECK(histogram.numSamples < Histogram::kMaxSamples);
+	CHECK(histogram.percentile(0.9) <= 0.000064);
+}
+
+TEST(Scheduler, statsCountMissedDeadlines) {
+	mock().clear();
+	mock().expectNCalls(0.01 / 0.001 - 2, "sleep_50ns");
+	mock().expectNCalls(1, "sleep_2ms");
+	TaskID fiftyns = addRepeatingTask(sleep_50ns, 10, 0.001, 0.001, 0.0015, "sleep_50ns");
+	addOnceTask(sleep_2ms, 11, 0.0035, "sleep 2ms");
+	taskManager.start(0.01);
+	mock().checkExpectations();
+
+	TaskStats stats;
+	CHECK_EQUAL(fiftyns, getTaskStats(0, &stats));
+	STRCMP_EQUAL("sleep_50ns", stats.name);
+	CHECK_EQUAL(8, stats.numRuns);
+	// it can't start while sleep_2ms is running, so one run comes well past its maxInterval
+	CHECK_EQUAL(1, stats.numMissedDeadlines);
+	CHECK(stats.latencyWorst > 0.0009);
+	CHECK(stats.durationWorst < 0.0001);
+	// the once task has gone
+	CHECK_EQUAL(-1, getTaskStats(fiftyns + 1, &stats));
+
+	resetTaskStats();
+	getTaskStats(0, &stats);
+	CHECK_EQUAL(0, stats.numRuns);
+	CHECK_EQUAL(0, stats.numMissedDeadlines);
+}
+
+TEST(SchedulerEDF, budgetsAreAdmittedUpToTheWholeCPU) {
+	TaskID a = addRepeatingTask(sleep_50ns, 0, 0, 0.001, 0.001, "a");
+	TaskID b = addRepeatingTask(sleep_50ns, 0, 0, 0.002, 0.002, "b");
+	CHECK(setTaskBudget(a, 0.0006));
+	CHECK_FALSE(setTaskBudget(b, 0.001));
+	CHECK(setTaskBudget(b, 0.0008));
+	// giving a a smaller budget still fits
+	CHECK(setTaskBudget(a, 0.0005));
+}
+
+TEST(SchedulerEDF, budgetedTaskMeetsItsDeadlines) {
+	mock().clear();
+	mock().expectNCalls(20, "sleep_50ns");
+	mock().expectNCalls(9, "sleep_500us");
+	TaskID hard = addRepeatingTask(sleep_50ns, 0, 0, 0.001, 0.0012, "hard");
+	TaskID soft = addRepeatingTask(sleep_500us, 0, 0, 0.002, 0.01, "soft");
+	CHECK(setTaskBudget(hard, 0.0001));
+	taskManager.start(0.0205);
+	mock().checkExpectations();
+
+	TaskStats stats;
+	getTaskStats(hard, &stats);
+	CHECK_EQUAL(0, stats.numMissedDeadlines);
+	CHECK_EQUAL(0, stats.numBudgetOverruns);
+}
+
+TEST(SchedulerEDF, longTaskStillGetsToRun) {
+	mock().clear();
+	mock().expectNCalls(2, "sleep_2ms");
+	mock().expectNCalls(17, "sleep_50ns");
+	TaskID hard = addRepeatingTask(sleep_50ns, 0, 0, 0.001, 0.0012, "hard");
+	// never fits between runs of the budgeted task, so only goes once it's a whole maxInterval overdue
+	addRepeatingTask(sleep_2ms, 0, 0, 0.002, 0.005, "long");
+	CHECK(setTaskBudget(hard, 0.0001));
+	taskManager.start(0.0205);
+	mock().checkExpectations();
+}
+
+using deluge::coroutine::addCoroutineTask;
+using deluge::coroutine::Coroutine;
+using deluge::coroutine::nextTick;
+using deluge::coroutine::until;
+
+Coroutine<void> sleepFiveTicks() {
+	for (int i = 0; i < 5; i++) {
+		sleep_50ns();
+		co_await nextTick();
+	}
+}
+
+Coroutine<int32_t> sleepAndCount(int32_t times) {
+	for (int32_t i = 0; i < times; i++) {
+		sleep_50ns();
+		co_await nextTick();
+	}
+	co_return times;
+}
+
+int32_t counted;
+Coroutine<void> countTwice() {
+	counted = co_await sleepAndCount(2);
+	counted += co_await sleepAndCount(3);
+}
+
+bool flag;
+double flagSetAt;
+double resumedAt;
+Coroutine<void> waitForFlag() {
+	co_await until([](void* context) { return *static_cast<bool*>(context); }, &flag);
+	resumedAt = getTimerValueSeconds(0);
+}
+
+int32_t numDestroyed;
+struct CountsDestruction {
+	~CountsDestruction() { numDestroyed += 1; }
+};
+Coroutine<void> runForever() {
+	CountsDestruction local;
+	while (true) {
+		sleep_50ns();
+		co_await nextTick();
+	}
+}
+
+TEST_GROUP(SchedulerCoroutine) {
+	void setup() { taskManager = TaskManager(SchedulingPolicy::PRIORITY); }
+};
+
+TEST(SchedulerCoroutine, runsUntilItReturns) {
+	mock().clear();
+	mock().expectNCalls(5, "sleep_50ns");
+	CHECK(addCoroutineTask(sleepFiveTicks(), 5, "five ticks") >= 0);
+	taskManager.start(0.01);
+	mock().checkExpectations();
+	// and was removed once it was done
+	CHECK_EQUAL(0, taskManager.numRegisteredTasks);
+}
+
+TEST(SchedulerCoroutine, givesOtherTasksATurn) {
+	mock().clear();
+	mock().expectNCalls(5, "sleep_50ns");
+	mock().expectNCalls(4, "sleep_2ms");
+	addRepeatingTask(sleep_2ms, 0, 0, 0.001, 0.002, "sleep_2ms");
+	addCoroutineTask(sleepFiveTicks(), 5, "five ticks");
+	// the coroutine doesn't get its next turn until the more important task's been
+	taskManager.start(0.0085);
+	mock().checkExpectations();
+}
+
+TEST(SchedulerCoroutine, awaitsOtherCoroutines) {
+	counted = 0;
+	mock().clear();
+	mock().expectNCalls(5, "sleep_50ns");
+	addCoroutineTask(countTwice(), 5, "count twice");
+	taskManager.start(0.01);
+	mock().checkExpectations();
+	CHECK_EQUAL(5, counted);
+}
+
+TEST(SchedulerCoroutine, waitsUntilReady) {
+	flag = false;
+	resumedAt = 0;
+	addCoroutineTask(waitForFlag(), 5, "wait for flag");
+	addOnceTask(
+	    []() {
+		    flag = true;
+		    flagSetAt = getTimerValueSeconds(0);
+	    },
+	    0, 0.002, "set flag");
+	taskManager.start(0.01);
+	CHECK(resumedAt >= flagSetAt);
+	CHECK(resumedAt > 0);
+	CHECK_EQUAL(0, taskManager.numRegisteredTasks);
+}
+
+TEST(SchedulerCoroutine, removingTheTaskDestroysTheCoroutine) {
+	numDestroyed = 0;
+	TaskID id = addCoroutineTask(runForever(), 5, "run forever");
+	taskManager.start(0.002);
+	CHECK_EQUAL(0, numDestroyed);
+	removeTask(id);
+	CHECK_EQUAL(1, numDestroyed);
+}
+
 } // namespace
@@ -0,0 +1,78 @@
+#include "CppUTest/TestHarness.h"
+#include "memory/slab_pool.h"
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kObjectSize = 64;
+constexpr uint32_t kCapacity = 16;
+
+} // namespace
+
+TEST_GROUP(SlabPoolTest) {
+	std::vector<uint32_t> memory = std::vector<uint32_t>(kObjectSize * kCapacity / sizeof(uint32_t));
+	SlabPool pool;
+
+	void setup() { pool.setup(memory.data(), kObjectSize, kCapacity); }
+};
+
+TEST(SlabPoolTest, handsOutEverySlotOnce) {
+	std::set<void*> addresses;
+	for (uint32_t i = 0; i < kCapacity; i++) {
+		void* address = pool.alloc();
+		CHECK(address != nullptr);
+		CHECK(pool.owns(address));
+		CHECK_EQUAL(0, ((char*)address - (char*)memory.data()) % kObjectSize);
+		addresses.insert(address);
+	}
+	CHECK_EQUAL(kCapacity, addresses.size());
+
+	POINTERS_EQUAL(nullptr, pool.alloc());
+	SlabPoolStats stats = pool.getStats();
+	CHECK_EQUAL(kCapacity, stats.numInUse);
+	CHECK_EQUAL(kCapacity, stats.numAllocs);
+	CHECK_EQUAL(1, stats.numExhausted);
+}
+
+TEST(SlabPoolTest, reusesFreedSlots) {
+	void* a = pool.alloc();
+	void* b = pool.alloc();
+	pool.dealloc(a);
+	POINTERS_EQUAL(a, pool.alloc());
+	pool.dealloc(b);
+	pool.dealloc(a);
+
+	SlabPoolStats stats = pool.getStats();
+	CHECK_EQUAL(0, stats.numInUse);
+	CHECK_EQUAL(2, stats.peakInUse);
+	CHECK_EQUAL(3, stats.numAllocs);
+}
+
+TEST(SlabPoolTest, ownsOnlyItsMemory) {
+	CHECK(pool.owns(memory.data()));
+	CHECK(pool.owns((char*)memory.data() + kObjectSize * kCapacity - 1));
+	CHECK_FALSE(pool.owns((char*)memory.data() + kObjectSize * kCapacity));
+	CHECK_FALSE(pool.owns((char*)memory.data() - 1));
+}
+
+TEST(SlabPoolTest, survivesChurn) {
+	std::vector<void*> held;
+	for (int32_t round = 0; round < 100; round++) {
+		while (void* address = pool.alloc()) {
+			held.push_back(address);
+		}
+		CHECK_EQUAL(kCapacity, held.size());
+		// Give back every other one, then the rest, in a different order each round
+		for (size_t i = round & 1; i < held.size(); i += 2) {
+			pool.dealloc(held[i]);
+		}
+		for (size_t i = !(round & 1); i < held.size(); i += 2) {
+			pool.dealloc(held[i]);
+		}
+		held.clear();
+	}
+	CHECK_EQUAL(0, pool.getStats().numInUse);
+	CHECK_EQUAL(kCapacity, pool.getStats().peakInUse);
+}
@@ -0,0 +1,57 @@
+#include "CppUTest/TestHarness.h"
+#include "util/container/ring/spsc_ring.hpp"
+#include <cstdint>
+
+TEST_GROUP(SPSCRingTest){};
+
+TEST(SPSCRingTest, emptyToStartWith) {
+	deluge::SPSCRing<int32_t, 8> ring;
+	CHECK(ring.empty());
+	CHECK(ring.front() == nullptr);
+	CHECK_EQUAL(0, ring.size());
+	CHECK_EQUAL(7, ring.capacity());
+}
+
+TEST(SPSCRingTest, firstInFirstOut) {
+	deluge::SPSCRing<int32_t, 8> ring;
+	for (int32_t i = 0; i < 5; i++) {
+		CHECK(ring.push(i));
+	}
+	CHECK_EQUAL(5, ring.size());
+	for (int32_t i = 0; i < 5; i++) {
+		CHECK_EQUAL(i, *ring.front());
+		ring.pop();
+	}
+	CHECK(ring.empty());
+}
+
+TEST(SPSCRingTest, refusesWhenFull) {
+	deluge::SPSCRing<int32_t, 8> ring;
+	for (int32_t i = 0; i < 7; i++) {
+		CHECK(ring.push(i));
+	}
+	CHECK_FALSE(ring.push(7));
+	CHECK_EQUAL(7, ring.size());
+
+	ring.pop();
+	CHECK(ring.push(7));
+	CHECK_EQUAL(1, *ring.front());
+}
+
+TEST(SPSCRingTest, wrapsAround) {
+	deluge::SPSCRing<int32_t, 4> ring;
+	int32_t nextIn = 0;
+	int32_t nextOut = 0;
+	for (int32_t round = 0; round < 100; round++) {
+		while (ring.push(nextIn)) {
+			nextIn++;
+		}
+		// Take out a different amount each time, so the positions wander
+		for (int32_t i = 0; i <= round % 3 && !ring.empty(); i++) {
+			CHECK_EQUAL(nextOut, *ring.front());
+			ring.pop();
+			nextOut++;
+		}
+	}
+	CHECK_EQUAL(nextIn - nextOut, ring.size());
+}
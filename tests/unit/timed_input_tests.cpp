@@ -0,0 +1,90 @@
+#include "CppUTest/TestHarness.h"
+#include "io/midi/timed_input.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Just what holdBackTimedInput() needs of MidiEngine's TimedMessage
+struct Message {
+	uint8_t statusType;
+	uint8_t data1;
+};
+
+constexpr Message kNoteOn{0x09, 60};
+constexpr Message kNoteOff{0x08, 60};
+constexpr Message kPitchBend{0x0E, 0};
+constexpr Message kCC{0x0B, 1};
+
+struct Port {
+	deluge::SPSCRing<Message, 4> queue;
+	std::vector<Message> actioned;
+
+	// As MidiEngine::channelMessageReceived() does it
+	void receive(Message message, bool mayHoldBack = true) {
+		if (!holdBackTimedInput(queue, message, mayHoldBack, [this](Message const& due) { actioned.push_back(due); })) {
+			actioned.push_back(message);
+		}
+	}
+
+	// As the audio routine does, once the time they came in at comes round
+	void render() {
+		flushTimedInput(queue, [this](Message const& due) { actioned.push_back(due); });
+	}
+
+	void checkActioned(std::vector<Message> expected) {
+		CHECK_EQUAL(expected.size(), actioned.size());
+		for (size_t i = 0; i < expected.size() && i < actioned.size(); i++) {
+			CHECK_EQUAL(expected[i].statusType, actioned[i].statusType);
+			CHECK_EQUAL(expected[i].data1, actioned[i].data1);
+		}
+	}
+};
+
+} // namespace
+
+TEST_GROUP(TimedInputTest){};
+
+TEST(TimedInputTest, notesAreHeldBack) {
+	Port port;
+	port.receive(kNoteOn);
+	port.receive(kNoteOff);
+	port.checkActioned({});
+
+	port.render();
+	port.checkActioned({kNoteOn, kNoteOff});
+}
+
+TEST(TimedInputTest, pitchBendWaitsForNoteBeforeIt) {
+	Port port;
+	port.receive(kNoteOn);
+	port.receive(kPitchBend);
+	port.checkActioned({kNoteOn, kPitchBend});
+	CHECK(port.queue.empty());
+}
+
+TEST(TimedInputTest, otherMessagesGoStraightThrough) {
+	Port port;
+	port.receive(kCC);
+	port.receive(kNoteOn);
+	port.checkActioned({kCC});
+
+	port.render();
+	port.checkActioned({kCC, kNoteOn});
+}
+
+TEST(TimedInputTest, noteNotHeldBackGoesAfterThoseThatWere) {
+	Port port;
+	port.receive(kNoteOn);
+	port.receive(kNoteOff, false);
+	port.checkActioned({kNoteOn, kNoteOff});
+}
+
+TEST(TimedInputTest, noteGoesAfterThoseQueuedWhenFull) {
+	Port port;
+	for (int32_t i = 0; i < 3; i++) {
+		port.receive(kNoteOn);
+	}
+	port.receive(kNoteOff);
+	port.checkActioned({kNoteOn, kNoteOn, kNoteOn, kNoteOff});
+}